@@ -39,6 +39,7 @@ class ADSRDisplay : public IUIControl
 public:
    ADSRDisplay(IDrawableModule* owner, const char* name, int x, int y, int w, int h, ::ADSR* adsr);
    void Render() override;
+   bool CheckNeedsDraw() override { return true; }
    void MouseReleased() override;
    bool MouseMoved(float x, float y) override;
 
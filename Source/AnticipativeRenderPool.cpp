@@ -0,0 +1,147 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    AnticipativeRenderPool.cpp
+    Created: 19 Oct 2026 6:12:40pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "AnticipativeRenderPool.h"
+#include "SynthGlobals.h"
+
+namespace
+{
+   const int kMaxWorkers = 8;
+}
+
+AnticipativeRenderPool::AnticipativeRenderPool()
+: mWriteIndex(0)
+, mReadIndex(0)
+{
+   for (int i=0; i<kQueueSize; ++i)
+      mQueue[i] = nullptr;
+}
+
+AnticipativeRenderPool::~AnticipativeRenderPool()
+{
+   for (auto& worker : mWorkers)
+      worker->signalThreadShouldExit();
+   mWorkAvailable.signal();
+   for (auto& worker : mWorkers)
+      worker->stopThread(1000);
+}
+
+void AnticipativeRenderPool::Start()
+{
+   if (!mWorkers.empty())
+      return;
+   
+   //leave a core for the audio thread
+   int numWorkers = CLAMP(juce::SystemStats::getNumCpus() - 1, 1, kMaxWorkers);
+   for (int i=0; i<numWorkers; ++i)
+   {
+      mWorkers.push_back(std::make_unique<Worker>(this));
+      mWorkers.back()->startThread(juce::Thread::realtimeAudioPriority);
+   }
+}
+
+void AnticipativeRenderPool::Submit(Job* job)
+{
+   job->mDone.reset();
+   job->mState = Job::kQueued;
+   
+   int writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+   if (mWorkers.empty() || writeIndex - mReadIndex.load(std::memory_order_acquire) >= kQueueSize)
+      return;  //Wait() will render it
+   
+   mQueue[writeIndex % kQueueSize] = job;
+   mWriteIndex.store(writeIndex + 1, std::memory_order_release);
+   mWorkAvailable.signal();
+}
+
+void AnticipativeRenderPool::Wait(Job* job)
+{
+   if (job->mState == Job::kIdle)
+      return;
+   
+   int expected = Job::kQueued;
+   if (job->mState.compare_exchange_strong(expected, Job::kRendering))
+      Render(job);
+   
+   while (job->mState.load(std::memory_order_acquire) == Job::kRendering)
+      job->mDone.wait(1);
+   
+   job->mState = Job::kIdle;
+}
+
+void AnticipativeRenderPool::Forget(Job* job)
+{
+   Wait(job);
+   
+   //a job that Wait() rendered itself can still be sitting in the queue
+   std::lock_guard<std::mutex> lock(mReadMutex);
+   for (int i=mReadIndex; i<mWriteIndex; ++i)
+   {
+      if (mQueue[i % kQueueSize] == job)
+         mQueue[i % kQueueSize] = nullptr;
+   }
+}
+
+AnticipativeRenderPool::Job* AnticipativeRenderPool::TakeJob()
+{
+   std::lock_guard<std::mutex> lock(mReadMutex);
+   int readIndex = mReadIndex.load(std::memory_order_relaxed);
+   if (readIndex == mWriteIndex.load(std::memory_order_acquire))
+      return nullptr;
+   Job* job = mQueue[readIndex % kQueueSize];
+   mQueue[readIndex % kQueueSize] = nullptr;
+   mReadIndex.store(readIndex + 1, std::memory_order_release);
+   return job;
+}
+
+//static
+void AnticipativeRenderPool::Render(Job* job)
+{
+   job->RenderAhead();
+   job->mState.store(Job::kDone, std::memory_order_release);
+   job->mDone.signal();
+}
+
+void AnticipativeRenderPool::Worker::run()
+{
+   NoteEventBus::ScopedRender noteRender(&mNoteQueue);
+   
+   while (!threadShouldExit())
+   {
+      Job* job = mPool->TakeJob();
+      if (job == nullptr)
+      {
+         mPool->mWorkAvailable.wait(10);
+         continue;
+      }
+      
+      //the audio thread may have gotten impatient and rendered it already
+      int expected = Job::kQueued;
+      if (job->mState.compare_exchange_strong(expected, Job::kRendering))
+         Render(job);
+   }
+}
@@ -0,0 +1,98 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    AnticipativeRenderPool.h
+    Created: 19 Oct 2026 6:12:40pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "juce_core/juce_core.h"
+#include "NoteEventBus.h"
+
+//worker threads for rendering modules a buffer ahead of the audio thread.
+//a module whose output doesn't depend on live input can submit its next buffer at the end of Process(), and pick up
+//the result at the start of the next one. in between, a worker renders it in parallel with the rest of the graph
+class AnticipativeRenderPool
+{
+public:
+   class Job
+   {
+   public:
+      virtual ~Job() {}
+      //runs on a worker, or on the audio thread if no worker got to it in time
+      virtual void RenderAhead() = 0;
+   private:
+      friend class AnticipativeRenderPool;
+      enum State
+      {
+         kIdle,
+         kQueued,
+         kRendering,
+         kDone
+      };
+      std::atomic<int> mState{kIdle};
+      juce::WaitableEvent mDone;
+   };
+   
+   AnticipativeRenderPool();
+   ~AnticipativeRenderPool();
+   
+   //main thread. the workers are started the first time something asks for them
+   void Start();
+   
+   //audio thread
+   void Submit(Job* job);
+   //returns once the job has been rendered. if no worker has picked it up yet, it is rendered right here
+   void Wait(Job* job);
+   static bool IsSubmitted(const Job* job) { return job->mState != Job::kIdle; }
+   
+   //main thread, before a job is deleted
+   void Forget(Job* job);
+   
+private:
+   class Worker : public juce::Thread
+   {
+   public:
+      Worker(AnticipativeRenderPool* pool) : juce::Thread("anticipative render"), mPool(pool) {}
+      void run() override;
+   private:
+      AnticipativeRenderPool* mPool;
+      NoteEventBus::RenderQueue mNoteQueue;   //notes played while rendering are delivered on this thread, like on the audio thread
+   };
+   
+   Job* TakeJob();
+   static void Render(Job* job);
+   
+   static const int kQueueSize = 256;
+   Job* mQueue[kQueueSize];
+   std::atomic<int> mWriteIndex;
+   std::atomic<int> mReadIndex;
+   std::mutex mReadMutex;  //only the workers take turns on this, the audio thread never does
+   juce::WaitableEvent mWorkAvailable;
+   std::vector<std::unique_ptr<Worker>> mWorkers;
+};
@@ -273,7 +273,7 @@ void Arpeggiator::UpdateInterval()
 {   
    TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
    if (transportListenerInfo != nullptr)
-      transportListenerInfo->mInterval = mInterval;
+      transportListenerInfo->SetInterval(mInterval);
 }
 
 void Arpeggiator::ButtonClicked(ClickButton* button)
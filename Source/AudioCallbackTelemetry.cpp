@@ -0,0 +1,315 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    AudioCallbackTelemetry.cpp
+    Created: 19 Oct 2026 5:36:10pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "AudioCallbackTelemetry.h"
+#include "SynthGlobals.h"
+#include "IAudioSource.h"
+#include "IDrawableModule.h"
+#include "ofxJSONElement.h"
+
+#include <cstring>
+
+#include "juce_core/juce_core.h"
+
+namespace
+{
+   const int kNumMissesToDraw = 6;
+   const float kPanelWidth = 420;
+   const float kHistogramHeight = 60;
+}
+
+AudioCallbackTelemetry::AudioCallbackTelemetry()
+: mNumCallbacks(0)
+, mNumDeadlineMisses(0)
+, mNumLateCallbacks(0)
+, mMaxLoad(0)
+, mLastLoad(0)
+, mNumMissesRecorded(0)
+, mFirstMissSinceReset(0)
+, mTicksPerMs(juce::Time::getHighResolutionTicksPerSecond() / 1000.0)
+, mCallbackStartTicks(0)
+, mLastCallbackStartTicks(0)
+, mSourceStartTicks(0)
+, mDeadlineTicks(1)
+, mNumTopModules(0)
+, mDrawEnabled(false)
+{
+   for (int i=0; i<kNumHistogramBuckets; ++i)
+      mHistogram[i] = 0;
+}
+
+void AudioCallbackTelemetry::BeginCallback(int bufferSize)
+{
+   int64_t now = juce::Time::getHighResolutionTicks();
+   mDeadlineTicks = MAX(1, int64_t(mTicksPerMs * bufferSize * 1000.0 / gSampleRate));
+   
+   //the device calls back once per buffer. a much longer gap means it was starved, usually a dropped buffer,
+   //even if the callback that overran was someone else's
+   if (mLastCallbackStartTicks != 0 && now - mLastCallbackStartTicks > mDeadlineTicks * 3 / 2)
+      mNumLateCallbacks.fetch_add(1, std::memory_order_relaxed);
+   
+   mLastCallbackStartTicks = now;
+   mCallbackStartTicks = now;
+   mNumTopModules = 0;
+}
+
+void AudioCallbackTelemetry::BeginSource()
+{
+   mSourceStartTicks = juce::Time::getHighResolutionTicks();
+}
+
+void AudioCallbackTelemetry::EndSource(IAudioSource* source)
+{
+   int64_t ticks = juce::Time::getHighResolutionTicks() - mSourceStartTicks;
+   
+   //keep the most expensive sources of this callback, sorted, most expensive first
+   int slot = mNumTopModules;
+   while (slot > 0 && mTopModuleTicks[slot-1] < ticks)
+      --slot;
+   if (slot >= kNumTopModules)
+      return;
+   
+   int last = MIN(mNumTopModules, kNumTopModules-1);
+   for (int i=last; i>slot; --i)
+   {
+      mTopModules[i] = mTopModules[i-1];
+      mTopModuleTicks[i] = mTopModuleTicks[i-1];
+   }
+   mTopModules[slot] = source;
+   mTopModuleTicks[slot] = ticks;
+   mNumTopModules = MIN(mNumTopModules + 1, kNumTopModules);
+}
+
+void AudioCallbackTelemetry::EndCallback()
+{
+   int64_t duration = juce::Time::getHighResolutionTicks() - mCallbackStartTicks;
+   float load = duration / (float)mDeadlineTicks;
+   
+   int bucket = MIN(int(load / kHistogramBucketLoad), kNumHistogramBuckets-1);
+   mHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+   mNumCallbacks.fetch_add(1, std::memory_order_relaxed);
+   mLastLoad.store(load, std::memory_order_relaxed);
+   if (load > mMaxLoad.load(std::memory_order_relaxed))
+      mMaxLoad.store(load, std::memory_order_relaxed);
+   
+   if (duration <= mDeadlineTicks)
+      return;
+   
+   mNumDeadlineMisses.fetch_add(1, std::memory_order_relaxed);
+   
+   int index = mNumMissesRecorded.load(std::memory_order_relaxed);
+   DeadlineMiss& miss = mMisses[index % kMaxMisses];
+   miss.mSequence.store(-1, std::memory_order_release);
+   miss.mWallTimeMs = juce::Time::currentTimeMillis();
+   miss.mAudioTimeMs = gTime;
+   miss.mDurationMs = TicksToMs(duration);
+   miss.mDeadlineMs = TicksToMs(mDeadlineTicks);
+   miss.mNumModules = mNumTopModules;
+   for (int i=0; i<mNumTopModules; ++i)
+   {
+      IDrawableModule* module = dynamic_cast<IDrawableModule*>(mTopModules[i]);
+      strncpy(miss.mModules[i].mName, module ? module->Name() : "?", sizeof(miss.mModules[i].mName) - 1);
+      miss.mModules[i].mName[sizeof(miss.mModules[i].mName) - 1] = 0;
+      miss.mModules[i].mTicks = mTopModuleTicks[i];
+   }
+   miss.mSequence.store(index, std::memory_order_release);
+   mNumMissesRecorded.store(index + 1, std::memory_order_release);
+}
+
+double AudioCallbackTelemetry::TicksToMs(int64_t ticks) const
+{
+   return ticks / mTicksPerMs;
+}
+
+void AudioCallbackTelemetry::NotePatchChange(const std::string& description)
+{
+   std::lock_guard<ofMutex> lock(mPatchChangesMutex);
+   
+   PatchChange change;
+   change.mWallTimeMs = juce::Time::currentTimeMillis();
+   change.mAudioTimeMs = gTime;
+   change.mDescription = description;
+   mPatchChanges.push_back(change);
+   while ((int)mPatchChanges.size() > kMaxPatchChanges)
+      mPatchChanges.pop_front();
+}
+
+void AudioCallbackTelemetry::Reset()
+{
+   for (int i=0; i<kNumHistogramBuckets; ++i)
+      mHistogram[i] = 0;
+   mNumCallbacks = 0;
+   mNumDeadlineMisses = 0;
+   mNumLateCallbacks = 0;
+   mMaxLoad = 0;
+   //the audio thread owns the miss log, so rather than clearing it, start reading after what's in it now
+   mFirstMissSinceReset = mNumMissesRecorded.load(std::memory_order_acquire);
+   
+   std::lock_guard<ofMutex> lock(mPatchChangesMutex);
+   mPatchChanges.clear();
+}
+
+//copies out the most recent misses, oldest first
+int AudioCallbackTelemetry::ReadMisses(DeadlineMiss* misses, int maxMisses) const
+{
+   int numRecorded = mNumMissesRecorded.load(std::memory_order_acquire);
+   int first = MAX(mFirstMissSinceReset.load(std::memory_order_relaxed), numRecorded - MIN(maxMisses, kMaxMisses));
+   int count = 0;
+   for (int i=first; i<numRecorded; ++i)
+   {
+      const DeadlineMiss& slot = mMisses[i % kMaxMisses];
+      if (slot.mSequence.load(std::memory_order_acquire) != i)
+         continue;
+      DeadlineMiss& miss = misses[count];
+      miss.mWallTimeMs = slot.mWallTimeMs;
+      miss.mAudioTimeMs = slot.mAudioTimeMs;
+      miss.mDurationMs = slot.mDurationMs;
+      miss.mDeadlineMs = slot.mDeadlineMs;
+      miss.mNumModules = slot.mNumModules;
+      memcpy(miss.mModules, slot.mModules, sizeof(miss.mModules));
+      if (slot.mSequence.load(std::memory_order_acquire) == i)  //otherwise it was overwritten while we were reading it
+         ++count;
+   }
+   return count;
+}
+
+void AudioCallbackTelemetry::Draw()
+{
+   if (!mDrawEnabled)
+      return;
+   
+   DeadlineMiss misses[kNumMissesToDraw];
+   int numMisses = ReadMisses(misses, kNumMissesToDraw);
+   
+   uint32_t histogram[kNumHistogramBuckets];
+   uint32_t maxCount = 1;
+   for (int i=0; i<kNumHistogramBuckets; ++i)
+   {
+      histogram[i] = mHistogram[i].load(std::memory_order_relaxed);
+      maxCount = MAX(maxCount, histogram[i]);
+   }
+   
+   ofPushMatrix();
+   ofTranslate(ofGetWidth() - kPanelWidth - 30, 70);
+   ofPushStyle();
+   ofFill();
+   
+   float height = 60 + kHistogramHeight + numMisses * 15;
+   ofSetColor(0,0,0,180);
+   ofRect(-5, -15, kPanelWidth, height);
+   
+   ofSetColor(255,255,255);
+   gFont.DrawString("callbacks: " + ofToString((int)mNumCallbacks.load()) +
+                    "   deadline misses: " + ofToString((int)mNumDeadlineMisses.load()) +
+                    "   late callbacks: " + ofToString((int)mNumLateCallbacks.load()), 13, 0, 0);
+   gFont.DrawString("load: " + ofToString(int(mLastLoad.load() * 100)) + "%   max: " + ofToString(int(mMaxLoad.load() * 100)) + "%", 13, 0, 15);
+   
+   //log scaled, so the rare slow callbacks are still visible next to the common ones
+   float barWidth = (kPanelWidth - 10) / kNumHistogramBuckets;
+   float histogramBottom = 25 + kHistogramHeight;
+   for (int i=0; i<kNumHistogramBuckets; ++i)
+   {
+      if (histogram[i] == 0)
+         continue;
+      float barHeight = log(1 + histogram[i]) / log(1 + maxCount) * kHistogramHeight;
+      if ((i + 1) * kHistogramBucketLoad > 1)
+         ofSetColor(255,0,0);
+      else
+         ofSetColor(0,255,0);
+      ofRect(i * barWidth, histogramBottom - barHeight, barWidth - 1, barHeight);
+   }
+   ofSetColor(255,255,255,120);
+   float deadlineX = (1 / kHistogramBucketLoad) * barWidth;
+   ofLine(deadlineX, 25, deadlineX, histogramBottom);
+   
+   ofSetColor(255,255,255);
+   float y = histogramBottom + 15;
+   for (int i=numMisses-1; i>=0; --i)
+   {
+      const DeadlineMiss& miss = misses[i];
+      std::string line = ofToString(miss.mAudioTimeMs / 1000, 1) + "s: " + ofToString(miss.mDurationMs, 2) + "/" + ofToString(miss.mDeadlineMs, 2) + "ms";
+      for (int j=0; j<miss.mNumModules && j<3; ++j)
+         line += "  " + std::string(miss.mModules[j].mName) + " " + ofToString(TicksToMs(miss.mModules[j].mTicks), 2);
+      gFont.DrawString(line, 11, 0, y);
+      y += 15;
+   }
+   
+   ofPopStyle();
+   ofPopMatrix();
+}
+
+std::string AudioCallbackTelemetry::Dump()
+{
+   ofxJSONElement root;
+   root["buffer_size"] = gBufferSize;
+   root["sample_rate"] = gSampleRate;
+   root["deadline_ms"] = gBufferSize * 1000.0 / gSampleRate;
+   root["callbacks"] = (int)mNumCallbacks.load();
+   root["deadline_misses"] = (int)mNumDeadlineMisses.load();
+   root["late_callbacks"] = (int)mNumLateCallbacks.load();
+   root["max_load"] = mMaxLoad.load();
+   
+   root["histogram"] = Json::Value(Json::arrayValue);
+   for (int i=0; i<kNumHistogramBuckets; ++i)
+   {
+      root["histogram"][i]["load_from"] = i * kHistogramBucketLoad;
+      root["histogram"][i]["load_to"] = i < kNumHistogramBuckets - 1 ? (i + 1) * kHistogramBucketLoad : -1;
+      root["histogram"][i]["count"] = (int)mHistogram[i].load();
+   }
+   
+   DeadlineMiss misses[kMaxMisses];
+   int numMisses = ReadMisses(misses, kMaxMisses);
+   root["misses"] = Json::Value(Json::arrayValue);
+   for (int i=0; i<numMisses; ++i)
+   {
+      root["misses"][i]["wall_time_ms"] = (double)misses[i].mWallTimeMs;
+      root["misses"][i]["audio_time_ms"] = misses[i].mAudioTimeMs;
+      root["misses"][i]["duration_ms"] = misses[i].mDurationMs;
+      root["misses"][i]["deadline_ms"] = misses[i].mDeadlineMs;
+      root["misses"][i]["modules"] = Json::Value(Json::arrayValue);
+      for (int j=0; j<misses[i].mNumModules; ++j)
+      {
+         root["misses"][i]["modules"][j]["name"] = misses[i].mModules[j].mName;
+         root["misses"][i]["modules"][j]["ms"] = TicksToMs(misses[i].mModules[j].mTicks);
+      }
+   }
+   
+   {
+      std::lock_guard<ofMutex> lock(mPatchChangesMutex);
+      root["patch_changes"] = Json::Value(Json::arrayValue);
+      for (int i=0; i<(int)mPatchChanges.size(); ++i)
+      {
+         root["patch_changes"][i]["wall_time_ms"] = (double)mPatchChanges[i].mWallTimeMs;
+         root["patch_changes"][i]["audio_time_ms"] = mPatchChanges[i].mAudioTimeMs;
+         root["patch_changes"][i]["description"] = mPatchChanges[i].mDescription;
+      }
+   }
+   
+   std::string path = ofToDataPath(ofGetTimestampString("xruns_%Y-%m-%d_%H-%M-%S.json"));
+   root.save(path, true);
+   return path;
+}
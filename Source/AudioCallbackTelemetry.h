@@ -0,0 +1,127 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    AudioCallbackTelemetry.h
+    Created: 19 Oct 2026 5:36:10pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include "OpenFrameworksPort.h"
+
+class IAudioSource;
+
+//times every audio callback against its deadline (the length of the buffer), so dropouts show up as data rather than by ear.
+//the audio thread writes a load histogram and a log of deadline misses without locking or allocating. each miss keeps the
+//most expensive modules of that callback, and patch changes are logged alongside so the two can be lined up afterwards
+class AudioCallbackTelemetry
+{
+public:
+   AudioCallbackTelemetry();
+   
+   class ScopedCallback
+   {
+   public:
+      ScopedCallback(AudioCallbackTelemetry* telemetry, int bufferSize) : mTelemetry(telemetry) { mTelemetry->BeginCallback(bufferSize); }
+      ~ScopedCallback() { mTelemetry->EndCallback(); }
+   private:
+      AudioCallbackTelemetry* mTelemetry;
+   };
+   
+   //audio thread
+   void BeginCallback(int bufferSize);
+   void BeginSource();
+   void EndSource(IAudioSource* source);
+   void EndCallback();
+   
+   //main thread
+   void NotePatchChange(const std::string& description);
+   void Reset();
+   void Draw();
+   void ToggleDraw() { mDrawEnabled = !mDrawEnabled; }
+   std::string Dump();  //writes a json file to the data folder, returns its path
+   
+   static const int kNumTopModules = 5;
+   static const int kNumHistogramBuckets = 40;
+   static constexpr float kHistogramBucketLoad = .05f;   //fraction of the deadline per bucket, the last bucket holds everything over
+   
+private:
+   struct ModuleCost
+   {
+      char mName[64];
+      int64_t mTicks;
+   };
+   
+   struct DeadlineMiss
+   {
+      std::atomic<int> mSequence{-1};
+      int64_t mWallTimeMs{0};
+      double mAudioTimeMs{0};
+      double mDurationMs{0};
+      double mDeadlineMs{0};
+      int mNumModules{0};
+      ModuleCost mModules[kNumTopModules]{};
+   };
+   
+   struct PatchChange
+   {
+      int64_t mWallTimeMs;
+      double mAudioTimeMs;
+      std::string mDescription;
+   };
+   
+   static const int kMaxMisses = 128;
+   static const int kMaxPatchChanges = 500;
+   
+   double TicksToMs(int64_t ticks) const;
+   int ReadMisses(DeadlineMiss* misses, int maxMisses) const;
+   
+   std::atomic<uint32_t> mHistogram[kNumHistogramBuckets];
+   std::atomic<uint32_t> mNumCallbacks;
+   std::atomic<uint32_t> mNumDeadlineMisses;
+   std::atomic<uint32_t> mNumLateCallbacks;
+   std::atomic<float> mMaxLoad;
+   std::atomic<float> mLastLoad;
+   DeadlineMiss mMisses[kMaxMisses];
+   std::atomic<int> mNumMissesRecorded;
+   std::atomic<int> mFirstMissSinceReset;   //misses before this were recorded before the last Reset(), so they're skipped
+   const double mTicksPerMs;
+   
+   //audio thread only
+   int64_t mCallbackStartTicks;
+   int64_t mLastCallbackStartTicks;
+   int64_t mSourceStartTicks;
+   int64_t mDeadlineTicks;
+   IAudioSource* mTopModules[kNumTopModules];
+   int64_t mTopModuleTicks[kNumTopModules];
+   int mNumTopModules;
+   
+   //main thread only
+   std::deque<PatchChange> mPatchChanges;
+   ofMutex mPatchChangesMutex;
+   bool mDrawEnabled;
+};
@@ -58,6 +58,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=86; h=38; }
    bool Enabled() const override { return mEnabled; }
    
@@ -52,6 +52,7 @@ public:
    //IModulator
    float Value(int samplesIn = 0) override;
    bool Active() const override { return mEnabled; }
+   bool IsAudioRate() const override { return true; }
    
    //IFloatSliderListener
    void FloatSliderUpdated(FloatSlider* slider, float oldVal) override {}
@@ -25,13 +25,10 @@
 
 #include "Autotalent.h"
 #include "SynthGlobals.h"
-#include "FFT.h"
 #include "Scale.h"
 #include "ModularSynth.h"
 #include "Profiler.h"
 
-#define L2SC (float)3.32192809488736218171
-
 Autotalent::Autotalent()
 : IAudioProcessor(gBufferSize)
 , mTune(440)
@@ -86,6 +83,8 @@ Autotalent::Autotalent()
 , mFwarpSlider(nullptr)
 , mMixSlider(nullptr)
 , mSetFromScaleButton(nullptr)
+, mHopSelector(nullptr)
+, mHop(512)
 , mPitch(0)
 , mConfidence(0)
 {
@@ -94,19 +93,9 @@ Autotalent::Autotalent()
 
    mfs = gSampleRate;
 
-   mcbsize = 2048;
-   mcorrsize = mcbsize / 2 + 1;
-
-   mpmax = 1/(float)70;  // max and min periods (ms)
-   mpmin = 1/(float)700; // eventually may want to bring these out as sliders
-
-   mnmax = (unsigned long)(gSampleRate * mpmax);
-   if (mnmax > mcorrsize) {
-      mnmax = mcorrsize;
-   }
-   mnmin = (unsigned long)(gSampleRate * mpmin);
+   mcbsize = mPitchDetector.GetWindowSize();
+   mPitchDetector.SetOverlap(mcbsize / mHop);
 
-   mcbi = (float*)calloc(mcbsize, sizeof(float));
    mcbf = (float*)calloc(mcbsize, sizeof(float));
    mcbo = (float*)calloc(mcbsize, sizeof(float));
 
@@ -143,51 +132,10 @@ Autotalent::Autotalent()
       mhannwindow[ti] = -0.5*cos(2*PI*ti/mcbsize) + 0.5;
    }
 
-   // Generate a window with a single raised cosine from N/4 to 3N/4
-   mcbwindow = (float*)calloc(mcbsize, sizeof(float));
-   for (int ti=0; ti<(mcbsize / 2); ti++) {
-      mcbwindow[ti+mcbsize/4] = -0.5*cos(4*PI*ti/(mcbsize - 1)) + 0.5;
-   }
-
-   mnoverlap = 4;
-
-   mFFT = new ::FFT((int)mcbsize);
-
-   mffttime = (float*)calloc(mcbsize, sizeof(float));
-   mfftfreqre = (float*)calloc(mcorrsize, sizeof(float));
-   mfftfreqim = (float*)calloc(mcorrsize, sizeof(float));
-
-
-   // ---- Calculate autocorrelation of window ----
-   macwinv = (float*)calloc(mcbsize, sizeof(float));
-   for (int ti=0; ti<mcbsize; ti++) {
-      mffttime[ti] = mcbwindow[ti];
-   }
-   mFFT->Forward(mcbwindow, mfftfreqre, mfftfreqim);
-   for (int ti=0; ti<mcorrsize; ti++) {
-      mfftfreqre[ti] = (mfftfreqre[ti])*(mfftfreqre[ti]) + (mfftfreqim[ti])*(mfftfreqim[ti]);
-      mfftfreqim[ti] = 0;
-   }
-   mFFT->Inverse(mfftfreqre, mfftfreqim, mffttime);
-   for (long ti=1; ti<mcbsize; ti++) {
-      macwinv[ti] = mffttime[ti]/mffttime[0];
-      if (macwinv[ti] > 0.000001) {
-         macwinv[ti] = (float)1/macwinv[ti];
-      }
-      else {
-         macwinv[ti] = 0;
-      }
-   }
-   macwinv[0] = 1;
-   // ---- END Calculate autocorrelation of window ----
-
-
    mlrshift = 0;
    mptarget = 0;
    msptarget = 0;
 
-   mvthresh = 0.7;  //  The voiced confidence (unbiased peak) threshold level
-
    // Pitch shifter initialization
    mphprdd = 0.01; // Default period
    minphinc = (float)1/(mphprdd * gSampleRate);
@@ -226,6 +174,7 @@ void Autotalent::CreateUIControls()
    mFwarpSlider = new FloatSlider(this,"fwarp",4,300,150,15,&mFwarp,-5,5);
    mMixSlider = new FloatSlider(this,"mix",4,320,150,15,&mMix,0,1);
    mSetFromScaleButton = new ClickButton(this,"set from scale",4,340);
+   mHopSelector = new DropdownList(this,"hop",170,100,&mHop);
    
    mASelector->AddLabel("A ", 1);
    mASelector->AddLabel(" ", 0);
@@ -274,21 +223,19 @@ void Autotalent::CreateUIControls()
    mAbSelector->AddLabel("Ab", 1);
    mAbSelector->AddLabel(" ", 0);
    mAbSelector->AddLabel("-", -1);
+   
+   mHopSelector->AddLabel("128", 128);
+   mHopSelector->AddLabel("256", 256);
+   mHopSelector->AddLabel("512", 512);
+   mHopSelector->AddLabel("1024", 1024);
 }
 
 Autotalent::~Autotalent()
 {
-   delete mFFT;
-   free(mcbi);
    free(mcbf);
    free(mcbo);
-   free(mcbwindow);
    free(mhannwindow);
-   free(macwinv);
    free(mfrag);
-   free(mffttime);
-   free(mfftfreqre);
-   free(mfftfreqim);
    free(mfk);
    free(mfb);
    free(mfc);
@@ -322,7 +269,6 @@ void Autotalent::Process(double time)
    int iScwarp;
 
    long int N;
-   long int Nf;
    long int fs;
 
    long int ti;
@@ -348,7 +294,6 @@ void Autotalent::Process(double time)
    int uppersnap;
    float lfoval;
 
-   float pperiod;
    float fa;
    float fb;
    float fc;
@@ -428,12 +373,10 @@ void Autotalent::Process(double time)
    maref = (float)mTune;
 
    N = mcbsize;
-   Nf = mcorrsize;
    fs = mfs;
 
-   pperiod = mpmax;
-   float inpitch = minpitch;
-   float conf = mconf;
+   mPitchDetector.SetTuning(maref);
+   float inpitch = mPitchDetector.GetPitch() - 69;
    float outpitch = moutpitch;
 
 
@@ -442,10 +385,10 @@ void Autotalent::Process(double time)
     *******************/
    for (int lSampleIndex = 0; lSampleIndex < bufferSize; lSampleIndex++)
    {
-      // load data into circular buffer
+      // load data into the pitch detector's circular buffer, which is written in step with mcbiwr
       tf = (float) *(pfInput++);
       ti4 = mcbiwr;
-      mcbi[ti4] = tf;
+      bool estimated = mPitchDetector.Push(tf, lSampleIndex);
 
       if (mFcorr)
       {
@@ -493,106 +436,14 @@ void Autotalent::Process(double time)
       // * Low-rate section *
       // ********************
 
-      // Every N/noverlap samples, run pitch estimation / manipulation code
-      if ((mcbiwr)%(N/mnoverlap) == 0)
+      // Every hop, run pitch manipulation code on the new estimate
+      if (estimated)
       {
-         // ---- Obtain autocovariance ----
-
-         // Window and fill FFT buffer
-         ti2 = mcbiwr;
-         for (ti=0; ti<N; ti++)
-         {
-            mffttime[ti] = (float)(mcbi[(ti2-ti+N)%N]*mcbwindow[ti]);
-         }
-
-         // Calculate FFT
-         mFFT->Forward(mffttime, mfftfreqre, mfftfreqim);
-
-         // Remove DC
-         mfftfreqre[0] = 0;
-         mfftfreqim[0] = 0;
-
-         // Take magnitude squared
-         for (ti=1; ti<Nf; ti++)
-         {
-            mfftfreqre[ti] = (mfftfreqre[ti])*(mfftfreqre[ti]) + (mfftfreqim[ti])*(mfftfreqim[ti]);
-            mfftfreqim[ti] = 0;
-         }
-
-         // Calculate IFFT
-         mFFT->Inverse(mfftfreqre, mfftfreqim, mffttime);
-
-         // Normalize
-         tf = (float)1/mffttime[0];
-         for (ti=1; ti<N; ti++)
-         {
-            mffttime[ti] = mffttime[ti] * tf;
-         }
-         mffttime[0] = 1;
-
-         //  ---- END Obtain autocovariance ----
-
-
-         //  ---- Calculate pitch and confidence ----
-
-         // Calculate pitch period
-         //   Pitch period is determined by the location of the max (biased)
-         //     peak within a given range
-         //   Confidence is determined by the corresponding unbiased height
-         tf2 = 0;
-         pperiod = mpmin;
-         for (ti=mnmin; ti<mnmax; ti++)
-         {
-            ti2 = ti-1;
-            ti3 = ti+1;
-            if (ti2<0)
-            {
-               ti2 = 0;
-            }
-            if (ti3>Nf)
-            {
-               ti3 = Nf;
-            }
-            tf = mffttime[ti];
-
-            if (tf>mffttime[ti2] && tf>=mffttime[ti3] && tf>tf2)
-            {
-               tf2 = tf;
-               ti4 = ti;
-            }
-         }
-         if (tf2>0)
-         {
-            conf = tf2*macwinv[ti4];
-            if (ti4>0 && ti4<Nf)
-            {
-               // Find the center of mass in the vicinity of the detected peak
-               tf = mffttime[ti4-1]*(ti4-1);
-               tf = tf + mffttime[ti4]*(ti4);
-               tf = tf + mffttime[ti4+1]*(ti4+1);
-               tf = tf/(mffttime[ti4-1] + mffttime[ti4] + mffttime[ti4+1]);
-               pperiod = tf/fs;
-            }
-            else
-            {
-               pperiod = (float)ti4/fs;
-            }
-         }
-
-         // Convert to semitones
-         tf = (float) -12*log10((float)maref*pperiod)*L2SC;
-         if (conf>=mvthresh)
-         {
-            inpitch = tf;
-            minpitch = tf; // update pitch only if voiced
-         }
-         mconf = conf;
+         if (mPitchDetector.IsVoiced())
+            inpitch = mPitchDetector.GetPitch() - 69; // update pitch only if voiced
 
          mPitch = inpitch + 69;
-         mConfidence = conf;
-
-         //  ---- END Calculate pitch and confidence ----
-
+         mConfidence = mPitchDetector.GetConfidence();
 
          //  ---- Modify pitch in all kinds of ways! ----
 
@@ -677,7 +528,7 @@ void Autotalent::Process(double time)
          outpitch = outpitch + mShift;
 
          // LFO logic
-         tf = mLforate*N/(mnoverlap*fs);
+         tf = mLforate*mPitchDetector.GetHopSize()/fs;
          if (tf>1) tf=1;
          mlfophase = mlfophase + tf;
          if (mlfophase>1) mlfophase = mlfophase-1;
@@ -920,7 +771,7 @@ void Autotalent::Process(double time)
       
       // Write audio to output of plugin
       // Mix (blend between original (delayed) =0 and processed =1)
-      *(pfOutput++) = mMix*tf + (1-mMix)*mcbi[ti4];
+      *(pfOutput++) = mMix*tf + (1-mMix)*mPitchDetector.GetInputBuffer()[ti4];
    }
 
    Add(target->GetBuffer()->GetChannel(0), mWorkingBuffer, bufferSize);
@@ -971,6 +822,7 @@ void Autotalent::DrawModule()
    mFwarpSlider->Draw();
    mMixSlider->Draw();
    mSetFromScaleButton->Draw();
+   mHopSelector->Draw();
 
    float pitch = mPitch;
    while (pitch > 12) pitch -= 12;
@@ -1000,6 +852,12 @@ void Autotalent::ButtonClicked(ClickButton* button)
    }
 }
 
+void Autotalent::DropdownUpdated(DropdownList* list, int oldVal)
+{
+   if (list == mHopSelector)
+      mPitchDetector.SetOverlap(mcbsize / mHop);
+}
+
 void Autotalent::PlayNote(double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation)
 {
    if (velocity > 0)
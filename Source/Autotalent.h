@@ -34,10 +34,10 @@
 #include "RadioButton.h"
 #include "ClickButton.h"
 #include "INoteReceiver.h"
+#include "DropdownList.h"
+#include "PitchDetector.h"
 
-class FFT;
-
-class Autotalent : public IAudioProcessor, public IIntSliderListener, public IFloatSliderListener, public IDrawableModule, public IRadioButtonListener, public IButtonListener, public INoteReceiver
+class Autotalent : public IAudioProcessor, public IIntSliderListener, public IFloatSliderListener, public IDrawableModule, public IRadioButtonListener, public IButtonListener, public INoteReceiver, public IDropdownListener
 {
 public:
    Autotalent();
@@ -68,6 +68,10 @@ public:
    void RadioButtonUpdated(RadioButton* radio, int oldVal) override {}
    //IButtonListener
    void ButtonClicked(ClickButton* button) override;
+   //IDropdownListener
+   void DropdownUpdated(DropdownList* list, int oldVal) override;
+   
+   PitchDetector* GetPitchDetector() { return &mPitchDetector; }
    
    virtual void LoadLayout(const ofxJSONElement& moduleInfo) override;
    virtual void SetUpFromSaveData() override;
@@ -109,6 +113,8 @@ private:
    FloatSlider* mMixSlider;
    
    ClickButton* mSetFromScaleButton;
+   DropdownList* mHopSelector;
+   int mHop;
 
 ////////////////////////////////////////
    //ported
@@ -144,38 +150,21 @@ private:
    float mInputBuffer1;
    float mOutputBuffer1;
    float mLatency;
-   ::FFT* mFFT;
+   PitchDetector mPitchDetector;
 
    unsigned long mfs; // Sample rate
 
    unsigned long mcbsize; // size of circular buffer
-   unsigned long mcorrsize; // cbsize/2 + 1
    unsigned long mcbiwr;
    unsigned long mcbord;
-   float* mcbi; // circular input buffer
    float* mcbf; // circular formant correction buffer
    float* mcbo; // circular output buffer
 
-   float* mcbwindow; // hann of length N/2, zeros for the rest
-   float* macwinv; // inverse of autocorrelation of window
    float* mhannwindow; // length-N hann
-   int mnoverlap;
-
-   float* mffttime;
-   float* mfftfreqre;
-   float* mfftfreqim;
 
    // VARIABLES FOR LOW-RATE SECTION
    float maref; // A tuning reference (Hz)
-   float minpitch; // Input pitch (semitones)
-   float mconf; // Confidence of pitch period estimate (between 0 and 1)
    float moutpitch; // Output pitch (semitones)
-   float mvthresh; // Voiced speech threshold
-
-   float mpmax; // Maximum allowable pitch period (seconds)
-   float mpmin; // Minimum allowable pitch period (seconds)
-   unsigned long mnmax; // Maximum period index for pitch prd est
-   unsigned long mnmin; // Minimum period index for pitch prd est
 
    float mlrshift; // Shift prescribed by low-rate section
    int mptarget; // Pitch target, between 0 and 11
@@ -52,18 +52,19 @@ BandVocoder::BandVocoder()
 , mMaxBandSlider(nullptr)
 , mSpacingStyle(0)
 , mCarrierDataSet(false)
+, mModulatorBank(VOCODER_MAX_BANDS)
+, mCarrierBank(VOCODER_MAX_BANDS)
 {
    mCarrierInputBuffer = new float[GetBuffer()->BufferSize()];
    Clear(mCarrierInputBuffer, GetBuffer()->BufferSize());
    
-   mWorkBuffer = new float[GetBuffer()->BufferSize()];
-   Clear(mWorkBuffer, GetBuffer()->BufferSize());
-   
    mOutBuffer = new float[GetBuffer()->BufferSize()];
    Clear(mOutBuffer, GetBuffer()->BufferSize());
    
    for (int i=0; i<VOCODER_MAX_BANDS; ++i)
    {
+      mBandBuffers[i] = new float[GetBuffer()->BufferSize()];
+      Clear(mBandBuffers[i], GetBuffer()->BufferSize());
       mPeaks[i].SetDecayTime(mRingTime);
       mOutputPeaks[i].SetDecayTime(mRingTime);
       mPeaks[i].SetLimit(mMaxBand);
@@ -71,6 +72,8 @@ BandVocoder::BandVocoder()
    }
    
    CalcFilters();
+   mModulatorBank.SnapCoefficients();
+   mCarrierBank.SnapCoefficients();
 }
 
 void BandVocoder::CreateUIControls()
@@ -97,7 +100,9 @@ void BandVocoder::CreateUIControls()
 BandVocoder::~BandVocoder()
 {
    delete[] mCarrierInputBuffer;
-   delete[] mWorkBuffer;
+   delete[] mOutBuffer;
+   for (int i=0; i<VOCODER_MAX_BANDS; ++i)
+      delete[] mBandBuffers[i];
 }
 
 void BandVocoder::SetCarrierBuffer(float *carrier, int bufferSize)
@@ -129,33 +134,26 @@ void BandVocoder::Process(double time)
    Mult(GetBuffer()->GetChannel(0), inputPreampSq * 5, bufferSize);
    Mult(mCarrierInputBuffer, carrierPreampSq * 5, bufferSize);
    
+   //get modulator bands
+   mModulatorBank.ProcessParallel(GetBuffer()->GetChannel(0), mBandBuffers, bufferSize);
+   
+   //calculate modulator band levels
+   float oldPeaks[VOCODER_MAX_BANDS];
    for (int i=0; i<mNumBands; ++i)
    {
-      //get modulator band
-      BufferCopy(mWorkBuffer,GetBuffer()->GetChannel(0), bufferSize);
-      mBiquadCarrier[i].Filter(mWorkBuffer, bufferSize);
-      
-      float oldPeak = mPeaks[i].GetPeak();
-      
-      //calculate modulator band level
-      mPeaks[i].Process(mWorkBuffer, bufferSize);
-      
-      //get carrier band
-      BufferCopy(mWorkBuffer,mCarrierInputBuffer, bufferSize);
-      mBiquadOut[i].Filter(mWorkBuffer, bufferSize);
-      
-      //multiply carrier band by modulator band level
-      //Mult(mWorkBuffer, mPeaks[i].GetPeak(), bufferSize);
+      oldPeaks[i] = mPeaks[i].GetPeak();
+      mPeaks[i].Process(mBandBuffers[i], bufferSize);
+   }
+   
+   //get carrier bands
+   mCarrierBank.ProcessParallel(mCarrierInputBuffer, mBandBuffers, bufferSize);
+   
+   for (int i=0; i<mNumBands; ++i)
+   {
+      //multiply carrier band by modulator band level, and accumulate output band into total output
+      float peak = mPeaks[i].GetPeak();
       for (int j=0; j<bufferSize; ++j)
-         mWorkBuffer[j] *= ofMap(j,0,bufferSize,oldPeak,mPeaks[i].GetPeak());
-      
-      //don't allow a band to go crazy
-      /*mOutputPeaks[i].Process(mWorkBuffer, bufferSize);
-      if (mOutputPeaks[i].GetPeak() > mMaxBand)
-         Mult(mWorkBuffer, 1/mOutputPeaks[i].GetPeak(), bufferSize);*/
-      
-      //accumulate output band into total output
-      Add(mOutBuffer, mWorkBuffer, bufferSize);
+         mOutBuffer[j] += mBandBuffers[i][j] * ofMap(j,0,bufferSize,oldPeaks[i],peak);
    }
 
    Mult(mOutBuffer, mDryWet * volSq, bufferSize);
@@ -241,21 +239,20 @@ void BandVocoder::CalcFilters()
          f = ofLerp(fExp, fBass, -mSpacingStyle);
       
       mBiquadCarrier[i].SetFilterType(kFilterType_Bandpass);
-      mBiquadOut[i].SetFilterType(kFilterType_Bandpass);
       mBiquadCarrier[i].SetFilterParams(f, mQ);
-      mBiquadOut[i].CopyCoeffFrom(mBiquadCarrier[i]);
+      mModulatorBank.SetCoefficients(i, mBiquadCarrier[i]);
+      mCarrierBank.SetCoefficients(i, mBiquadCarrier[i]);
    }
+   mModulatorBank.SetNumFilters(mNumBands);
+   mCarrierBank.SetNumFilters(mNumBands);
 }
 
 void BandVocoder::CheckboxUpdated(Checkbox* checkbox)
 {
    if (checkbox == mEnabledCheckbox)
    {
-      for (int i = 0; i < VOCODER_MAX_BANDS; ++i)
-      {
-         mBiquadCarrier[i].Clear();
-         mBiquadOut[i].Clear();
-      }
+      mModulatorBank.Clear();
+      mCarrierBank.Clear();
    }
 }
 
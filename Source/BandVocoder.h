@@ -33,6 +33,7 @@
 #include "RollingBuffer.h"
 #include "Slider.h"
 #include "BiquadFilterEffect.h"
+#include "BiquadBank.h"
 #include "VocoderCarrierInput.h"
 #include "PeakTracker.h"
 
@@ -76,8 +77,8 @@ private:
    
    float* mCarrierInputBuffer;
    
-   float* mWorkBuffer;
    float* mOutBuffer;
+   float* mBandBuffers[VOCODER_MAX_BANDS];
    
    float mInputPreamp;
    float mCarrierPreamp;
@@ -103,7 +104,8 @@ private:
    FloatSlider* mSpacingStyleSlider;
    
    BiquadFilter mBiquadCarrier[VOCODER_MAX_BANDS];
-   BiquadFilter mBiquadOut[VOCODER_MAX_BANDS];
+   BiquadBank mModulatorBank;
+   BiquadBank mCarrierBank;
    PeakTracker mPeaks[VOCODER_MAX_BANDS];
    PeakTracker mOutputPeaks[VOCODER_MAX_BANDS];
 
@@ -0,0 +1,369 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    BiquadBank.cpp
+    Created: 18 Oct 2026 7:12:40pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "BiquadBank.h"
+#include "BiquadFilter.h"
+#include "SynthGlobals.h"
+
+#include <functional>
+
+#include "juce_audio_basics/juce_audio_basics.h"
+
+namespace
+{
+   const int kTileSize = 64;
+}
+
+BiquadBank::BiquadBank(int maxFilters)
+: mGroups((maxFilters + kLanes - 1) / kLanes)
+, mNumFilters(maxFilters)
+{
+   for (int i=0; i<GetMaxFilters(); ++i)
+      SetPassthrough(i);
+   SnapCoefficients();
+   Clear();
+}
+
+void BiquadBank::SetNumFilters(int numFilters)
+{
+   numFilters = MAX(0, MIN(numFilters, GetMaxFilters()));
+   for (int i=mNumFilters; i<numFilters; ++i)
+      Clear(i);
+   mNumFilters = numFilters;
+}
+
+void BiquadBank::SetCoefficients(int index, const BiquadFilter& filter)
+{
+   double a0, a1, a2, b1, b2;
+   filter.GetCoefficients(a0, a1, a2, b1, b2);
+   SetTarget(index, a0, a1, a2, b1, b2);
+}
+
+void BiquadBank::SetPassthrough(int index)
+{
+   SetTarget(index, 1, 0, 0, 0, 0);
+}
+
+void BiquadBank::SetTarget(int index, float a0, float a1, float a2, float b1, float b2)
+{
+   assert(index >= 0 && index < GetMaxFilters());
+   LaneGroup& group = mGroups[index / kLanes];
+   Lanes& target = group.mTargetCoeffs;
+   int lane = index % kLanes;
+   if (target.mA0[lane] != a0 || target.mA1[lane] != a1 || target.mA2[lane] != a2 || target.mB1[lane] != b1 || target.mB2[lane] != b2)
+   {
+      target.mA0[lane] = a0;
+      target.mA1[lane] = a1;
+      target.mA2[lane] = a2;
+      target.mB1[lane] = b1;
+      target.mB2[lane] = b2;
+      group.mRamping = true;
+   }
+}
+
+void BiquadBank::SnapCoefficients()
+{
+   for (auto& group : mGroups)
+   {
+      group.mCoeffs = group.mTargetCoeffs;
+      group.mRamping = false;
+   }
+}
+
+void BiquadBank::Clear()
+{
+   for (auto& group : mGroups)
+   {
+      ::Clear(group.mZ1, kLanes);
+      ::Clear(group.mZ2, kLanes);
+   }
+}
+
+void BiquadBank::Clear(int index)
+{
+   assert(index >= 0 && index < GetMaxFilters());
+   mGroups[index / kLanes].mZ1[index % kLanes] = 0;
+   mGroups[index / kLanes].mZ2[index % kLanes] = 0;
+}
+
+void BiquadBank::ProcessParallel(const float* input, float* const* outputs, int bufferSize)
+{
+   const float* inputs[kLanes];
+   for (int lane=0; lane<kLanes; ++lane)
+      inputs[lane] = input;
+
+   for (int i=0; i*kLanes<mNumFilters; ++i)
+      ProcessGroupParallel(mGroups[i], inputs, outputs + i*kLanes, MIN(kLanes, mNumFilters - i*kLanes), bufferSize);
+}
+
+void BiquadBank::ProcessParallel(const float* const* inputs, float* const* outputs, int bufferSize)
+{
+   for (int i=0; i*kLanes<mNumFilters; ++i)
+      ProcessGroupParallel(mGroups[i], inputs + i*kLanes, outputs + i*kLanes, MIN(kLanes, mNumFilters - i*kLanes), bufferSize);
+}
+
+void BiquadBank::ProcessSeries(float* buffer, int bufferSize, float* const* taps)
+{
+   for (int i=0; i*kLanes<mNumFilters; ++i)
+      ProcessGroupSeries(mGroups[i], buffer, taps ? taps + i*kLanes : nullptr, MIN(kLanes, mNumFilters - i*kLanes), bufferSize);
+}
+
+//written as flat loops over kLanes with no branches, so the compiler turns each line into lane-wide vector operations
+inline void BiquadBank::Tick(const Lanes& coeffs, float* z1, float* z2, float* samples)
+{
+   for (int lane=0; lane<kLanes; ++lane)
+   {
+      float in = samples[lane];
+      float out = in * coeffs.mA0[lane] + z1[lane];
+      z1[lane] = in * coeffs.mA1[lane] + z2[lane] - coeffs.mB1[lane] * out;
+      z2[lane] = in * coeffs.mA2[lane] - coeffs.mB2[lane] * out;
+      samples[lane] = out;
+   }
+}
+
+inline void BiquadBank::BeginRamp(const LaneGroup& group, Lanes& coeffs, Lanes& deltas, int numSteps)
+{
+   coeffs = group.mCoeffs;
+   const Lanes& target = group.mTargetCoeffs;
+   for (int lane=0; lane<kLanes; ++lane)
+   {
+      deltas.mA0[lane] = (target.mA0[lane] - coeffs.mA0[lane]) / numSteps;
+      deltas.mA1[lane] = (target.mA1[lane] - coeffs.mA1[lane]) / numSteps;
+      deltas.mA2[lane] = (target.mA2[lane] - coeffs.mA2[lane]) / numSteps;
+      deltas.mB1[lane] = (target.mB1[lane] - coeffs.mB1[lane]) / numSteps;
+      deltas.mB2[lane] = (target.mB2[lane] - coeffs.mB2[lane]) / numSteps;
+   }
+}
+
+inline void BiquadBank::Ramp(Lanes& coeffs, const Lanes& deltas)
+{
+   for (int lane=0; lane<kLanes; ++lane)
+   {
+      coeffs.mA0[lane] += deltas.mA0[lane];
+      coeffs.mA1[lane] += deltas.mA1[lane];
+      coeffs.mA2[lane] += deltas.mA2[lane];
+      coeffs.mB1[lane] += deltas.mB1[lane];
+      coeffs.mB2[lane] += deltas.mB2[lane];
+   }
+}
+
+void BiquadBank::ProcessGroupParallel(LaneGroup& group, const float* const* inputs, float* const* outputs, int numLanes, int bufferSize)
+{
+   Lanes coeffs;
+   Lanes deltas;
+   float z1[kLanes];
+   float z2[kLanes];
+   float tile[kTileSize][kLanes];
+
+   bool ramping = group.mRamping;
+   if (ramping)
+      BeginRamp(group, coeffs, deltas, bufferSize);
+   else
+      coeffs = group.mCoeffs;
+   memcpy(z1, group.mZ1, sizeof(z1));
+   memcpy(z2, group.mZ2, sizeof(z2));
+
+   for (int start=0; start<bufferSize; start += kTileSize)
+   {
+      int tileSize = MIN(kTileSize, bufferSize - start);
+
+      //interleave the inputs so each sample step is one lane-wide operation
+      for (int i=0; i<tileSize; ++i)
+      {
+         for (int lane=0; lane<numLanes; ++lane)
+            tile[i][lane] = inputs[lane][start + i];
+         for (int lane=numLanes; lane<kLanes; ++lane)
+            tile[i][lane] = 0;
+      }
+
+      if (ramping)
+      {
+         for (int i=0; i<tileSize; ++i)
+         {
+            Tick(coeffs, z1, z2, tile[i]);
+            Ramp(coeffs, deltas);
+         }
+      }
+      else
+      {
+         for (int i=0; i<tileSize; ++i)
+            Tick(coeffs, z1, z2, tile[i]);
+      }
+
+      for (int lane=0; lane<numLanes; ++lane)
+      {
+         for (int i=0; i<tileSize; ++i)
+            outputs[lane][start + i] = tile[i][lane];
+      }
+   }
+
+   if (ramping)
+   {
+      group.mCoeffs = group.mTargetCoeffs;
+      group.mRamping = false;
+   }
+   memcpy(group.mZ1, z1, sizeof(z1));
+   memcpy(group.mZ2, z2, sizeof(z2));
+}
+
+void BiquadBank::ProcessGroupSeries(LaneGroup& group, float* buffer, float* const* taps, int numLanes, int bufferSize)
+{
+   //skewed so that lane k works on sample (step - k), taking lane k-1's output from the previous step.
+   //that keeps every lane busy without adding latency, at the cost of numLanes-1 partially filled steps at each end
+   int numSteps = bufferSize + numLanes - 1;
+
+   Lanes coeffs;
+   Lanes deltas;
+   float z1[kLanes];
+   float z2[kLanes];
+   float samples[kLanes] = {};
+
+   bool ramping = group.mRamping;
+   if (ramping)
+      BeginRamp(group, coeffs, deltas, numSteps);
+   else
+      coeffs = group.mCoeffs;
+   memcpy(z1, group.mZ1, sizeof(z1));
+   memcpy(z2, group.mZ2, sizeof(z2));
+
+   for (int step=0; step<numSteps; ++step)
+   {
+      for (int lane=kLanes-1; lane>0; --lane)
+         samples[lane] = samples[lane - 1];
+      samples[0] = step < bufferSize ? buffer[step] : 0;
+
+      if (step >= numLanes - 1 && step < bufferSize)
+      {
+         Tick(coeffs, z1, z2, samples);
+      }
+      else
+      {
+         //lanes that are outside of the buffer at this step must leave their state alone.
+         //lanes past numLanes aren't in use, so they're free to run
+         float oldZ1[kLanes];
+         float oldZ2[kLanes];
+         memcpy(oldZ1, z1, sizeof(z1));
+         memcpy(oldZ2, z2, sizeof(z2));
+         Tick(coeffs, z1, z2, samples);
+         for (int lane=0; lane<numLanes; ++lane)
+         {
+            if (step - lane < 0 || step - lane >= bufferSize)
+            {
+               z1[lane] = oldZ1[lane];
+               z2[lane] = oldZ2[lane];
+            }
+         }
+      }
+
+      if (ramping)
+         Ramp(coeffs, deltas);
+
+      if (taps)
+      {
+         for (int lane=0; lane<numLanes; ++lane)
+         {
+            int sample = step - lane;
+            if (taps[lane] && sample >= 0 && sample < bufferSize)
+               taps[lane][sample] = samples[lane];
+         }
+      }
+
+      if (step >= numLanes - 1)
+         buffer[step - (numLanes - 1)] = samples[numLanes - 1];
+   }
+
+   if (ramping)
+   {
+      group.mCoeffs = group.mTargetCoeffs;
+      group.mRamping = false;
+   }
+   memcpy(group.mZ1, z1, sizeof(z1));
+   memcpy(group.mZ2, z2, sizeof(z2));
+}
+
+void BiquadBank::RunBenchmark(int numFilters, int bufferSize)
+{
+   juce::ScopedNoDenormals noDenormals;
+
+   const int kIterations = 2000;
+
+   std::vector<float> input(bufferSize);
+   for (auto& sample : input)
+      sample = ofRandom(-1, 1);
+   std::vector<std::vector<float>> outputs(numFilters, std::vector<float>(bufferSize));
+   std::vector<float*> outputPointers;
+   for (auto& output : outputs)
+      outputPointers.push_back(output.data());
+
+   std::vector<BiquadFilter> filters(numFilters);
+   BiquadBank bank(numFilters);
+   for (int i=0; i<numFilters; ++i)
+   {
+      filters[i].SetFilterType(kFilterType_Peak);
+      filters[i].mDbGain = 1;
+      filters[i].SetFilterParams(100 * powf(2, i * 7.0f / numFilters), 4);
+      bank.SetCoefficients(i, filters[i]);
+   }
+   bank.SnapCoefficients();
+
+   auto NanosecondsPerBand = [numFilters](std::function<void()> process)
+   {
+      juce::int64 start = juce::Time::getHighResolutionTicks();
+      for (int i=0; i<kIterations; ++i)
+         process();
+      double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+      return seconds * 1e9 / kIterations / numFilters;
+   };
+
+   double biquadParallel = NanosecondsPerBand([&]()
+   {
+      for (int i=0; i<numFilters; ++i)
+      {
+         BufferCopy(outputPointers[i], input.data(), bufferSize);
+         filters[i].Filter(outputPointers[i], bufferSize);
+      }
+   });
+   double bankParallel = NanosecondsPerBand([&]()
+   {
+      bank.ProcessParallel(input.data(), outputPointers.data(), bufferSize);
+   });
+   double biquadSeries = NanosecondsPerBand([&]()
+   {
+      BufferCopy(outputPointers[0], input.data(), bufferSize);
+      for (int i=0; i<numFilters; ++i)
+         filters[i].Filter(outputPointers[0], bufferSize);
+   });
+   double bankSeries = NanosecondsPerBand([&]()
+   {
+      BufferCopy(outputPointers[0], input.data(), bufferSize);
+      bank.ProcessSeries(outputPointers[0], bufferSize);
+   });
+
+   ofLog() << "biquad benchmark: " << numFilters << " bands, buffer size " << bufferSize << ", ns per band per buffer";
+   ofLog() << "   parallel: BiquadFilter " << ofToString(biquadParallel, 1) << ", BiquadBank " << ofToString(bankParallel, 1) << " (" << ofToString(biquadParallel / bankParallel, 2) << "x)";
+   ofLog() << "   series:   BiquadFilter " << ofToString(biquadSeries, 1) << ", BiquadBank " << ofToString(bankSeries, 1) << " (" << ofToString(biquadSeries / bankSeries, 2) << "x)";
+}
@@ -0,0 +1,91 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    BiquadBank.h
+    Created: 18 Oct 2026 7:12:40pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+
+class BiquadFilter;
+
+//runs a set of biquads side by side, structure-of-arrays in groups of kLanes so the per-sample math vectorizes across filters
+class BiquadBank
+{
+public:
+   static const int kLanes = 8;
+
+   BiquadBank(int maxFilters = kLanes);
+
+   void SetNumFilters(int numFilters);
+   int GetNumFilters() const { return mNumFilters; }
+   int GetMaxFilters() const { return (int)mGroups.size() * kLanes; }
+
+   //coefficients ramp linearly to the new values over the next processed buffer
+   void SetCoefficients(int index, const BiquadFilter& filter);
+   void SetPassthrough(int index);
+   void SnapCoefficients();
+   void Clear();
+   void Clear(int index);
+
+   //every filter processes the same input
+   void ProcessParallel(const float* input, float* const* outputs, int bufferSize);
+   //each filter processes its own input, outputs may be the same buffers as inputs
+   void ProcessParallel(const float* const* inputs, float* const* outputs, int bufferSize);
+   //filters are chained in index order, in place. taps, if provided, receive the output of each filter
+   void ProcessSeries(float* buffer, int bufferSize, float* const* taps = nullptr);
+
+   static void RunBenchmark(int numFilters, int bufferSize);
+
+private:
+   struct Lanes
+   {
+      float mA0[kLanes];
+      float mA1[kLanes];
+      float mA2[kLanes];
+      float mB1[kLanes];
+      float mB2[kLanes];
+   };
+
+   struct LaneGroup
+   {
+      Lanes mCoeffs;
+      Lanes mTargetCoeffs;
+      float mZ1[kLanes];
+      float mZ2[kLanes];
+      bool mRamping;
+   };
+
+   static void Tick(const Lanes& coeffs, float* z1, float* z2, float* samples);
+   static void BeginRamp(const LaneGroup& group, Lanes& coeffs, Lanes& deltas, int numSteps);
+   static void Ramp(Lanes& coeffs, const Lanes& deltas);
+
+   void SetTarget(int index, float a0, float a1, float a2, float b1, float b2);
+   void ProcessGroupParallel(LaneGroup& group, const float* const* inputs, float* const* outputs, int numLanes, int bufferSize);
+   void ProcessGroupSeries(LaneGroup& group, float* buffer, float* const* taps, int numLanes, int bufferSize);
+
+   std::vector<LaneGroup> mGroups;
+   int mNumFilters;
+};
@@ -66,6 +66,7 @@ private:
    //IDrawableModule
    void GetModuleDimensions(float& width, float& height) override { width = mWidth; height = mHeight; }
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return mEnabled; }
    
    void ResetFilter();
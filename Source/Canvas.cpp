@@ -29,6 +29,14 @@
 #include "FileStream.h"
 #include "ModularSynth.h"
 
+#include <algorithm>
+
+namespace
+{
+   const float kIndexEpsilon = .0001f;
+   const int kMaxUnindexedElements = 32;   //past this many new elements, rebuild rather than checking them all individually
+}
+
 Canvas::Canvas(IDrawableModule* parent, int x, int y, int w, int h, float length, int rows, int cols, CreateCanvasElementFn elementCreator)
 : mClick(false)
 , mWidth(w)
@@ -58,6 +66,11 @@ Canvas::Canvas(IDrawableModule* parent, int x, int y, int w, int h, float length
 , mHasDuplicatedThisDrag(false)
 , mScrollVerticalPartial(0)
 , mDragMode(kDragBoth)
+, mNumIndexedElements(0)
+, mElementIndexDirty(true)
+, mMaxElementLength(0)
+, mIndexedViewStart(0)
+, mIndexedViewEnd(0)
 {
    SetName("canvas");
    SetPosition(x,y);
@@ -110,11 +123,22 @@ void Canvas::Render()
       }
    }
 
-   for (int i=0; i<mElements.size(); ++i)
+   const float viewStart = mViewStart / GetLength();
+   const float viewEnd = mViewEnd / GetLength();
+   if (GetCandidateElements(viewStart, viewEnd, 0, mUICandidates))
+   {
+      //everything outside of the window is offscreen horizontally, and elements offscreen to the same side of the same row all draw the same marker
+      int begin, end;
+      GetIndexRange(viewStart - mMaxElementLength - kIndexEpsilon, viewEnd + kIndexEpsilon, begin, end);
+      DrawOffscreenMarkers(0, begin);
+      DrawOffscreenMarkers(end, mNumIndexedElements);
+   }
+
+   for (int i : mUICandidates)
    {
       //ofMap(GetStart() + offset,mCanvas->mStart/mCanvas->GetLength(),mCanvas->mEnd/mCanvas->GetLength(),0,1,clamp)
       bool visibleOnCanvas = mElements[i]->mRow >= mRowOffset && mElements[i]->mRow < mRowOffset + GetNumVisibleRows() &&
-                             mElements[i]->GetStart() <= mViewEnd / GetLength() && mElements[i]->GetEnd() >= mViewStart / GetLength();
+                             mElements[i]->GetStart() <= viewEnd && mElements[i]->GetEnd() >= viewStart;
       if (visibleOnCanvas)
       {
          ofVec2f offset(0, 0);
@@ -148,6 +172,141 @@ void Canvas::Render()
    ofPopMatrix();
 }
 
+void Canvas::Poll()
+{
+   //EventCanvasElement lengths depend on the zoom, so a view change has to rebuild too
+   bool viewChanged = mViewStart != mIndexedViewStart || mViewEnd != mIndexedViewEnd;
+   if (mElementIndexDirty || viewChanged || (int)mElements.size() - mNumIndexedElements > kMaxUnindexedElements)
+      RebuildElementIndex();
+}
+
+//the audio thread only has to wait while the element positions are copied out and the finished index is swapped in, not for the sort
+void Canvas::RebuildElementIndex()
+{
+   std::vector<IndexEntry>& newIndex = mPendingElementIndex;
+   newIndex.reserve(mElements.size() + kMaxUnindexedElements);
+   float viewStart, viewEnd;
+   {
+      ScopedMutex mutex(TheSynth->GetAudioMutex(), "Canvas::RebuildElementIndex()");
+      mElementIndexDirty = false;   //anything that changes while we sort marks it dirty again
+      viewStart = mViewStart;
+      viewEnd = mViewEnd;
+      newIndex.resize(mElements.size());
+      for (int i = 0; i < (int)mElements.size(); ++i)
+      {
+         newIndex[i].mStart = mElements[i]->GetStart();
+         newIndex[i].mElementIndex = i;
+      }
+   }
+
+   std::sort(newIndex.begin(), newIndex.end(), [](const IndexEntry& a, const IndexEntry& b) { return a.mStart < b.mStart; });
+
+   ScopedMutex mutex(TheSynth->GetAudioMutex(), "Canvas::RebuildElementIndex()");
+   mElementIndex.swap(newIndex);
+   mNumIndexedElements = (int)mElementIndex.size();
+   mIndexedViewStart = viewStart;
+   mIndexedViewEnd = viewEnd;
+
+   //lengths can have changed since the copy, so take the longest from the elements as they are now
+   float maxLength = 0;
+   for (auto* element : mElements)
+      maxLength = MAX(maxLength, element->GetEnd() - element->GetStart());
+   mMaxElementLength = maxLength;
+
+   //so that the audio thread doesn't allocate when it looks things up
+   mAudioThreadCandidates.reserve(mElements.size() + kMaxUnindexedElements);
+}
+
+void Canvas::ElementLengthChanged(CanvasElement* element)
+{
+   float length = element->GetEnd() - element->GetStart();
+   float maxLength = mMaxElementLength;
+   while (length > maxLength && !mMaxElementLength.compare_exchange_weak(maxLength, length))
+   {
+   }
+}
+
+void Canvas::GetIndexRange(float minStart, float maxStart, int& begin, int& end) const
+{
+   auto indexBegin = mElementIndex.begin();
+   auto indexEnd = mElementIndex.begin() + mNumIndexedElements;
+   auto lower = std::lower_bound(indexBegin, indexEnd, minStart, [](const IndexEntry& entry, float start) { return entry.mStart < start; });
+   auto upper = std::upper_bound(lower, indexEnd, maxStart, [](float start, const IndexEntry& entry) { return start < entry.mStart; });
+   begin = int(lower - indexBegin);
+   end = int(upper - indexBegin);
+}
+
+//fills in the indices (in mElements order) of every element that might overlap [start, end], and returns false if the index couldn't be used
+bool Canvas::GetCandidateElements(float start, float end, float wrapShift, std::vector<int>& candidates) const
+{
+   candidates.clear();
+   int numElements = (int)mElements.size();
+   if (mElementIndexDirty || mNumIndexedElements > numElements)
+   {
+      for (int i = 0; i < numElements; ++i)
+         candidates.push_back(i);
+      return false;
+   }
+
+   float maxLength = mMaxElementLength;
+   int rangeBegin, rangeEnd;
+   GetIndexRange(start - maxLength - kIndexEpsilon, end + kIndexEpsilon, rangeBegin, rangeEnd);
+   for (int i = rangeBegin; i < rangeEnd; ++i)
+      candidates.push_back(mElementIndex[i].mElementIndex);
+   if (wrapShift != 0)
+   {
+      GetIndexRange(start + wrapShift - maxLength - kIndexEpsilon, end + wrapShift + kIndexEpsilon, rangeBegin, rangeEnd);
+      for (int i = rangeBegin; i < rangeEnd; ++i)
+         candidates.push_back(mElementIndex[i].mElementIndex);
+   }
+   std::sort(candidates.begin(), candidates.end());
+   candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+   for (int i = mNumIndexedElements; i < numElements; ++i)
+      candidates.push_back(i);
+   return true;
+}
+
+void Canvas::GetCandidateElementsAtX(float x1, float x2, std::vector<int>& candidates) const
+{
+   if (x1 > x2)
+      std::swap(x1, x2);
+   if (x1 <= 0 || x2 >= mWidth)
+   {
+      //elements off the edge clamp to it, so anything could be there
+      candidates.clear();
+      for (int i = 0; i < (int)mElements.size(); ++i)
+         candidates.push_back(i);
+      return;
+   }
+
+   const float viewStart = mViewStart / GetLength();
+   const float viewEnd = mViewEnd / GetLength();
+   const float pixel = (viewEnd - viewStart) / mWidth;
+   GetCandidateElements(viewStart + x1 * pixel - pixel, viewStart + x2 * pixel + pixel, mWrap ? 1 : 0, candidates);
+}
+
+void Canvas::DrawOffscreenMarkers(int indexBegin, int indexEnd)
+{
+   std::vector<bool> drawnRows(GetNumVisibleRows() + 2, false);
+   for (int i = indexBegin; i < indexEnd; ++i)
+   {
+      CanvasElement* element = mElements[mElementIndex[i].mElementIndex];
+      if (mWrap && element->GetEnd() > 1)
+      {
+         element->DrawOffscreen();
+         continue;
+      }
+      //rows above or below the visible ones all get squashed onto the edge
+      int row = ofClamp(element->mRow - mRowOffset, -1, GetNumVisibleRows()) + 1;
+      if (!drawnRows[row])
+      {
+         element->DrawOffscreen();
+         drawnRows[row] = true;
+      }
+   }
+}
+
 void Canvas::AddElement(CanvasElement* element)
 {
    mElements.push_back(element);
@@ -158,6 +317,7 @@ void Canvas::RemoveElement(CanvasElement* element)
    if (mListener)
       mListener->ElementRemoved(element);
    RemoveFromVector(element, mElements, !K(fail));
+   mElementIndexDirty = true;
    //delete element; TODO(Ryan) figure out how to delete without messing up stuff accessing data from other thread
 }
 
@@ -243,8 +403,10 @@ void Canvas::OnClicked(int x, int y, bool right)
    else
    {
       bool clickedElement = false;
-      for (int i=(int)mElements.size()-1; i>=0; --i)
+      GetCandidateElementsAtX(x, x, mUICandidates);
+      for (int c=(int)mUICandidates.size()-1; c>=0; --c)
       {
+         int i = mUICandidates[c];
          if (IsOnElement(mElements[i], x, y))
          {
             SelectElement(mElements[i]);
@@ -471,8 +633,10 @@ void Canvas::MouseReleased()
    if (mDragSelecting)
    {
       std::vector<CanvasElement*> selectedElements;
-      for (int i=(int)mElements.size()-1; i>=0; --i)
+      GetCandidateElementsAtX(mDragSelectRect.x, mDragSelectRect.x + mDragSelectRect.width, mUICandidates);
+      for (int c=(int)mUICandidates.size()-1; c>=0; --c)
       {
+         int i = mUICandidates[c];
          if (mElements[i]->GetRect(true, false).intersects(mDragSelectRect) ||
              (mWrap && mElements[i]->GetRect(true, true).intersects(mDragSelectRect)))
          {
@@ -573,6 +737,7 @@ void Canvas::KeyPressed(int key, bool isRepeat)
             if (element->GetHighlighted())
                element->mCol += direction;
          }
+         mElementIndexDirty = true;
       }
       if (key == OF_KEY_UP || key == OF_KEY_DOWN)
       {
@@ -595,6 +760,7 @@ void Canvas::RescaleNumCols(int cols)
       element->mLength *= ratio;
    }
    mNumCols = cols;
+   mElementIndexDirty = true;
 }
 
 void Canvas::SetRowColor(int row, ofColor color)
@@ -633,7 +799,8 @@ CanvasElement* Canvas::GetElementAt(float pos, int row)
 
 void Canvas::FillElementsAt(float pos, std::vector<CanvasElement*>& elementsAt) const
 {
-   for (int i=0; i<mElements.size(); ++i)
+   GetCandidateElements(pos, pos, mWrap ? mLength : 0, mAudioThreadCandidates);
+   for (int i : mAudioThreadCandidates)
    {
       if (mElements[i]->mRow == -1 || mElements[i]->mCol == -1 || mElements[i]->mRow >= elementsAt.size())
          continue;
@@ -651,7 +818,8 @@ void Canvas::FillElementsAt(float pos, std::vector<CanvasElement*>& elementsAt)
 void Canvas::EraseElementsAt(float pos)
 {
    std::vector<CanvasElement*> toErase;
-   for (int i = 0; i < mElements.size(); ++i)
+   GetCandidateElements(pos, pos, mWrap ? mLength : 0, mAudioThreadCandidates);
+   for (int i : mAudioThreadCandidates)
    {
       if (mElements[i]->mRow == -1 || mElements[i]->mCol == -1)
          continue;
@@ -683,6 +851,7 @@ CanvasCoord Canvas::GetCoordAt(int x, int y)
 void Canvas::Clear()
 {
    mElements.clear();
+   mElementIndexDirty = true;
 }
 
 namespace
@@ -718,6 +887,7 @@ void Canvas::LoadState(FileStreamIn& in, bool shouldSetValue)
    in >> mNumVisibleRows;
    in >> mRowOffset;
    mElements.clear();
+   mElementIndexDirty = true;
    int size;
    in >> size;
    for (int i=0; i<size; ++i)
@@ -27,6 +27,8 @@
 #define __Bespoke__Canvas__
 
 #include <iostream>
+#include <atomic>
+#include <vector>
 #include "IUIControl.h"
 #include "CanvasElement.h"
 
@@ -78,6 +80,8 @@ public:
    ~Canvas();
    
    void Render() override;
+   void Poll() override;
+   bool CheckNeedsDraw() override { return true; }
    void MouseReleased() override;
    bool MouseMoved(float x, float y) override;
    bool MouseScrolled(int x, int y, float scrollX, float scrollY) override;
@@ -89,7 +93,7 @@ public:
    void SetLength(float length) { mLength = length; }
    float GetLength() const { return mLength; }
    void SetNumRows(int rows) { mNumRows = rows; }
-   void SetNumCols(int cols) { mNumCols = cols; }
+   void SetNumCols(int cols) { mNumCols = cols; mElementIndexDirty = true; }
    int GetNumRows() const { return mNumRows; }
    int GetNumCols() const { return mNumCols; }
    void RescaleNumCols(int cols);
@@ -120,6 +124,8 @@ public:
    void SetRowColor(int row, ofColor color);
    juce::MouseCursor GetMouseCursorType();
    ofVec2f RescaleForZoom(float x, float y) const;
+   void InvalidateElementIndex() { mElementIndexDirty = true; } //call after moving elements, lookups scan everything until the next rebuild
+   void ElementLengthChanged(CanvasElement* element);
    
    //IUIControl
    void SetFromMidiCC(float slider, bool setViaModulator = false) override {}
@@ -141,6 +147,11 @@ private:
    
    bool IsOnElement(CanvasElement* element, float x, float y) const;
    float QuantizeToGrid(float input) const;
+   void RebuildElementIndex();
+   void GetIndexRange(float minStart, float maxStart, int& begin, int& end) const;
+   bool GetCandidateElements(float start, float end, float wrapShift, std::vector<int>& candidates) const;
+   void GetCandidateElementsAtX(float x1, float x2, std::vector<int>& candidates) const;
+   void DrawOffscreenMarkers(int indexBegin, int indexEnd);
    
    bool mClick;
    CanvasElement* mClickedElement;
@@ -175,6 +186,23 @@ private:
    int mNumVisibleRows;
    DragMode mDragMode;
    
+   //elements sorted by start, so that lookups only have to look at the elements near a position.
+   //elements added since the last rebuild are past mNumIndexedElements and get checked individually
+   struct IndexEntry
+   {
+      float mStart;
+      int mElementIndex;
+   };
+   std::vector<IndexEntry> mElementIndex;
+   std::vector<IndexEntry> mPendingElementIndex;   //built on the main thread, then swapped with mElementIndex
+   int mNumIndexedElements;
+   std::atomic<bool> mElementIndexDirty;
+   std::atomic<float> mMaxElementLength;
+   float mIndexedViewStart;
+   float mIndexedViewEnd;
+   mutable std::vector<int> mAudioThreadCandidates;
+   std::vector<int> mUICandidates;
+   
    friend CanvasControls;
 };
 
@@ -145,6 +145,7 @@ void CanvasControls::FloatSliderUpdated(FloatSlider* slider, float oldVal)
       if (element->GetHighlighted())
          element->FloatSliderUpdated(slider->Name(), oldVal, slider->GetValue());
    }
+   mCanvas->InvalidateElementIndex();   //the element sliders point right at the position and length
 }
 
 void CanvasControls::IntSliderUpdated(IntSlider* slider, int oldVal)
@@ -154,6 +155,7 @@ void CanvasControls::IntSliderUpdated(IntSlider* slider, int oldVal)
       if (element->GetHighlighted())
          element->IntSliderUpdated(slider->Name(), oldVal, slider->GetValue());
    }
+   mCanvas->InvalidateElementIndex();
 }
 
 void CanvasControls::TextEntryComplete(TextEntry* entry)
@@ -198,6 +200,7 @@ void CanvasControls::ButtonClicked(ClickButton* button)
       if (element->GetHighlighted())
          element->ButtonClicked(button->Name());
    }
+   mCanvas->InvalidateElementIndex();
 }
 
 void CanvasControls::LoadLayout(const ofxJSONElement& moduleInfo)
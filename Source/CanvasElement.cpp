@@ -184,6 +184,7 @@ void CanvasElement::SetStart(float start, bool preserveLength)
    start *= mCanvas->GetNumCols();
    mCol = int(start + .5f);
    mOffset = start - mCol;
+   mCanvas->InvalidateElementIndex();
    if (!preserveLength)
       SetEnd(end);
 }
@@ -196,6 +197,7 @@ float CanvasElement::GetEnd() const
 void CanvasElement::SetEnd(float end)
 {
    mLength = end * mCanvas->GetNumCols() - mCol - mOffset;
+   mCanvas->ElementLengthChanged(this);
 }
 
 ofRectangle CanvasElement::GetRect(bool clamp, bool wrapped, ofVec2f offset) const
@@ -257,6 +259,7 @@ void CanvasElement::MoveElementByDrag(ofVec2f dragOffset)
    mRow = newRow;
    mCol = newCol;
    mOffset = newOffset;
+   mCanvas->InvalidateElementIndex();
 }
 
 void CanvasElement::AddElementUIControl(IUIControl* control)
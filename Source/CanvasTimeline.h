@@ -48,6 +48,7 @@ public:
    bool IsButtonControl() override { return false; }
 
    void Render() override;
+   bool CheckNeedsDraw() override { return true; }
    void MouseReleased() override;
    bool MouseMoved(float x, float y) override;
    bool MouseScrolled(int x, int y, float scrollX, float scrollY) override;
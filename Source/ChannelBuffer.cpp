@@ -26,13 +26,15 @@
 */
 
 #include "ChannelBuffer.h"
+#include "PagedMemory.h"
 
-ChannelBuffer::ChannelBuffer(int bufferSize)
+ChannelBuffer::ChannelBuffer(int bufferSize, bool pagedMemory /*= false*/)
 {
    mActiveChannels = 1;
    mNumChannels = kMaxNumChannels;
    mRecentActiveChannels = 1;
    mOwnsBuffers = true;
+   mPagedMemory = pagedMemory;
    
    Setup(bufferSize);
 }
@@ -44,6 +46,8 @@ ChannelBuffer::ChannelBuffer(float* data, int bufferSize)
    mActiveChannels = 1;
    mNumChannels = 1;
    mOwnsBuffers = false;
+   mPagedMemory = false;
+   mPagedChannels = nullptr;
    
    mBuffers = new float*[1];
    mBuffers[0] = data;
@@ -55,35 +59,111 @@ ChannelBuffer::~ChannelBuffer()
    if (mOwnsBuffers)
    {
       for (int i=0; i<mNumChannels; ++i)
-         delete[] mBuffers[i];
+         FreeChannel(i);
    }
    delete[] mBuffers;
+   delete[] mPagedChannels;
 }
 
 void ChannelBuffer::Setup(int bufferSize)
 {
    mBuffers = new float*[mNumChannels];
+   mPagedChannels = new PagedChannel*[mNumChannels];
    mBufferSize = bufferSize;
    
    for (int i=0; i<mNumChannels; ++i)
+   {
       mBuffers[i] = nullptr;
+      mPagedChannels[i] = nullptr;
+   }
+   
+   if (mPagedMemory)
+   {
+      //reserve every channel now, it costs nothing until it's written to and keeps GetChannel() from allocating on the audio thread
+      for (int i=0; i<mNumChannels; ++i)
+      {
+         AllocateChannel(i);
+         if (mBuffers[i] == nullptr)
+         {
+            for (int j=0; j<=i; ++j)
+               FreeChannel(j);
+            mPagedMemory = false;
+            break;
+         }
+      }
+   }
    
-   Clear();
+   if (!mPagedMemory)   //paged memory starts out zeroed
+      Clear();
+}
+
+void ChannelBuffer::AllocateChannel(int channel)
+{
+   assert(mOwnsBuffers);
+   if (mPagedMemory)
+   {
+      PagedChannel* paged = new PagedChannel(BufferSize());
+      if (paged->IsValid())
+      {
+         mPagedChannels[channel] = paged;
+         mBuffers[channel] = paged->Get();
+      }
+      else
+      {
+         delete paged;
+      }
+      return;
+   }
+   mBuffers[channel] = new float[BufferSize()];
+   ::Clear(mBuffers[channel], BufferSize());
+}
+
+void ChannelBuffer::FreeChannel(int channel)
+{
+   if (mPagedMemory)
+   {
+      delete mPagedChannels[channel];
+      mPagedChannels[channel] = nullptr;
+   }
+   else
+   {
+      delete[] mBuffers[channel];
+   }
+   mBuffers[channel] = nullptr;
+}
+
+void ChannelBuffer::ClearChannel(int channel) const
+{
+   if (mPagedChannels != nullptr && mPagedChannels[channel] != nullptr)
+   {
+      mPagedChannels[channel]->Clear();
+      mBuffers[channel] = mPagedChannels[channel]->Get();
+   }
+   else
+   {
+      ::Clear(mBuffers[channel], BufferSize());
+   }
+}
+
+void ChannelBuffer::SetCommittedLength(int length)
+{
+   if (!mPagedMemory)
+      return;
+   for (int i=0; i<mNumChannels; ++i)
+   {
+      if (mPagedChannels[i] != nullptr)
+         mPagedChannels[i]->RequestCommitted(length);
+   }
 }
 
 float* ChannelBuffer::GetChannel(int channel)
 {
    if (channel >= mActiveChannels)
       ofLog() << "error: requesting a higher channel index than we have active";
-   float* ret = mBuffers[MIN(channel, mActiveChannels-1)];
-   if (ret == nullptr)
-   {
-      assert(mOwnsBuffers);
-      ret = new float[BufferSize()];
-      ::Clear(ret, BufferSize());
-      mBuffers[MIN(channel, mActiveChannels-1)] = ret;
-   }
-   return ret;
+   int index = MIN(channel, mActiveChannels-1);
+   if (mBuffers[index] == nullptr)
+      AllocateChannel(index);
+   return mBuffers[index];
 }
 
 void ChannelBuffer::Clear() const
@@ -91,26 +171,35 @@ void ChannelBuffer::Clear() const
    for (int i=0; i<mNumChannels; ++i)
    {
       if (mBuffers[i] != nullptr)
-         ::Clear(mBuffers[i], BufferSize());
+         ClearChannel(i);
    }
 }
 
 void ChannelBuffer::SetMaxAllowedChannels(int channels)
 {
    float** newBuffers = new float*[channels];
+   PagedChannel** newPagedChannels = new PagedChannel*[channels];
    for (int i=0; i<channels; ++i)
    {
       if (i < mNumChannels)
+      {
          newBuffers[i] = mBuffers[i];
+         newPagedChannels[i] = mPagedChannels != nullptr ? mPagedChannels[i] : nullptr;
+      }
       else
+      {
          newBuffers[i] = nullptr;
+         newPagedChannels[i] = nullptr;
+      }
    }
    
    for (int i=channels; i<mNumChannels; ++i)
-      delete[] mBuffers[i];
+      FreeChannel(i);
    delete[] mBuffers;
+   delete[] mPagedChannels;
    
    mBuffers = newBuffers;
+   mPagedChannels = newPagedChannels;
    mNumChannels = channels;
    if (mActiveChannels > channels)
       mActiveChannels = channels;
@@ -128,23 +217,23 @@ void ChannelBuffer::CopyFrom(ChannelBuffer* src, int length /*= -1*/, int startO
       if (src->mBuffers[i])
       {
          if (mBuffers[i] == nullptr)
-         {
-            assert(mOwnsBuffers);
-            mBuffers[i] = new float[mBufferSize];
-            ::Clear(mBuffers[i], mBufferSize);
-         }
+            AllocateChannel(i);
          BufferCopy(mBuffers[i], src->mBuffers[i] + startOffset, length);
       }
+      else if (mPagedMemory)
+      {
+         ClearChannel(i);
+      }
       else
       {
-         delete mBuffers[i];
-         mBuffers[i] = nullptr;
+         FreeChannel(i);
       }
    }
 }
 
 void ChannelBuffer::SetChannelPointer(float* data, int channel, bool deleteOldData)
 {
+   assert(!mPagedMemory);
    if (deleteOldData)
       delete[] mBuffers[channel];
    mBuffers[channel] = data;
@@ -154,8 +243,9 @@ void ChannelBuffer::Resize(int bufferSize)
 {
    assert(mOwnsBuffers);
    for (int i=0; i<mNumChannels; ++i)
-      delete[] mBuffers[i];
+      FreeChannel(i);
    delete[] mBuffers;
+   delete[] mPagedChannels;
    
    Setup(bufferSize);
 }
@@ -188,7 +278,7 @@ void ChannelBuffer::Load(FileStreamIn& in, int& readLength, LoadMode loadMode)
    
    in >> readLength;
    if (loadMode == LoadMode::kSetBufferSize)
-      Setup(readLength);
+      Resize(readLength);
    else if (loadMode == LoadMode::kRequireExactBufferSize)
       assert(readLength == mBufferSize);
    else
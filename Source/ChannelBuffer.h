@@ -29,10 +29,12 @@
 #include "SynthGlobals.h"
 #include "FileStream.h"
 
+class PagedChannel;
+
 class ChannelBuffer
 {
 public:
-   ChannelBuffer(int bufferSize);
+   ChannelBuffer(int bufferSize, bool pagedMemory = false);   //pagedMemory: reserve the full size now, but only use memory for what gets written (see PagedMemory)
    ChannelBuffer(float* data, int bufferSize);  //intended as a temporary holder for passing raw data to methods that want a ChannelBuffer
    ~ChannelBuffer();
    
@@ -50,6 +52,8 @@ public:
    void SetChannelPointer(float* data, int channel, bool deleteOldData);
    void Reset() { Clear(); mRecentActiveChannels = mActiveChannels; SetNumActiveChannels(1); }
    void Resize(int bufferSize);
+   //for paged buffers: have the first length samples ready to be written to without page faulting on the audio thread
+   void SetCommittedLength(int length);
    
    enum class LoadMode
    {
@@ -65,6 +69,9 @@ public:
    
 private:
    void Setup(int bufferSize);
+   void AllocateChannel(int channel);
+   void FreeChannel(int channel);
+   void ClearChannel(int channel) const;
    
    int mActiveChannels;
    int mNumChannels;
@@ -72,4 +79,6 @@ private:
    float** mBuffers;
    int mRecentActiveChannels;
    bool mOwnsBuffers;
+   bool mPagedMemory;
+   PagedChannel** mPagedChannels;
 };
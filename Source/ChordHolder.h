@@ -58,6 +58,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 131; height = 21; }
    bool Enabled() const override { return mEnabled; }
 
@@ -66,6 +66,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 135; height = 75; }
    void OnClicked(int x, int y, bool right) override;
    void MouseReleased() override;
@@ -35,6 +35,7 @@ ClickButton::ClickButton(IButtonListener* owner, const char* label, int x, int y
 , mClickTime(-9999)
 , mOwner(owner)
 , mDisplayStyle(displayStyle)
+, mLastDisplayedPress(0)
 {
    assert(owner);
    SetLabel(label);
@@ -63,6 +64,7 @@ void ClickButton::SetLabel(const char* label)
       if (mDisplayStyle == ButtonDisplayStyle::kSampleIcon || mDisplayStyle == ButtonDisplayStyle::kFolderIcon)
          mWidth += 20;
    }
+   MarkNeedsDraw();
 }
 
 void ClickButton::Render()
@@ -79,7 +81,8 @@ void ClickButton::Render()
    ofSetColor(0, 0, 0, gModuleDrawAlpha * .5f);
    ofRect(mX+1,mY+1,w,h);
    DrawBeacon(mX+w/2, mY+h/2);
-   float press = ofClamp((1 - (gTime - mClickTime) / 200), 0, 1);
+   float press = GetPressAmount();
+   mLastDisplayedPress = press;
    color.r = ofLerp(color.r, 0, press);
    color.g = ofLerp(color.g, 0, press);
    color.b = ofLerp(color.b, 0, press);
@@ -150,6 +153,19 @@ bool ClickButton::ButtonLit() const
    return mClickTime + 200 > gTime;
 }
 
+float ClickButton::GetPressAmount() const
+{
+   return ofClamp((1 - (gTime - mClickTime) / 200), 0, 1);
+}
+
+bool ClickButton::CheckNeedsDraw()
+{
+   if (IUIControl::CheckNeedsDraw())
+      return true;
+   
+   return GetPressAmount() != mLastDisplayedPress;
+}
+
 void ClickButton::OnClicked(int x, int y, bool right)
 {
    if (right)
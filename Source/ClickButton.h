@@ -58,9 +58,10 @@ public:
    void Render() override;
    void MouseReleased() override;
    bool MouseMoved(float x, float y) override;
-   void SetDisplayText(bool display) { mDisplayStyle = ButtonDisplayStyle::kNoLabel; }
-   void SetDisplayStyle(ButtonDisplayStyle style) { mDisplayStyle = style; }
+   void SetDisplayText(bool display) { mDisplayStyle = ButtonDisplayStyle::kNoLabel; MarkNeedsDraw(); }
+   void SetDisplayStyle(ButtonDisplayStyle style) { mDisplayStyle = style; MarkNeedsDraw(); }
    void SetDimensions(float width, float height) { mWidth = width; mHeight = height; }
+   bool CheckNeedsDraw() override;
 
    //IUIControl
    void SetFromMidiCC(float slider, bool setViaModulator = false) override;
@@ -80,6 +81,7 @@ protected:
 
 private:
    bool ButtonLit() const;
+   float GetPressAmount() const;
 
    void OnClicked(int x, int y, bool right) override;
    float mWidth;
@@ -87,6 +89,7 @@ private:
    double mClickTime;
    IButtonListener* mOwner;
    ButtonDisplayStyle mDisplayStyle;
+   float mLastDisplayedPress;
 };
 
 #endif /* defined(__modularSynth__ClickButton__) */
@@ -97,6 +97,7 @@ void CodeEntry::Poll()
       {
          try
          {
+            py::gil_scoped_acquire gil;
             py::globals()["syntax_highlight_code"] = GetVisibleCode();
             py::object ret = py::eval("syntax_highlight_basic()", py::globals());
             mSyntaxHighlightMapping = ret.cast< std::vector<int> >();
@@ -130,6 +131,7 @@ void CodeEntry::Poll()
             {
                try
                {
+                  py::gil_scoped_acquire gil;
                   std::string prefix = ScriptModule::GetBootstrapImportString() + "; import me\n";
                   py::exec("jediScript = jedi.Script('''" + prefix + GetVisibleCode() + "''', project=jediProject)", py::globals());
                   //py::exec("jediScript = jedi.Script('''" + prefix + GetVisibleCode() + "''')", py::globals());
@@ -46,6 +46,7 @@ public:
    CodeEntry(ICodeEntryListener* owner, const char* name, int x, int y, float w, float h);
    void OnKeyPressed(int key, bool isRepeat) override;
    void Render() override;
+   bool CheckNeedsDraw() override { return true; }
    void Poll() override;
    
    void RenderOverlay();
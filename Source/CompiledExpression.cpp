@@ -0,0 +1,731 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    CompiledExpression.cpp
+    Created: 18 Oct 2026 9:41:03pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "CompiledExpression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+
+namespace
+{
+   typedef CompiledExpression::Op Op;
+
+   const int kBlockSize = 64;
+   const float kEpsilon = 0.000001f;  //matches exprtk's epsilon for floats, used by == and !=
+   const float kPi = 3.14159265358979323846f;
+
+   bool IsTrue(float v) { return v != 0; }
+   float FromBool(bool b) { return b ? 1.0f : 0.0f; }
+
+   bool NearlyEqual(float a, float b)
+   {
+      return fabsf(a - b) <= std::max(1.0f, std::max(fabsf(a), fabsf(b))) * kEpsilon;
+   }
+
+   //the single place that defines what every op does. visitors receive a lambda of the right arity,
+   //so the scalar path (constant folding, single samples) and the block path can't drift apart
+   template <typename Visitor>
+   void Dispatch(Op op, Visitor& v)
+   {
+      switch (op)
+      {
+         case Op::kNegate: v.Unary([](float a) { return -a; }); break;
+         case Op::kAdd: v.Binary([](float a, float b) { return a + b; }); break;
+         case Op::kSubtract: v.Binary([](float a, float b) { return a - b; }); break;
+         case Op::kMultiply: v.Binary([](float a, float b) { return a * b; }); break;
+         case Op::kDivide: v.Binary([](float a, float b) { return a / b; }); break;
+         case Op::kModulo: v.Binary([](float a, float b) { return fmodf(a, b); }); break;
+         case Op::kPower: v.Binary([](float a, float b) { return powf(a, b); }); break;
+         case Op::kLess: v.Binary([](float a, float b) { return FromBool(a < b); }); break;
+         case Op::kLessEqual: v.Binary([](float a, float b) { return FromBool(a <= b); }); break;
+         case Op::kGreater: v.Binary([](float a, float b) { return FromBool(a > b); }); break;
+         case Op::kGreaterEqual: v.Binary([](float a, float b) { return FromBool(a >= b); }); break;
+         case Op::kEqual: v.Binary([](float a, float b) { return FromBool(NearlyEqual(a, b)); }); break;
+         case Op::kNotEqual: v.Binary([](float a, float b) { return FromBool(!NearlyEqual(a, b)); }); break;
+         case Op::kAnd: v.Binary([](float a, float b) { return FromBool(IsTrue(a) && IsTrue(b)); }); break;
+         case Op::kOr: v.Binary([](float a, float b) { return FromBool(IsTrue(a) || IsTrue(b)); }); break;
+         case Op::kXor: v.Binary([](float a, float b) { return FromBool(IsTrue(a) != IsTrue(b)); }); break;
+         case Op::kNand: v.Binary([](float a, float b) { return FromBool(!(IsTrue(a) && IsTrue(b))); }); break;
+         case Op::kNor: v.Binary([](float a, float b) { return FromBool(!(IsTrue(a) || IsTrue(b))); }); break;
+         case Op::kXnor: v.Binary([](float a, float b) { return FromBool(IsTrue(a) == IsTrue(b)); }); break;
+         case Op::kNot: v.Unary([](float a) { return FromBool(!IsTrue(a)); }); break;
+         case Op::kSelect: v.Ternary([](float c, float a, float b) { return IsTrue(c) ? a : b; }); break;
+         case Op::kAbs: v.Unary([](float a) { return fabsf(a); }); break;
+         case Op::kCeil: v.Unary([](float a) { return ceilf(a); }); break;
+         case Op::kFloor: v.Unary([](float a) { return floorf(a); }); break;
+         case Op::kRound: v.Unary([](float a) { return a < 0 ? ceilf(a - .5f) : floorf(a + .5f); }); break;
+         case Op::kTrunc: v.Unary([](float a) { return float(static_cast<long long>(a)); }); break;
+         case Op::kFrac: v.Unary([](float a) { return a - static_cast<long long>(a); }); break;
+         case Op::kSign: v.Unary([](float a) { return a > 0 ? 1.0f : (a < 0 ? -1.0f : 0.0f); }); break;
+         case Op::kSqrt: v.Unary([](float a) { return sqrtf(a); }); break;
+         case Op::kExp: v.Unary([](float a) { return expf(a); }); break;
+         case Op::kLog: v.Unary([](float a) { return logf(a); }); break;
+         case Op::kLog10: v.Unary([](float a) { return log10f(a); }); break;
+         case Op::kLog2: v.Unary([](float a) { return log2f(a); }); break;
+         case Op::kSin: v.Unary([](float a) { return sinf(a); }); break;
+         case Op::kCos: v.Unary([](float a) { return cosf(a); }); break;
+         case Op::kTan: v.Unary([](float a) { return tanf(a); }); break;
+         case Op::kAsin: v.Unary([](float a) { return asinf(a); }); break;
+         case Op::kAcos: v.Unary([](float a) { return acosf(a); }); break;
+         case Op::kAtan: v.Unary([](float a) { return atanf(a); }); break;
+         case Op::kSinh: v.Unary([](float a) { return sinhf(a); }); break;
+         case Op::kCosh: v.Unary([](float a) { return coshf(a); }); break;
+         case Op::kTanh: v.Unary([](float a) { return tanhf(a); }); break;
+         case Op::kMin: v.Binary([](float a, float b) { return a < b ? a : b; }); break;
+         case Op::kMax: v.Binary([](float a, float b) { return a > b ? a : b; }); break;
+         case Op::kClamp: v.Ternary([](float lo, float a, float hi) { return a < lo ? lo : (a > hi ? hi : a); }); break;
+         case Op::kAtan2: v.Binary([](float a, float b) { return atan2f(a, b); }); break;
+         case Op::kHypot: v.Binary([](float a, float b) { return sqrtf(a * a + b * b); }); break;
+         case Op::kConstant:
+         case Op::kVariable:
+            break;
+      }
+   }
+
+   struct ScalarVisitor
+   {
+      float mArgs[3];
+      float mResult;
+
+      template <typename F> void Unary(F f) { mResult = f(mArgs[0]); }
+      template <typename F> void Binary(F f) { mResult = f(mArgs[0], mArgs[1]); }
+      template <typename F> void Ternary(F f) { mResult = f(mArgs[0], mArgs[1], mArgs[2]); }
+   };
+
+   struct Register
+   {
+      float mValues[kBlockSize];
+      bool mUniform;  //if true, all samples equal mValues[0]
+   };
+
+   void Broadcast(Register& reg, int count)
+   {
+      if (reg.mUniform)
+      {
+         std::fill(reg.mValues + 1, reg.mValues + count, reg.mValues[0]);
+         reg.mUniform = false;
+      }
+   }
+
+   //operations on uniform operands are computed once for the whole block.
+   //the destination register is always the first argument's register, so the loops work in place
+   struct BlockVisitor
+   {
+      Register* mDest;
+      Register* mArgs[3];
+      int mCount;
+
+      template <typename F> void Unary(F f)
+      {
+         Register& a = *mArgs[0];
+         if (a.mUniform)
+         {
+            mDest->mValues[0] = f(a.mValues[0]);
+            mDest->mUniform = true;
+            return;
+         }
+         for (int i = 0; i < mCount; ++i)
+            mDest->mValues[i] = f(a.mValues[i]);
+         mDest->mUniform = false;
+      }
+
+      template <typename F> void Binary(F f)
+      {
+         Register& a = *mArgs[0];
+         Register& b = *mArgs[1];
+         if (a.mUniform && b.mUniform)
+         {
+            mDest->mValues[0] = f(a.mValues[0], b.mValues[0]);
+            mDest->mUniform = true;
+            return;
+         }
+         Broadcast(a, mCount);
+         Broadcast(b, mCount);
+         for (int i = 0; i < mCount; ++i)
+            mDest->mValues[i] = f(a.mValues[i], b.mValues[i]);
+         mDest->mUniform = false;
+      }
+
+      template <typename F> void Ternary(F f)
+      {
+         Register& a = *mArgs[0];
+         Register& b = *mArgs[1];
+         Register& c = *mArgs[2];
+         if (a.mUniform && b.mUniform && c.mUniform)
+         {
+            mDest->mValues[0] = f(a.mValues[0], b.mValues[0], c.mValues[0]);
+            mDest->mUniform = true;
+            return;
+         }
+         Broadcast(a, mCount);
+         Broadcast(b, mCount);
+         Broadcast(c, mCount);
+         for (int i = 0; i < mCount; ++i)
+            mDest->mValues[i] = f(a.mValues[i], b.mValues[i], c.mValues[i]);
+         mDest->mUniform = false;
+      }
+   };
+
+   int GetArity(Op op)
+   {
+      switch (op)
+      {
+         case Op::kConstant:
+         case Op::kVariable:
+            return 0;
+         case Op::kSelect:
+         case Op::kClamp:
+            return 3;
+         case Op::kAdd: case Op::kSubtract: case Op::kMultiply: case Op::kDivide: case Op::kModulo: case Op::kPower:
+         case Op::kLess: case Op::kLessEqual: case Op::kGreater: case Op::kGreaterEqual: case Op::kEqual: case Op::kNotEqual:
+         case Op::kAnd: case Op::kOr: case Op::kXor: case Op::kNand: case Op::kNor: case Op::kXnor:
+         case Op::kMin: case Op::kMax: case Op::kAtan2: case Op::kHypot:
+            return 2;
+         default:
+            return 1;
+      }
+   }
+
+   struct Node
+   {
+      Op mOp;
+      float mValue;
+      int mVariable;
+      std::vector<std::unique_ptr<Node>> mArgs;
+   };
+
+   std::unique_ptr<Node> MakeConstant(float value)
+   {
+      std::unique_ptr<Node> node(new Node());
+      node->mOp = Op::kConstant;
+      node->mValue = value;
+      return node;
+   }
+
+   //builds an op node, folding it down to a constant if all of its arguments are constant
+   std::unique_ptr<Node> MakeOp(Op op, std::unique_ptr<Node> a, std::unique_ptr<Node> b = nullptr, std::unique_ptr<Node> c = nullptr)
+   {
+      std::unique_ptr<Node> node(new Node());
+      node->mOp = op;
+      node->mArgs.push_back(std::move(a));
+      if (b)
+         node->mArgs.push_back(std::move(b));
+      if (c)
+         node->mArgs.push_back(std::move(c));
+
+      bool allConstant = true;
+      ScalarVisitor visitor;
+      for (size_t i = 0; i < node->mArgs.size(); ++i)
+      {
+         if (node->mArgs[i]->mOp != Op::kConstant)
+            allConstant = false;
+         else
+            visitor.mArgs[i] = node->mArgs[i]->mValue;
+      }
+      if (allConstant)
+      {
+         Dispatch(op, visitor);
+         return MakeConstant(visitor.mResult);
+      }
+      return node;
+   }
+
+   struct Token
+   {
+      enum Type
+      {
+         kNumber,
+         kName,
+         kSymbol,
+         kOpen,
+         kClose,
+         kComma,
+         kEnd
+      };
+      Type mType;
+      std::string mText;
+      float mValue;
+   };
+
+   bool Tokenize(const std::string& text, std::vector<Token>& tokens)
+   {
+      size_t pos = 0;
+      while (pos < text.size())
+      {
+         char ch = text[pos];
+         if (isspace((unsigned char)ch))
+         {
+            ++pos;
+            continue;
+         }
+
+         Token token;
+         token.mValue = 0;
+         if (isdigit((unsigned char)ch) || (ch == '.' && pos + 1 < text.size() && isdigit((unsigned char)text[pos + 1])))
+         {
+            const char* start = text.c_str() + pos;
+            char* end;
+            token.mType = Token::kNumber;
+            token.mValue = strtof(start, &end);
+            pos += end - start;
+         }
+         else if (isalpha((unsigned char)ch) || ch == '_')
+         {
+            token.mType = Token::kName;
+            while (pos < text.size() && (isalnum((unsigned char)text[pos]) || text[pos] == '_'))
+               token.mText += (char)tolower((unsigned char)text[pos++]);
+         }
+         else if (ch == '(' || ch == '[' || ch == '{')
+         {
+            token.mType = Token::kOpen;
+            token.mText = ch;
+            ++pos;
+         }
+         else if (ch == ')' || ch == ']' || ch == '}')
+         {
+            token.mType = Token::kClose;
+            token.mText = ch;
+            ++pos;
+         }
+         else if (ch == ',')
+         {
+            token.mType = Token::kComma;
+            ++pos;
+         }
+         else
+         {
+            static const char* kSymbols[] = { "<=", ">=", "==", "!=", "<>", "+", "-", "*", "/", "%", "^", "<", ">", "=", "&", "|", "?", ":" };
+            token.mType = Token::kSymbol;
+            for (const char* symbol : kSymbols)
+            {
+               size_t length = strlen(symbol);
+               if (text.compare(pos, length, symbol) == 0)
+               {
+                  token.mText = symbol;
+                  pos += length;
+                  break;
+               }
+            }
+            if (token.mText.empty())
+               return false;  //assignments, strings, statements etc. are left to exprtk
+            if (token.mText == ":" && pos < text.size() && text[pos] == '=')
+               return false;
+         }
+         tokens.push_back(token);
+      }
+
+      Token end;
+      end.mType = Token::kEnd;
+      end.mValue = 0;
+      tokens.push_back(end);
+      return true;
+   }
+
+   //recursive descent parser using the same operator precedence as exprtk
+   class Parser
+   {
+   public:
+      Parser(const std::vector<Token>& tokens, const std::vector<std::string>& variables)
+      : mTokens(tokens)
+      , mVariables(variables)
+      , mPos(0)
+      {
+      }
+
+      std::unique_ptr<Node> Parse()
+      {
+         std::unique_ptr<Node> root = ParseExpression(0);
+         if (root && Current().mType != Token::kEnd)
+            return nullptr;
+         return root;
+      }
+
+   private:
+      struct BinaryOp
+      {
+         const char* mText;
+         Op mOp;
+         int mLeft;
+         int mRight;
+      };
+
+      const Token& Current() const { return mTokens[mPos]; }
+
+      const BinaryOp* GetBinaryOp(const Token& token) const
+      {
+         static const BinaryOp kBinaryOps[] =
+         {
+            { "or", Op::kOr, 1, 2 }, { "nor", Op::kNor, 1, 2 }, { "xor", Op::kXor, 1, 2 }, { "xnor", Op::kXnor, 1, 2 }, { "|", Op::kOr, 1, 2 },
+            { "and", Op::kAnd, 3, 4 }, { "nand", Op::kNand, 3, 4 }, { "&", Op::kAnd, 3, 4 },
+            { "<", Op::kLess, 5, 6 }, { "<=", Op::kLessEqual, 5, 6 }, { ">", Op::kGreater, 5, 6 }, { ">=", Op::kGreaterEqual, 5, 6 },
+            { "==", Op::kEqual, 5, 6 }, { "=", Op::kEqual, 5, 6 }, { "!=", Op::kNotEqual, 5, 6 }, { "<>", Op::kNotEqual, 5, 6 },
+            { "+", Op::kAdd, 7, 8 }, { "-", Op::kSubtract, 7, 8 },
+            { "*", Op::kMultiply, 10, 11 }, { "/", Op::kDivide, 10, 11 }, { "%", Op::kModulo, 10, 11 },
+            { "^", Op::kPower, 12, 12 }
+         };
+
+         if (token.mType != Token::kSymbol && token.mType != Token::kName)
+            return nullptr;
+         for (const BinaryOp& op : kBinaryOps)
+         {
+            if (token.mText == op.mText)
+               return &op;
+         }
+         return nullptr;
+      }
+
+      std::unique_ptr<Node> ParseExpression(int precedence)
+      {
+         std::unique_ptr<Node> expression = ParseBranch();
+         while (expression)
+         {
+            const Token& token = Current();
+            if (precedence == 0 && token.mType == Token::kSymbol && token.mText == "?")
+            {
+               ++mPos;
+               std::unique_ptr<Node> consequent = ParseExpression(0);
+               if (consequent == nullptr || Current().mText != ":")
+                  return nullptr;
+               ++mPos;
+               std::unique_ptr<Node> alternative = ParseExpression(0);
+               if (alternative == nullptr)
+                  return nullptr;
+               expression = MakeOp(Op::kSelect, std::move(expression), std::move(consequent), std::move(alternative));
+               continue;
+            }
+
+            const BinaryOp* op = GetBinaryOp(token);
+            if (op == nullptr || op->mLeft < precedence)
+               break;
+            ++mPos;
+            std::unique_ptr<Node> rhs = ParseExpression(op->mRight);
+            if (rhs == nullptr)
+               return nullptr;
+            expression = MakeOp(op->mOp, std::move(expression), std::move(rhs));
+         }
+         return expression;
+      }
+
+      std::unique_ptr<Node> ParseBranch()
+      {
+         std::unique_ptr<Node> branch = ParsePrimary();
+         //exprtk reads "2x" or "(a)(b)" as implicit multiplication, leave those to it
+         Token::Type next = Current().mType;
+         if (branch && (next == Token::kNumber || next == Token::kName || next == Token::kOpen) && GetBinaryOp(Current()) == nullptr)
+            return nullptr;
+         return branch;
+      }
+
+      std::unique_ptr<Node> ParsePrimary()
+      {
+         const Token& token = Current();
+         switch (token.mType)
+         {
+            case Token::kNumber:
+               ++mPos;
+               return MakeConstant(token.mValue);
+            case Token::kOpen:
+            {
+               char close = token.mText[0] == '(' ? ')' : (token.mText[0] == '[' ? ']' : '}');
+               ++mPos;
+               std::unique_ptr<Node> inner = ParseExpression(0);
+               if (inner == nullptr || Current().mType != Token::kClose || Current().mText[0] != close)
+                  return nullptr;
+               ++mPos;
+               return inner;
+            }
+            case Token::kSymbol:
+               if (token.mText == "-")
+               {
+                  ++mPos;
+                  std::unique_ptr<Node> operand = ParseExpression(11);
+                  return operand ? MakeOp(Op::kNegate, std::move(operand)) : nullptr;
+               }
+               if (token.mText == "+")
+               {
+                  ++mPos;
+                  return ParseExpression(13);
+               }
+               return nullptr;
+            case Token::kName:
+               ++mPos;
+               if (Current().mType == Token::kOpen)
+                  return ParseFunction(token.mText);
+               return ParseName(token.mText);
+            default:
+               return nullptr;
+         }
+      }
+
+      std::unique_ptr<Node> ParseName(const std::string& name)
+      {
+         for (size_t i = 0; i < mVariables.size(); ++i)
+         {
+            if (mVariables[i] == name)
+            {
+               std::unique_ptr<Node> node(new Node());
+               node->mOp = Op::kVariable;
+               node->mVariable = (int)i;
+               return node;
+            }
+         }
+
+         if (name == "pi")
+            return MakeConstant(kPi);
+         if (name == "epsilon")
+            return MakeConstant(kEpsilon);
+         if (name == "inf")
+            return MakeConstant(std::numeric_limits<float>::infinity());
+         if (name == "true")
+            return MakeConstant(1);
+         if (name == "false")
+            return MakeConstant(0);
+         return nullptr;
+      }
+
+      std::unique_ptr<Node> ParseFunction(const std::string& name)
+      {
+         struct Function
+         {
+            const char* mName;
+            Op mOp;
+         };
+         static const Function kFunctions[] =
+         {
+            { "abs", Op::kAbs }, { "ceil", Op::kCeil }, { "floor", Op::kFloor }, { "round", Op::kRound }, { "trunc", Op::kTrunc },
+            { "frac", Op::kFrac }, { "sgn", Op::kSign }, { "sqrt", Op::kSqrt }, { "exp", Op::kExp }, { "log", Op::kLog },
+            { "log10", Op::kLog10 }, { "log2", Op::kLog2 }, { "sin", Op::kSin }, { "cos", Op::kCos }, { "tan", Op::kTan },
+            { "asin", Op::kAsin }, { "acos", Op::kAcos }, { "atan", Op::kAtan }, { "sinh", Op::kSinh }, { "cosh", Op::kCosh },
+            { "tanh", Op::kTanh }, { "not", Op::kNot }, { "min", Op::kMin }, { "max", Op::kMax }, { "clamp", Op::kClamp },
+            { "atan2", Op::kAtan2 }, { "hypot", Op::kHypot }, { "if", Op::kSelect }
+         };
+
+         const Function* function = nullptr;
+         for (const Function& candidate : kFunctions)
+         {
+            if (name == candidate.mName)
+               function = &candidate;
+         }
+         if (function == nullptr)
+            return nullptr;
+
+         std::vector<std::unique_ptr<Node>> args;
+         ++mPos;  //opening bracket
+         while (true)
+         {
+            std::unique_ptr<Node> arg = ParseExpression(0);
+            if (arg == nullptr)
+               return nullptr;
+            args.push_back(std::move(arg));
+            if (Current().mType == Token::kComma)
+            {
+               ++mPos;
+               continue;
+            }
+            if (Current().mType != Token::kClose)
+               return nullptr;
+            ++mPos;
+            break;
+         }
+
+         Op op = function->mOp;
+         if ((op == Op::kMin || op == Op::kMax) && args.size() >= 2)
+         {
+            //variadic min/max becomes a chain of binary ops
+            std::unique_ptr<Node> result = std::move(args[0]);
+            for (size_t i = 1; i < args.size(); ++i)
+               result = MakeOp(op, std::move(result), std::move(args[i]));
+            return result;
+         }
+
+         if ((int)args.size() != GetArity(op))
+            return nullptr;
+         if (args.size() == 1)
+            return MakeOp(op, std::move(args[0]));
+         if (args.size() == 2)
+            return MakeOp(op, std::move(args[0]), std::move(args[1]));
+         return MakeOp(op, std::move(args[0]), std::move(args[1]), std::move(args[2]));
+      }
+
+      const std::vector<Token>& mTokens;
+      const std::vector<std::string>& mVariables;
+      size_t mPos;
+   };
+
+   //each node is emitted into the register matching its depth, with its arguments in the registers above it
+   bool Emit(const Node* node, int reg, std::vector<CompiledExpression::Instruction>& instructions)
+   {
+      if (reg + (int)node->mArgs.size() > CompiledExpression::kMaxRegisters)
+         return false;
+
+      CompiledExpression::Instruction instruction;
+      instruction.mOp = node->mOp;
+      instruction.mDest = reg;
+      instruction.mValue = node->mValue;
+      instruction.mVariable = node->mVariable;
+      std::fill(instruction.mArgs, instruction.mArgs + 3, reg);
+      for (size_t i = 0; i < node->mArgs.size(); ++i)
+      {
+         if (!Emit(node->mArgs[i].get(), reg + (int)i, instructions))
+            return false;
+         instruction.mArgs[i] = reg + (int)i;
+      }
+      instructions.push_back(instruction);
+      return true;
+   }
+}
+
+std::shared_ptr<const CompiledExpression> CompiledExpression::Compile(const std::string& text, const std::vector<std::string>& variables)
+{
+   static std::mutex sCacheMutex;
+   static std::map<std::string, std::shared_ptr<const CompiledExpression>> sCache;
+
+   std::string key;
+   for (const auto& variable : variables)
+      key += variable + ",";
+   key += "|" + text;
+
+   std::lock_guard<std::mutex> lock(sCacheMutex);
+   auto cached = sCache.find(key);
+   if (cached != sCache.end())
+      return cached->second;
+
+   std::shared_ptr<CompiledExpression> compiled;
+   std::vector<Token> tokens;
+   if (Tokenize(text, tokens))
+   {
+      Parser parser(tokens, variables);
+      std::unique_ptr<Node> root = parser.Parse();
+      if (root)
+      {
+         compiled.reset(new CompiledExpression());
+         if (Emit(root.get(), 0, compiled->mInstructions))
+            compiled->mResultRegister = 0;
+         else
+            compiled.reset();
+      }
+   }
+
+   //drop expressions nobody is using anymore, failures included
+   const size_t kMaxUnusedEntries = 64;
+   if (sCache.size() > kMaxUnusedEntries)
+   {
+      for (auto iter = sCache.begin(); iter != sCache.end();)
+      {
+         if (iter->second.use_count() <= 1)
+            iter = sCache.erase(iter);
+         else
+            ++iter;
+      }
+   }
+
+   sCache[key] = compiled;
+   return compiled;
+}
+
+bool CompiledExpression::UsesVariable(int index) const
+{
+   for (const auto& instruction : mInstructions)
+   {
+      if (instruction.mOp == Op::kVariable && instruction.mVariable == index)
+         return true;
+   }
+   return false;
+}
+
+void CompiledExpression::Evaluate(const Input* inputs, float* output, int count) const
+{
+   Register registers[kMaxRegisters];
+   for (int start = 0; start < count; start += kBlockSize)
+   {
+      int blockCount = std::min(kBlockSize, count - start);
+      for (const auto& instruction : mInstructions)
+      {
+         Register& dest = registers[instruction.mDest];
+         if (instruction.mOp == Op::kConstant)
+         {
+            dest.mValues[0] = instruction.mValue;
+            dest.mUniform = true;
+         }
+         else if (instruction.mOp == Op::kVariable)
+         {
+            const Input& input = inputs[instruction.mVariable];
+            dest.mUniform = input.mUniform;
+            if (input.mUniform)
+               dest.mValues[0] = input.mValues[0];
+            else
+               std::copy(input.mValues + start, input.mValues + start + blockCount, dest.mValues);
+         }
+         else
+         {
+            BlockVisitor visitor;
+            visitor.mDest = &dest;
+            for (int i = 0; i < 3; ++i)
+               visitor.mArgs[i] = &registers[instruction.mArgs[i]];
+            visitor.mCount = blockCount;
+            Dispatch(instruction.mOp, visitor);
+         }
+      }
+
+      const Register& result = registers[mResultRegister];
+      if (result.mUniform)
+         std::fill(output + start, output + start + blockCount, result.mValues[0]);
+      else
+         std::copy(result.mValues, result.mValues + blockCount, output + start);
+   }
+}
+
+float CompiledExpression::Evaluate(const float* inputs) const
+{
+   float registers[kMaxRegisters];
+   for (const auto& instruction : mInstructions)
+   {
+      if (instruction.mOp == Op::kConstant)
+      {
+         registers[instruction.mDest] = instruction.mValue;
+      }
+      else if (instruction.mOp == Op::kVariable)
+      {
+         registers[instruction.mDest] = inputs[instruction.mVariable];
+      }
+      else
+      {
+         ScalarVisitor visitor;
+         for (int i = 0; i < 3; ++i)
+            visitor.mArgs[i] = registers[instruction.mArgs[i]];
+         Dispatch(instruction.mOp, visitor);
+         registers[instruction.mDest] = visitor.mResult;
+      }
+   }
+   return registers[mResultRegister];
+}
@@ -0,0 +1,125 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    CompiledExpression.h
+    Created: 18 Oct 2026 9:41:03pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//an arithmetic expression compiled to a flat list of instructions that evaluate a whole block of samples at a time.
+//covers the common subset of exprtk syntax (operators, comparisons, logic, ternaries, math functions).
+//Compile() returns nullptr for anything outside of that, and callers fall back to exprtk
+class CompiledExpression
+{
+public:
+   struct Input
+   {
+      const float* mValues;
+      bool mUniform;  //if true, only mValues[0] is read
+   };
+
+   //compiled expressions are immutable and shared between everyone that asks for the same text and variables
+   static std::shared_ptr<const CompiledExpression> Compile(const std::string& text, const std::vector<std::string>& variables);
+
+   //inputs are in the order of the variables passed to Compile()
+   void Evaluate(const Input* inputs, float* output, int count) const;
+   float Evaluate(const float* inputs) const;
+
+   bool IsConstant() const { return mInstructions.size() == 1 && mInstructions[0].mOp == Op::kConstant; }
+   bool UsesVariable(int index) const;
+
+   enum class Op
+   {
+      kConstant,
+      kVariable,
+      kNegate,
+      kAdd,
+      kSubtract,
+      kMultiply,
+      kDivide,
+      kModulo,
+      kPower,
+      kLess,
+      kLessEqual,
+      kGreater,
+      kGreaterEqual,
+      kEqual,
+      kNotEqual,
+      kAnd,
+      kOr,
+      kXor,
+      kNand,
+      kNor,
+      kXnor,
+      kNot,
+      kSelect,
+      kAbs,
+      kCeil,
+      kFloor,
+      kRound,
+      kTrunc,
+      kFrac,
+      kSign,
+      kSqrt,
+      kExp,
+      kLog,
+      kLog10,
+      kLog2,
+      kSin,
+      kCos,
+      kTan,
+      kAsin,
+      kAcos,
+      kAtan,
+      kSinh,
+      kCosh,
+      kTanh,
+      kMin,
+      kMax,
+      kClamp,
+      kAtan2,
+      kHypot
+   };
+
+   struct Instruction
+   {
+      Op mOp;
+      int mDest;
+      int mArgs[3];
+      float mValue;  //for kConstant
+      int mVariable;  //for kVariable
+   };
+
+   static const int kMaxRegisters = 32;
+
+private:
+   CompiledExpression() {}
+
+   std::vector<Instruction> mInstructions;
+   int mResultRegister;
+};
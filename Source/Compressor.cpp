@@ -31,18 +31,6 @@
 
 namespace
 {
-   static double lin2dB( double lin )
-   {
-      static const double LOG_2_DB = 8.6858896380650365530225783783321;	// 20 / ln( 10 )
-      return log( lin ) * LOG_2_DB;
-   }
-
-   static double dB2lin( double dB )
-   {
-      static const double DB_2_LOG = 0.11512925464970228420089957273422;	// ln( 10 ) / 20
-      return exp( dB * DB_2_LOG );
-   }
-
    const float kMaxLookaheadMs = 50;
 }
 
@@ -54,15 +42,15 @@ Compressor::Compressor()
 , mRelease(100)
 , mLookahead(3)
 , mOutputAdjust(1)
+, mKnee(0)
 , mThresholdSlider(nullptr)
 , mRatioSlider(nullptr)
 , mAttackSlider(nullptr)
 , mReleaseSlider(nullptr)
 , mCurrentInputDb(0)
 , mOutputGain(1)
-, mDelayBuffer(kMaxLookaheadMs * gSampleRateMs)
+, mLookaheadDelay(kMaxLookaheadMs * gSampleRateMs)
 {
-   envdB_ = DC_OFFSET;
 }
 
 void Compressor::CreateUIControls()
@@ -76,6 +64,7 @@ void Compressor::CreateUIControls()
    FLOATSLIDER(mReleaseSlider, "release",&mRelease,.1f,500);
    FLOATSLIDER(mLookaheadSlider, "lookahead",&mLookahead,0,kMaxLookaheadMs);
    FLOATSLIDER(mOutputAdjustSlider, "output",&mOutputAdjust,0,2);
+   FLOATSLIDER(mKneeSlider, "knee",&mKnee,0,24);
    ENDUIBLOCK(mWidth, mHeight);
 
    mRatioSlider->SetMode(FloatSlider::kSquare);
@@ -84,8 +73,8 @@ void Compressor::CreateUIControls()
    mLookaheadSlider->SetMode(FloatSlider::kSquare);
    mOutputAdjustSlider->SetMode(FloatSlider::kSquare);
    
-   mEnv.setAttack(mAttack);
-   mEnv.setRelease(mRelease);
+   mEnv.SetAttack(mAttack);
+   mEnv.SetRelease(mRelease);
 }
 
 void Compressor::ProcessAudio(double time, ChannelBuffer* buffer)
@@ -96,58 +85,33 @@ void Compressor::ProcessAudio(double time, ChannelBuffer* buffer)
       return;
    
    int bufferSize = buffer->BufferSize();
-   mDelayBuffer.SetNumChannels(buffer->NumActiveChannels());
-
+   ComputeSliders(0);
+   
+   //sidechain level in db, from the loudest channel
+   float* gain = gWorkBuffer;
+   DynamicsCore::LinkedPeak(buffer, gain, bufferSize);
+   DynamicsCore::LinToDb(gain, gain, bufferSize);
+   mCurrentInputDb = gain[bufferSize-1];
+   
+   //delta over threshold, through the knee and the attack/release envelope
+   mGainComputer.SetThreshold(mThreshold);
+   mGainComputer.SetKnee(mKnee);
+   mGainComputer.Process(gain, gain, bufferSize);
+   mEnv.Process(gain, bufferSize);
+   
+   //transfer function
+   float invRatio = 1 / mRatio;
+   float reductionPerDb = invRatio - 1;
+   float makeup = (-mThreshold * .5f) * (1 - invRatio);
    for (int i=0; i<bufferSize; ++i)
-   {
-      ComputeSliders(i);
-      
-      // create sidechain
-
-      float input = 0;
-      for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
-         input = MAX(input, fabsf(buffer->GetChannel(ch)[i]));
-
-      /* if desired, one could use another EnvelopeDetector to smooth
-       * the rectified signal.
-       */
-
-      // convert key to dB
-      input += DC_OFFSET;				// add DC offset to avoid log( 0 )
-      mCurrentInputDb = lin2dB( input );	// convert linear -> dB
-
-      // threshold
-      double overdB = mCurrentInputDb - mThreshold;	// delta over threshold
-      if ( overdB < 0.0 )
-         overdB = 0.0;
-
-      // attack/release
-
-      overdB += DC_OFFSET;					// add DC offset to avoid denormal
-      mEnv.run( overdB, envdB_ );	// run attack/release envelope
-      overdB = envdB_ - DC_OFFSET;			// subtract DC offset
-
-      /* REGARDING THE DC OFFSET: In this case, since the offset is added before
-       * the attack/release processes, the envelope will never fall below the offset,
-       * thereby avoiding denormals. However, to prevent the offset from causing
-       * constant gain reduction, we must subtract it from the envelope, yielding
-       * a minimum value of 0dB.
-       */
-      
-      double invRatio = 1 / mRatio;
-
-      // transfer function
-      double reduction = overdB * ( invRatio - 1.0 );	// gain reduction (dB)
-      double makeup = (-mThreshold * .5) * (1.0 - invRatio);
-      mOutputGain = ofLerp(1, dB2lin( reduction + makeup ) * mOutputAdjust, mMix);
-
-      // output gain
-      for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
-      {
-         mDelayBuffer.Write(buffer->GetChannel(ch)[i], ch);
-         buffer->GetChannel(ch)[i] = mDelayBuffer.GetSample(ofClamp(int(mLookahead * gSampleRateMs)+1, 1, mDelayBuffer.Size()-1), ch) * mOutputGain;	// apply gain reduction to input
-      }
-   }
+      gain[i] = gain[i] * reductionPerDb + makeup;
+   DynamicsCore::DbToLin(gain, gain, bufferSize);
+   for (int i=0; i<bufferSize; ++i)
+      gain[i] = 1 + (gain[i] * mOutputAdjust - 1) * mMix;
+   mOutputGain = gain[bufferSize-1];
+   
+   mLookaheadDelay.Process(buffer, int(mLookahead * gSampleRateMs));
+   DynamicsCore::ApplyGain(buffer, gain, bufferSize);
 }
 
 void Compressor::DrawModule()
@@ -159,6 +123,7 @@ void Compressor::DrawModule()
    mReleaseSlider->Draw();
    mLookaheadSlider->Draw();
    mOutputAdjustSlider->Draw();
+   mKneeSlider->Draw();
    
    ofPushStyle();
    ofSetColor(0,255,0,gModuleDrawAlpha);
@@ -181,59 +146,13 @@ void Compressor::DrawModule()
 void Compressor::CheckboxUpdated(Checkbox* checkbox)
 {
    if (checkbox == mEnabledCheckbox)
-      envdB_ = DC_OFFSET;  //reset state
+      mEnv.Reset();
 }
 
 void Compressor::FloatSliderUpdated(FloatSlider* slider, float oldVal)
 {
    if (slider == mAttackSlider)
-      mEnv.setAttack(MAX(.1f,mAttack));
+      mEnv.SetAttack(MAX(.1f,mAttack));
    if (slider == mReleaseSlider)
-      mEnv.setRelease(MAX(.1f,mRelease));
-}
-
-//-------------------------------------------------------------
-// envelope detector
-//-------------------------------------------------------------
-EnvelopeDetector::EnvelopeDetector( double ms )
-{
-   assert( ms > 0.0 );
-   ms_ = ms;
-   setCoef();
-}
-
-//-------------------------------------------------------------
-void EnvelopeDetector::setTc( double ms )
-{
-   assert( ms > 0.0 );
-   ms_ = ms;
-   setCoef();
-}
-
-//-------------------------------------------------------------
-void EnvelopeDetector::setCoef( void )
-{
-   coef_ = exp( -1000.0 / ( ms_ * gSampleRate ) );
-}
-
-//-------------------------------------------------------------
-// attack/release envelope
-//-------------------------------------------------------------
-AttRelEnvelope::AttRelEnvelope( double att_ms, double rel_ms )
-: att_( att_ms )
-, rel_( rel_ms )
-{
-}
-
-//-------------------------------------------------------------
-void AttRelEnvelope::setAttack( double ms )
-{
-   att_.setTc( ms );
+      mEnv.SetRelease(MAX(.1f,mRelease));
 }
-
-//-------------------------------------------------------------
-void AttRelEnvelope::setRelease( double ms )
-{
-   rel_.setTc( ms );
-}
-
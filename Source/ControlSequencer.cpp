@@ -227,7 +227,7 @@ void ControlSequencer::DropdownUpdated(DropdownList* list, int oldVal)
       {
          TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
          if (transportListenerInfo != nullptr)
-            transportListenerInfo->mInterval =  mInterval;
+            transportListenerInfo->SetInterval(mInterval);
          SetNumSteps(newSteps, true);
       }
       else
@@ -55,6 +55,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=120; h=22; }
    bool Enabled() const override { return mEnabled; }
    
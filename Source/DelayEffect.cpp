@@ -86,8 +86,11 @@ void DelayEffect::ProcessAudio(double time, ChannelBuffer* buffer)
    if (!mEnabled)
       return;
    
-   float bufferSize = buffer->BufferSize();
+   int bufferSize = buffer->BufferSize();
    mDelayBuffer.SetNumChannels(buffer->NumActiveChannels());
+   mDelaySamps.resize(bufferSize);
+   mAmounts.resize(bufferSize);
+   mDelayedSamples.resize(bufferSize);
 
    if (mInterval != kInterval_None)
    {
@@ -96,35 +99,111 @@ void DelayEffect::ProcessAudio(double time, ChannelBuffer* buffer)
    }
 
    mAmountRamp.Start(time, mFeedback, time + 3);
+
+   //delay times in ms first, converted to samples below
+   if (SlidersNeedPerSampleCompute())
+   {
+      //the sliders can move the ramps on any sample, so they have to be followed sample by sample
+      for (int i=0; i<bufferSize; ++i)
+      {
+         mFeedback = mAmountRamp.Value(time);
+         ComputeSliders(i);
+         mAmounts[i] = mFeedback;
+         mDelaySamps[i] = MAX(mDelayRamp.Value(time), GetMinDelayMs());
+         time += gInvSampleRateMs;
+      }
+   }
+   else
+   {
+      mAmountRamp.Fill(time, mAmounts.data(), bufferSize);
+      mFeedback = mAmounts[0];
+      ComputeSliders(0);
+      mAmounts[0] = mFeedback;
+      mFeedback = mAmounts[bufferSize-1];
+      mDelayRamp.Fill(time, mDelaySamps.data(), bufferSize);
+      for (int i=0; i<bufferSize; ++i)
+         mDelaySamps[i] = MAX(mDelaySamps[i], GetMinDelayMs());
+   }
+   
+   float minDelaySamps = DELAY_BUFFER_SIZE;
    for (int i=0; i<bufferSize; ++i)
    {
-      mFeedback = mAmountRamp.Value(time);
-
-      ComputeSliders(i);
-
-      float delay = MAX(mDelayRamp.Value(time), GetMinDelayMs());
-
-      float delaySamps = delay / gInvSampleRateMs;
+      float delaySamps = mDelaySamps[i] / gInvSampleRateMs;
       if (mFeedbackModuleMode)
          delaySamps -= gBufferSize;
-      delaySamps = ofClamp(delaySamps, 0.1f, DELAY_BUFFER_SIZE-2);
+      mDelaySamps[i] = ofClamp(delaySamps, 0.1f, DELAY_BUFFER_SIZE-2);
+      minDelaySamps = MIN(minDelaySamps, mDelaySamps[i]);
+   }
+   
+   //short delays read samples written within this buffer, so they have to run sample by sample
+   if (!DelayLine::CanReadBlock(minDelaySamps, bufferSize))
+   {
+      ProcessPerSample(buffer);
+      return;
+   }
+   
+   bool constantDelay = true;
+   for (int i=1; i<bufferSize; ++i)
+      constantDelay &= (mDelaySamps[i] == mDelaySamps[0]);
+   
+   float* delayed = mDelayedSamples.data();
+   for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
+   {
+      float* channel = buffer->GetChannel(ch);
+      
+      if (constantDelay)
+         mDelayBuffer.ReadBlock(delayed, bufferSize, mDelaySamps[0], ch);
+      else
+         mDelayBuffer.ReadBlock(delayed, bufferSize, mDelaySamps.data(), ch);
+      
+      Mult(delayed, mAmounts.data(), bufferSize);
+      if (mInvert)
+         Mult(delayed, -1, bufferSize);
+      for (int i=0; i<bufferSize; ++i)
+      {
+         JUCE_UNDENORMALISE(delayed[i]);
+         if (delayed[i] != delayed[i]) //filter NaNs
+            delayed[i] = 0;
+      }
+
+      if (!mEcho && mAcceptInput) //single delay, no continuous feedback so do it pre
+         mDelayBuffer.WriteChunk(channel, bufferSize, ch);
 
-      int sampsAgoA = int(delaySamps);
-      int sampsAgoB = sampsAgoA+1;
+      if (mDry)
+      {
+         Add(channel, delayed, bufferSize);
+         if (mEcho && mAcceptInput) //continuous feedback so do it post
+            mDelayBuffer.WriteChunk(channel, bufferSize, ch);
+      }
+      else
+      {
+         if (mEcho && mAcceptInput)
+         {
+            Add(channel, delayed, bufferSize);
+            mDelayBuffer.WriteChunk(channel, bufferSize, ch);
+         }
+         BufferCopy(channel, delayed, bufferSize);
+      }
+      
+      if (!mAcceptInput)
+         mDelayBuffer.WriteChunk(delayed, bufferSize, ch);
+   }
+}
 
+void DelayEffect::ProcessPerSample(ChannelBuffer* buffer)
+{
+   for (int i=0; i<buffer->BufferSize(); ++i)
+   {
       for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
       {
-         float sample = mDelayBuffer.GetSample(sampsAgoA, ch);
-         float nextSample = mDelayBuffer.GetSample(sampsAgoB, ch);
-         float a = delaySamps - sampsAgoA;
-         float delayedSample = (1-a)*sample + a*nextSample; //interpolate
+         float delayedSample = mDelayBuffer.Read(mDelaySamps[i], ch);
          
          float in = buffer->GetChannel(ch)[i];
 
          if (!mEcho && mAcceptInput) //single delay, no continuous feedback so do it pre
             mDelayBuffer.Write(buffer->GetChannel(ch)[i], ch);
 
-         float delayInput = delayedSample * mFeedback * (mInvert ? -1 : 1);
+         float delayInput = delayedSample * mAmounts[i] * (mInvert ? -1 : 1);
          JUCE_UNDENORMALISE(delayInput);
          if (delayInput == delayInput) //filter NaNs
             buffer->GetChannel(ch)[i] += delayInput;
@@ -138,8 +217,6 @@ void DelayEffect::ProcessAudio(double time, ChannelBuffer* buffer)
          if (!mDry)
             buffer->GetChannel(ch)[i] -= in;
       }
-
-      time += gInvSampleRateMs;
    }
 }
 
@@ -28,7 +28,7 @@
 
 #include <iostream>
 #include "IAudioEffect.h"
-#include "RollingBuffer.h"
+#include "DelayLine.h"
 #include "Slider.h"
 #include "Checkbox.h"
 #include "DropdownList.h"
@@ -74,11 +74,15 @@ private:
    void DrawModule() override;
    
    float GetMinDelayMs() const;
+   void ProcessPerSample(ChannelBuffer* buffer);
    
    float mDelay;
    float mFeedback;
    bool mEcho;
-   RollingBuffer mDelayBuffer;
+   DelayLine mDelayBuffer;
+   std::vector<float> mDelaySamps;
+   std::vector<float> mAmounts;
+   std::vector<float> mDelayedSamples;
    FloatSlider* mFeedbackSlider;
    FloatSlider* mDelaySlider;
    Checkbox* mEchoCheckbox;
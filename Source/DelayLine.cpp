@@ -0,0 +1,196 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    DelayLine.cpp
+    Created: 19 Oct 2026 2:41:08pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "DelayLine.h"
+#include "SynthGlobals.h"
+
+#include <functional>
+#include <vector>
+
+#include "juce_audio_basics/juce_audio_basics.h"
+
+namespace
+{
+   const int kChunkSize = 64;
+}
+
+DelayLine::DelayLine(int sizeInSamples)
+: RollingBuffer(sizeInSamples)
+{
+}
+
+float DelayLine::Read(float delaySamples, int channel)
+{
+   int sampsAgoA = int(delaySamples);
+   int sampsAgoB = sampsAgoA+1;
+   
+   float sample = GetSample(sampsAgoA, channel);
+   float nextSample = GetSample(sampsAgoB, channel);
+   float a = delaySamples - sampsAgoA;
+   return (1-a)*sample + a*nextSample; //interpolate
+}
+
+void DelayLine::ReadBlock(float* dst, int size, float delaySamples, int channel)
+{
+   assert(CanReadBlock(delaySamples, size));
+   assert(delaySamples < Size() - 1);
+   
+   int sampsAgo = int(delaySamples);
+   float a = delaySamples - sampsAgo;
+   float chunk[kChunkSize + 1];
+   for (int start = 0; start < size; start += kChunkSize)
+   {
+      int chunkSize = MIN(kChunkSize, size - start);
+      //the delay is constant, so the whole chunk is one contiguous read. chunk[i] is the sample after the one that sample i reads
+      ReadChunk(chunk, chunkSize + 1, sampsAgo - start - chunkSize, channel);
+      for (int i=0; i<chunkSize; ++i)
+         dst[start + i] = (1-a)*chunk[i+1] + a*chunk[i];
+   }
+}
+
+void DelayLine::ReadBlock(float* dst, int size, const float* delaySamples, int channel)
+{
+   const float* raw = GetRawBuffer()->GetChannel(channel);
+   int length = Size();
+   int now = GetRawBufferOffset(channel);
+   
+   int sampsAgo[kChunkSize];
+   float blend[kChunkSize];
+   for (int start = 0; start < size; start += kChunkSize)
+   {
+      int chunkSize = MIN(kChunkSize, size - start);
+      
+      //split the positions out first so this loop vectorizes, the reads below are a gather
+      for (int i=0; i<chunkSize; ++i)
+      {
+         sampsAgo[i] = int(delaySamples[start + i]);
+         blend[i] = delaySamples[start + i] - sampsAgo[i];
+      }
+      
+      for (int i=0; i<chunkSize; ++i)
+      {
+         assert(sampsAgo[i] > start + i && sampsAgo[i] < length - 1);
+         int posA = now + start + i - sampsAgo[i];
+         int posB = posA - 1;
+         if (posA < 0)
+            posA += length;
+         if (posB < 0)
+            posB += length;
+         dst[start + i] = (1-blend[i])*raw[posA] + blend[i]*raw[posB];
+      }
+   }
+}
+
+void DelayLine::AccumChunk(const float* samples, int size, int samplesAgo, int channel)
+{
+   assert(size + samplesAgo <= Size());
+   
+   float* raw = GetRawBuffer()->GetChannel(channel);
+   int offset = GetRawBufferOffset(channel) - samplesAgo;
+   if (offset < 0)
+      offset += Size();
+   
+   int wrapSamples = size - offset;
+   if (wrapSamples <= 0) //no wraparound
+   {
+      Add(raw+(offset-size), samples, size);
+   }
+   else  //wrap around loop point
+   {
+      Add(raw+(Size()-wrapSamples), samples, wrapSamples);
+      Add(raw, samples+wrapSamples, size-wrapSamples);
+   }
+}
+
+//static
+void DelayLine::RunBenchmark(int bufferSize)
+{
+   juce::ScopedNoDenormals noDenormals;
+   
+   const int kIterations = 20000;
+   
+   DelayLine line(5 * gSampleRate);
+   for (int i=0; i<line.Size(); ++i)
+      line.Write(ofRandom(-1, 1), 0);
+   
+   std::vector<float> output(bufferSize);
+   std::vector<float> delays(bufferSize);
+   float delaySamples = gSampleRate * .3f + .37f;
+   float rampStart = delaySamples;
+   
+   auto NanosecondsPerSample = [bufferSize](std::function<void()> process)
+   {
+      juce::int64 start = juce::Time::getHighResolutionTicks();
+      for (int i=0; i<kIterations; ++i)
+         process();
+      double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+      return seconds * 1e9 / kIterations / bufferSize;
+   };
+   
+   //each path reads with feedback, writing half of what it read back into the line
+   double perSampleConstant = NanosecondsPerSample([&]()
+   {
+      for (int i=0; i<bufferSize; ++i)
+      {
+         output[i] = line.Read(delaySamples, 0);
+         line.Write(output[i] * .5f, 0);
+      }
+   });
+   double blockConstant = NanosecondsPerSample([&]()
+   {
+      line.ReadBlock(output.data(), bufferSize, delaySamples, 0);
+      Mult(output.data(), .5f, bufferSize);
+      line.WriteChunk(output.data(), bufferSize, 0);
+   });
+   
+   auto FillRamp = [&]()
+   {
+      for (int i=0; i<bufferSize; ++i)
+         delays[i] = rampStart + i * .01f;
+      rampStart = delays[bufferSize-1] > gSampleRate * .6f ? delaySamples : delays[bufferSize-1];
+   };
+   double perSampleRamping = NanosecondsPerSample([&]()
+   {
+      FillRamp();
+      for (int i=0; i<bufferSize; ++i)
+      {
+         output[i] = line.Read(delays[i], 0);
+         line.Write(output[i] * .5f, 0);
+      }
+   });
+   double blockRamping = NanosecondsPerSample([&]()
+   {
+      FillRamp();
+      line.ReadBlock(output.data(), bufferSize, delays.data(), 0);
+      Mult(output.data(), .5f, bufferSize);
+      line.WriteChunk(output.data(), bufferSize, 0);
+   });
+   
+   ofLog() << "delay line benchmark: buffer size " << bufferSize << ", ns per sample";
+   ofLog() << "   constant delay: per sample " << ofToString(perSampleConstant, 2) << ", block " << ofToString(blockConstant, 2) << " (" << ofToString(perSampleConstant / blockConstant, 2) << "x)";
+   ofLog() << "   ramping delay:  per sample " << ofToString(perSampleRamping, 2) << ", block " << ofToString(blockRamping, 2) << " (" << ofToString(perSampleRamping / blockRamping, 2) << "x)";
+}
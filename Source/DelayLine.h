@@ -0,0 +1,50 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    DelayLine.h
+    Created: 19 Oct 2026 2:41:08pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RollingBuffer.h"
+
+//a RollingBuffer with linearly interpolated fractional delay reads.
+//delays are measured like RollingBuffer::GetSample(), from the current write position
+class DelayLine : public RollingBuffer
+{
+public:
+   DelayLine(int sizeInSamples);
+
+   float Read(float delaySamples, int channel);
+   //reads size samples, where sample i is read delaySamples behind the write position advanced by i.
+   //this matches calling Read() and then Write() once per sample, as long as the block never reads samples it would write itself, see CanReadBlock()
+   void ReadBlock(float* dst, int size, float delaySamples, int channel);
+   void ReadBlock(float* dst, int size, const float* delaySamples, int channel);
+   //adds to the size samples ending samplesAgo behind the write position, the counterpart of ReadChunk()
+   void AccumChunk(const float* samples, int size, int samplesAgo, int channel);
+
+   static bool CanReadBlock(float minDelaySamples, int size) { return int(minDelaySamples) >= size; }
+
+   static void RunBenchmark(int bufferSize);
+};
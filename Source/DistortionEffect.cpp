@@ -37,6 +37,8 @@ DistortionEffect::DistortionEffect()
 , mPreampSlider(nullptr)
 , mFuzzAmount(0)
 , mRemoveInputDC(true)
+, mOversample(1)
+, mOversampleDropdown(nullptr)
 {
    SetClip(1);
    
@@ -59,8 +61,11 @@ void DistortionEffect::CreateUIControls()
    FLOATSLIDER(mPreampSlider, "preamp", &mPreamp, 1, 10);
    FLOATSLIDER(mFuzzAmountSlider, "fuzz", &mFuzzAmount, -1, 1);
    CHECKBOX(mRemoveInputDCCheckbox, "center input", &mRemoveInputDC);
+   DROPDOWN(mOversampleDropdown, "oversample", &mOversample, 40);
    ENDUIBLOCK(mWidth, mHeight);
    
+   Oversampler::AddFactorLabels(mOversampleDropdown);
+   
    mTypeDropdown->AddLabel("clean", kClean);
    mTypeDropdown->AddLabel("warm", kWarm);
    mTypeDropdown->AddLabel("dirty", kDirty);
@@ -77,7 +82,12 @@ void DistortionEffect::ProcessAudio(double time, ChannelBuffer* buffer)
    if (!mEnabled)
       return;
    
-   float bufferSize = buffer->BufferSize();
+   int bufferSize = buffer->BufferSize();
+   
+   if (mOversampler.GetFactor() != mOversample)
+      mOversampler.SetFactor(mOversample);
+   const int factor = mOversampler.GetFactor();
+   const int numSamples = bufferSize * factor;
    
    for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
    {
@@ -86,60 +96,63 @@ void DistortionEffect::ProcessAudio(double time, ChannelBuffer* buffer)
 
       mPeakTracker[ch].Process(buffer->GetChannel(ch), bufferSize);
       
+      //only the shaping runs oversampled
+      float* samples = mOversampler.Upsample(buffer->GetChannel(ch), bufferSize, ch);
+      
       if (mType == kDirty)
       {
-         for (int i=0; i<bufferSize; ++i)
+         for (int i=0; i<numSamples; ++i)
          {
-            ComputeSliders(i);
-            buffer->GetChannel(ch)[i] = (ofClamp((buffer->GetChannel(ch)[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain, -1, 1)) / mGain;
+            ComputeSliders(i / factor);
+            samples[i] = (ofClamp((samples[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain, -1, 1)) / mGain;
          }
       }
       else if (mType == kClean)
       {
-         for (int i=0; i<bufferSize; ++i)
+         for (int i=0; i<numSamples; ++i)
          {
-            ComputeSliders(i);
-            buffer->GetChannel(ch)[i] = tanh((buffer->GetChannel(ch)[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain) / mGain;
+            ComputeSliders(i / factor);
+            samples[i] = tanh((samples[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain) / mGain;
          }
       }
       else if (mType == kWarm)
       {
-         for (int i=0; i<bufferSize; ++i)
+         for (int i=0; i<numSamples; ++i)
          {
-            ComputeSliders(i);
-            buffer->GetChannel(ch)[i] = sin((buffer->GetChannel(ch)[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain) / mGain;
+            ComputeSliders(i / factor);
+            samples[i] = sin((samples[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain) / mGain;
          }
       }
       else if (mType == kGrungy)
       {
-         for (int i = 0; i < bufferSize; ++i)
+         for (int i = 0; i < numSamples; ++i)
          {
-            ComputeSliders(i);
-            buffer->GetChannel(ch)[i] = asin(ofClamp((buffer->GetChannel(ch)[i] +  mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain, -1, 1)) / mGain;
+            ComputeSliders(i / factor);
+            samples[i] = asin(ofClamp((samples[i] +  mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain, -1, 1)) / mGain;
          }
       }
       //soft and asymmetric from http://www.music.mcgill.ca/~gary/courses/projects/618_2009/NickDonaldson/#Distortion
       else if (mType == kSoft)
       {
-         for (int i=0; i<bufferSize; ++i)
+         for (int i=0; i<numSamples; ++i)
          {
-            ComputeSliders(i);
-            float sample = (buffer->GetChannel(ch)[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain;
+            ComputeSliders(i / factor);
+            float sample = (samples[i] + mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain;
             if (sample > 1)
                sample = .66666f;
             else if (sample < -1)
                sample = -.66666f;
             else
                sample = sample - (sample*sample*sample)/3.0f;
-            buffer->GetChannel(ch)[i] = sample / mGain;
+            samples[i] = sample / mGain;
          }
       }
       else if (mType == kAsymmetric)
       {
-         for (int i=0; i<bufferSize; ++i)
+         for (int i=0; i<numSamples; ++i)
          {
-            ComputeSliders(i);
-            float sample = (buffer->GetChannel(ch)[i]*.5f+ mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain;
+            ComputeSliders(i / factor);
+            float sample = (samples[i]*.5f+ mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain;
             if (sample >= .320018f)
                sample = .630035f;
             else if (sample >= -.08905f)
@@ -148,15 +161,15 @@ void DistortionEffect::ProcessAudio(double time, ChannelBuffer* buffer)
                sample = -.75f*(1-powf(1-(fabsf(sample)-.032847f),12)+.333f*(fabsf(sample)-.032847f))+.01f;
             else
                sample = -.9818f;
-            buffer->GetChannel(ch)[i] = sample / mGain;
+            samples[i] = sample / mGain;
          }
       }
       else if (mType == kFold)
       {
-         for (int i=0; i<bufferSize; ++i)
+         for (int i=0; i<numSamples; ++i)
          {
-            ComputeSliders(i);
-            float sample = ofClamp((buffer->GetChannel(ch)[i]*.5f+ mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain, -100, 100);
+            ComputeSliders(i / factor);
+            float sample = ofClamp((samples[i]*.5f+ mFuzzAmount * mPeakTracker[ch].GetPeak()) * mPreamp * mGain, -100, 100);
             while (sample > 1 || sample < -1)
             {
                if (sample > 1)
@@ -164,9 +177,11 @@ void DistortionEffect::ProcessAudio(double time, ChannelBuffer* buffer)
                if (sample < -1)
                   sample = -2 - sample;
             }
-            buffer->GetChannel(ch)[i] = sample / mGain;
+            samples[i] = sample / mGain;
          }
       }
+      
+      mOversampler.Downsample(buffer->GetChannel(ch), bufferSize, ch);
    }
 }
 
@@ -192,6 +207,13 @@ void DistortionEffect::DrawModule()
    mPreampSlider->Draw();
    mRemoveInputDCCheckbox->Draw();
    mFuzzAmountSlider->Draw();
+   mOversampleDropdown->Draw();
+   
+   if (mOversampler.GetFactor() > 1)
+   {
+      ofRectangle rect = mOversampleDropdown->GetRect(K(local));
+      DrawTextNormal("+" + ofToString(mOversampler.GetLatency(), 1) + " smp", rect.getMaxX() + 4, rect.getMaxY() - 3, 11);
+   }
 }
 
 float DistortionEffect::GetEffectAmount()
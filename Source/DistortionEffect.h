@@ -33,6 +33,7 @@
 #include "DropdownList.h"
 #include "BiquadFilter.h"
 #include "PeakTracker.h"
+#include "Oversampler.h"
 
 class DistortionEffect : public IAudioEffect, public IFloatSliderListener, public IDropdownListener
 {
@@ -81,14 +82,17 @@ private:
    float mPreamp;
    float mFuzzAmount;
    bool mRemoveInputDC;
+   int mOversample;
    
    DropdownList* mTypeDropdown;
    FloatSlider* mClipSlider;
    FloatSlider* mPreampSlider;
    Checkbox* mRemoveInputDCCheckbox;
    FloatSlider* mFuzzAmountSlider;
+   DropdownList* mOversampleDropdown;
    BiquadFilter mDCRemover[ChannelBuffer::kMaxNumChannels];
    PeakTracker mPeakTracker[ChannelBuffer::kMaxNumChannels];
+   Oversampler mOversampler;
 };
 
 #endif /* defined(__modularSynth__DistortionEffect__) */
@@ -49,6 +49,8 @@ DropdownList::DropdownList(IDropdownListener* owner, const char* name, int x, in
 , mAutoCalculateWidth(false)
 , mDrawTriangle(true)
 , mLastScrolledTime(-9999)
+, mLastDisplayedValue(INT_MAX)
+, mLastDisplayedScrolling(false)
 {
    assert(owner);
    SetName(name);
@@ -86,6 +88,7 @@ void DropdownList::AddLabel(std::string label, int value)
    mHeight = itemSpacing;
    
    CalcSliderVal();
+   MarkNeedsDraw();
 }
 
 void DropdownList::RemoveLabel(int value)
@@ -100,6 +103,7 @@ void DropdownList::RemoveLabel(int value)
          mHeight = itemSpacing;
          
          CalcSliderVal();
+         MarkNeedsDraw();
          break;
       }
    }
@@ -140,6 +144,9 @@ void DropdownList::Poll()
 
 void DropdownList::Render()
 {
+   mLastDisplayedValue = *mVar;
+   mLastDisplayedScrolling = IsShowingScrollDisplay();
+   
    ofPushStyle();
    
    float xOffset = 0;
@@ -180,7 +187,7 @@ void DropdownList::Render()
    
    DrawHover(mX+xOffset, mY, w-xOffset, h);
    
-   if (mLastScrolledTime + 300 > gTime && TheSynth->GetTopModalFocusItem() != &mModalList && !Push2Control::sDrawingPush2Display && mElements.size() < mMaxPerColumn)
+   if (IsShowingScrollDisplay() && !Push2Control::sDrawingPush2Display)
    {
       const float kCentering = 7;
       float w, h;
@@ -296,6 +303,23 @@ void DropdownList::Clear()
    if (mAutoCalculateWidth)
       mWidth = 35;
    mHeight = itemSpacing;
+   MarkNeedsDraw();
+}
+
+bool DropdownList::IsShowingScrollDisplay() const
+{
+   return mLastScrolledTime + 300 > gTime && TheSynth->GetTopModalFocusItem() != &mModalList && mElements.size() < mMaxPerColumn;
+}
+
+bool DropdownList::CheckNeedsDraw()
+{
+   if (IUIControl::CheckNeedsDraw())
+      return true;
+   
+   if (IsShowingScrollDisplay() || mLastDisplayedScrolling)
+      return true;
+   
+   return *mVar != mLastDisplayedValue;
 }
 
 void DropdownList::SetFromMidiCC(float slider, bool setViaModulator /*= false*/)
@@ -109,6 +109,7 @@ public:
    bool InvertScrollDirection() override { return true; }
    void Increment(float amount) override;
    void Poll() override;
+   bool CheckNeedsDraw() override;
    void SaveState(FileStreamOut& out) override;
    void LoadState(FileStreamIn& in, bool shouldSetValue = true) override;
    
@@ -124,6 +125,7 @@ private:
    void SetValue(int value, bool forceUpdate);
    void CalculateWidth();
    void UpdateModalListPosition();
+   bool IsShowingScrollDisplay() const;
 
    int mWidth;
    int mHeight;
@@ -142,6 +144,8 @@ private:
    bool mAutoCalculateWidth;
    bool mDrawTriangle;
    double mLastScrolledTime;
+   int mLastDisplayedValue;
+   bool mLastDisplayedScrolling;
 };
 
 #endif /* defined(__modularSynth__DropdownList__) */
@@ -1004,7 +1004,7 @@ void DrumPlayer::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mQuantizeInterval;
+         transportListenerInfo->SetInterval(mQuantizeInterval);
    }
 }
 
@@ -0,0 +1,335 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    DynamicsCore.cpp
+    Created: 19 Oct 2026 9:31:08pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "DynamicsCore.h"
+#include "ChannelBuffer.h"
+#include "SynthGlobals.h"
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "juce_core/juce_core.h"
+#include "juce_audio_basics/juce_audio_basics.h"
+
+namespace
+{
+   const float kDbPerOctave = 6.02059991f;   //20 * log10(2)
+   const float kMinLevel = 1e-25f;
+   
+   //log2(1+t) and 2^t over [0,1), least squares fits
+   inline float Log2Mantissa(float t)
+   {
+      return (((-.080010877f * t + .315467609f) * t - .672934193f) * t + 1.43730217f) * t + .00010018903f;
+   }
+   
+   inline float Exp2Fraction(float t)
+   {
+      return (((.013683983f * t + .0517177353f) * t + .241621323f) * t + .692969551f) * t + 1.0000036f;
+   }
+}
+
+void DynamicsCore::LinkedPeak(ChannelBuffer* buffer, float* out, int bufferSize)
+{
+   const float* in = buffer->GetChannel(0);
+   for (int i=0; i<bufferSize; ++i)
+      out[i] = fabsf(in[i]);
+   for (int ch=1; ch<buffer->NumActiveChannels(); ++ch)
+   {
+      in = buffer->GetChannel(ch);
+      for (int i=0; i<bufferSize; ++i)
+         out[i] = MAX(out[i], fabsf(in[i]));
+   }
+}
+
+void DynamicsCore::LinToDb(const float* lin, float* db, int size)
+{
+   for (int i=0; i<size; ++i)
+   {
+      float x = MAX(lin[i], kMinLevel);
+      uint32_t bits;
+      memcpy(&bits, &x, sizeof(bits));
+      float exponent = float(int(bits >> 23) - 127);
+      bits = (bits & 0x007FFFFF) | 0x3F800000;   //mantissa as a float in [1,2)
+      float mantissa;
+      memcpy(&mantissa, &bits, sizeof(mantissa));
+      db[i] = (exponent + Log2Mantissa(mantissa - 1)) * kDbPerOctave;
+   }
+}
+
+void DynamicsCore::DbToLin(const float* db, float* lin, int size)
+{
+   const float kOctavesPerDb = 1 / kDbPerOctave;
+   for (int i=0; i<size; ++i)
+   {
+      float octaves = db[i] * kOctavesPerDb;
+      octaves = CLAMP(octaves, -126.0f, 127.0f);
+      float whole = float(int(octaves));
+      if (whole > octaves)
+         whole -= 1;
+      uint32_t bits = uint32_t(int(whole) + 127) << 23;
+      float scale;
+      memcpy(&scale, &bits, sizeof(scale));
+      lin[i] = Exp2Fraction(octaves - whole) * scale;
+   }
+}
+
+void DynamicsCore::ApplyGain(ChannelBuffer* buffer, const float* gain, int bufferSize)
+{
+   for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
+      Mult(buffer->GetChannel(ch), gain, bufferSize);
+}
+
+void DynamicsCore::Smooth(float* values, int size, float& state, float coef)
+{
+   float smoothed = state;
+   for (int i=0; i<size; ++i)
+   {
+      smoothed = values[i] + coef * (smoothed - values[i]);
+      values[i] = smoothed;
+   }
+   state = smoothed;
+}
+
+void DynamicsCore::FollowPeaks(const float* in, float* peaks, int size, float& peak, float decayScalar, float limit /*= -1*/)
+{
+   const float maxPeak = (limit == -1) ? FLT_MAX : limit;
+   float current = peak;
+   for (int i=0; i<size; ++i)
+   {
+      float input = fabsf(in[i]);
+      float decayed = current * decayScalar;
+      if (decayed < FLT_EPSILON)
+         decayed = 0;
+      current = (input >= current) ? MIN(input, maxPeak) : decayed;
+      if (peaks != nullptr)
+         peaks[i] = current;
+   }
+   peak = current;
+}
+
+float DynamicsCore::DecayScalar(float halfLifeSeconds)
+{
+   return powf(.5f, 1.0f / (halfLifeSeconds * gSampleRate));
+}
+
+DynamicsCore::AttackRelease::AttackRelease()
+: mState(kDenormalGuard)
+{
+   SetAttack(10);
+   SetRelease(100);
+}
+
+void DynamicsCore::AttackRelease::SetAttack(float ms)
+{
+   mAttackCoef = expf(-1000.0f / (ms * gSampleRate));
+}
+
+void DynamicsCore::AttackRelease::SetRelease(float ms)
+{
+   mReleaseCoef = expf(-1000.0f / (ms * gSampleRate));
+}
+
+void DynamicsCore::AttackRelease::Process(float* values, int size)
+{
+   float state = mState;
+   for (int i=0; i<size; ++i)
+   {
+      float in = values[i] + kDenormalGuard;
+      float coef = (in > state) ? mAttackCoef : mReleaseCoef;
+      state = in + coef * (state - in);
+      values[i] = state - kDenormalGuard;
+   }
+   mState = state;
+}
+
+DynamicsCore::GainComputer::GainComputer()
+: mThreshold(0)
+, mKnee(0)
+{
+   for (int i=0; i<=kKneeTableSize; ++i)
+   {
+      float u = float(i) / kKneeTableSize;
+      mKneeTable[i] = .5f * u * u;
+   }
+}
+
+void DynamicsCore::GainComputer::Process(const float* db, float* overDb, int size) const
+{
+   if (mKnee <= 0)
+   {
+      for (int i=0; i<size; ++i)
+      {
+         float over = db[i] - mThreshold;
+         overDb[i] = MAX(over, 0.0f);
+      }
+      return;
+   }
+   
+   const float halfKnee = mKnee * .5f;
+   const float invKnee = 1 / mKnee;
+   for (int i=0; i<size; ++i)
+   {
+      float over = db[i] - mThreshold;
+      float u = (over + halfKnee) * invKnee;
+      u = CLAMP(u, 0.0f, 1.0f);
+      float pos = u * kKneeTableSize;
+      int index = MIN(int(pos), kKneeTableSize - 1);
+      float blend = pos - index;
+      float knee = (mKneeTable[index] + blend * (mKneeTable[index + 1] - mKneeTable[index])) * mKnee;
+      overDb[i] = (over > halfKnee) ? over : knee;
+   }
+}
+
+DynamicsCore::Lookahead::Lookahead(int maxDelaySamples)
+: mDelay(maxDelaySamples + gBufferSize + 1)
+{
+}
+
+void DynamicsCore::Lookahead::Process(ChannelBuffer* buffer, int delaySamples)
+{
+   int bufferSize = buffer->BufferSize();
+   delaySamples = CLAMP(delaySamples, 0, mDelay.Size() - bufferSize);
+   mDelay.SetNumChannels(buffer->NumActiveChannels());
+   for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
+   {
+      //with no delay this reads back exactly what was just written
+      mDelay.WriteChunk(buffer->GetChannel(ch), bufferSize, ch);
+      mDelay.ReadChunk(buffer->GetChannel(ch), bufferSize, delaySamples, ch);
+   }
+}
+
+void DynamicsCore::RunBenchmark(int bufferSize)
+{
+   juce::ScopedNoDenormals noDenormals;
+   
+   const int kIterations = 5000;
+   const float kThreshold = -24;
+   const float kRatio = 4;
+   const int kLookaheadSamples = int(3 * gSampleRateMs);
+   
+   ChannelBuffer buffer(bufferSize);
+   std::vector<float> work(bufferSize);
+   
+   auto NanosecondsPerChannelSample = [bufferSize, &buffer](int numChannels, std::function<void()> process)
+   {
+      buffer.SetNumActiveChannels(numChannels);
+      juce::int64 start = juce::Time::getHighResolutionTicks();
+      for (int i=0; i<kIterations; ++i)
+      {
+         for (int ch=0; ch<numChannels; ++ch)
+         {
+            for (int j=0; j<bufferSize; ++j)
+               buffer.GetChannel(ch)[j] = sinf(j * .05f + ch) * ((i / 20) % 2 ? .9f : .05f);  //bursts, so the envelopes move
+         }
+         process();
+      }
+      double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+      return seconds * 1e9 / kIterations / bufferSize / numChannels;
+   };
+   
+   ofLog() << "dynamics benchmark: buffer size " << bufferSize << ", ns per sample per channel (includes filling the input)";
+   for (int numChannels = 1; numChannels <= 2; ++numChannels)
+   {
+      //the per sample compressor this replaced
+      RollingBuffer perSampleDelay(kLookaheadSamples + bufferSize + 1);
+      double envelope = kMinLevel;
+      const double attackCoef = exp(-1000.0 / (.1 * gSampleRate));
+      const double releaseCoef = exp(-1000.0 / (100 * gSampleRate));
+      double perSampleCompressor = NanosecondsPerChannelSample(numChannels, [&]()
+      {
+         perSampleDelay.SetNumChannels(numChannels);
+         for (int i=0; i<bufferSize; ++i)
+         {
+            float input = 0;
+            for (int ch=0; ch<numChannels; ++ch)
+               input = MAX(input, fabsf(buffer.GetChannel(ch)[i]));
+            double over = log(input + kMinLevel) * 8.6858896380650365 - kThreshold;
+            over = MAX(over, 0.0) + kMinLevel;
+            envelope = over + ((over > envelope) ? attackCoef : releaseCoef) * (envelope - over);
+            over = envelope - kMinLevel;
+            double invRatio = 1 / kRatio;
+            float gain = exp((over * (invRatio - 1) + (-kThreshold * .5) * (1 - invRatio)) * .11512925464970228);
+            for (int ch=0; ch<numChannels; ++ch)
+            {
+               perSampleDelay.Write(buffer.GetChannel(ch)[i], ch);
+               buffer.GetChannel(ch)[i] = perSampleDelay.GetSample(kLookaheadSamples + 1, ch) * gain;
+            }
+         }
+      });
+      
+      GainComputer gainComputer;
+      gainComputer.SetThreshold(kThreshold);
+      AttackRelease follower;
+      follower.SetAttack(.1f);
+      follower.SetRelease(100);
+      Lookahead lookahead(kLookaheadSamples + bufferSize);   //sized for gBufferSize, and this buffer could be bigger
+      double blockCompressor = NanosecondsPerChannelSample(numChannels, [&]()
+      {
+         const float invRatio = 1 / kRatio;
+         LinkedPeak(&buffer, work.data(), bufferSize);
+         LinToDb(work.data(), work.data(), bufferSize);
+         gainComputer.Process(work.data(), work.data(), bufferSize);
+         follower.Process(work.data(), bufferSize);
+         for (int i=0; i<bufferSize; ++i)
+            work[i] = work[i] * (invRatio - 1) + (-kThreshold * .5f) * (1 - invRatio);
+         DbToLin(work.data(), work.data(), bufferSize);
+         lookahead.Process(&buffer, kLookaheadSamples);
+         ApplyGain(&buffer, work.data(), bufferSize);
+      });
+      
+      //the per sample peak detector that the gate and peak trackers used
+      float peak = 0;
+      double perSamplePeaks = NanosecondsPerChannelSample(numChannels, [&]()
+      {
+         for (int i=0; i<bufferSize; ++i)
+         {
+            float scalar = powf(.5f, 1.0f / (.01f * gSampleRate));
+            float input = 0;
+            for (int ch=0; ch<numChannels; ++ch)
+               input = MAX(input, fabsf(buffer.GetChannel(ch)[i]));
+            if (input >= peak)
+               peak = input;
+            else
+               peak = (peak * scalar < FLT_EPSILON) ? 0 : peak * scalar;
+            for (int ch=0; ch<numChannels; ++ch)
+               buffer.GetChannel(ch)[i] *= peak;
+         }
+      });
+      double blockPeaks = NanosecondsPerChannelSample(numChannels, [&]()
+      {
+         LinkedPeak(&buffer, work.data(), bufferSize);
+         FollowPeaks(work.data(), work.data(), bufferSize, peak, DecayScalar(.01f));
+         ApplyGain(&buffer, work.data(), bufferSize);
+      });
+      
+      ofLog() << "   " << numChannels << " channel" << (numChannels > 1 ? "s" : "") << ":";
+      ofLog() << "      compressor: per sample " << ofToString(perSampleCompressor, 2) << ", block " << ofToString(blockCompressor, 2) << " (" << ofToString(perSampleCompressor / blockCompressor, 2) << "x)";
+      ofLog() << "      peak gate:  per sample " << ofToString(perSamplePeaks, 2) << ", block " << ofToString(blockPeaks, 2) << " (" << ofToString(perSamplePeaks / blockPeaks, 2) << "x)";
+   }
+}
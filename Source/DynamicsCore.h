@@ -0,0 +1,99 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    DynamicsCore.h
+    Created: 19 Oct 2026 9:31:08pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RollingBuffer.h"
+
+class ChannelBuffer;
+
+//shared pieces for compressors, gates and peak meters.
+//everything works on whole buffers, so apart from the envelope recursions the loops are free to vectorize
+namespace DynamicsCore
+{
+   //|x| of the loudest channel for each sample, so that linked channels share one detector
+   void LinkedPeak(ChannelBuffer* buffer, float* out, int bufferSize);
+   //polynomial approximations, good to about .001dB. levels are floored at 1e-25 (-500dB) to stay out of denormals
+   void LinToDb(const float* lin, float* db, int size);
+   void DbToLin(const float* db, float* lin, int size);
+   void ApplyGain(ChannelBuffer* buffer, const float* gain, int bufferSize);
+   //one pole lowpass, in place
+   void Smooth(float* values, int size, float& state, float coef);
+   //rides up to peaks of |in| instantly and decays by decayScalar per sample. peaks can be the same buffer as in, or nullptr if only the final peak matters.
+   //limit clamps new peaks, -1 for none
+   void FollowPeaks(const float* in, float* peaks, int size, float& peak, float decayScalar, float limit = -1);
+   //per sample scalar that halves a peak every halfLifeSeconds
+   float DecayScalar(float halfLifeSeconds);
+   
+   void RunBenchmark(int bufferSize);
+   
+   //one pole follower with separate coefficients for rising and falling, in place
+   class AttackRelease
+   {
+   public:
+      AttackRelease();
+      void SetAttack(float ms);
+      void SetRelease(float ms);
+      void Reset() { mState = kDenormalGuard; }
+      void Process(float* values, int size);
+      float GetValue() const { return mState - kDenormalGuard; }
+   private:
+      //kept in the state so it can never decay into denormals, and taken back out of the output
+      static constexpr float kDenormalGuard = 1e-25f;
+      
+      float mAttackCoef;
+      float mReleaseCoef;
+      float mState;
+   };
+   
+   //how far each level is over the threshold in db, eased in over the knee
+   class GainComputer
+   {
+   public:
+      GainComputer();
+      void SetThreshold(float db) { mThreshold = db; }
+      void SetKnee(float widthDb) { mKnee = widthDb; }
+      void Process(const float* db, float* overDb, int size) const;
+   private:
+      //quadratic knee shape over the knee width, normalized to a width of 1
+      static const int kKneeTableSize = 64;
+      float mKneeTable[kKneeTableSize + 1];
+      float mThreshold;
+      float mKnee;
+   };
+   
+   //delays the signal being processed, so that gain changes land on the transients that caused them instead of after
+   class Lookahead
+   {
+   public:
+      Lookahead(int maxDelaySamples);
+      //in place, on every active channel
+      void Process(ChannelBuffer* buffer, int delaySamples);
+   private:
+      RollingBuffer mDelay;
+   };
+}
@@ -68,6 +68,7 @@ private:
    //IDrawableModule
    void GetModuleDimensions(float& width, float& height) override;
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return mEnabled; }
 
    struct FilterBank
@@ -44,6 +44,8 @@ EQModule::EQModule()
    , mDrawGain(1)
 {
    // Generate a window with a single raised cosine from N/4 to 3N/4
+   mRollingInputBuffer.SetCaptureOnDemand(true);   //only needed for drawing the spectrum
+
    mWindower = new float[kNumFFTBins];
    for (int i = 0; i < kNumFFTBins; ++i)
       mWindower[i] = -.5f*cos(FTWO_PI*i / kNumFFTBins) + .5f;
@@ -58,11 +60,8 @@ EQModule::EQModule()
    {
       auto& filter = mFilters[i];
       filter.mEnabled = i < 4;
-      for (auto& biquad : filter.mFilter)
-      {
-         biquad.SetFilterParams(cutoffs[i], sqrtf(2)/2);
-         biquad.SetFilterType(types[i]);
-      }
+      filter.mFilter.SetFilterParams(cutoffs[i], sqrtf(2)/2);
+      filter.mFilter.SetFilterType(types[i]);
       filter.mNeedToCalculateCoefficients = true;
    }
 }
@@ -77,10 +76,10 @@ void EQModule::CreateUIControls()
       auto& filter = mFilters[i];
 
       CHECKBOX(filter.mEnabledCheckbox, ("enabled" + ofToString(i)).c_str(), &filter.mEnabled);
-      DROPDOWN(filter.mTypeSelector, ("type" + ofToString(i)).c_str(), (int*)(&filter.mFilter[0].mType), 45);
-      FLOATSLIDER(filter.mFSlider, ("f" + ofToString(i)).c_str(), &filter.mFilter[0].mF, 0, 10000);
-      FLOATSLIDER(filter.mGSlider, ("g" + ofToString(i)).c_str(), &filter.mFilter[0].mDbGain, -15, 15);
-      FLOATSLIDER(filter.mQSlider, ("q" + ofToString(i)).c_str(), &filter.mFilter[0].mQ, .1f, 18);
+      DROPDOWN(filter.mTypeSelector, ("type" + ofToString(i)).c_str(), (int*)(&filter.mFilter.mType), 45);
+      FLOATSLIDER(filter.mFSlider, ("f" + ofToString(i)).c_str(), &filter.mFilter.mF, 0, 10000);
+      FLOATSLIDER(filter.mGSlider, ("g" + ofToString(i)).c_str(), &filter.mFilter.mDbGain, -15, 15);
+      FLOATSLIDER(filter.mQSlider, ("q" + ofToString(i)).c_str(), &filter.mFilter.mQ, .1f, 18);
       UIBLOCK_NEWCOLUMN();
 
       filter.mTypeSelector->AddLabel("lp", kFilterType_Lowpass);
@@ -93,8 +92,8 @@ void EQModule::CreateUIControls()
 
       filter.mFSlider->SetMode(FloatSlider::kSquare);
       filter.mQSlider->SetMode(FloatSlider::kSquare);
-      filter.mGSlider->SetShowing(filter.mFilter[0].UsesGain());
-      filter.mQSlider->SetShowing(filter.mFilter[0].UsesQ());
+      filter.mGSlider->SetShowing(filter.mFilter.UsesGain());
+      filter.mQSlider->SetShowing(filter.mFilter.UsesQ());
    }
    ENDUIBLOCK0();
 }
@@ -111,14 +110,23 @@ void EQModule::Process(double time)
 
    ComputeSliders(0);
 
-   for (auto& filter : mFilters)
+   for (size_t i=0; i<mFilters.size(); ++i)
    {
+      auto& filter = mFilters[i];
       if (filter.mEnabled)
       {
          bool updated = filter.UpdateCoefficientsIfNecessary();
          if (updated)
             mNeedToUpdateFrequencyResponseGraph = true;
       }
+
+      for (auto& bank : mBanks)
+      {
+         if (filter.mEnabled)
+            bank.SetCoefficients(i, filter.mFilter);
+         else
+            bank.SetPassthrough(i);
+      }
    }
 
    IAudioReceiver* target = GetTarget();
@@ -138,29 +146,20 @@ void EQModule::Process(double time)
       for (int ch = 0; ch < GetBuffer()->NumActiveChannels(); ++ch)
       {
          BufferCopy(gWorkChannelBuffer.GetChannel(ch), GetBuffer()->GetChannel(ch), GetBuffer()->BufferSize());
-         for (auto& filter : mFilters)
-         {
-            if (filter.mEnabled)
-               filter.mFilter[ch].Filter(gWorkChannelBuffer.GetChannel(ch), GetBuffer()->BufferSize());
-         }
+         mBanks[ch].ProcessSeries(gWorkChannelBuffer.GetChannel(ch), GetBuffer()->BufferSize());
          //Add(gWorkChannelBuffer.GetChannel(ch), GetBuffer()->GetChannel(ch), GetBuffer()->BufferSize());
 
          Add(out->GetChannel(ch), gWorkChannelBuffer.GetChannel(ch), GetBuffer()->BufferSize());
          GetVizBuffer()->WriteChunk(gWorkChannelBuffer.GetChannel(ch), GetBuffer()->BufferSize(), ch);
       }
 
-      for (int ch = 0; ch < GetBuffer()->NumActiveChannels(); ++ch)
-         Add(gWorkBuffer, gWorkChannelBuffer.GetChannel(ch), GetBuffer()->BufferSize());
-
-      mRollingInputBuffer.WriteChunk(gWorkBuffer, GetBuffer()->BufferSize(), 0);
-
-      //copy rolling input buffer into working buffer and window it
-      mRollingInputBuffer.ReadChunk(mFFTData.mTimeDomain, kNumFFTBins, 0, 0);
-      Mult(mFFTData.mTimeDomain, mWindower, kNumFFTBins);
+      if (mRollingInputBuffer.IsCapturing())
+      {
+         for (int ch = 0; ch < GetBuffer()->NumActiveChannels(); ++ch)
+            Add(gWorkBuffer, gWorkChannelBuffer.GetChannel(ch), GetBuffer()->BufferSize());
 
-      mFFT.Forward(mFFTData.mTimeDomain,
-         mFFTData.mRealValues,
-         mFFTData.mImaginaryValues);
+         mRollingInputBuffer.WriteChunk(gWorkBuffer, GetBuffer()->BufferSize(), 0);
+      }
    }
    else   //passthrough
    {
@@ -180,12 +179,22 @@ void EQModule::DrawModule()
    if (Minimized() || IsVisible() == false)
       return;
 
+   mRollingInputBuffer.RequestCapture();
+
+   //copy rolling input buffer into working buffer and window it
+   mRollingInputBuffer.ReadChunk(mFFTData.mTimeDomain, kNumFFTBins, 0, 0);
+   Mult(mFFTData.mTimeDomain, mWindower, kNumFFTBins);
+
+   mFFT.Forward(mFFTData.mTimeDomain,
+      mFFTData.mRealValues,
+      mFFTData.mImaginaryValues);
+
    for (auto& filter : mFilters)
    {
       filter.mTypeSelector->SetShowing(filter.mEnabled);
       filter.mFSlider->SetShowing(filter.mEnabled);
-      filter.mGSlider->SetShowing(filter.mEnabled && filter.mFilter[0].UsesGain());
-      filter.mQSlider->SetShowing(filter.mEnabled && filter.mFilter[0].UsesQ());
+      filter.mGSlider->SetShowing(filter.mEnabled && filter.mFilter.UsesGain());
+      filter.mQSlider->SetShowing(filter.mEnabled && filter.mFilter.UsesQ());
 
       filter.mEnabledCheckbox->Draw();
       filter.mTypeSelector->Draw();
@@ -259,7 +268,7 @@ void EQModule::DrawModule()
             for (auto& filter : mFilters)
             {
                if (filter.mEnabled)
-                  response *= filter.mFilter[0].GetMagnitudeResponseAt(freq);
+                  response *= filter.mFilter.GetMagnitudeResponseAt(freq);
             }
             if (responseGraphIndex < mFrequencyResponse.size())
                mFrequencyResponse[responseGraphIndex] = response;
@@ -279,8 +288,8 @@ void EQModule::DrawModule()
       auto& filter = mFilters[i];
       if (filter.mEnabled)
       {
-         float x = PosForFreq(filter.mFilter[0].mF) * w;
-         float y = PosForGain(filter.mFilter[0].mDbGain) * h + kDrawYOffset;
+         float x = PosForFreq(filter.mFilter.mF) * w;
+         float y = PosForGain(filter.mFilter.mDbGain) * h + kDrawYOffset;
          ofFill();
          ofSetColor(255, 210, 0);
          ofCircle(x, y, 8);
@@ -303,9 +312,7 @@ bool EQModule::Filter::UpdateCoefficientsIfNecessary()
 {
    if (mNeedToCalculateCoefficients)
    {
-      mFilter[0].UpdateFilterCoeff();
-      for (size_t ch = 1; ch < mFilter.size(); ++ch)
-         mFilter[ch].CopyCoeffFrom(mFilter[0]);
+      mFilter.UpdateFilterCoeff();
       mNeedToCalculateCoefficients = false;
       return true;
    }
@@ -350,8 +357,8 @@ bool EQModule::MouseMoved(float x, float y)
       for (int i = 0; i < mFilters.size(); ++i)
       {
          if (mFilters[i].mEnabled &&
-             abs(x - PosForFreq(mFilters[i].mFilter[0].mF)*w) < 5 &&
-             abs((y - kDrawYOffset) - PosForGain(mFilters[i].mFilter[0].mDbGain)*h) < 5)
+             abs(x - PosForFreq(mFilters[i].mFilter.mF)*w) < 5 &&
+             abs((y - kDrawYOffset) - PosForGain(mFilters[i].mFilter.mDbGain)*h) < 5)
          {
             mHoveredFilterHandleIndex = i;
             break;
@@ -382,7 +389,7 @@ void EQModule::DropdownUpdated(DropdownList* list, int oldVal)
    {
       if (list == filter.mTypeSelector)
       {
-         filter.mFilter[0].SetFilterType(filter.mFilter[0].mType);
+         filter.mFilter.SetFilterType(filter.mFilter.mType);
          filter.mNeedToCalculateCoefficients = true;
       }
    }
@@ -390,12 +397,12 @@ void EQModule::DropdownUpdated(DropdownList* list, int oldVal)
 
 void EQModule::CheckboxUpdated(Checkbox* checkbox)
 {
-   for (auto& filter : mFilters)
+   for (size_t i=0; i<mFilters.size(); ++i)
    {
-      if (checkbox == filter.mEnabledCheckbox)
+      if (checkbox == mFilters[i].mEnabledCheckbox)
       {
-         filter.mFilter[0].Clear();
-         filter.mFilter[1].Clear();
+         for (auto& bank : mBanks)
+            bank.Clear(i);
          mNeedToUpdateFrequencyResponseGraph = true;
       }
    }
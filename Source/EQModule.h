@@ -33,6 +33,8 @@
 #include "FFT.h"
 #include "RollingBuffer.h"
 #include "BiquadFilter.h"
+#include "BiquadBank.h"
+#include "ChannelBuffer.h"
 #include "DropdownList.h"
 
 class EQModule : public IAudioProcessor, public IDrawableModule, public IFloatSliderListener, public IDropdownListener
@@ -92,7 +94,7 @@ private:
    struct Filter
    {
       bool mEnabled;
-      std::array<BiquadFilter,2> mFilter;
+      BiquadFilter mFilter;
       Checkbox* mEnabledCheckbox;
       DropdownList* mTypeSelector;
       FloatSlider* mFSlider;
@@ -104,6 +106,7 @@ private:
    };
 
    std::array<Filter, 8> mFilters;
+   std::array<BiquadBank, ChannelBuffer::kMaxNumChannels> mBanks;
    int mHoveredFilterHandleIndex;
    int mDragging;
    std::array<float, 1024> mFrequencyResponse;
@@ -363,6 +363,7 @@ void EventCanvas::ButtonClicked(ClickButton* button)
             element->mOffset = 0;
          }
       }
+      mCanvas->InvalidateElementIndex();
    }
 }
 
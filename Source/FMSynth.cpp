@@ -83,6 +83,7 @@ FMSynth::FMSynth()
    mVoiceParams.mPhaseOffset2 = 0;
    mVoiceParams.mVol = 1.f;
 
+   mVoiceParams.mBlock.Resize(gBufferSize);
    mPolyMgr.Init(kVoiceType_FM, &mVoiceParams);
 }
 
@@ -154,6 +155,16 @@ void FMSynth::Process(double time)
    assert(bufferSize == gBufferSize);
    
    mWriteBuffer.Clear();
+   if (mPolyMgr.GetNumActiveVoices() > 0)
+   {
+      //compute the modulated sliders once per sample here, instead of in every voice
+      mVoiceParams.mBlock.Resize(bufferSize);
+      for (int pos=0; pos<bufferSize; ++pos)
+      {
+         ComputeSliders(pos);
+         mVoiceParams.CaptureBlockValues(pos);
+      }
+   }
    mPolyMgr.Process(time, &mWriteBuffer, bufferSize);
    
    SyncOutputBuffer(mWriteBuffer.NumActiveChannels());
@@ -234,6 +245,10 @@ void FMSynth::DrawModule()
    DrawTextNormal("mod",mAdsrDisplayMod->GetPosition(true).x, mAdsrDisplayMod->GetPosition(true).y+10);
    DrawTextNormal("harm2",mAdsrDisplayHarm2->GetPosition(true).x, mAdsrDisplayHarm2->GetPosition(true).y+10);
    DrawTextNormal("mod2",mAdsrDisplayMod2->GetPosition(true).x, mAdsrDisplayMod2->GetPosition(true).y+10);
+
+   float width, height;
+   GetModuleDimensions(width, height);
+   mPolyMgr.DrawVoiceMeter(3, height - 4, width - 6, 2);
 }
 
 void FMSynth::DrawModuleUnclipped()
@@ -283,7 +298,7 @@ void FMSynth::CheckboxUpdated(Checkbox* checkbox)
 void FMSynth::LoadLayout(const ofxJSONElement& moduleInfo)
 {
    mModuleSaveData.LoadString("target", moduleInfo);
-   mModuleSaveData.LoadInt("voicelimit", moduleInfo, -1, -1, kNumVoices);
+   mModuleSaveData.LoadInt("voicelimit", moduleInfo, -1, -1, kMaxVoicePoolSize);
    EnumMap oversamplingMap;
    oversamplingMap["1"] = 1;
    oversamplingMap["2"] = 2;
@@ -31,6 +31,77 @@
 #include "ChannelBuffer.h"
 #include "PolyphonyMgr.h"
 
+namespace
+{
+   const int kChunkSize = 64;      //voices are rendered in chunks of this many samples, one stage at a time
+   const int kEnvelopeStep = 16;   //envelopes are evaluated every this many samples, and interpolated in between
+   
+   //sine of any phase, wrapped to [-pi,pi), folded to [-pi/2,pi/2] and evaluated with a 9th order polynomial.
+   //branchless so the loops that use it vectorize, error is below 1e-5
+   inline float FastSin(float phase)
+   {
+      float x = phase - FTWO_PI * floorf(phase * (1.0f / FTWO_PI) + .5f);
+      x = x > FPI * .5f ? FPI - x : x;
+      x = x < -FPI * .5f ? -FPI - x : x;
+      float x2 = x * x;
+      return x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880)))));
+   }
+   
+   void RenderEnvelope(const ::ADSR* adsr, double time, double sampleIncrementMs, float* out, int length)
+   {
+      float start = adsr->Value(time);
+      for (int i = 0; i < length; i += kEnvelopeStep)
+      {
+         int segment = MIN(kEnvelopeStep, length - i);
+         float end = adsr->Value(time + (i + segment) * sampleIncrementMs);
+         float step = (end - start) / segment;
+         for (int j = 0; j < segment; ++j)
+            out[i + j] = start + step * j;
+         start = end;
+      }
+   }
+   
+   void AccumulatePhase(float& phase, const float* phaseInc, float* phaseOut, int length)
+   {
+      for (int i = 0; i < length; ++i)
+      {
+         phase += phaseInc[i];
+         while (phase > FTWO_PI) { phase -= FTWO_PI; }
+         while (phase < 0) { phase += FTWO_PI; }
+         phaseOut[i] = phase;
+      }
+   }
+}
+
+void FMParamBlock::Resize(int size)
+{
+   if ((int)mModIdx.size() < size)
+   {
+      mModIdx.resize(size);
+      mHarmRatio.resize(size);
+      mModIdx2.resize(size);
+      mHarmRatio2.resize(size);
+      mVol.resize(size);
+      mPhaseOffset0.resize(size);
+      mPhaseOffset1.resize(size);
+      mPhaseOffset2.resize(size);
+   }
+   mSize = size;
+}
+
+void FMVoiceParams::CaptureBlockValues(int pos)
+{
+   assert(pos < mBlock.mSize);
+   mBlock.mModIdx[pos] = mModIdx;
+   mBlock.mHarmRatio[pos] = mHarmRatio;
+   mBlock.mModIdx2[pos] = mModIdx2;
+   mBlock.mHarmRatio2[pos] = mHarmRatio2;
+   mBlock.mVol[pos] = mVol;
+   mBlock.mPhaseOffset0[pos] = mPhaseOffset0;
+   mBlock.mPhaseOffset1[pos] = mPhaseOffset1;
+   mBlock.mPhaseOffset2[pos] = mPhaseOffset2;
+}
+
 FMVoice::FMVoice(IDrawableModule* owner)
 : mOscPhase(0)
 , mHarmPhase(0)
@@ -71,46 +142,129 @@ bool FMVoice::Process(double time, ChannelBuffer* out, int oversampling)
       bufferSize *= oversampling;
       sampleIncrementMs /= oversampling;
    }
-
-   for (int pos=0; pos<bufferSize; ++pos)
+   
+   const FMParamBlock& block = mVoiceParams->mBlock;
+   bool useBlock = block.mSize * oversampling >= bufferSize;
+   float phaseIncScale = gTwoPiOverSampleRate / oversampling;
+   float leftGain = GetLeftPanGain(GetPan());
+   float rightGain = GetRightPanGain(GetPan());
+   float lastPitch = -1;
+   float lastFreq = 0;
+   
+   //each chunk is rendered one stage at a time across all of its samples, with the operators' state laid out as arrays.
+   //only the phase accumulation has to be sequential
+   float oscEnv[kChunkSize];
+   float harmEnv[kChunkSize];
+   float harmEnv2[kChunkSize];
+   float modIdxEnv[kChunkSize];
+   float modIdxEnv2[kChunkSize];
+   float oscFreq[kChunkSize];
+   float harmFreq[kChunkSize];
+   float harmFreq2[kChunkSize];
+   float phaseInc[kChunkSize];
+   float phase[kChunkSize];
+   float modIdx[kChunkSize];
+   float modIdx2[kChunkSize];
+   float vol[kChunkSize];
+   float phaseOffset0[kChunkSize];
+   float phaseOffset1[kChunkSize];
+   float phaseOffset2[kChunkSize];
+   
+   for (int chunkStart = 0; chunkStart < bufferSize; chunkStart += kChunkSize)
    {
-      if (mOwner)
-         mOwner->ComputeSliders(pos/oversampling);
+      int length = MIN(kChunkSize, bufferSize - chunkStart);
+      
+      RenderEnvelope(mOsc.GetADSR(), time, sampleIncrementMs, oscEnv, length);
+      RenderEnvelope(mHarm.GetADSR(), time, sampleIncrementMs, harmEnv, length);
+      RenderEnvelope(mHarm2.GetADSR(), time, sampleIncrementMs, harmEnv2, length);
+      RenderEnvelope(&mModIdx, time, sampleIncrementMs, modIdxEnv, length);
+      RenderEnvelope(&mModIdx2, time, sampleIncrementMs, modIdxEnv2, length);
+      
+      for (int i = 0; i < length; ++i)
+      {
+         int samplesIn = (chunkStart + i) / oversampling;
+         if (useBlock)
+         {
+            modIdx[i] = block.mModIdx[samplesIn];
+            harmFreq[i] = block.mHarmRatio[samplesIn];
+            modIdx2[i] = block.mModIdx2[samplesIn];
+            harmFreq2[i] = block.mHarmRatio2[samplesIn];
+            vol[i] = block.mVol[samplesIn];
+            phaseOffset0[i] = block.mPhaseOffset0[samplesIn];
+            phaseOffset1[i] = block.mPhaseOffset1[samplesIn];
+            phaseOffset2[i] = block.mPhaseOffset2[samplesIn];
+         }
+         else
+         {
+            if (mOwner)
+               mOwner->ComputeSliders(samplesIn);
+            modIdx[i] = mVoiceParams->mModIdx;
+            harmFreq[i] = mVoiceParams->mHarmRatio;
+            modIdx2[i] = mVoiceParams->mModIdx2;
+            harmFreq2[i] = mVoiceParams->mHarmRatio2;
+            vol[i] = mVoiceParams->mVol;
+            phaseOffset0[i] = mVoiceParams->mPhaseOffset0;
+            phaseOffset1[i] = mVoiceParams->mPhaseOffset1;
+            phaseOffset2[i] = mVoiceParams->mPhaseOffset2;
+         }
+         
+         float pitch = GetPitch(samplesIn);
+         if (pitch != lastPitch)
+         {
+            lastPitch = pitch;
+            lastFreq = TheScale->PitchToFreq(pitch);
+         }
+         oscFreq[i] = lastFreq;
+      }
+      
+      //harmFreq and harmFreq2 hold the ratios until here
+      for (int i = 0; i < length; ++i)
+      {
+         harmFreq[i] = oscFreq[i] * harmEnv[i] * harmFreq[i];
+         harmFreq2[i] = harmFreq[i] * harmEnv2[i] * harmFreq2[i];
+         phaseInc[i] = harmFreq2[i] * phaseIncScale;
+      }
       
-      float oscFreq = TheScale->PitchToFreq(GetPitch(pos/oversampling));
-      float harmFreq = oscFreq * mHarm.GetADSR()->Value(time) * mVoiceParams->mHarmRatio;
-      float harmFreq2 = harmFreq * mHarm2.GetADSR()->Value(time) * mVoiceParams->mHarmRatio2;
+      AccumulatePhase(mHarmPhase2, phaseInc, phase, length);
       
-      float harmPhaseInc2 = GetPhaseInc(harmFreq2) / oversampling;
+      for (int i = 0; i < length; ++i)
+      {
+         float modHarmFreq = harmFreq[i] + FastSin(phase[i] + phaseOffset2[i]) * harmEnv2[i] * harmFreq2[i] * modIdxEnv2[i] * modIdx2[i];
+         phaseInc[i] = modHarmFreq * phaseIncScale;
+      }
       
-      mHarmPhase2 += harmPhaseInc2;
-      while (mHarmPhase2 > FTWO_PI) { mHarmPhase2 -= FTWO_PI; }
+      AccumulatePhase(mHarmPhase, phaseInc, phase, length);
       
-      float modHarmFreq = harmFreq + mHarm2.Audio(time, mHarmPhase2 + mVoiceParams->mPhaseOffset2) * harmFreq2 * mModIdx2.Value(time) * mVoiceParams->mModIdx2;
+      for (int i = 0; i < length; ++i)
+      {
+         float modOscFreq = oscFreq[i] + FastSin(phase[i] + phaseOffset1[i]) * harmEnv[i] * harmFreq[i] * modIdxEnv[i] * modIdx[i];
+         phaseInc[i] = modOscFreq * phaseIncScale;
+      }
       
-      float harmPhaseInc = GetPhaseInc(modHarmFreq) / oversampling;
+      AccumulatePhase(mOscPhase, phaseInc, phase, length);
+      
+      //reuse oscEnv for the output
+      for (int i = 0; i < length; ++i)
+         oscEnv[i] *= FastSin(phase[i] + phaseOffset0[i]) * vol[i] / 20.0f;
       
-      mHarmPhase += harmPhaseInc;
-      while (mHarmPhase > FTWO_PI) { mHarmPhase -= FTWO_PI; }
-
-      float modOscFreq = oscFreq + mHarm.Audio(time, mHarmPhase + mVoiceParams->mPhaseOffset1) * harmFreq * mModIdx.Value(time) * mVoiceParams->mModIdx;
-      float oscPhaseInc = GetPhaseInc(modOscFreq) / oversampling;
-
-      mOscPhase += oscPhaseInc;
-      while (mOscPhase > FTWO_PI) { mOscPhase -= FTWO_PI; }
-
-      float sample = mOsc.Audio(time, mOscPhase + mVoiceParams->mPhaseOffset0) * mVoiceParams->mVol/20.0f;
       if (channels == 1)
       {
-         destBuffer->GetChannel(0)[pos] += sample;
+         float* dest = destBuffer->GetChannel(0) + chunkStart;
+         for (int i = 0; i < length; ++i)
+            dest[i] += oscEnv[i];
       }
       else
       {
-         destBuffer->GetChannel(0)[pos] += sample * GetLeftPanGain(GetPan());
-         destBuffer->GetChannel(1)[pos] += sample * GetRightPanGain(GetPan());
+         float* destLeft = destBuffer->GetChannel(0) + chunkStart;
+         float* destRight = destBuffer->GetChannel(1) + chunkStart;
+         for (int i = 0; i < length; ++i)
+         {
+            destLeft[i] += oscEnv[i] * leftGain;
+            destRight[i] += oscEnv[i] * rightGain;
+         }
       }
-
-      time += sampleIncrementMs;
+      
+      time += length * sampleIncrementMs;
    }
 
    if (oversampling != 1)
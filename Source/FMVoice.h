@@ -27,6 +27,7 @@
 #define __modularSynth__FMVoice__
 
 #include <iostream>
+#include <vector>
 #include "OpenFrameworksPort.h"
 #include "IMidiVoice.h"
 #include "IVoiceParams.h"
@@ -35,9 +36,28 @@
 
 class IDrawableModule;
 
+//per-sample values of the modulatable FMVoiceParams for the current buffer.
+//the owner computes its sliders once per sample and fills this in, rather than every voice doing it
+struct FMParamBlock
+{
+   void Resize(int size);
+   
+   int mSize { 0 };  //0 if the owner didn't fill it in, and the voices should use the plain values
+   std::vector<float> mModIdx;
+   std::vector<float> mHarmRatio;
+   std::vector<float> mModIdx2;
+   std::vector<float> mHarmRatio2;
+   std::vector<float> mVol;
+   std::vector<float> mPhaseOffset0;
+   std::vector<float> mPhaseOffset1;
+   std::vector<float> mPhaseOffset2;
+};
+
 class FMVoiceParams : public IVoiceParams
 {
 public:
+   void CaptureBlockValues(int pos);
+   
    ::ADSR mOscADSRParams;
    ::ADSR mModIdxADSRParams;
    ::ADSR mHarmRatioADSRParams;
@@ -51,6 +71,7 @@ public:
    float mPhaseOffset0;
    float mPhaseOffset1;
    float mPhaseOffset2;
+   FMParamBlock mBlock;
 };
 
 class FMVoice : public IMidiVoice
@@ -66,6 +87,7 @@ public:
    bool Process(double time, ChannelBuffer* out, int oversampling) override;
    void SetVoiceParams(IVoiceParams* params) override;
    bool IsDone(double time) override;
+   float GetEnvelopeLevel(double time) override { return mOsc.GetADSR()->Value(time); }
 private:
    float mOscPhase;
    EnvOscillator mOsc;
@@ -25,12 +25,14 @@
 
 #include "FileStream.h"
 #include "ModularSynth.h"
+#include "RealtimeSafetyChecker.h"
 
 #include "juce_core/juce_core.h"
 
 FileStreamOut::FileStreamOut(const std::string& file)
 : mStream(std::make_unique<juce::FileOutputStream>(juce::File{file}))
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_FileAccess, "FileStreamOut");
    mStream->setPosition(0);
    mStream->truncate();
 }
@@ -43,6 +45,7 @@ FileStreamOut::~FileStreamOut()
 FileStreamIn::FileStreamIn(const std::string& file)
 : mStream(std::make_unique<juce::FileInputStream>(juce::File{file}))
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_FileAccess, "FileStreamIn");
 }
 
 FileStreamIn::~FileStreamIn() = default;
@@ -37,13 +37,21 @@ FormantFilterEffect::FormantFilterEffect()
 , mU(0)
 , mA(0)
 , mRescaling(false)
+, mBank(NUM_FORMANT_BANDS * ChannelBuffer::kMaxNumChannels)
 {
    SetEnabled(true);
    
-   mOutputBuffer = new float[gBufferSize];
+   for (int i=0; i<NUM_FORMANT_BANDS * ChannelBuffer::kMaxNumChannels; ++i)
+      mBandBuffers[i] = new float[gBufferSize];
    
    for (int i=0; i<NUM_FORMANT_BANDS; ++i)
+   {
       mBiquads[i].SetFilterType(kFilterType_Bandpass);
+      mBiquads[i].UpdateFilterCoeff();
+   }
+   for (int i=0; i<NUM_FORMANT_BANDS * ChannelBuffer::kMaxNumChannels; ++i)
+      mBank.SetCoefficients(i, mBiquads[i % NUM_FORMANT_BANDS]);
+   mBank.SnapCoefficients();
    
    mFormants.push_back(Formants(400,1,  1700,.35f,   2300,.4f));  //EE
    mFormants.push_back(Formants(360,1,   750,.25f,   2400,.035f));//OO
@@ -75,6 +83,8 @@ void FormantFilterEffect::CreateUIControls()
 
 FormantFilterEffect::~FormantFilterEffect()
 {
+   for (int i=0; i<NUM_FORMANT_BANDS * ChannelBuffer::kMaxNumChannels; ++i)
+      delete[] mBandBuffers[i];
 }
 
 void FormantFilterEffect::Init()
@@ -89,22 +99,29 @@ void FormantFilterEffect::ProcessAudio(double time, ChannelBuffer* buffer)
    if (!mEnabled)
       return;
    
-   float bufferSize = buffer->BufferSize();
+   int bufferSize = buffer->BufferSize();
    
    ComputeSliders(0);
    
    assert(gBufferSize == bufferSize);
-   Clear(mOutputBuffer, bufferSize);
    
-   //TODO(Ryan)
-   /*for (int i=0; i<NUM_FORMANT_BANDS; ++i)
+   //every channel/band pair gets its own lane in the bank
+   const float* inputs[NUM_FORMANT_BANDS * ChannelBuffer::kMaxNumChannels];
+   for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
    {
-      BufferCopy(gWorkBuffer, audio, bufferSize);
-      mBiquads[i].Filter(gWorkBuffer, bufferSize);
-      Add(mOutputBuffer, gWorkBuffer, bufferSize);
+      for (int i=0; i<NUM_FORMANT_BANDS; ++i)
+         inputs[ch * NUM_FORMANT_BANDS + i] = buffer->GetChannel(ch);
    }
+   mBank.SetNumFilters(buffer->NumActiveChannels() * NUM_FORMANT_BANDS);
+   mBank.ProcessParallel(inputs, mBandBuffers, bufferSize);
    
-   BufferCopy(audio, gWorkBuffer, bufferSize);*/
+   for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
+   {
+      float* audio = buffer->GetChannel(ch);
+      Clear(audio, bufferSize);
+      for (int i=0; i<NUM_FORMANT_BANDS; ++i)
+         Add(audio, mBandBuffers[ch * NUM_FORMANT_BANDS + i], bufferSize);
+   }
 }
 
 void FormantFilterEffect::DrawModule()
@@ -126,8 +143,7 @@ float FormantFilterEffect::GetEffectAmount()
 
 void FormantFilterEffect::ResetFilters()
 {
-   for (int i=0; i<NUM_FORMANT_BANDS; ++i)
-      mBiquads[i].Clear();
+   mBank.Clear();
 }
 
 void FormantFilterEffect::UpdateFilters()
@@ -156,6 +172,8 @@ void FormantFilterEffect::UpdateFilters()
    const float bandwidth = 100;
    for (int i=0; i<NUM_FORMANT_BANDS; ++i)
       mBiquads[i].SetFilterParams(formant[i], formant[i]/(bandwidth/2));
+   for (int i=0; i<NUM_FORMANT_BANDS * ChannelBuffer::kMaxNumChannels; ++i)
+      mBank.SetCoefficients(i, mBiquads[i % NUM_FORMANT_BANDS]);
 }
 
 void FormantFilterEffect::DropdownUpdated(DropdownList* list, int oldVal)
@@ -32,6 +32,7 @@
 #include "Slider.h"
 #include "Transport.h"
 #include "BiquadFilter.h"
+#include "BiquadBank.h"
 #include "RadioButton.h"
 
 class FormantFilterEffect : public IAudioEffect, public IDropdownListener, public IFloatSliderListener, public IRadioButtonListener
@@ -66,6 +67,7 @@ private:
    //IDrawableModule
    void GetModuleDimensions(float& width, float& height) override { width = mWidth; height = mHeight; }
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return mEnabled; }
    
    void ResetFilters();
@@ -73,6 +75,8 @@ private:
    
 #define NUM_FORMANT_BANDS 3
    BiquadFilter mBiquads[NUM_FORMANT_BANDS];
+   BiquadBank mBank;
+   float* mBandBuffers[NUM_FORMANT_BANDS * ChannelBuffer::kMaxNumChannels];
    float* mDryBuffer;
    int mDryBufferSize;
    float mEE;
@@ -109,7 +113,6 @@ private:
    };
    
    std::vector<Formants> mFormants;
-   float* mOutputBuffer;
 };
 
 #endif /* defined(__Bespoke__FormantFilter__) */
@@ -78,13 +78,13 @@ void FourOnTheFloor::CheckboxUpdated(Checkbox* checkbox)
       {
          TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
          if (transportListenerInfo != nullptr)
-            transportListenerInfo->mInterval = kInterval_2n;
+            transportListenerInfo->SetInterval(kInterval_2n);
       }
       else
       {
          TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
          if (transportListenerInfo != nullptr)
-            transportListenerInfo->mInterval = kInterval_4n;
+            transportListenerInfo->SetInterval(kInterval_4n);
       }
    }
 }
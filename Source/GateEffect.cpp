@@ -26,6 +26,7 @@
 #include "GateEffect.h"
 #include "SynthGlobals.h"
 #include "Profiler.h"
+#include "DynamicsCore.h"
 
 GateEffect::GateEffect()
 : mThreshold(.1f)
@@ -56,41 +57,26 @@ void GateEffect::ProcessAudio(double time, ChannelBuffer* buffer)
    if (!mEnabled)
       return;
    
-   float bufferSize = buffer->BufferSize();
+   int bufferSize = buffer->BufferSize();
 
    ComputeSliders(0);
 
+   float* gain = gWorkBuffer;
+   DynamicsCore::LinkedPeak(buffer, gain, bufferSize);
+   DynamicsCore::FollowPeaks(gain, gain, bufferSize, mPeak, DynamicsCore::DecayScalar(.01f));
+
+   //the envelope ramps linearly, so it has to run serially, but it's cheap next to the detection
+   float attackStep = gInvSampleRateMs / mAttackTime;
+   float releaseStep = gInvSampleRateMs / mReleaseTime;
+   float envelope = mEnvelope;
    for (int i=0; i<bufferSize; ++i)
    {
-      const float decayTime = .01f;
-      float scalar = powf( 0.5f, 1.0f/(decayTime * gSampleRate));
-      float input = 0;
-      for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
-         input = MAX(input, fabsf(buffer->GetChannel(ch)[i]));
-
-      if ( input >= mPeak )
-      {
-         /* When we hit a peak, ride the peak to the top. */
-         mPeak = input;
-      }
-      else
-      {
-         /* Exponential decay of output when signal is low. */
-         mPeak = mPeak * scalar;
-         if(mPeak < FLT_EPSILON)
-            mPeak = 0.0;
-      }
-
-      if (mPeak >= mThreshold && mEnvelope < 1)
-         mEnvelope = MIN(1, mEnvelope+gInvSampleRateMs/mAttackTime );
-      if (mPeak < mThreshold && mEnvelope > 0)
-         mEnvelope = MAX(0, mEnvelope-gInvSampleRateMs/mReleaseTime );
-
-      for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
-         buffer->GetChannel(ch)[i] *= mEnvelope;
-
-      time += gInvSampleRateMs;
+      envelope = ofClamp(envelope + ((gain[i] >= mThreshold) ? attackStep : -releaseStep), 0, 1);
+      gain[i] = envelope;
    }
+   mEnvelope = envelope;
+
+   DynamicsCore::ApplyGain(buffer, gain, bufferSize);
 }
 
 void GateEffect::DrawModule()
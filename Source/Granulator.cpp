@@ -28,12 +28,75 @@
 #include "Profiler.h"
 #include "ChannelBuffer.h"
 
+namespace
+{
+   const int kWindowTableSize = 1024;
+   const int kGrainChunkSize = 64;
+   
+   //windows are looked up from tables with linear interpolation, instead of evaluated per sample
+   struct GrainWindowTables
+   {
+      GrainWindowTables()
+      {
+         const float kTukeyTaper = .5f;   //fraction of the grain that fades in and out
+         const float kGaussianSigma = .4f;
+         float gaussianEdge = expf(-.5f / (kGaussianSigma * kGaussianSigma));
+         for (int i = 0; i <= kWindowTableSize; ++i)
+         {
+            float phase = float(i) / kWindowTableSize;
+            
+            mTables[kGrainWindow_Hann][i] = .5f * (1 - cosf(phase * FTWO_PI));
+            
+            float edge = MIN(phase, 1 - phase);
+            if (edge < kTukeyTaper / 2)
+               mTables[kGrainWindow_Tukey][i] = .5f * (1 - cosf(FTWO_PI * edge / kTukeyTaper));
+            else
+               mTables[kGrainWindow_Tukey][i] = 1;
+            
+            //gaussian, lowered so that it reaches zero at the edges
+            float x = (phase - .5f) * 2;
+            float gaussian = expf(-.5f * (x * x) / (kGaussianSigma * kGaussianSigma));
+            mTables[kGrainWindow_Gaussian][i] = MAX(0, (gaussian - gaussianEdge) / (1 - gaussianEdge));
+         }
+         //one extra entry for interpolation past the end
+         for (int type = 0; type < kNumGrainWindowTypes; ++type)
+            mTables[type][kWindowTableSize + 1] = mTables[type][kWindowTableSize];
+      }
+      
+      float mTables[kNumGrainWindowTypes][kWindowTableSize + 2];
+   };
+   
+   const float* GetWindowTable(GrainWindowType type)
+   {
+      static GrainWindowTables sTables;
+      return sTables.mTables[type];
+   }
+   
+   float LookupWindow(const float* table, double phase)
+   {
+      if (phase <= 0 || phase >= 1)
+         return 0;
+      float index = phase * kWindowTableSize;
+      int i = int(index);
+      float a = index - i;
+      return table[i] + (table[i + 1] - table[i]) * a;
+   }
+}
+
 Granulator::Granulator()
-: mNextGrainIdx(0)
-, mNextGrainSpawnMs(0)
+: mNextGrainSpawnMs(0)
+, mGrainCap(MAX_GRAINS)
 , mLiveMode(false)
 , mOctaves(false)
+, mWindowType(kGrainWindow_Hann)
 {
+   //allocate the whole pool up front, raising the cap never allocates on the audio thread
+   mGrains.resize(MAX_GRAIN_CAP);
+   mActiveGrains.reserve(MAX_GRAIN_CAP);
+   mFreeGrains.reserve(MAX_GRAIN_CAP);
+   for (int i = MAX_GRAIN_CAP - 1; i >= 0; --i)
+      mFreeGrains.push_back(i);
+   
    Reset();
 }
 
@@ -59,23 +122,79 @@ void Granulator::Reset()
 
 void Granulator::ProcessFrame(double time, ChannelBuffer* buffer, int bufferLength, double offset, float* output)
 {
-   if (time + gInvSampleRateMs >= mNextGrainSpawnMs)
+   float* outputs[ChannelBuffer::kMaxNumChannels];
+   for (int ch = 0; ch < ChannelBuffer::kMaxNumChannels; ++ch)
+      outputs[ch] = &output[ch];
+   Render(time, buffer, bufferLength, &offset, outputs, 1);
+}
+
+void Granulator::ProcessBlock(double time, ChannelBuffer* buffer, int bufferLength, const double* offsets, ChannelBuffer* output, int numSamples)
+{
+   PROFILER(Granulator);
+   
+   assert(numSamples <= output->BufferSize());
+   output->SetNumActiveChannels(buffer->NumActiveChannels());
+   float* outputs[ChannelBuffer::kMaxNumChannels];
+   for (int ch = 0; ch < buffer->NumActiveChannels(); ++ch)
+      outputs[ch] = output->GetChannel(ch);
+   Render(time, buffer, bufferLength, offsets, outputs, numSamples);
+}
+
+void Granulator::Render(double time, ChannelBuffer* buffer, int bufferLength, const double* offsets, float* const* output, int numSamples)
+{
+   int channels = buffer->NumActiveChannels();
+   for (int ch = 0; ch < channels; ++ch)
+      ::Clear(output[ch], numSamples);
+   
+   //grains are rendered in runs between spawns, so a grain that gets replaced still plays up until that point
+   int renderedUpTo = 0;
+   for (int i = 0; i < numSamples; ++i)
    {
-      double startFromMs = mNextGrainSpawnMs;
-      if (startFromMs < time - 1000)   //must have recently started processing, reset
-         startFromMs = time;
-      SpawnGrain(mNextGrainSpawnMs, offset, buffer->NumActiveChannels() == 2 ? mWidth : 0);
-      mNextGrainSpawnMs = startFromMs + mGrainLengthMs * 1/mGrainOverlap * ofRandom(1-mSpacingRandomize/2,1+mSpacingRandomize/2);
+      double sampleTime = time + i * gInvSampleRateMs;
+      if (sampleTime + gInvSampleRateMs >= mNextGrainSpawnMs)
+      {
+         RenderGrains(time, buffer, bufferLength, output, renderedUpTo, i);
+         renderedUpTo = i;
+         
+         double startFromMs = mNextGrainSpawnMs;
+         if (startFromMs < sampleTime - 1000)   //must have recently started processing, reset
+            startFromMs = sampleTime;
+         SpawnGrain(mNextGrainSpawnMs, offsets[i], channels == 2 ? mWidth : 0);
+         mNextGrainSpawnMs = startFromMs + mGrainLengthMs * 1/mGrainOverlap * ofRandom(1-mSpacingRandomize/2,1+mSpacingRandomize/2);
+      }
    }
+   RenderGrains(time, buffer, bufferLength, output, renderedUpTo, numSamples);
    
-   for (int i=0; i<MAX_GRAINS; ++i)
-      mGrains[i].Process(time, buffer, bufferLength, output);
-   
-   for (int ch = 0; ch < buffer->NumActiveChannels(); ++ch)
+   for (int ch = 0; ch < channels; ++ch)
    {
       if (mGrainOverlap > 4)
-         output[ch] *= ofMap(mGrainOverlap, MAX_GRAINS, 4, .5f, 1);   //lower volume on dense granulation, starting at 4 overlap
-      output[ch] = mBiquad[ch].Filter(output[ch]);
+         Mult(output[ch], ofMap(mGrainOverlap, MAX_GRAINS, 4, .5f, 1), numSamples);   //lower volume on dense granulation, starting at 4 overlap
+      if (numSamples == 1)
+         output[ch][0] = mBiquad[ch].Filter(output[ch][0]);
+      else
+         mBiquad[ch].Filter(output[ch], numSamples);
+   }
+}
+
+void Granulator::RenderGrains(double time, ChannelBuffer* buffer, int bufferLength, float* const* output, int startSample, int endSample)
+{
+   if (startSample >= endSample)
+      return;
+   
+   const float* window = GetWindowTable(mWindowType);
+   for (int i = 0; i < (int)mActiveGrains.size();)
+   {
+      int grainIdx = mActiveGrains[i];
+      if (mGrains[grainIdx].Render(time, buffer, bufferLength, window, output, startSample, endSample))
+      {
+         ++i;
+      }
+      else
+      {
+         mActiveGrains[i] = mActiveGrains.back();
+         mActiveGrains.pop_back();
+         mFreeGrains.push_back(grainIdx);
+      }
    }
 }
 
@@ -107,21 +226,42 @@ void Granulator::SpawnGrain(double time, double offset, float width)
       }
    }
    offset += ofRandom(-mPosRandomizeMs, mPosRandomizeMs) / gInvSampleRateMs;
-   mGrains[mNextGrainIdx].Spawn(this, time, offset, speedMult, mGrainLengthMs, vol, width);
    
-   mNextGrainIdx = (mNextGrainIdx+1) % MAX_GRAINS;
+   int grainIdx;
+   if ((int)mActiveGrains.size() < mGrainCap && !mFreeGrains.empty())
+   {
+      grainIdx = mFreeGrains.back();
+      mFreeGrains.pop_back();
+      mActiveGrains.push_back(grainIdx);
+   }
+   else
+   {
+      //at the cap, replace the oldest grain
+      int oldest = 0;
+      for (int i = 1; i < (int)mActiveGrains.size(); ++i)
+      {
+         if (mGrains[mActiveGrains[i]].GetStartTime() < mGrains[mActiveGrains[oldest]].GetStartTime())
+            oldest = i;
+      }
+      grainIdx = mActiveGrains[oldest];
+   }
+   mGrains[grainIdx].Spawn(this, time, offset, speedMult, mGrainLengthMs, vol, width);
 }
 
 void Granulator::Draw(float x, float y, float w, float h, int bufferStart, int viewLength, int bufferLength)
 {
-   for (int i=0; i<MAX_GRAINS; ++i)
+   for (int i=0; i<(int)mGrains.size(); ++i)
       mGrains[i].DrawGrain(i, x, y, w, h, bufferStart, viewLength, bufferLength);
 }
 
 void Granulator::ClearGrains()
 {
-   for (int i=0; i<MAX_GRAINS; ++i)
-      mGrains[i].Clear();
+   for (int grainIdx : mActiveGrains)
+   {
+      mGrains[grainIdx].Clear();
+      mFreeGrains.push_back(grainIdx);
+   }
+   mActiveGrains.clear();
 }
 
 void Grain::Spawn(Granulator* owner, double time, double pos, float speedMult, float lengthInMs, float vol, float width)
@@ -136,18 +276,88 @@ void Grain::Spawn(Granulator* owner, double time, double pos, float speedMult, f
    mDrawPos = ofRandom(1);
 }
 
-void Grain::Process(double time, ChannelBuffer* buffer, int bufferLength, float* output)
+//renders the samples in [startSample, endSample) of a block starting at time, returns false once the grain has finished
+bool Grain::Render(double time, ChannelBuffer* buffer, int bufferLength, const float* window, float* const* output, int startSample, int endSample)
 {
-   if (time >= mStartTime && time <= mEndTime && mVol != 0)
+   if (mVol == 0)
+      return false;
+   
+   //the samples of this range that fall within the grain, with some slack for grains that start exactly on a sample
+   const double kEpsilon = .0001;
+   int first = MAX(startSample, (int)ceil((mStartTime - time) / gInvSampleRateMs - kEpsilon));
+   int last = MIN(endSample, (int)floor((mEndTime - time) / gInvSampleRateMs + kEpsilon) + 1);
+   
+   if (first < last && bufferLength > 0)
    {
-      mPos += mSpeedMult * mOwner->mSpeed;
-      float window = GetWindow(time);
-      for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
+      int channels = buffer->NumActiveChannels();
+      double speed = mSpeedMult * mOwner->mSpeed;
+      double invLength = 1.0 / (mEndTime - mStartTime);
+      
+      //per-channel source blend and gain, same as reading with GetInterpolatedSample() with a channel blend
+      float blend[2];
+      float gain[2];
+      for (int ch = 0; ch < 2; ++ch)
       {
-         float sample = GetInterpolatedSample(mPos, buffer, bufferLength, ofClamp(ch + mStereoPosition, 0, 1));
-         output[ch] += sample * window * mVol * (1 + (ch == 0 ? mStereoPosition : -mStereoPosition));
+         blend[ch] = ofClamp(ch + mStereoPosition, 0, 1);
+         gain[ch] = mVol * (1 + (ch == 0 ? mStereoPosition : -mStereoPosition));
       }
+      
+      const float* left = buffer->GetChannel(0);
+      const float* right = channels > 1 ? buffer->GetChannel(1) : left;
+      
+      double readPos = mPos;
+      FloatWrap(readPos, bufferLength);
+      
+      float windowChunk[kGrainChunkSize];
+      float leftChunk[kGrainChunkSize];
+      float rightChunk[kGrainChunkSize];
+      for (int chunkStart = first; chunkStart < last; chunkStart += kGrainChunkSize)
+      {
+         int length = MIN(kGrainChunkSize, last - chunkStart);
+         
+         //the reads themselves can't be vectorized, so gather them into arrays first
+         for (int i = 0; i < length; ++i)
+         {
+            readPos += speed;
+            if (readPos >= bufferLength)
+               readPos -= bufferLength;
+            else if (readPos < 0)
+               readPos += bufferLength;
+            
+            int pos = int(readPos);
+            int posNext = pos + 1 < bufferLength ? pos + 1 : 0;
+            float a = readPos - pos;
+            leftChunk[i] = left[pos] + (left[posNext] - left[pos]) * a;
+            rightChunk[i] = right[pos] + (right[posNext] - right[pos]) * a;
+            
+            double sampleTime = time + (chunkStart + i) * gInvSampleRateMs;
+            windowChunk[i] = LookupWindow(window, (sampleTime - mStartTime) * invLength);
+         }
+         
+         if (channels == 1)
+         {
+            float* out = output[0] + chunkStart;
+            for (int i = 0; i < length; ++i)
+               out[i] += leftChunk[i] * windowChunk[i] * mVol;
+         }
+         else
+         {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+               float* out = output[ch] + chunkStart;
+               float leftAmount = (1 - blend[ch]) * gain[ch];
+               float rightAmount = blend[ch] * gain[ch];
+               for (int i = 0; i < length; ++i)
+                  out[i] += (leftChunk[i] * leftAmount + rightChunk[i] * rightAmount) * windowChunk[i];
+            }
+         }
+      }
+      
+      mPos += speed * (last - first);
    }
+   
+   //done once the end of this range is past the end of the grain
+   return time + (endSample - 1) * gInvSampleRateMs < mEndTime;
 }
 
 double Grain::GetWindow(double time)
@@ -162,12 +372,14 @@ double Grain::GetWindow(double time)
 
 void Grain::DrawGrain(int idx, float x, float y, float w, float h, int bufferStart, int viewLength, int bufferLength)
 {
+   float alpha = GetWindow(gTime);
+   if (alpha == 0)
+      return;
    float a = fmod((mPos - bufferStart), bufferLength) / viewLength;
    if (a < 0 || a > 1)
       return;
    ofPushStyle();
    ofFill();
-   float alpha = GetWindow(gTime);
    ofSetColor(255,0,0,alpha*255);
    ofCircle(x+a*w, y+mDrawPos*h, MAX(3,h/MAX_GRAINS/2));
    ofPopStyle();
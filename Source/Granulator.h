@@ -27,22 +27,33 @@
 #define __modularSynth__Granulator__
 
 #include <iostream>
+#include <vector>
 #include "Ramp.h"
 #include "BiquadFilter.h"
 #include "ChannelBuffer.h"
 
 #define MAX_GRAINS 32
+#define MAX_GRAIN_CAP 256
 
 class Granulator;
 
+enum GrainWindowType
+{
+   kGrainWindow_Hann,
+   kGrainWindow_Tukey,
+   kGrainWindow_Gaussian,
+   kNumGrainWindowTypes
+};
+
 class Grain
 {
 public:
-   Grain() : mPos(0), mSpeedMult(1), mStartTime(0), mEndTime(0), mVol(0), mStereoPosition(0) {}
+   Grain() : mPos(0), mSpeedMult(1), mStartTime(0), mEndTime(0), mVol(0), mStereoPosition(0), mDrawPos(0), mOwner(nullptr) {}
    void Spawn(Granulator* owner, double time, double pos, float speedMult, float lengthInMs, float vol, float width);
-   void Process(double time, ChannelBuffer* buffer, int bufferLength, float* output);
+   bool Render(double time, ChannelBuffer* buffer, int bufferLength, const float* window, float* const* output, int startSample, int endSample);
    void DrawGrain(int idx, float x, float y, float w, float h, int bufferStart, int viewLength, int bufferLength);
    void Clear() { mVol = 0; }
+   double GetStartTime() const { return mStartTime; }
 private:
    double GetWindow(double time);
    double mPos;
@@ -60,10 +71,14 @@ class Granulator
 public:
    Granulator();
    void ProcessFrame(double time, ChannelBuffer* buffer, int bufferLength, double offset, float* output);
+   //renders numSamples into output, with grains spawned at offsets[i] for sample i. the grain parameters are read once for the block
+   void ProcessBlock(double time, ChannelBuffer* buffer, int bufferLength, const double* offsets, ChannelBuffer* output, int numSamples);
    void Draw(float x, float y, float w, float h, int bufferStart, int viewLength, int bufferLength);
    void Reset();
    void ClearGrains();
    void SetLiveMode(bool live) { mLiveMode = live; }
+   void SetGrainCap(int cap) { mGrainCap = ofClamp(cap, 1, MAX_GRAIN_CAP); }
+   int GetNumActiveGrains() const { return (int)mActiveGrains.size(); }
    
    float mSpeed;
    float mGrainLengthMs;
@@ -73,13 +88,18 @@ public:
    float mSpacingRandomize;
    bool mOctaves;
    float mWidth;
+   GrainWindowType mWindowType;
    
 private:
+   void Render(double time, ChannelBuffer* buffer, int bufferLength, const double* offsets, float* const* output, int numSamples);
+   void RenderGrains(double time, ChannelBuffer* buffer, int bufferLength, float* const* output, int startSample, int endSample);
    void SpawnGrain(double time, double offset, float width);
    
    double mNextGrainSpawnMs;
-   int mNextGrainIdx;
-   Grain mGrains[MAX_GRAINS];
+   std::vector<Grain> mGrains;
+   std::vector<int> mActiveGrains;  //grains that are playing, the rest aren't looked at
+   std::vector<int> mFreeGrains;
+   int mGrainCap;
    bool mLiveMode;
    BiquadFilter mBiquad[ChannelBuffer::kMaxNumChannels];
 };
@@ -78,6 +78,7 @@ public:
    virtual ~GridControlTarget() {}
    
    void Render() override;
+   bool CheckNeedsDraw() override { return true; }
    static void DrawGridIcon(float x, float y);
    
    void SetGridController(IGridController* gridController) { mGridController = gridController; gridController->SetGridControllerOwner(mOwner); }
@@ -32,4 +32,5 @@ class IAudioPoller
 public:
    virtual ~IAudioPoller() {}
    virtual void OnTransportAdvanced(float amount) = 0;
+   virtual bool IsControlRate() const { return false; }   //can be advanced less often than every buffer, see Transport::GetControlRate()
 };
@@ -37,7 +37,7 @@ class IAudioReceiver;
 class IAudioSource : public virtual IPatchable
 {
 public:
-   IAudioSource() : mVizBuffer(VIZ_BUFFER_SECONDS*gSampleRate) {}
+   IAudioSource() : mVizBuffer(VIZ_BUFFER_SECONDS*gSampleRate) { mVizBuffer.SetCaptureOnDemand(true); }
    virtual ~IAudioSource() {}
    virtual void Process(double time) = 0;
    IAudioReceiver* GetTarget(int index=0);
@@ -39,16 +39,31 @@ IClickable::IClickable()
 , mParent(nullptr)
 , mShowing(true)
 , mBeaconTime(-999)
+, mNeedsDraw(true)
+, mDrawnShowing(false)
+, mDrawnX(0)
+, mDrawnY(0)
+, mDrawnWidth(0)
+, mDrawnHeight(0)
+, mDrawnBeaconAmount(0)
 {
    mName[0] = 0;
 }
 
 void IClickable::Draw()
 {
+   mNeedsDraw = false;
+   mDrawnShowing = mShowing;
+   
    if (!mShowing)
       return;
    
    Render();
+   
+   mDrawnX = mX;
+   mDrawnY = mY;
+   GetDimensions(mDrawnWidth, mDrawnHeight);
+   mDrawnBeaconAmount = GetBeaconAmount();
 }
 
 bool IClickable::TestClick(int x, int y, bool right, bool testOnly /* = false */)
@@ -183,7 +198,15 @@ std::string IClickable::Path(bool ignoreContext)
 
 bool IClickable::CheckNeedsDraw()
 {
-   return mShowing;
+   if (!mShowing && !mDrawnShowing)
+      return false;
+   if (mNeedsDraw || mShowing != mDrawnShowing)
+      return true;
+   
+   float w, h;
+   GetDimensions(w, h);
+   return mX != mDrawnX || mY != mDrawnY || w != mDrawnWidth || h != mDrawnHeight ||
+          GetBeaconAmount() > 0 || mDrawnBeaconAmount > 0;
 }
 
 float IClickable::GetBeaconAmount() const
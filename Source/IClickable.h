@@ -39,10 +39,10 @@ public:
    virtual ~IClickable() {}
    void Draw();
    virtual void Render() {}
-   void SetPosition(float x, float y) { mX = x; mY = y; }
+   void SetPosition(float x, float y) { mX = x; mY = y; OnPositionChanged(); }
    void GetPosition(float& x, float& y, bool local = false) const;
    ofVec2f GetPosition(bool local = false) const;
-   virtual void Move(float moveX, float moveY) { mX += moveX; mY += moveY; }
+   virtual void Move(float moveX, float moveY) { mX += moveX; mY += moveY; OnPositionChanged(); }
    virtual bool TestClick(int x, int y, bool right, bool testOnly = false);
    IClickable* GetParent() const { return mParent; }
    void SetParent(IClickable* parent) { mParent = parent; }
@@ -59,7 +59,8 @@ public:
    const char* Name() const { return mName; }
    char* NameMutable() { return mName; }
    std::string Path(bool ignoreContext = false);
-   virtual bool CheckNeedsDraw();
+   virtual bool CheckNeedsDraw();  //true if this would look different than it did the last time it was drawn
+   void MarkNeedsDraw() { mNeedsDraw = true; }
    virtual void SetShowing(bool showing) { mShowing = showing; }
    bool IsShowing() const { return mShowing; }
    virtual void StartBeacon() { mBeaconTime = gTime; }
@@ -80,6 +81,7 @@ protected:
    virtual void OnClicked(int x, int y, bool right) {}
    virtual bool MouseMoved(float x, float y) { return false; }
    virtual bool MouseScrolled(int x, int y, float scrollX, float scrollY) { return false; }
+   virtual void OnPositionChanged() {}
    
    float mX;
    float mY;
@@ -89,6 +91,14 @@ protected:
 private:
    char mName[MAX_TEXTENTRY_LENGTH];
    double mBeaconTime;
+   
+   bool mNeedsDraw;
+   bool mDrawnShowing;
+   float mDrawnX;
+   float mDrawnY;
+   float mDrawnWidth;
+   float mDrawnHeight;
+   float mDrawnBeaconAmount;
 };
 
 #endif /* defined(__modularSynth__IClickable__) */
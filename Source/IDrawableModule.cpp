@@ -180,6 +180,36 @@ bool IDrawableModule::IsWithinRect(const ofRectangle& rect)
    return rect.intersects(ofRectangle(x,y-titleBarHeight,w,h+titleBarHeight));
 }
 
+//the area that TestClick() can respond to, in the space of our owning container
+ofRectangle IDrawableModule::GetHitTestBounds()
+{
+   float w, h;
+   GetDimensions(w, h);
+   
+   float titleBarHeight = HasTitleBar() ? TitleBarHeight() : 0;
+   ofRectangle bounds(mX, mY - titleBarHeight, w, h + titleBarHeight);
+   
+   //sources are positioned in absolute space, and respond to hovering rather than to the exact click position,
+   //so leave some slop for callers that probe around the cursor
+   const float kSourceSlop = 10;
+   ofVec2f containerOffset = mOwningContainer ? mOwningContainer->GetOwnerPosition() : ofVec2f();
+   for (auto source : mPatchCableSources)
+   {
+      ofRectangle sourceBounds = source->GetHoverBounds();
+      sourceBounds.x -= containerOffset.x;
+      sourceBounds.y -= containerOffset.y;
+      bounds.growToInclude(sourceBounds.grow(kSourceSlop));
+   }
+   
+   return bounds;
+}
+
+void IDrawableModule::UpdateSpatialIndex()
+{
+   if (mOwningContainer)
+      mOwningContainer->UpdateSpatialIndex(this);
+}
+
 bool IDrawableModule::IsVisible()
 {
    return IsWithinRect(TheSynth->GetDrawRect());
@@ -202,7 +232,9 @@ void IDrawableModule::DrawFrame(float w, float h, bool drawModule, float& titleB
       IAudioSource* audioSource = dynamic_cast<IAudioSource*>(this);
       if (audioSource)
       {
+         //modules are only drawn while they're on screen, so this is what keeps offscreen modules from capturing
          RollingBuffer* vizBuff = audioSource->GetVizBuffer();
+         vizBuff->RequestCapture();
          int numSamples = std::min(500,vizBuff->Size());
          float sample;
          float mag = 0;
@@ -254,31 +286,7 @@ void IDrawableModule::DrawFrame(float w, float h, bool drawModule, float& titleB
    //gModuleShader.end();
    ofNoFill();
 
-   if (Enabled())
-      gModuleDrawAlpha = 255;
-   else
-      gModuleDrawAlpha = 100;
-   
-   bool dimModule = false;
-   
-   if (TheSynth->GetGroupSelectedModules().empty() == false)
-   {
-      if (!VectorContains(GetModuleParent(), TheSynth->GetGroupSelectedModules()))
-         dimModule = true;
-   }
-   
-   if (PatchCable::sActivePatchCable &&
-       (PatchCable::sActivePatchCable->GetConnectionType() != kConnectionType_Modulator || PatchCable::sActivePatchCable->GetConnectionType() != kConnectionType_UIControl) &&
-       !PatchCable::sActivePatchCable->IsValidTarget(this))
-   {
-      dimModule = true;
-   }
-
-   if (TheSynth->GetHeldSample() != nullptr && !CanDropSample())
-      dimModule = true;
-   
-   if (dimModule)
-      gModuleDrawAlpha *= .2f;
+   gModuleDrawAlpha = GetDrawAlpha();
    
    float enableToggleOffset = 0;
    if (HasTitleBar())
@@ -331,14 +339,8 @@ void IDrawableModule::DrawFrame(float w, float h, bool drawModule, float& titleB
    
    if (drawModule)
    {
-      ofSetColor(color, gModuleDrawAlpha);
-      ofPushMatrix();
-      if (ShouldClipContents())
-         ofClipWindow(0, 0, w, h, true);
-      else
-         ofResetClipWindow();
-      DrawModule();
-      ofPopMatrix();
+      if (Push2Control::sDrawingPush2Display || !TheSynth->GetRenderCache()->DrawBody(this, w, h))
+         DrawBody(w, h);
    }
    
    ofSetColor(color * (1-GetBeaconAmount()) + ofColor::yellow * GetBeaconAmount(), gModuleDrawAlpha);
@@ -448,6 +450,50 @@ void IDrawableModule::Render()
       source->UpdatePosition(false);
       source->DrawSource();
    }
+   
+   //dimensions are computed by each module and can change with its state, and cable sources have just been placed,
+   //so catch up on anything the position and size setters didn't see. this only touches the index if something moved
+   UpdateSpatialIndex();
+}
+
+void IDrawableModule::DrawBody(float w, float h)
+{
+   ofSetColor(GetColor(mModuleType), gModuleDrawAlpha);
+   ofPushMatrix();
+   if (ShouldClipContents())
+      ofClipWindow(0, 0, w, h, true);
+   else
+      ofResetClipWindow();
+   DrawModule();
+   ofPopMatrix();
+}
+
+float IDrawableModule::GetDrawAlpha()
+{
+   float alpha = Enabled() ? 255 : 100;
+   
+   bool dimModule = false;
+   
+   if (TheSynth->GetGroupSelectedModules().empty() == false)
+   {
+      if (!VectorContains(GetModuleParent(), TheSynth->GetGroupSelectedModules()))
+         dimModule = true;
+   }
+   
+   if (PatchCable::sActivePatchCable &&
+       (PatchCable::sActivePatchCable->GetConnectionType() != kConnectionType_Modulator || PatchCable::sActivePatchCable->GetConnectionType() != kConnectionType_UIControl) &&
+       !PatchCable::sActivePatchCable->IsValidTarget(this))
+   {
+      dimModule = true;
+   }
+
+   if (TheSynth->GetHeldSample() != nullptr && !CanDropSample())
+      dimModule = true;
+   
+   if (dimModule)
+      alpha *= .2f;
+   
+   return alpha;
 }
 
 void IDrawableModule::RenderUnclipped()
@@ -867,6 +913,16 @@ void IDrawableModule::ComputeSliders(int samplesIn)
    //mSliderMutex.unlock();
 }
 
+bool IDrawableModule::SlidersNeedPerSampleCompute() const
+{
+   for (auto* slider : mFloatSliders)
+   {
+      if (slider->IsModulatedPerSample())
+         return true;
+   }
+   return false;
+}
+
 PatchCableOld IDrawableModule::GetPatchCableOld(IClickable* target)
 {
    float wThis,hThis,xThis,yThis,wThat,hThat,xThat,yThat;
@@ -991,7 +1047,7 @@ void IDrawableModule::ToggleMinimized()
 
 bool IDrawableModule::CheckNeedsDraw()
 {
-   if (IClickable::CheckNeedsDraw())
+   if (!IsRenderCacheable())
       return true;
    
    for (int i=0; i<mUIControls.size(); ++i)
@@ -74,8 +74,11 @@ public:
    void RenderUnclipped();
    virtual void PostRender() {}
    void DrawFrame(float width, float height, bool drawModule, float& titleBarHeight, float& highlight);
+   void DrawBody(float width, float height);
+   float GetDrawAlpha();
    void DrawPatchCables(bool parentMinimized);
    bool CheckNeedsDraw() override;
+   virtual bool IsRenderCacheable() const { return false; }  //override for modules whose body draws nothing but their ui controls, see ModuleRenderCache
    virtual bool AlwaysOnTop() { return false; }
    void ToggleMinimized();
    void SetMinimized(bool minimized) { if (HasTitleBar()) mMinimized = minimized; }
@@ -107,6 +110,8 @@ public:
    virtual bool CanDropSample() const { return false; }
    void BasePoll();  //calls poll, using this to guarantee base poll is always called
    bool IsWithinRect(const ofRectangle& rect);
+   ofRectangle GetHitTestBounds();
+   void UpdateSpatialIndex();   //call when the module's bounds have changed
    bool IsVisible();
    std::vector<IDrawableModule*> GetChildren() const { return mChildren; }
    virtual bool IsResizable() const { return false; }
@@ -124,6 +129,7 @@ public:
    virtual bool HasSpecialDelete() const { return false; }
    virtual void DoSpecialDelete() {}
    void ComputeSliders(int samplesIn);
+   bool SlidersNeedPerSampleCompute() const;
    void SetOwningContainer(ModuleContainer* container) { mOwningContainer = container; }
    ModuleContainer* GetOwningContainer() const { return mOwningContainer; }
    virtual ModuleContainer* GetContainer() { return nullptr; }
@@ -177,6 +183,7 @@ protected:
    virtual void Poll() override {}
    virtual void OnClicked(int x, int y, bool right) override;
    virtual bool MouseMoved(float x, float y) override;
+   void OnPositionChanged() override { UpdateSpatialIndex(); }
    
    ModuleSaveData mModuleSaveData;
    Checkbox* mEnabledCheckbox;
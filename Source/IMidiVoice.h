@@ -43,6 +43,7 @@ public:
    virtual void Stop(double time) = 0;
    virtual bool Process(double time, ChannelBuffer* out, int oversampling) = 0;
    virtual bool IsDone(double time) = 0;
+   virtual float GetEnvelopeLevel(double time) { return 1; }  //used to pick the quietest voice to steal
    virtual void SetVoiceParams(IVoiceParams* params) = 0;
    void SetPan(float pan) { assert(pan >= -1 && pan <= 1); mPan = pan; }
    float GetPan() const { assert(mPan >= -1 && mPan <= 1); return mPan; }
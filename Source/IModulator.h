@@ -41,6 +41,7 @@ public:
    virtual bool Active() const = 0;
    virtual bool CanAdjustRange() const { return true; }
    virtual bool InitializeWithZeroRange() const { return false; }
+   virtual bool IsAudioRate() const { return false; }   //evaluate every sample, even when the patch runs modulation at control rate
    float& GetMin() { return mTarget ? mTarget->GetModulatorMin() : mDummyMin; }
    float& GetMax() { return mTarget ? mTarget->GetModulatorMax() : mDummyMax; }
    void OnModulatorRepatch();
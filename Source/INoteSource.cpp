@@ -30,27 +30,21 @@
 #include "Scale.h"
 #include "PatchCableSource.h"
 #include "Profiler.h"
+#include "NoteEventBus.h"
 
 void NoteOutput::PlayNote(double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation)
 {
-   ResetStackDepth();
    PlayNoteInternal(time, pitch, velocity, voiceIdx, modulation);
 }
 
 void NoteOutput::PlayNoteInternal(double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation)
 {
-   const int kMaxDepth = 100;
-   if (mStackDepth > kMaxDepth)
-   {
-      TheSynth->LogEvent("note chain hit max stack depth", kLogEventType_Error);
-      return;  //avoid stack overflow
-   }
-   ++mStackDepth;
-   
    if (pitch >= 0 && pitch <= 127)
    {
+      //delivered through the bus rather than called directly, see NoteEventBus
+      NoteEventBus* bus = TheSynth->GetNoteEventBus();
       for (auto noteReceiver : mNoteSource->GetPatchCableSource()->GetNoteReceivers())
-         noteReceiver->PlayNote(time,pitch,velocity,voiceIdx,modulation);
+         bus->PlayNote(noteReceiver,time,pitch,velocity,voiceIdx,modulation);
 
       if (velocity>0)
       {
@@ -109,6 +103,7 @@ std::list<int> NoteOutput::GetHeldNotesList()
 void NoteOutput::Flush(double time)
 {
    bool flushed = false;
+   NoteEventBus* bus = TheSynth->GetNoteEventBus();
    
    for (int i=0; i<128; ++i)
    {
@@ -116,8 +111,8 @@ void NoteOutput::Flush(double time)
       {
          for (auto noteReceiver : mNoteSource->GetPatchCableSource()->GetNoteReceivers())
          {
-            noteReceiver->PlayNote(time,i,0);
-            noteReceiver->PlayNote(time+Transport::sEventEarlyMs,i,0);
+            bus->PlayNote(noteReceiver,time,i,0,-1,ModulationParameters());
+            bus->PlayNote(noteReceiver,time+Transport::sEventEarlyMs,i,0,-1,ModulationParameters());
          }
          flushed = true;
          mNotes[i] = false;
@@ -135,7 +130,7 @@ void NoteOutput::FlushTarget(double time, INoteReceiver* target)
       for (int i=0; i<128; ++i)
       {
          if (mNotes[i])
-            target->PlayNote(time,i,0);
+            TheSynth->GetNoteEventBus()->PlayNote(target,time,i,0,-1,ModulationParameters());
       }
    }
 }
@@ -146,11 +141,7 @@ void INoteSource::PlayNoteOutput(double time, int pitch, int velocity, int voice
    if (time < gTime)
       ofLog() << "Calling PlayNoteOutput() with a time in the past!  " << ofToString(time/1000) << " < " << ofToString(gTime/1000);
    
-   if (!mInNoteOutput)
-      mNoteOutput.ResetStackDepth();
-   mInNoteOutput = true;
    mNoteOutput.PlayNoteInternal(time, pitch, velocity, voiceIdx, modulation);
-   mInNoteOutput = false;
 }
 
 void INoteSource::SendCCOutput(int control, int value, int voiceIdx /*=-1*/)
@@ -38,7 +38,7 @@ class INoteSource;
 class NoteOutput : public INoteReceiver
 {
 public:
-   explicit NoteOutput(INoteSource* source) : mNoteSource(source), mStackDepth(0) {}
+   explicit NoteOutput(INoteSource* source) : mNoteSource(source) {}
    
    void Flush(double time);
    void FlushTarget(double time, INoteReceiver* target);
@@ -51,7 +51,6 @@ public:
    
    void PlayNoteInternal(double time, int pitch, int velocity, int voiceIdx = -1, ModulationParameters modulation = ModulationParameters());
 
-   void ResetStackDepth() { mStackDepth = 0; }
    bool* GetNotes() { return mNotes; }
    bool HasHeldNotes();
    std::list<int> GetHeldNotesList();
@@ -59,13 +58,12 @@ private:
    bool mNotes[128]{};
    double mNoteOnTimes[128]{};
    INoteSource* mNoteSource;
-   int mStackDepth;
 };
 
 class INoteSource : public virtual IPatchable
 {
 public:
-   INoteSource() : mNoteOutput(this), mInNoteOutput(false) {}
+   INoteSource() : mNoteOutput(this) {}
    virtual ~INoteSource() {}
    void PlayNoteOutput(double time, int pitch, int velocity, int voiceIdx = -1, ModulationParameters modulation = ModulationParameters());
    void SendCCOutput(int control, int value, int voiceIdx = -1);
@@ -74,7 +72,6 @@ public:
    void PreRepatch(PatchCableSource* cableSource) override;
 protected:
    NoteOutput mNoteOutput;
-   bool mInNoteOutput;
 };
 
 class AdditionalNoteCable : public INoteSource
@@ -185,6 +185,10 @@ void KarplusStrong::DrawModule()
    mExciterDecaySlider->Draw();
 
    mBiquad.Draw();
+
+   float width, height;
+   GetModuleDimensions(width, height);
+   mPolyMgr.DrawVoiceMeter(3, height - 4, width - 6, 2);
 }
 
 void KarplusStrong::DrawModuleUnclipped()
@@ -217,7 +221,7 @@ void KarplusStrong::CheckboxUpdated(Checkbox* checkbox)
 void KarplusStrong::LoadLayout(const ofxJSONElement& moduleInfo)
 {
    mModuleSaveData.LoadString("target", moduleInfo);
-   mModuleSaveData.LoadInt("voicelimit", moduleInfo, -1, -1, kNumVoices);
+   mModuleSaveData.LoadInt("voicelimit", moduleInfo, -1, -1, kMaxVoicePoolSize);
    EnumMap oversamplingMap;
    oversamplingMap["1"] = 1;
    oversamplingMap["2"] = 2;
@@ -92,6 +92,7 @@ public:
    bool Process(double time, ChannelBuffer* out, int oversampling) override;
    void SetVoiceParams(IVoiceParams* params) override;
    bool IsDone(double time) override;
+   float GetEnvelopeLevel(double time) override { return mActive ? mMuteRamp.Value(time) : 0; }
 private:
    void DoParameterUpdate(int samplesIn,
                           int oversampling,
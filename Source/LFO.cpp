@@ -153,7 +153,7 @@ void LFO::SetPeriod(NoteInterval interval)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mPeriod;
+         transportListenerInfo->SetInterval(mPeriod);
    }
    
    if (mOsc.GetType() == kOsc_Drunk || mPeriod == kInterval_Free)
@@ -47,6 +47,8 @@ LiveGranulator::LiveGranulator()
 , mAutoCaptureInterval(kInterval_None)
 , mAutoCaptureDropdown(nullptr)
 , mGranSpacingRandomize(nullptr)
+, mWindowDropdown(nullptr)
+, mGrainOutput(gBufferSize)
 {
    mGranulator.SetLiveMode(true);
    mGranulator.mSpeed = 1;
@@ -84,6 +86,7 @@ void LiveGranulator::CreateUIControls()
    CHECKBOX(mFreezeCheckbox,"frz",&mFreeze); UIBLOCK_SHIFTX(35);
    CHECKBOX(mGranOctaveCheckbox,"g oct",&mGranulator.mOctaves); UIBLOCK_NEWLINE();
    FLOATSLIDER(mWidthSlider, "width", &mGranulator.mWidth, 0, 1);
+   DROPDOWN(mWindowDropdown, "window", (int*)(&mGranulator.mWindowType), 60);
    ENDUIBLOCK(mWidth, mHeight);
 
    mBufferX = mWidth + 3;
@@ -98,6 +101,10 @@ void LiveGranulator::CreateUIControls()
    mAutoCaptureDropdown->AddLabel("8n", kInterval_8n);
    mAutoCaptureDropdown->AddLabel("16n", kInterval_16n);
    
+   mWindowDropdown->AddLabel("hann", kGrainWindow_Hann);
+   mWindowDropdown->AddLabel("tukey", kGrainWindow_Tukey);
+   mWindowDropdown->AddLabel("gaussian", kGrainWindow_Gaussian);
+   
    mGranPosRandomize->SetMode(FloatSlider::kSquare);
    mGranSpeedRandomize->SetMode(FloatSlider::kSquare);
    mGranLengthMs->SetMode(FloatSlider::kSquare);
@@ -112,14 +119,18 @@ void LiveGranulator::ProcessAudio(double time, ChannelBuffer* buffer)
 {
    PROFILER(LiveGranulator);
    
-   float bufferSize = buffer->BufferSize();
+   int bufferSize = buffer->BufferSize();
    mBuffer.SetNumChannels(buffer->NumActiveChannels());
+   if ((int)mGrainOffsets.size() < bufferSize)
+      mGrainOffsets.resize(bufferSize);
+   if (mGrainOutput.BufferSize() < bufferSize)
+      mGrainOutput.Resize(bufferSize);
 
+   //record the input first, then render the grains for the whole buffer from where the write head was at each sample
    for (int i=0; i<bufferSize; ++i)
    {
       ComputeSliders(i);
       
-      mGranulator.SetLiveMode(!mFreeze);
       if (!mFreeze)
       {
          for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
@@ -132,16 +143,18 @@ void LiveGranulator::ProcessAudio(double time, ChannelBuffer* buffer)
             mBuffer.Write(buffer->GetChannel(ch)[i], ch);
       }
       
-      if (mEnabled)
+      mGrainOffsets[i] = mBuffer.GetRawBufferOffset(0)-mFreezeExtraSamples-1+mPos;
+   }
+   
+   if (mEnabled)
+   {
+      mGranulator.SetLiveMode(!mFreeze);
+      mGranulator.ProcessBlock(time, mBuffer.GetRawBuffer(), mBufferLength, mGrainOffsets.data(), &mGrainOutput, bufferSize);
+      for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
       {
-         float sample[ChannelBuffer::kMaxNumChannels];
-         Clear(sample, ChannelBuffer::kMaxNumChannels);
-         mGranulator.ProcessFrame(time, mBuffer.GetRawBuffer(), mBufferLength, mBuffer.GetRawBufferOffset(0)-mFreezeExtraSamples-1+mPos, sample);
-         for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
-            buffer->GetChannel(ch)[i] = mDry * buffer->GetChannel(ch)[i] + sample[ch];
+         Mult(buffer->GetChannel(ch), mDry, bufferSize);
+         Add(buffer->GetChannel(ch), mGrainOutput.GetChannel(ch), bufferSize);
       }
-      
-      time += gInvSampleRateMs;
    }
 }
 
@@ -162,6 +175,7 @@ void LiveGranulator::DrawModule()
    mAutoCaptureDropdown->Draw();
    mGranSpacingRandomize->Draw();
    mWidthSlider->Draw();
+   mWindowDropdown->Draw();
    if (mEnabled)
    {
       int drawLength = MIN(mBufferLength, gSampleRate*2);
@@ -205,13 +219,25 @@ void LiveGranulator::CheckboxUpdated(Checkbox* checkbox)
    }
 }
 
+void LiveGranulator::LoadLayout(const ofxJSONElement& moduleInfo)
+{
+   mModuleSaveData.LoadInt("max_grains", moduleInfo, MAX_GRAINS, 1, MAX_GRAIN_CAP, K(isTextField));
+   
+   SetUpFromSaveData();
+}
+
+void LiveGranulator::SetUpFromSaveData()
+{
+   mGranulator.SetGrainCap(mModuleSaveData.GetInt("max_grains"));
+}
+
 void LiveGranulator::DropdownUpdated(DropdownList* list, int oldVal)
 {
    if (list == mAutoCaptureDropdown)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mAutoCaptureInterval;
+         transportListenerInfo->SetInterval(mAutoCaptureInterval);
       if (mAutoCaptureInterval == kInterval_None)
       {
          mFreeze = false;
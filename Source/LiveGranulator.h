@@ -62,6 +62,9 @@ public:
    void FloatSliderUpdated(FloatSlider* slider, float oldVal) override;
    void DropdownUpdated(DropdownList* list, int oldVal) override;
    
+   void LoadLayout(const ofxJSONElement& moduleInfo) override;
+   void SetUpFromSaveData() override;
+   
 private:
    void Freeze();
    
@@ -73,6 +76,8 @@ private:
    float mBufferLength;
    RollingBuffer mBuffer;
    Granulator mGranulator;
+   ChannelBuffer mGrainOutput;
+   std::vector<double> mGrainOffsets;
    FloatSlider* mGranOverlap;
    FloatSlider* mGranSpeed;
    FloatSlider* mGranLengthMs;
@@ -90,6 +95,7 @@ private:
    NoteInterval mAutoCaptureInterval;
    DropdownList* mAutoCaptureDropdown;
    FloatSlider* mWidthSlider;
+   DropdownList* mWindowDropdown;
    
    float mWidth;
    float mHeight;
@@ -11,6 +11,8 @@
 #ifndef LOCKFREEQUEUE_H_INCLUDED
 #define LOCKFREEQUEUE_H_INCLUDED
 
+#include "juce_core/juce_core.h"
+
 /**
  * A simple single producer & consumer lock free queue, based on Herb Sutter's code:
  * http://www.drdobbs.com/parallel/writing-lock-free-code-a-corrected-queue/
@@ -82,7 +84,7 @@ private:
     };
     
     Node* first;
-    Atomic<Node*> divider, last;
+    juce::Atomic<Node*> divider, last;
 };
 
 
@@ -182,7 +182,7 @@ void LoopStorer::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mQuantization;
+         transportListenerInfo->SetInterval(mQuantization);
    }
 }
 
@@ -262,7 +262,7 @@ void LoopStorer::SetUpFromSaveData()
    mQuantization = mModuleSaveData.GetEnum<NoteInterval>("quantization");
    TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
    if (transportListenerInfo != nullptr)
-      transportListenerInfo->mInterval = mQuantization;
+      transportListenerInfo->SetInterval(mQuantization);
 }
 
 namespace
@@ -374,7 +374,7 @@ void LoopStorer::SampleData::Init(LoopStorer* storer, int index)
    }
    else
    {
-      mBuffer = new ChannelBuffer(MAX_BUFFER_SIZE);
+      mBuffer = new ChannelBuffer(MAX_BUFFER_SIZE, true);
       mNumBars = 1;
       mIsCurrentBuffer = false;
    }
@@ -117,8 +117,8 @@ Looper::Looper()
 , mBufferTempo(-1)
 {
    //TODO(Ryan) buffer sizes
-   mBuffer = new ChannelBuffer(MAX_BUFFER_SIZE);
-   mUndoBuffer = new ChannelBuffer(MAX_BUFFER_SIZE);
+   mBuffer = new ChannelBuffer(MAX_BUFFER_SIZE, true);
+   mUndoBuffer = new ChannelBuffer(MAX_BUFFER_SIZE, true);
    Clear();
    
    mMuteRamp.SetValue(1);
@@ -337,6 +337,7 @@ void Looper::Process(double time)
       mBuffer = mQueuedNewBuffer;
       mBufferMutex.unlock();
       mQueuedNewBuffer = nullptr;
+      mBuffer->SetCommittedLength(mLoopLength);
    }
    
    if (mKeepPitch)
@@ -942,6 +943,8 @@ void Looper::SetLoopLength(int length)
 {
    assert(length > 0);
    mLoopLength = length;
+   mBuffer->SetCommittedLength(length);
+   mUndoBuffer->SetCommittedLength(length);
    if (mLoopPosOffsetSlider != nullptr)
       mLoopPosOffsetSlider->SetExtents(0, length);
    mBufferTempo = TheTransport->GetTempo();
@@ -1218,45 +1221,21 @@ void Looper::HalveNumBars()
 void Looper::DoShiftMeasure()
 {
    int measureSize = int(TheTransport->MsPerBar() * gSampleRate / 1000);
-   for (int ch=0; ch<mBuffer->NumActiveChannels(); ++ch)
-   {
-      float* newBuffer = new float[MAX_BUFFER_SIZE];
-      BufferCopy(newBuffer, mBuffer->GetChannel(ch)+measureSize, mLoopLength-measureSize);
-      BufferCopy(newBuffer+mLoopLength-measureSize, mBuffer->GetChannel(ch), measureSize);
-      mBufferMutex.lock();
-      mBuffer->SetChannelPointer(newBuffer, ch, true);
-      mBufferMutex.unlock();
-   }
+   RotateLoop(measureSize);
    mWantShiftMeasure = false;
 }
 
 void Looper::DoHalfShift()
 {
    int halfMeasureSize = int(TheTransport->MsPerBar() * gSampleRate / 1000 / 2);
-   for (int ch=0; ch<mBuffer->NumActiveChannels(); ++ch)
-   {
-      float* newBuffer = new float[MAX_BUFFER_SIZE];
-      BufferCopy(newBuffer, mBuffer->GetChannel(ch)+halfMeasureSize, mLoopLength-halfMeasureSize);
-      BufferCopy(newBuffer+mLoopLength-halfMeasureSize, mBuffer->GetChannel(ch), halfMeasureSize);
-      mBufferMutex.lock();
-      mBuffer->SetChannelPointer(newBuffer, ch, true);
-      mBufferMutex.unlock();
-   }
+   RotateLoop(halfMeasureSize);
    mWantHalfShift = false;
 }
 
 void Looper::DoShiftDownbeat()
 {
    int shift = int(mLoopPos);
-   for (int ch=0; ch<mBuffer->NumActiveChannels(); ++ch)
-   {
-      float* newBuffer = new float[MAX_BUFFER_SIZE];
-      BufferCopy(newBuffer, mBuffer->GetChannel(ch)+shift, mLoopLength-shift);
-      BufferCopy(newBuffer+mLoopLength-shift, mBuffer->GetChannel(ch), shift);
-      mBufferMutex.lock();
-      mBuffer->SetChannelPointer(newBuffer, ch, true);
-      mBufferMutex.unlock();
-   }
+   RotateLoop(shift);
    mWantShiftDownbeat = false;
 }
 
@@ -1264,21 +1243,26 @@ void Looper::DoShiftOffset()
 {
    int shift = int(mLoopPosOffset);
    if (shift != 0)
-   {
-      for (int ch = 0; ch < mBuffer->NumActiveChannels(); ++ch)
-      {
-         float* newBuffer = new float[MAX_BUFFER_SIZE];
-         BufferCopy(newBuffer, mBuffer->GetChannel(ch) + shift, mLoopLength - shift);
-         BufferCopy(newBuffer + mLoopLength - shift, mBuffer->GetChannel(ch), shift);
-         mBufferMutex.lock();
-         mBuffer->SetChannelPointer(newBuffer, ch, true);
-         mBufferMutex.unlock();
-      }
-   }
+      RotateLoop(shift);
    mWantShiftOffset = false;
    mLoopPosOffset = 0;
 }
 
+void Looper::RotateLoop(int shift)
+{
+   //in place, these run on the audio thread
+   if (mLoopLength <= 0)
+      return;
+   shift = ((shift % mLoopLength) + mLoopLength) % mLoopLength;
+   mBufferMutex.lock();
+   for (int ch=0; ch<mBuffer->NumActiveChannels(); ++ch)
+   {
+      float* buffer = mBuffer->GetChannel(ch);
+      std::rotate(buffer, buffer+shift, buffer+mLoopLength);
+   }
+   mBufferMutex.unlock();
+}
+
 void Looper::Rewrite()
 {
    mWantRewrite = true;
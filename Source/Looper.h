@@ -125,6 +125,7 @@ private:
    void DoHalfShift();
    void DoShiftDownbeat();
    void DoShiftOffset();
+   void RotateLoop(int shift);
    void DoCommit();
    void UpdateNumBars(int oldNumBars);
    void BakeVolume();
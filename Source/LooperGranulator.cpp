@@ -38,6 +38,7 @@ LooperGranulator::LooperGranulator()
    , mFreeze(false)
    , mDummyPos(0)
    , mLooper(nullptr)
+   , mWindowDropdown(nullptr)
 {
 }
 
@@ -61,6 +62,7 @@ void LooperGranulator::CreateUIControls()
    FLOATSLIDER(mGranSpacingRandomize, "spacing rand", &mGranulator.mSpacingRandomize, 0, 1);
    CHECKBOX(mGranOctaveCheckbox, "octaves", &mGranulator.mOctaves);
    FLOATSLIDER(mGranWidthSlider, "width", &mGranulator.mWidth, 0, 1);
+   DROPDOWN(mWindowDropdown, "window", (int*)(&mGranulator.mWindowType), 60);
    ENDUIBLOCK(mWidth, mHeight);
 
    mLooperCable = new PatchCableSource(this, kConnectionType_Special);
@@ -70,6 +72,10 @@ void LooperGranulator::CreateUIControls()
 
    mGranPosRandomize->SetMode(FloatSlider::kSquare);
    mGranLengthMs->SetMode(FloatSlider::kSquare);
+   
+   mWindowDropdown->AddLabel("hann", kGrainWindow_Hann);
+   mWindowDropdown->AddLabel("tukey", kGrainWindow_Tukey);
+   mWindowDropdown->AddLabel("gaussian", kGrainWindow_Gaussian);
 }
 
 void LooperGranulator::DrawModule()
@@ -91,6 +97,7 @@ void LooperGranulator::DrawModule()
    mGranSpacingRandomize->Draw();
    mGranOctaveCheckbox->Draw();
    mGranWidthSlider->Draw();
+   mWindowDropdown->Draw();
 }
 
 void LooperGranulator::DrawOverlay(ofRectangle bufferRect, int loopLength)
@@ -158,6 +165,7 @@ void LooperGranulator::SaveLayout(ofxJSONElement& moduleInfo)
 void LooperGranulator::LoadLayout(const ofxJSONElement& moduleInfo)
 {
    mModuleSaveData.LoadString("looper", moduleInfo, "", FillDropdown<Looper*>);
+   mModuleSaveData.LoadInt("max_grains", moduleInfo, MAX_GRAINS, 1, MAX_GRAIN_CAP, K(isTextField));
 
    SetUpFromSaveData();
 }
@@ -165,5 +173,6 @@ void LooperGranulator::LoadLayout(const ofxJSONElement& moduleInfo)
 void LooperGranulator::SetUpFromSaveData()
 {
    mLooperCable->SetTarget(TheSynth->FindModule(mModuleSaveData.GetString("looper"), false));
+   mGranulator.SetGrainCap(mModuleSaveData.GetInt("max_grains"));
 }
 
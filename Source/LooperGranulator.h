@@ -92,4 +92,5 @@ private:
    FloatSlider* mGranSpacingRandomize;
    Checkbox* mGranOctaveCheckbox;
    FloatSlider* mGranWidthSlider;
+   DropdownList* mWindowDropdown;
 };
@@ -40,7 +40,7 @@ LooperRecorder::LooperRecorder()
 : IAudioProcessor(gBufferSize)
 , mWidth(235)
 , mHeight(125)
-, mRecordBuffer(MAX_BUFFER_SIZE)
+, mRecordBuffer(MAX_BUFFER_SIZE, true)
 , mNumBars(1)
 , mNumBarsSelector(nullptr)
 , mSpeed(1.0f)
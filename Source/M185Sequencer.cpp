@@ -200,7 +200,7 @@ void M185Sequencer::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mInterval;
+         transportListenerInfo->SetInterval(mInterval);
    }
 }
 
@@ -221,6 +221,7 @@ public:
       std::string inputDevice = kNoneDevice;
       int sampleRate = 48000;
       int bufferSize = 256;
+      int blockSize = 0;
       bool loaded = userPrefs.open(ModularSynth::GetUserPrefsPath(false));
       if (loaded)
       {
@@ -228,6 +229,8 @@ public:
             sampleRate = userPrefs["samplerate"].asInt();
          if (!userPrefs["buffersize"].isNull())
             bufferSize = userPrefs["buffersize"].asInt();
+         if (!userPrefs["blocksize"].isNull())
+            blockSize = userPrefs["blocksize"].asInt();
          if (!userPrefs["devicetype"].isNull() && userPrefs["devicetype"].asString() != "auto")
             mGlobalManagers.mDeviceManager.setCurrentAudioDeviceType(userPrefs["devicetype"].asString(), true);
          if (!userPrefs["audio_output_device"].isNull())
@@ -236,7 +239,9 @@ public:
             inputDevice = userPrefs["audio_input_device"].asString();
       }
 
-      SetGlobalSampleRateAndBufferSize(sampleRate, bufferSize);
+      //the engine processes in blocks of gBufferSize regardless of what the device calls back with, so the block size
+      //can be set smaller than the device buffer for finer timing, or the device buffer can be whatever the device wants
+      SetGlobalSampleRateAndBufferSize(sampleRate, blockSize > 0 ? blockSize : bufferSize);
       
       mSynth.Setup(&mGlobalManagers.mDeviceManager, &mGlobalManagers.mAudioFormatManager, this, &openGLContext);
 
@@ -245,7 +250,7 @@ public:
       
       AudioDeviceManager::AudioDeviceSetup preferredSetupOptions;
       preferredSetupOptions.sampleRate = gSampleRate;
-      preferredSetupOptions.bufferSize = gBufferSize;
+      preferredSetupOptions.bufferSize = bufferSize;
       if (outputDevice != kAutoDevice && outputDevice != kNoneDevice)
          preferredSetupOptions.outputDeviceName = outputDevice;
       if (inputDevice != kAutoDevice && inputDevice != kNoneDevice)
@@ -286,11 +291,6 @@ public:
             mSynth.SetFatalError("error setting input device to '"+inputDevice+"', fix this in userprefs.json (use \"auto\" for default device, or \"none\" for no device)"+
                                  "\n\n\nvalid devices:\n"+GetAudioDevices());
          }
-         else if (loadedSetup.bufferSize != gBufferSize)
-         {
-            mSynth.SetFatalError("error setting buffer size to "+ofToString(gBufferSize)+" on device '"+ loadedSetup.outputDeviceName.toStdString()+"', fix this in userprefs.json" +
-                                 "\n\n(a valid buffer size might be: " + ofToString(loadedSetup.bufferSize) + ")");
-         }
          else if (loadedSetup.sampleRate != gSampleRate)
          {
             mSynth.SetFatalError("error setting sample rate to "+ofToString(gSampleRate) + " on device '" + loadedSetup.outputDeviceName.toStdString() + "', fix this in userprefs.json"+
@@ -299,6 +299,9 @@ public:
          else
          {            
             ofLog() << "output: " << loadedSetup.outputDeviceName << "   input: " << loadedSetup.inputDeviceName;
+            
+            if (loadedSetup.bufferSize != bufferSize)
+               mSynth.LogEvent("couldn't set buffer size to "+ofToString(bufferSize)+" on device '"+loadedSetup.outputDeviceName.toStdString()+"', using "+ofToString(loadedSetup.bufferSize), kLogEventType_Warning);
 
             int numInputChannels = 0;
             int64 inputMask = loadedSetup.inputChannels.toInteger();
@@ -316,7 +319,7 @@ public:
                outputMask >>= 1;
             }
 
-            mSynth.InitIOBuffers(numInputChannels, numOutputChannels);
+            mSynth.InitIOBuffers(numInputChannels, numOutputChannels, loadedSetup.bufferSize);
 
             mGlobalManagers.mDeviceManager.addAudioCallback(this);
          }
@@ -351,6 +354,8 @@ public:
       mouse -= mScreenPosition;
       mSynth.MouseMoved(mouse.x, mouse.y);
       
+      mSynth.UpdateRenderCache(mVG);
+      
       float width = getWidth();
       float height = getHeight();
       
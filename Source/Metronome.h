@@ -64,6 +64,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return mEnabled; }
    void GetModuleDimensions(float& width, float& height) override { width=80; height=35; }
 
@@ -76,6 +76,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 300; height = 150; }
    bool Enabled() const override { return true; }
    
@@ -65,6 +65,7 @@ private:
    
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=190; h=25; }
    
@@ -15,9 +15,11 @@
 #include "Profiler.h"
 #include "Sample.h"
 #include "FloatSliderLFOControl.h"
+#include "RetrospectiveRecorder.h"
 //#include <CoreServices/CoreServices.h>
 #include "fenv.h"
 #include <stdlib.h>
+#include <numeric>
 #include "GridController.h"
 #include "PerformanceTimer.h"
 #include "FileStream.h"
@@ -35,6 +37,11 @@
 #include "Canvas.h"
 #include "EffectChain.h"
 #include "ClickButton.h"
+#include "BiquadBank.h"
+#include "DelayLine.h"
+#include "DynamicsCore.h"
+#include "Oversampler.h"
+#include "RealtimeSafetyChecker.h"
 
 #if BESPOKE_WINDOWS
 #include <Windows.h>
@@ -67,7 +74,7 @@ void AtExit()
 ModularSynth::ModularSynth()
 : mMoveModule(nullptr)
 , mIsMousePanning(false)
-, mGlobalRecordBuffer(nullptr)
+, mRetrospectiveRecorder(nullptr)
 , mAudioPaused(false)
 , mIsLoadingState(false)
 , mClickStartX(INT_MAX)
@@ -78,7 +85,6 @@ ModularSynth::ModularSynth()
 , mUserPrefsEditor(nullptr)
 , mLastClickedModule(nullptr)
 , mInitialized(false)
-, mRecordingLength(0)
 , mGroupSelectContext(nullptr)
 , mResizeModule(nullptr)
 , mShowLoadStatePopup(false)
@@ -94,6 +100,12 @@ ModularSynth::ModularSynth()
 , mScrollMultiplierHorizontal(1)
 , mScrollMultiplierVertical(1)
 , mPixelRatio(1)
+, mIOBufferSize(0)
+, mIOLatency(0)
+, mInputFifoSize(0)
+, mInputFifoWritePos(0)
+, mInputFifoCount(0)
+, mOutputReadPos(0)
 {
    mConsoleText[0] = 0;
    assert(TheSynth == nullptr);
@@ -108,9 +120,7 @@ ModularSynth::~ModularSynth()
 {
    DeleteAllModules();
    
-   delete mGlobalRecordBuffer;
-   delete[] mSaveOutputBuffer[0];
-   delete[] mSaveOutputBuffer[1];
+   delete mRetrospectiveRecorder;
 
    SetMemoryTrackingEnabled(false); //avoid crashes when the tracking lists themselves are deleted
    
@@ -242,6 +252,7 @@ void ModularSynth::Setup(juce::AudioDeviceManager* globalAudioDeviceManager, juc
    mMainComponent = mainComponent;
    mOpenGLContext = openGLContext;
    int recordBufferLengthMinutes = 30;
+   bool recordBufferToDisk = false;
    
    bool loaded = mUserPrefs.open(GetUserPrefsPath(false));
    if (loaded)
@@ -255,6 +266,8 @@ void ModularSynth::Setup(juce::AudioDeviceManager* globalAudioDeviceManager, juc
 
       if (!mUserPrefs["record_buffer_length_minutes"].isNull())
          recordBufferLengthMinutes = mUserPrefs["record_buffer_length_minutes"].asDouble();
+      if (!mUserPrefs["record_buffer_to_disk"].isNull())
+         recordBufferToDisk = mUserPrefs["record_buffer_to_disk"].asBool();
    }
    /*else
    {
@@ -266,12 +279,25 @@ void ModularSynth::Setup(juce::AudioDeviceManager* globalAudioDeviceManager, juc
       LogEvent("couldn't find or load userprefs.json", kLogEventType_Error);
    }*/
 
-   mIOBufferSize = gBufferSize;
-   
-   mGlobalRecordBuffer = new RollingBuffer(recordBufferLengthMinutes * 60 * gSampleRate);
-   mGlobalRecordBuffer->SetNumChannels(2);
-   mSaveOutputBuffer[0] = new float[mGlobalRecordBuffer->Size()];
-   mSaveOutputBuffer[1] = new float[mGlobalRecordBuffer->Size()];
+   long long recordBufferSamples = (long long)recordBufferLengthMinutes * 60 * gSampleRate;
+   if (recordBufferToDisk)
+   {
+      const int kRecordBufferMemorySeconds = 60;
+      int memorySamples = (int)MIN(recordBufferSamples, (long long)kRecordBufferMemorySeconds * gSampleRate);
+      mRetrospectiveRecorder = new RetrospectiveRecorder(memorySamples, recordBufferSamples, ofToDataPath("internal/record_buffer.tmp"));
+   }
+   else
+   {
+      //all of it is held in memory, twice over while saving, so it can't be anywhere near as long as the disk ring
+      const int kRecordBufferMaxMemoryMinutes = 30;
+      long long maxMemorySamples = (long long)kRecordBufferMaxMemoryMinutes * 60 * gSampleRate;
+      if (recordBufferSamples > maxMemorySamples)
+      {
+         LogEvent("record_buffer_length_minutes is limited to " + ofToString(kRecordBufferMaxMemoryMinutes) + " unless record_buffer_to_disk is on", kLogEventType_Warning);
+         recordBufferSamples = maxMemorySamples;
+      }
+      mRetrospectiveRecorder = new RetrospectiveRecorder((int)recordBufferSamples, 0, "");
+   }
    
    juce::File(ofToDataPath("savestate")).createDirectory();
    juce::File(ofToDataPath("savestate/autosave")).createDirectory();
@@ -310,12 +336,42 @@ void ModularSynth::LoadResources(void* nanoVG, void* fontBoundsNanoVG)
       mFatalError = "couldn't load font from " + gFont.GetFontPath();
 }
 
-void ModularSynth::InitIOBuffers(int inputChannelCount, int outputChannelCount)
+void ModularSynth::InitIOBuffers(int inputChannelCount, int outputChannelCount, int ioBufferSize)
 {
+   //room for the latency priming plus a callback bigger than the one the device promised
+   mInputFifoSize = 2 * MAX(ioBufferSize, gBufferSize) + gBufferSize;
    for (int i = 0; i < inputChannelCount; ++i)
+   {
       mInputBuffers.push_back(new float[gBufferSize]);
+      mInputFifo.push_back(new float[mInputFifoSize]);
+   }
    for (int i = 0; i < outputChannelCount; ++i)
       mOutputBuffers.push_back(new float[gBufferSize]);
+   
+   mIOBufferSize = ioBufferSize;
+   ResetIOFifo(GetIOLatencyForBufferSize(ioBufferSize));
+}
+
+//static
+int ModularSynth::GetIOLatencyForBufferSize(int ioBufferSize)
+{
+   //blocks start on multiples of gBufferSize, and callbacks end on multiples of gcd(ioBufferSize, gBufferSize).
+   //the worst case is a block starting that far before the end of a callback, so it needs the rest of its input early.
+   //if every callback is a whole number of blocks, they line up and there's no added latency
+   return gBufferSize - std::gcd(ioBufferSize, gBufferSize);
+}
+
+void ModularSynth::ResetIOFifo(int latency)
+{
+   mIOLatency = latency;
+   for (auto* fifo : mInputFifo)
+      Clear(fifo, mInputFifoSize);
+   mInputFifoWritePos = latency;
+   mInputFifoCount = latency;
+   
+   for (auto* buffer : mOutputBuffers)
+      Clear(buffer, gBufferSize);
+   mOutputReadPos = gBufferSize;  //nothing rendered yet
 }
 
 
@@ -362,6 +418,8 @@ void ModularSynth::Poll()
    
    mZoomer.Update();
    
+   RealtimeSafetyChecker::Flush();
+   
    if (!mIsLoadingState)
    {
       for (auto p : mExtraPollers)
@@ -430,6 +488,7 @@ void ModularSynth::Poll()
 
 void ModularSynth::DeleteAllModules()
 {
+   mNoteEventBus.Clear();
    mModuleContainer.Clear();
    
    for (int i=0; i<mDeletedModules.size(); ++i)
@@ -471,6 +530,16 @@ void ModularSynth::PanView(float x, float y)
    GetDrawOffset() += ofVec2f(x, y) / gDrawScale;
 }
 
+void ModularSynth::UpdateRenderCache(void* vg)
+{
+   if (!mInitialized || mFatalError != "")
+      return;
+   
+   mRenderCacheModules.clear();
+   GetAllModules(mRenderCacheModules);
+   mRenderCache.Update((NVGcontext*)vg, mRenderCacheModules, mPixelRatio);
+}
+
 void ModularSynth::Draw(void* vg)
 {
    gNanoVG = (NVGcontext*)vg;
@@ -500,7 +569,7 @@ void ModularSynth::Draw(void* vg)
       ofPopStyle();
    }
    
-   DrawLissajous(mGlobalRecordBuffer, 0, 0, ofGetWidth(), ofGetHeight(), sBackgroundLissajousR, sBackgroundLissajousG, sBackgroundLissajousB);
+   DrawLissajous(mRetrospectiveRecorder->GetMemoryBuffer(), 0, 0, ofGetWidth(), ofGetHeight(), sBackgroundLissajousR, sBackgroundLissajousG, sBackgroundLissajousB);
    
    if (gTime == 1 && mFatalError == "")
    {
@@ -538,6 +607,7 @@ void ModularSynth::Draw(void* vg)
       float moduleX, moduleY;
       mLissajousDrawers[i]->GetPosition(moduleX, moduleY);
       IAudioSource* source = dynamic_cast<IAudioSource*>(mLissajousDrawers[i]);
+      source->GetVizBuffer()->RequestCapture();
       DrawLissajous(source->GetVizBuffer(), moduleX, moduleY-240, 240, 240);
    }
    
@@ -617,6 +687,7 @@ void ModularSynth::Draw(void* vg)
       mUILayerModuleContainer.DrawUnclipped();
       
       Profiler::Draw();
+      mCallbackTelemetry.Draw();
       DrawConsole();
    }
    ofPopMatrix();
@@ -1239,6 +1310,7 @@ void ModularSynth::MouseDragged(int intX, int intY, int button)
       newWidth = MAX(newWidth, minimumDimensions.x);
       newHeight = MAX(newHeight, minimumDimensions.y);
       mResizeModule->Resize(newWidth, newHeight);
+      mResizeModule->UpdateSpatialIndex();
    }
 
    mModuleContainer.MouseMoved(x, y);
@@ -1539,6 +1611,7 @@ void ModularSynth::OnModuleDeleted(IDrawableModule* module)
       return;
    
    mDeletedModules.push_back(module);
+   mCallbackTelemetry.NotePatchChange("deleted " + std::string(module->Name()));
    
    mAudioThreadMutex.Lock("delete");
    
@@ -1633,6 +1706,9 @@ void ModularSynth::MouseReleased(int intX, int intY, int button)
 void ModularSynth::AudioOut(float** output, int bufferSize, int nChannels)
 {
    PROFILER(audioOut_total);
+   RealtimeSafetyChecker::ScopedAudioThread audioThread;
+   NoteEventBus::ScopedRender noteRender(mNoteEventBus.GetAudioThreadQueue());
+   AudioCallbackTelemetry::ScopedCallback telemetry(&mCallbackTelemetry, bufferSize);
    
    static bool sFirst = true;
    if (sFirst)
@@ -1654,27 +1730,22 @@ void ModularSynth::AudioOut(float** output, int bufferSize, int nChannels)
    ScopedMutex mutex(&mAudioThreadMutex, "audioOut()");
    
    /////////// AUDIO PROCESSING STARTS HERE /////////////
-   assert(bufferSize == mIOBufferSize);
    assert(nChannels == (int)mOutputBuffers.size());
-   assert(mIOBufferSize == gBufferSize);  //need to be the same for now
-                                          //if we want these different, need to fix outBuffer here, and also fix audioIn()
-                                          //by now, many assumptions will have to be fixed to support mIOBufferSize and gBufferSize diverging
-   for (int ioOffset = 0; ioOffset < mIOBufferSize; ioOffset += gBufferSize)
+   
+   //render gBufferSize blocks as they're needed, and hand them out in whatever size the device asks for
+   for (int outPos = 0; outPos < bufferSize; )
    {
-      for (size_t i = 0; i < mOutputBuffers.size(); ++i)
-         Clear(mOutputBuffers[i], mIOBufferSize);
-
-      double elapsed = gInvSampleRateMs * mIOBufferSize;
-      gTime += elapsed;
-      TheTransport->Advance(elapsed);
+      if (mOutputReadPos == gBufferSize)
+      {
+         ProcessAudioBlock();
+         mOutputReadPos = 0;
+      }
       
-      //process all audio
-      for (int i=0; i<mSources.size(); ++i)
-         mSources[i]->Process(gTime);
-
-      //put it into speakers
+      int numSamples = MIN(bufferSize - outPos, gBufferSize - mOutputReadPos);
       for (int i = 0; i < nChannels; ++i)
-         BufferCopy(output[i], mOutputBuffers[i], gBufferSize);
+         BufferCopy(output[i] + outPos, mOutputBuffers[i] + mOutputReadPos, numSamples);
+      outPos += numSamples;
+      mOutputReadPos += numSamples;
    }
    
    if (gTime - mLastClapboardTime < 100)
@@ -1689,16 +1760,49 @@ void ModularSynth::AudioOut(float** output, int bufferSize, int nChannels)
       }
    }
    /////////// AUDIO PROCESSING ENDS HERE /////////////
-   if (nChannels >= 1)
-      mGlobalRecordBuffer->WriteChunk(output[0], bufferSize, 0);
-   if (nChannels >= 2)
-      mGlobalRecordBuffer->WriteChunk(output[1], bufferSize, 1);
-   mRecordingLength += bufferSize;
-   mRecordingLength = MIN(mRecordingLength, mGlobalRecordBuffer->Size());
+   mRetrospectiveRecorder->Write(output, bufferSize, nChannels);
    
    Profiler::PrintCounters();
 }
 
+void ModularSynth::ProcessAudioBlock()
+{
+   //pull the next block of input out of the fifo
+   int numInput = MIN(mInputFifoCount, gBufferSize);
+   int readPos = (mInputFifoWritePos - mInputFifoCount + mInputFifoSize) % mInputFifoSize;
+   int numBeforeWrap = MIN(numInput, mInputFifoSize - readPos);
+   for (size_t i = 0; i < mInputBuffers.size(); ++i)
+   {
+      BufferCopy(mInputBuffers[i], mInputFifo[i] + readPos, numBeforeWrap);
+      BufferCopy(mInputBuffers[i] + numBeforeWrap, mInputFifo[i], numInput - numBeforeWrap);
+      Clear(mInputBuffers[i] + numInput, gBufferSize - numInput);
+   }
+   mInputFifoCount -= numInput;
+   
+   for (size_t i = 0; i < mOutputBuffers.size(); ++i)
+      Clear(mOutputBuffers[i], gBufferSize);
+
+   double elapsed = gInvSampleRateMs * gBufferSize;
+   gTime += elapsed;
+   {
+      RealtimeSafetyChecker::ScopedContext context("note events");
+      mNoteEventBus.BeginBuffer();
+   }
+   {
+      RealtimeSafetyChecker::ScopedContext context("transport");
+      TheTransport->Advance(elapsed);
+   }
+   
+   //process all audio
+   for (int i=0; i<mSources.size(); ++i)
+   {
+      RealtimeSafetyChecker::ScopedContext context(mSources[i]);
+      mCallbackTelemetry.BeginSource();
+      mSources[i]->Process(gTime);
+      mCallbackTelemetry.EndSource(mSources[i]);
+   }
+}
+
 void ModularSynth::AudioIn(const float** input, int bufferSize, int nChannels)
 {
    if (mAudioPaused)
@@ -1706,13 +1810,25 @@ void ModularSynth::AudioIn(const float** input, int bufferSize, int nChannels)
    
    ScopedMutex mutex(&mAudioThreadMutex, "audioIn()");
 
-   assert(bufferSize == mIOBufferSize);
-   assert(nChannels == (int)mInputBuffers.size());
+   assert(nChannels == (int)mInputFifo.size());
+   
+   //devices are allowed to change their callback size, which can need more latency than we primed the fifo with
+   int latency = GetIOLatencyForBufferSize(bufferSize);
+   if (latency > mIOLatency)
+      ResetIOFifo(latency);
+   mIOBufferSize = bufferSize;
    
+   //if the fifo overflows, keep the newest input
+   int skip = MAX(0, bufferSize - mInputFifoSize);
+   int numSamples = bufferSize - skip;
+   int numBeforeWrap = MIN(numSamples, mInputFifoSize - mInputFifoWritePos);
    for (int i=0; i<nChannels; ++i)
    {
-      BufferCopy(mInputBuffers[i], input[i], bufferSize);
+      BufferCopy(mInputFifo[i] + mInputFifoWritePos, input[i] + skip, numBeforeWrap);
+      BufferCopy(mInputFifo[i], input[i] + skip + numBeforeWrap, numSamples - numBeforeWrap);
    }
+   mInputFifoWritePos = (mInputFifoWritePos + numSamples) % mInputFifoSize;
+   mInputFifoCount = MIN(mInputFifoCount + numSamples, mInputFifoSize);
 }
 
 float* ModularSynth::GetInputBuffer(int channel)
@@ -1749,6 +1865,19 @@ void ModularSynth::FilesDropped(std::vector<std::string> files, int intX, int in
    }
 }
 
+bool ModularSynth::IsAudioTarget(IAudioReceiver* receiver)
+{
+   for (auto* source : mSources)
+   {
+      for (int i=0; i<source->GetNumTargets(); ++i)
+      {
+         if (source->GetTarget(i) == receiver)
+            return true;
+      }
+   }
+   return false;
+}
+
 struct SourceDepInfo
 {
    SourceDepInfo(IAudioSource* me) : mMe(me) {}
@@ -1759,6 +1888,7 @@ struct SourceDepInfo
 void ModularSynth::ArrangeAudioSourceDependencies()
 {
    //ofLog() << "Calculating audio source dependencies:";
+   mCallbackTelemetry.NotePatchChange("audio graph rearranged");
    
    std::vector<SourceDepInfo> deps;
    for (int i=0; i<mSources.size(); ++i)
@@ -1838,6 +1968,7 @@ void ModularSynth::ResetLayout()
    mMainComponent->getTopLevelComponent()->setName("bespoke synth");
    mCurrentSaveStatePath = "";
 
+   mNoteEventBus.Clear();
    mModuleContainer.Clear();
    mUILayerModuleContainer.Clear();
    
@@ -2084,6 +2215,7 @@ void ModularSynth::OnModuleAdded(IDrawableModule* module)
    IAudioSource* source = dynamic_cast<IAudioSource*>(module);
    if (source)
       mSources.push_back(source);
+   mCallbackTelemetry.NotePatchChange("added " + std::string(module->Name()));
 }
 
 void ModularSynth::AddDynamicModule(IDrawableModule* module)
@@ -2452,7 +2584,10 @@ void ModularSynth::OnConsoleInput()
       }
       else if (tokens[0] == "write")
       {
-         SaveOutput();
+         if (tokens.size() > 1)
+            SaveOutput(ofToFloat(tokens[1]));
+         else
+            SaveOutput();
       }
       else if (tokens[0] == "reconnect")
       {
@@ -2544,6 +2679,57 @@ void ModularSynth::OnConsoleInput()
       {
          DumpStats(false, nullptr);
       }
+      else if (tokens[0] == "benchmarkbiquads")
+      {
+         int numBands = tokens.size() >= 2 ? atoi(tokens[1].c_str()) : 40;
+         if (numBands > 0)
+            BiquadBank::RunBenchmark(numBands, gBufferSize);
+      }
+      else if (tokens[0] == "rtcheck")
+      {
+         if (tokens.size() >= 2 && tokens[1] == "report")
+            RealtimeSafetyChecker::WriteReport();
+         else if (tokens.size() >= 2)
+            RealtimeSafetyChecker::SetEnabled(tokens[1] == "on");
+         else
+            RealtimeSafetyChecker::SetEnabled(!RealtimeSafetyChecker::IsEnabled());
+      }
+      else if (tokens[0] == "xruns")
+      {
+         mCallbackTelemetry.ToggleDraw();
+      }
+      else if (tokens[0] == "dumpxruns")
+      {
+         ofLog() << "wrote audio callback telemetry to " << mCallbackTelemetry.Dump();
+      }
+      else if (tokens[0] == "resetxruns")
+      {
+         mCallbackTelemetry.Reset();
+      }
+      else if (tokens[0] == "benchmarkdelay")
+      {
+         int bufferSize = tokens.size() >= 2 ? atoi(tokens[1].c_str()) : gBufferSize;
+         if (bufferSize > 0 && bufferSize <= 8192)
+            DelayLine::RunBenchmark(bufferSize);
+      }
+      else if (tokens[0] == "benchmarkdynamics")
+      {
+         int bufferSize = tokens.size() >= 2 ? atoi(tokens[1].c_str()) : gBufferSize;
+         if (bufferSize > 0 && bufferSize <= 8192)
+            DynamicsCore::RunBenchmark(bufferSize);
+      }
+      else if (tokens[0] == "benchmarkoversampling")
+      {
+         int bufferSize = tokens.size() >= 2 ? atoi(tokens[1].c_str()) : gBufferSize;
+         if (bufferSize > 0 && bufferSize <= 8192)
+            Oversampler::RunBenchmark(bufferSize);
+      }
+      else if (tokens[0] == "rendercache")
+      {
+         if (tokens.size() >= 2)
+            mRenderCache.SetEnabled(tokens[1] == "on");
+         ofLog() << "module render cache " << (mRenderCache.IsEnabled() ? "on" : "off");
+      }
       else
       {
          ofLog() << "Creating: " << mConsoleText;
@@ -2752,32 +2938,19 @@ void ModularSynth::ReconnectMidiDevices()
       mMidiDevices[i]->Reconnect();
 }
 
-void ModularSynth::SaveOutput()
+void ModularSynth::SaveOutput(float lastMinutes /*= -1*/)
 {
-   ScopedMutex mutex(&mAudioThreadMutex, "SaveOutput()");
-
    std::string recordingsPath = "recordings/";
    if (!mUserPrefs["recordings_path"].isNull())
       recordingsPath = mUserPrefs["recordings_path"].asString();
    
    std::string filename = ofGetTimestampString(recordingsPath + "recording_%Y-%m-%d_%H-%M.wav");
-   //string filenamePos = ofGetTimestampString("recordings/pos_%Y-%m-%d_%H-%M.wav");
-
-   assert(mRecordingLength <= mGlobalRecordBuffer->Size());
-   
-   for (int i=0; i<mRecordingLength; ++i)
-   {
-      mSaveOutputBuffer[0][i] = mGlobalRecordBuffer->GetSample((int)mRecordingLength-i-1, 0);
-      mSaveOutputBuffer[1][i] = mGlobalRecordBuffer->GetSample((int)mRecordingLength-i-1, 1);
-   }
 
-   Sample::WriteDataToFile(filename.c_str(), mSaveOutputBuffer, (int)mRecordingLength, 2);
-   
-   //mOutputBufferMeasurePos.ReadChunk(mSaveOutputBuffer, mRecordingLength);
-   //Sample::WriteDataToFile(filenamePos.c_str(), mSaveOutputBuffer, mRecordingLength, 1);
-   
-   mGlobalRecordBuffer->ClearBuffer();
-   mRecordingLength = 0;
+   long long maxSamples = -1;
+   if (lastMinutes > 0)
+      maxSamples = (long long)(lastMinutes * 60 * gSampleRate);
+   if (!mRetrospectiveRecorder->Save(filename, maxSamples))
+      LogEvent("couldn't write " + filename, kLogEventType_Error);
 }
 
 const String& ModularSynth::GetTextFromClipboard() const {
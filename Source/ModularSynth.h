@@ -13,6 +13,10 @@
 #include "LocationZoomer.h"
 #include "EffectFactory.h"
 #include "ModuleContainer.h"
+#include "ModuleRenderCache.h"
+#include "NoteEventBus.h"
+#include "AudioCallbackTelemetry.h"
+#include "AnticipativeRenderPool.h"
 #ifdef BESPOKE_LINUX
 #include <climits>
 #endif
@@ -34,6 +38,7 @@ class PatchCable;
 class MidiController;
 class NVGcontext;
 class QuickSpawnMenu;
+class RetrospectiveRecorder;
 class ADSRDisplay;
 class UserPrefsEditor;
 
@@ -63,9 +68,10 @@ public:
    
    void Setup(juce::AudioDeviceManager* globalAudioDeviceManager, juce::AudioFormatManager* globalAudioFormatManager, juce::Component* mainComponent, juce::OpenGLContext* openGLContext);
    void LoadResources(void* nanoVG, void* fontBoundsNanoVG);
-   void InitIOBuffers(int inputChannelCount, int outputChannelCount);
+   void InitIOBuffers(int inputChannelCount, int outputChannelCount, int ioBufferSize);
    void Poll();
    void Draw(void* vg);
+   void UpdateRenderCache(void* vg);
    void PostRender();
    
    void Exit();
@@ -97,11 +103,13 @@ public:
    
    void AddMidiDevice(MidiDevice* device);
    void ArrangeAudioSourceDependencies();
+   bool IsAudioTarget(IAudioReceiver* receiver);
    IDrawableModule* SpawnModuleOnTheFly(std::string moduleName, float x, float y, bool addToContainer = true);
    void SetMoveModule(IDrawableModule* module, float offsetX, float offsetY);
    
    int GetNumInputChannels() const { return (int)mInputBuffers.size(); }
    int GetNumOutputChannels() const { return (int)mOutputBuffers.size(); }
+   int GetIOLatency() const { return mIOLatency; }
    float* GetInputBuffer(int channel);
    float* GetOutputBuffer(int channel);
    
@@ -150,6 +158,9 @@ public:
    long GetFrameCount() { return mFrameCount; }
    void SetUIScale(float scale) { mUILayerModuleContainer.SetDrawScale(scale); }
    ModuleContainer* GetRootContainer() { return &mModuleContainer; }
+   ModuleRenderCache* GetRenderCache() { return &mRenderCache; }
+   NoteEventBus* GetNoteEventBus() { return &mNoteEventBus; }
+   AnticipativeRenderPool* GetAnticipativeRenderPool() { return &mAnticipativeRenderPool; }
 
    void ZoomView(float zoomAmount, bool fromMouse);
    void PanView(float x, float y);
@@ -205,7 +216,7 @@ public:
    void SaveLayout(std::string jsonFile = "", bool makeDefaultLayout = true);
    ofxJSONElement GetLayout();
    void SaveLayoutAsPopup();
-   void SaveOutput();
+   void SaveOutput(float lastMinutes = -1);
    void SaveState(std::string file, bool autosave);
    void LoadState(std::string file);
    void SaveCurrentState();
@@ -242,7 +253,12 @@ private:
 
    void ReadClipboardTextFromSystem();
    
+   void ResetIOFifo(int latency);
+   static int GetIOLatencyForBufferSize(int ioBufferSize);
+   void ProcessAudioBlock();
+   
    int mIOBufferSize;
+   int mIOLatency;
    
    std::vector<IAudioSource*> mSources;
    std::vector<IDrawableModule*> mLissajousDrawers;
@@ -280,8 +296,7 @@ private:
    QuickSpawnMenu* mQuickSpawn;
    UserPrefsEditor* mUserPrefsEditor;
 
-   RollingBuffer* mGlobalRecordBuffer;
-   long long mRecordingLength;
+   RetrospectiveRecorder* mRetrospectiveRecorder;
    
    struct LogEventItem
    {
@@ -294,6 +309,7 @@ private:
    std::list<std::string> mErrors;
    
    NamedMutex mAudioThreadMutex;
+   AudioCallbackTelemetry mCallbackTelemetry;
    
    bool mAudioPaused;
    bool mIsLoadingState;
@@ -311,8 +327,6 @@ private:
    
    Sample* mHeldSample;
    
-   float* mSaveOutputBuffer[2];
-   
    IDrawableModule* mLastClickedModule;
    
    ofxJSONElement mUserPrefs;
@@ -363,9 +377,22 @@ private:
    float mScrollMultiplierVertical;
 
    double mPixelRatio;
+   
+   ModuleRenderCache mRenderCache;
+   NoteEventBus mNoteEventBus;
+   AnticipativeRenderPool mAnticipativeRenderPool;
+   std::vector<IDrawableModule*> mRenderCacheModules;
 
    std::vector<float*> mInputBuffers;
    std::vector<float*> mOutputBuffers;
+   
+   //the device buffer size doesn't have to match gBufferSize. device input is queued in a fifo until there's a whole
+   //block of it, and each block of output is handed out to the device in whatever pieces it asks for
+   std::vector<float*> mInputFifo;
+   int mInputFifoSize;
+   int mInputFifoWritePos;
+   int mInputFifoCount;
+   int mOutputReadPos;
 };
 
 extern ModularSynth* TheSynth;
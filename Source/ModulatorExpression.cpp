@@ -36,6 +36,7 @@ const int kGraphWidth = 100;
 const int kGraphHeight = 100;
 const int kGraphX = 115;
 const int kGraphY = 18;
+const std::vector<std::string> kVariables = { "x", "t", "a", "b", "c", "d", "e" };  //in BlockInput order
 }
 
 ModulatorExpression::ModulatorExpression()
@@ -54,8 +55,20 @@ ModulatorExpression::ModulatorExpression()
 , mExpressionValid(false)
 , mLastDrawMinOutput(0)
 , mLastDrawMaxOutput(1)
+, mBlockTime(-1)
 {
    mEntryString = "x";
+   
+   for (int i=0; i<kNumBlockInputs; ++i)
+      mBlockInputs[i] = new float[gBufferSize];
+   mBlockOutput = new float[gBufferSize];
+}
+
+void ModulatorExpression::Init()
+{
+   IDrawableModule::Init();
+   
+   TheTransport->AddAudioPoller(this);
 }
 
 void ModulatorExpression::CreateUIControls()
@@ -100,14 +113,66 @@ void ModulatorExpression::CreateUIControls()
 
 ModulatorExpression::~ModulatorExpression()
 {
+   TheTransport->RemoveAudioPoller(this);
+   
+   for (int i=0; i<kNumBlockInputs; ++i)
+      delete[] mBlockInputs[i];
+   delete[] mBlockOutput;
+}
+
+void ModulatorExpression::OnTransportAdvanced(float amount)
+{
+   std::shared_ptr<const CompiledExpression> compiled = std::atomic_load(&mCompiled);
+   if (!mEnabled || !mExpressionValid || compiled == nullptr || mTarget == nullptr)
+   {
+      mBlockTime = -1;
+      return;
+   }
+   
+   //evaluate the whole buffer up front, so the target slider's per-sample Value() calls are lookups
+   float* values[kNumBlockInputs] = { &mExpressionInput, &mT, &mA, &mB, &mC, &mD, &mE };
+   for (int i=0; i<gBufferSize; ++i)
+   {
+      ComputeSliders(i);
+      mT = (gTime + i * gInvSampleRateMs) * .001;
+      for (int j=0; j<kNumBlockInputs; ++j)
+         mBlockInputs[j][i] = *values[j];
+   }
+   
+   CompiledExpression::Input inputs[kNumBlockInputs];
+   for (int j=0; j<kNumBlockInputs; ++j)
+   {
+      inputs[j].mValues = mBlockInputs[j];
+      inputs[j].mUniform = true;
+      for (int i=1; i<gBufferSize; ++i)
+      {
+         if (mBlockInputs[j][i] != mBlockInputs[j][0])
+         {
+            inputs[j].mUniform = false;
+            break;
+         }
+      }
+   }
+   
+   compiled->Evaluate(inputs, mBlockOutput, gBufferSize);
+   mBlockTime = gTime;
 }
 
 float ModulatorExpression::Value(int samplesIn)
 {
+   if (mExpressionValid && mBlockTime == gTime && samplesIn >= 0 && samplesIn < gBufferSize)
+      return mBlockOutput[samplesIn];
+   
    ComputeSliders(samplesIn);
    if (mExpressionValid)
    {
       mT = (gTime + samplesIn * gInvSampleRateMs) * .001;
+      std::shared_ptr<const CompiledExpression> compiled = std::atomic_load(&mCompiled);
+      if (compiled)
+      {
+         float inputs[kNumBlockInputs] = { mExpressionInput, mT, mA, mB, mC, mD, mE };
+         return compiled->Evaluate(inputs);
+      }
       return mExpression.value();
    }
    
@@ -133,6 +198,10 @@ void ModulatorExpression::TextEntryComplete(TextEntry* entry)
    mExpressionValid = parser.compile(mEntryString, mExpression);
    if (mExpressionValid)
       parser.compile(mEntryString, mExpressionDraw);
+   
+   //compiled expressions are shared between every module using the same text
+   std::atomic_store(&mCompiled, mExpressionValid ? CompiledExpression::Compile(mEntryString, kVariables) : std::shared_ptr<const CompiledExpression>());
+   mBlockTime = -1;
 }
 
 void ModulatorExpression::DrawModule()
@@ -164,10 +233,27 @@ void ModulatorExpression::DrawModule()
       ofBeginShape();
       float drawMinOutput = mLastDrawMinOutput;
       float drawMaxOutput = mLastDrawMaxOutput;
+      float graphInputs[kGraphWidth+1];
+      float graphOutputs[kGraphWidth+1];
       for (int i=0; i<=kGraphWidth; ++i)
+         graphInputs[i] = ofMap(i, 0, kGraphWidth, mExpressionInputSlider->GetMin(), mExpressionInputSlider->GetMax());
+      std::shared_ptr<const CompiledExpression> compiled = std::atomic_load(&mCompiled);
+      if (compiled)
+      {
+         CompiledExpression::Input inputs[kNumBlockInputs] = { {graphInputs,false}, {&mT,true}, {&mA,true}, {&mB,true}, {&mC,true}, {&mD,true}, {&mE,true} };
+         compiled->Evaluate(inputs, graphOutputs, kGraphWidth+1);
+      }
+      else
       {
-         mExpressionInputDraw = ofMap(i, 0, kGraphWidth, mExpressionInputSlider->GetMin(), mExpressionInputSlider->GetMax());
-         float output = mExpressionDraw.value();
+         for (int i=0; i<=kGraphWidth; ++i)
+         {
+            mExpressionInputDraw = graphInputs[i];
+            graphOutputs[i] = mExpressionDraw.value();
+         }
+      }
+      for (int i=0; i<=kGraphWidth; ++i)
+      {
+         float output = graphOutputs[i];
          ofVertex(i + kGraphX, ofMap(output, drawMinOutput, drawMaxOutput, kGraphHeight, 0) + kGraphY);
          
          if (i == 0)
@@ -187,7 +273,17 @@ void ModulatorExpression::DrawModule()
       
       ofSetColor(245, 58, 135);
       mExpressionInputDraw = mExpressionInput;
-      ofCircle(kGraphX + ofMap(mExpressionInputDraw, mExpressionInputSlider->GetMin(), mExpressionInputSlider->GetMax(), 0, kGraphWidth), ofMap(mExpressionDraw.value(), mLastDrawMinOutput, mLastDrawMaxOutput, kGraphHeight, 0) + kGraphY, 3);
+      float currentOutput;
+      if (compiled)
+      {
+         float inputs[kNumBlockInputs] = { mExpressionInputDraw, mT, mA, mB, mC, mD, mE };
+         currentOutput = compiled->Evaluate(inputs);
+      }
+      else
+      {
+         currentOutput = mExpressionDraw.value();
+      }
+      ofCircle(kGraphX + ofMap(mExpressionInputDraw, mExpressionInputSlider->GetMin(), mExpressionInputSlider->GetMax(), 0, kGraphWidth), ofMap(currentOutput, mLastDrawMinOutput, mLastDrawMaxOutput, kGraphHeight, 0) + kGraphY, 3);
       ofPopStyle();
       
       DrawTextNormal(ofToString(drawMinOutput,2), kGraphX+kGraphWidth*.35f, kGraphY+kGraphHeight-1);
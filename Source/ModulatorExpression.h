@@ -32,9 +32,11 @@
 #include "Slider.h"
 #include "ClickButton.h"
 #include "TextEntry.h"
+#include "Transport.h"
+#include "CompiledExpression.h"
 #include "exprtk/exprtk.hpp"
 
-class ModulatorExpression : public IDrawableModule, public IFloatSliderListener, public ITextEntryListener, public IModulator
+class ModulatorExpression : public IDrawableModule, public IFloatSliderListener, public ITextEntryListener, public IModulator, public IAudioPoller
 {
 public:
    ModulatorExpression();
@@ -43,12 +45,16 @@ public:
    
    std::string GetTitleLabel() override { return "expression"; }
    void CreateUIControls() override;
+   void Init() override;
    
    //IModulator
    float Value(int samplesIn = 0) override;
    bool Active() const override { return mEnabled; }
    bool CanAdjustRange() const override { return false; }
    
+   //IAudioPoller
+   void OnTransportAdvanced(float amount) override;
+   
    void PostRepatch(PatchCableSource* cableSource, bool fromUserClick) override;
    
    //IFloatSliderListener
@@ -89,6 +95,23 @@ private:
    float mExpressionInputDraw;
    float mT;
    bool mExpressionValid;
+   
+   //the expression compiled for block evaluation, null if it uses syntax that only exprtk handles
+   std::shared_ptr<const CompiledExpression> mCompiled;
+   enum BlockInput
+   {
+      kBlockInput_X,
+      kBlockInput_T,
+      kBlockInput_A,
+      kBlockInput_B,
+      kBlockInput_C,
+      kBlockInput_D,
+      kBlockInput_E,
+      kNumBlockInputs
+   };
+   float* mBlockInputs[kNumBlockInputs];
+   float* mBlockOutput;
+   double mBlockTime;
    float mLastDrawMinOutput;
    float mLastDrawMaxOutput;
 };
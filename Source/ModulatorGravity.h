@@ -59,6 +59,7 @@ public:
    
    //IAudioPoller
    void OnTransportAdvanced(float amount) override;
+   bool IsControlRate() const override { return true; }
    
    FloatSlider* GetTarget() { return mTarget; }
    
@@ -77,6 +78,7 @@ private:
 
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=mWidth; h=mHeight; }
    bool Enabled() const override { return mEnabled; }
    
@@ -56,6 +56,7 @@ public:
    
    //IAudioPoller
    void OnTransportAdvanced(float amount) override;
+   bool IsControlRate() const override { return true; }
    
    FloatSlider* GetTarget() { return mTarget; }
    
@@ -69,6 +70,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=106; h=17*2+4; }
    bool Enabled() const override { return mEnabled; }
    
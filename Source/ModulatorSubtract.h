@@ -63,6 +63,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=106; h=17*2+4; }
    bool Enabled() const override { return mEnabled; }
    
@@ -37,9 +37,15 @@
 
 #include "juce_core/juce_core.h"
 
+namespace
+{
+   const float kCullMargin = 40;  //room for beacons and shadows
+}
+
 ModuleContainer::ModuleContainer()
 : mOwner(nullptr)
 , mDrawScale(1)
+, mSpatialIndexDirty(true)
 {
    
 }
@@ -61,19 +67,94 @@ void ModuleContainer::GetAllModules(std::vector<IDrawableModule*>& out)
    }
 }
 
+void ModuleContainer::QuerySpatialIndex(const ofRectangle& rect, std::vector<IDrawableModule*>& output)
+{
+   std::lock_guard<std::mutex> lock(mSpatialIndexMutex);
+   
+   if (mSpatialIndexDirty)
+   {
+      mSpatialIndex.Rebuild(mModules);
+      mSpatialIndexDirty = false;
+   }
+   
+   mSpatialIndex.Query(rect, output);
+}
+
+void ModuleContainer::UpdateSpatialIndex(IDrawableModule* module)
+{
+   std::lock_guard<std::mutex> lock(mSpatialIndexMutex);
+   if (!mSpatialIndexDirty)   //otherwise the next query rebuilds it anyway
+      mSpatialIndex.Update(module);
+}
+
+void ModuleContainer::UpdateSpatialIndex(const std::vector<IDrawableModule*>& modules)
+{
+   std::lock_guard<std::mutex> lock(mSpatialIndexMutex);
+   if (!mSpatialIndexDirty)
+   {
+      for (auto* module : modules)
+         mSpatialIndex.Update(module);
+   }
+}
+
 void ModuleContainer::Draw()
 {
+   //cull offscreen modules. DrawRect is only meaningful for the root container,
+   //and modules that don't clip their contents can draw anywhere.
+   bool cull = (this == TheSynth->GetRootContainer());
+   if (cull)
+   {
+      ofRectangle drawRect = TheSynth->GetDrawRect();
+      mVisibleModules.clear();
+      QuerySpatialIndex(drawRect.grow(kCullMargin), mVisibleModules);
+      mCulledModules.clear();
+   }
+   
+   //both lists are front to back, so walk them together
+   int visibleIndex = (int)mVisibleModules.size()-1;
    for (int i = (int)mModules.size()-1; i >= 0; --i)
    {
+      bool visible = true;
+      if (cull)
+      {
+         visible = visibleIndex >= 0 && mVisibleModules[visibleIndex] == mModules[i];
+         if (visible)
+            --visibleIndex;
+      }
+      
       if (!mModules[i]->AlwaysOnTop())
-         mModules[i]->Draw();
+      {
+         if (visible || !mModules[i]->ShouldClipContents())
+            mModules[i]->Draw();
+         else
+            mCulledModules.push_back(mModules[i]);
+      }
    }
    
+   visibleIndex = (int)mVisibleModules.size()-1;
    for (int i = (int)mModules.size()-1; i >= 0; --i)
    {
+      bool visible = true;
+      if (cull)
+      {
+         visible = visibleIndex >= 0 && mVisibleModules[visibleIndex] == mModules[i];
+         if (visible)
+            --visibleIndex;
+      }
+      
       if (mModules[i]->AlwaysOnTop())
-         mModules[i]->Draw();
+      {
+         if (visible || !mModules[i]->ShouldClipContents())
+            mModules[i]->Draw();
+         else
+            mCulledModules.push_back(mModules[i]);
+      }
    }
+   
+   //drawn modules refresh their own bounds as they render. the rest can still change size with their state,
+   //and stale bounds would keep one that grew onto the screen from ever being drawn
+   if (cull)
+      UpdateSpatialIndex(mCulledModules);
 }
 
 void ModuleContainer::DrawUnclipped()
@@ -133,6 +214,7 @@ void ModuleContainer::Clear()
          DeleteModule(module);
    }
    mModules.clear();
+   mSpatialIndexDirty = true;
 }
 
 void ModuleContainer::Exit()
@@ -210,11 +292,14 @@ IDrawableModule* ModuleContainer::GetModuleAt(float x, float y)
          return modalItems[i];
    }
    
-   for (int i=0; i<mModules.size(); ++i)
+   std::vector<IDrawableModule*> candidates;
+   QuerySpatialIndex(ofRectangle(x, y, 0, 0), candidates);
+   
+   for (auto* module : candidates)
    {
-      if (mModules[i]->AlwaysOnTop() && mModules[i]->TestClick(x,y,false,true))
+      if (module->AlwaysOnTop() && module->TestClick(x,y,false,true))
       {
-         ModuleContainer* subcontainer = mModules[i]->GetContainer();
+         ModuleContainer* subcontainer = module->GetContainer();
          if (subcontainer)
          {
             IDrawableModule* contained = subcontainer->GetModuleAt(x - subcontainer->GetOwnerPosition().x, y - subcontainer->GetOwnerPosition().y);
@@ -223,14 +308,14 @@ IDrawableModule* ModuleContainer::GetModuleAt(float x, float y)
                return contained;
             }
          }
-         return mModules[i];
+         return module;
       }
    }
-   for (int i=0; i<mModules.size(); ++i)
+   for (auto* module : candidates)
    {
-      if (!mModules[i]->AlwaysOnTop() && mModules[i]->TestClick(x,y,false,true))
+      if (!module->AlwaysOnTop() && module->TestClick(x,y,false,true))
       {
-         ModuleContainer* subcontainer = mModules[i]->GetContainer();
+         ModuleContainer* subcontainer = module->GetContainer();
          if (subcontainer)
          {
             IDrawableModule* contained = subcontainer->GetModuleAt(x, y);
@@ -239,7 +324,7 @@ IDrawableModule* ModuleContainer::GetModuleAt(float x, float y)
                return contained;
             }
          }
-         return mModules[i];
+         return module;
       }
    }
    return nullptr;
@@ -261,11 +346,14 @@ float ModuleContainer::GetDrawScale() const
 
 void ModuleContainer::GetModulesWithinRect(ofRectangle rect, std::vector<IDrawableModule*>& output)
 {
+   std::vector<IDrawableModule*> candidates;
+   QuerySpatialIndex(rect, candidates);
+   
    output.clear();
-   for (int i=0; i<mModules.size(); ++i)
+   for (auto* module : candidates)
    {
-      if (mModules[i]->IsWithinRect(rect) && mModules[i] != TheQuickSpawnMenu && mModules[i]->IsShowing())
-         output.push_back(mModules[i]);
+      if (module->IsWithinRect(rect) && module != TheQuickSpawnMenu && module->IsShowing())
+         output.push_back(module);
    }
 }
 
@@ -281,6 +369,7 @@ void ModuleContainer::MoveToFront(IDrawableModule* module)
          for (int j=i; j>0; --j)
             mModules[j] = mModules[j-1];
          mModules[0] = module;
+         mSpatialIndexDirty = true;
          
          break;
       }
@@ -290,6 +379,7 @@ void ModuleContainer::MoveToFront(IDrawableModule* module)
 void ModuleContainer::AddModule(IDrawableModule* module)
 {
    mModules.push_back(module);
+   mSpatialIndexDirty = true;
    MoveToFront(module);
    TheSynth->OnModuleAdded(module);
    module->SetOwningContainer(this);
@@ -304,8 +394,10 @@ void ModuleContainer::TakeModule(IDrawableModule* module)
    if (module->GetOwningContainer()->mOwner)
       module->GetOwningContainer()->mOwner->RemoveChild(module);
    RemoveFromVector(module, module->GetOwningContainer()->mModules);
+   module->GetOwningContainer()->mSpatialIndexDirty = true;
    
    mModules.push_back(module);
+   mSpatialIndexDirty = true;
    MoveToFront(module);
    
    ofVec2f offset = oldOwnerPos - GetOwnerPosition();
@@ -331,10 +423,12 @@ void ModuleContainer::DeleteModule(IDrawableModule* module)
    {
       module->DoSpecialDelete();
       RemoveFromVector(module, mModules, K(fail));
+      mSpatialIndexDirty = true;
       return;
    }
    
    RemoveFromVector(module, mModules, K(fail));
+   mSpatialIndexDirty = true;
    for (auto iter : mModules)
    {
       if (iter->GetPatchCableSource())
@@ -527,6 +621,8 @@ void ModuleContainer::LoadModules(const ofxJSONElement& modules)
       
       IClickable::ClearLoadContext();
    }
+   
+   mSpatialIndexDirty = true;
 }
 
 bool ModuleSorter(const IDrawableModule* a, const IDrawableModule* b)
@@ -31,6 +31,9 @@
 #include "OpenFrameworksPort.h"
 #include "IDrawableModule.h"
 #include "ofxJSONElement.h"
+#include "ModuleSpatialIndex.h"
+
+#include <mutex>
 
 class ModuleContainer
 {
@@ -90,12 +93,23 @@ public:
    static const char* GetModuleSeparator() { return "ryanchallinor"; }
    static bool DoesModuleHaveMoreSaveData(FileStreamIn& in);
    
-private:   
+   void UpdateSpatialIndex(IDrawableModule* module);
+   
+private:
+   void QuerySpatialIndex(const ofRectangle& rect, std::vector<IDrawableModule*>& output);
+   void UpdateSpatialIndex(const std::vector<IDrawableModule*>& modules);
+   
    std::vector<IDrawableModule*> mModules;
    IDrawableModule* mOwner;
 
    ofVec2f mDrawOffset;
    float mDrawScale;
+   
+   ModuleSpatialIndex mSpatialIndex;
+   std::mutex mSpatialIndexMutex;
+   bool mSpatialIndexDirty;   //set when modules are added, removed or reordered, and when a patch is loaded
+   std::vector<IDrawableModule*> mVisibleModules;
+   std::vector<IDrawableModule*> mCulledModules;
 };
 
 #endif  // MODULECONTAINER_H_INCLUDED
@@ -0,0 +1,283 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    ModuleRenderCache.cpp
+    Created: 19 Oct 2026 10:02:17am
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "juce_opengl/juce_opengl.h"
+using namespace juce::gl;
+
+#include "ModuleRenderCache.h"
+#include "nanovg/nanovg.h"
+#include "nanovg/nanovg_gl_utils.h"
+#include "OpenFrameworksPort.h"
+#include "IDrawableModule.h"
+#include "IUIControl.h"
+#include "SynthGlobals.h"
+#include "ModularSynth.h"
+#include "PatchCable.h"
+#include "Presets.h"
+#include "TextEntry.h"
+
+namespace
+{
+   const int kMaxPixelSize = 2048;
+   const long kZoomSettleFrames = 10;   //draw live while zooming, rather than re-rendering every frame
+   const long kEvictAfterFrames = 600;  //free framebuffers of modules that haven't been on screen for a while
+}
+
+ModuleRenderCache::Entry::Entry()
+: mFramebuffer(nullptr)
+, mPixelWidth(0)
+, mPixelHeight(0)
+, mWidth(0)
+, mHeight(0)
+, mAlpha(0)
+, mDrawScale(0)
+, mValid(false)
+, mDrawable(false)
+, mRenderedFrame(-1)
+, mLastVisibleFrame(-1)
+{
+}
+
+bool ModuleRenderCache::DrawState::operator==(const DrawState& other) const
+{
+   return mMidiMapMode == other.mMidiMapMode &&
+          mGroupSelecting == other.mGroupSelecting &&
+          mBindTarget == other.mBindTarget &&
+          mKeyboardFocus == other.mKeyboardFocus &&
+          mActivePatchCable == other.mActivePatchCable &&
+          mNumPresetHighlights == other.mNumPresetHighlights;
+}
+
+ModuleRenderCache::ModuleRenderCache()
+: mEnabled(true)
+, mFrame(0)
+, mDrawScale(0)
+, mPixelRatio(0)
+, mLastScaleChangeFrame(0)
+, mNumHits(0)
+, mNumRedraws(0)
+{
+   mDrawState = DrawState();
+}
+
+ModuleRenderCache::~ModuleRenderCache()
+{
+   for (auto& iter : mEntries)
+      FreeEntry(iter.second);
+}
+
+void ModuleRenderCache::Update(NVGcontext* vg, const std::vector<IDrawableModule*>& modules, float pixelRatio)
+{
+   ++mFrame;
+   mNumHits = 0;
+   mNumRedraws = 0;
+
+   for (auto& iter : mEntries)
+      iter.second.mDrawable = false;
+
+   if (!mEnabled)
+   {
+      for (auto& iter : mEntries)
+         FreeEntry(iter.second);
+      mEntries.clear();
+      return;
+   }
+
+   if (gDrawScale != mDrawScale || pixelRatio != mPixelRatio)
+   {
+      mDrawScale = gDrawScale;
+      mPixelRatio = pixelRatio;
+      mLastScaleChangeFrame = mFrame;
+   }
+   bool zooming = mFrame - mLastScaleChangeFrame < kZoomSettleFrames;
+
+   DrawState drawState = GetCurrentDrawState();
+   bool invalidateAll = !(drawState == mDrawState);
+   mDrawState = drawState;
+
+   gNanoVG = vg;
+
+   for (auto* module : modules)
+   {
+      if (!module->IsRenderCacheable() || !module->IsShowing() || module->Minimized() ||
+          !module->ShouldClipContents() || !module->IsVisible() || ShouldDrawLive(module))
+         continue;
+
+      Entry& entry = mEntries[module];
+      entry.mLastVisibleFrame = mFrame;
+      if (invalidateAll)
+         entry.mValid = false;
+
+      float w, h;
+      module->GetDimensions(w, h);
+      float alpha = module->GetDrawAlpha();
+      bool upToDate = entry.mValid && w == entry.mWidth && h == entry.mHeight && alpha == entry.mAlpha && entry.mDrawScale == mDrawScale;
+      if (upToDate && !module->CheckNeedsDraw())
+      {
+         entry.mDrawable = true;
+         continue;
+      }
+
+      if (zooming)
+         continue;
+
+      if (Render(vg, module, entry, w, h, alpha))
+      {
+         entry.mDrawable = true;
+         ++mNumRedraws;
+      }
+   }
+
+   for (auto iter = mEntries.begin(); iter != mEntries.end();)
+   {
+      if (mFrame - iter->second.mLastVisibleFrame > kEvictAfterFrames)
+      {
+         FreeEntry(iter->second);
+         iter = mEntries.erase(iter);
+      }
+      else
+      {
+         ++iter;
+      }
+   }
+}
+
+bool ModuleRenderCache::Render(NVGcontext* vg, IDrawableModule* module, Entry& entry, float width, float height, float alpha)
+{
+   int pixelWidth = (int)ceilf(width * mDrawScale * mPixelRatio);
+   int pixelHeight = (int)ceilf(height * mDrawScale * mPixelRatio);
+   if (pixelWidth <= 0 || pixelHeight <= 0 || pixelWidth > kMaxPixelSize || pixelHeight > kMaxPixelSize)
+   {
+      FreeEntry(entry);
+      return false;
+   }
+
+   if (entry.mFramebuffer == nullptr || entry.mPixelWidth != pixelWidth || entry.mPixelHeight != pixelHeight)
+   {
+      FreeEntry(entry);
+      entry.mFramebuffer = nvgluCreateFramebuffer(vg, pixelWidth, pixelHeight, 0);
+      if (entry.mFramebuffer == nullptr)
+         return false;
+      entry.mPixelWidth = pixelWidth;
+      entry.mPixelHeight = pixelHeight;
+   }
+
+   GLint previousFramebuffer = 0;
+   glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+   nvgluBindFramebuffer(entry.mFramebuffer);
+   glViewport(0, 0, pixelWidth, pixelHeight);
+   glClearColor(0, 0, 0, 0);
+   glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+   nvgBeginFrame(vg, pixelWidth / mPixelRatio, pixelHeight / mPixelRatio, mPixelRatio);
+
+   nvgLineCap(vg, NVG_ROUND);
+   nvgLineJoin(vg, NVG_ROUND);
+   nvgTextLetterSpacing(vg, -.3f);
+
+   ofPushStyle();
+   ofScale(mDrawScale, mDrawScale, mDrawScale);
+   gModuleDrawAlpha = alpha;
+   module->DrawBody(width, height);
+   ofPopStyle();
+
+   nvgEndFrame(vg);
+   glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+   entry.mWidth = width;
+   entry.mHeight = height;
+   entry.mAlpha = alpha;
+   entry.mDrawScale = mDrawScale;
+   entry.mValid = true;
+   entry.mRenderedFrame = mFrame;
+   return true;
+}
+
+bool ModuleRenderCache::DrawBody(IDrawableModule* module, float width, float height)
+{
+   if (!mEnabled)
+      return false;
+
+   auto iter = mEntries.find(module);
+   if (iter == mEntries.end())
+      return false;
+
+   Entry& entry = iter->second;
+   if (!entry.mDrawable)
+   {
+      //the body is being drawn live, so the controls will consider themselves drawn and the image is stale
+      entry.mValid = false;
+      return false;
+   }
+
+   float scale = mDrawScale * mPixelRatio;
+   NVGpaint paint = nvgImagePattern(gNanoVG, 0, 0, entry.mPixelWidth / scale, entry.mPixelHeight / scale, 0, entry.mFramebuffer->image, 1);
+   nvgBeginPath(gNanoVG);
+   nvgRect(gNanoVG, 0, 0, width, height);
+   nvgFillPaint(gNanoVG, paint);
+   nvgFill(gNanoVG);
+
+   if (entry.mRenderedFrame != mFrame)
+      ++mNumHits;
+   return true;
+}
+
+bool ModuleRenderCache::ShouldDrawLive(IDrawableModule* module) const
+{
+   //whatever the user is interacting with is drawn live, it's going to change anyway
+   if (PatchCable::sActivePatchCable != nullptr)
+      return true;
+   if (module == gHoveredModule)
+      return true;
+   if (gHoveredUIControl != nullptr && gHoveredUIControl->GetModuleParent() == module)
+      return true;
+   IUIControl* focus = dynamic_cast<IUIControl*>(IKeyboardFocusListener::GetActiveKeyboardFocus());
+   if (focus != nullptr && focus->GetModuleParent() == module)
+      return true;
+   return false;
+}
+
+//static
+ModuleRenderCache::DrawState ModuleRenderCache::GetCurrentDrawState()
+{
+   DrawState state;
+   state.mMidiMapMode = TheSynth->InMidiMapMode();
+   state.mGroupSelecting = !TheSynth->GetGroupSelectedModules().empty();
+   state.mBindTarget = gBindToUIControl;
+   state.mKeyboardFocus = IKeyboardFocusListener::GetActiveKeyboardFocus();
+   state.mActivePatchCable = PatchCable::sActivePatchCable;
+   state.mNumPresetHighlights = Presets::sPresetHighlightControls.size();
+   return state;
+}
+
+void ModuleRenderCache::FreeEntry(Entry& entry)
+{
+   if (entry.mFramebuffer != nullptr)
+      nvgluDeleteFramebuffer(entry.mFramebuffer);
+   entry.mFramebuffer = nullptr;
+   entry.mValid = false;
+   entry.mDrawable = false;
+}
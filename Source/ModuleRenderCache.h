@@ -0,0 +1,104 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    ModuleRenderCache.h
+    Created: 19 Oct 2026 10:02:17am
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+struct NVGcontext;
+struct NVGLUframebuffer;
+class IDrawableModule;
+class IUIControl;
+class IKeyboardFocusListener;
+class PatchCable;
+
+//keeps the bodies of modules that opt in (IDrawableModule::IsRenderCacheable()) in offscreen framebuffers.
+//a cached body is drawn as a single image until one of its controls reports CheckNeedsDraw()
+class ModuleRenderCache
+{
+public:
+   ModuleRenderCache();
+   ~ModuleRenderCache();
+
+   void SetEnabled(bool enabled) { mEnabled = enabled; }
+   bool IsEnabled() const { return mEnabled; }
+
+   //must be called outside of the main nanovg frame, since it renders into the framebuffers with the same context
+   void Update(NVGcontext* vg, const std::vector<IDrawableModule*>& modules, float pixelRatio);
+   //called in place of drawing the module's body, returns false if the body has to be drawn live this frame
+   bool DrawBody(IDrawableModule* module, float width, float height);
+
+   int GetNumHits() const { return mNumHits; }
+   int GetNumRedraws() const { return mNumRedraws; }
+
+private:
+   struct Entry
+   {
+      Entry();
+
+      NVGLUframebuffer* mFramebuffer;
+      int mPixelWidth;
+      int mPixelHeight;
+      float mWidth;
+      float mHeight;
+      float mAlpha;
+      float mDrawScale;
+      bool mValid;
+      bool mDrawable;  //valid and up to date for this frame
+      long mRenderedFrame;
+      long mLastVisibleFrame;
+   };
+
+   //global ui state that changes how controls draw
+   struct DrawState
+   {
+      bool operator==(const DrawState& other) const;
+
+      bool mMidiMapMode;
+      bool mGroupSelecting;
+      IUIControl* mBindTarget;
+      IKeyboardFocusListener* mKeyboardFocus;
+      PatchCable* mActivePatchCable;
+      size_t mNumPresetHighlights;
+   };
+
+   bool Render(NVGcontext* vg, IDrawableModule* module, Entry& entry, float width, float height, float alpha);
+   bool ShouldDrawLive(IDrawableModule* module) const;
+   static DrawState GetCurrentDrawState();
+   void FreeEntry(Entry& entry);
+
+   std::map<IDrawableModule*, Entry> mEntries;
+   bool mEnabled;
+   long mFrame;
+   float mDrawScale;
+   float mPixelRatio;
+   long mLastScaleChangeFrame;
+   DrawState mDrawState;
+   int mNumHits;
+   int mNumRedraws;
+};
@@ -0,0 +1,208 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    ModuleSpatialIndex.cpp
+    Created: 19 Oct 2026 2:41:09pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "ModuleSpatialIndex.h"
+#include "IDrawableModule.h"
+#include "SynthGlobals.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+   const float kCellSize = 256;
+   const int kMaxCellsPerModule = 64;
+}
+
+ModuleSpatialIndex::ModuleSpatialIndex()
+: mQueryStamp(0)
+{
+}
+
+//static
+int ModuleSpatialIndex::GetCell(float pos)
+{
+   return (int)floorf(pos / kCellSize);
+}
+
+void ModuleSpatialIndex::Rebuild(const std::vector<IDrawableModule*>& modules)
+{
+   ++mQueryStamp;   //use the stamp to find modules that have gone away
+   
+   for (int i=0; i<(int)modules.size(); ++i)
+   {
+      IDrawableModule* module = modules[i];
+      ofRectangle bounds = module->GetHitTestBounds();
+      
+      auto iter = mEntries.find(module);
+      if (iter == mEntries.end())
+      {
+         Entry& entry = mEntries[module];
+         entry.mBounds = bounds;
+         Insert(module, entry);
+         entry.mOrder = i;
+         entry.mQueryStamp = mQueryStamp;
+         continue;
+      }
+      
+      Entry& entry = iter->second;
+      entry.mOrder = i;
+      entry.mQueryStamp = mQueryStamp;
+      SetBounds(module, entry, bounds);
+   }
+   
+   mStale.clear();
+   for (auto& iter : mEntries)
+   {
+      if (iter.second.mQueryStamp != mQueryStamp)
+         mStale.push_back(iter.first);
+   }
+   for (auto* module : mStale)
+   {
+      Remove(module, mEntries[module]);
+      mEntries.erase(module);
+   }
+}
+
+void ModuleSpatialIndex::Update(IDrawableModule* module)
+{
+   auto iter = mEntries.find(module);
+   if (iter != mEntries.end())
+      SetBounds(module, iter->second, module->GetHitTestBounds());
+}
+
+//only moves the module between cells if it has left the ones it was in
+void ModuleSpatialIndex::SetBounds(IDrawableModule* module, Entry& entry, const ofRectangle& bounds)
+{
+   if (bounds.x == entry.mBounds.x && bounds.y == entry.mBounds.y &&
+       bounds.width == entry.mBounds.width && bounds.height == entry.mBounds.height)
+      return;
+   
+   entry.mBounds = bounds;
+   if (entry.mOversized || GetCell(bounds.getMinX()) != entry.mMinCellX || GetCell(bounds.getMinY()) != entry.mMinCellY ||
+       GetCell(bounds.getMaxX()) != entry.mMaxCellX || GetCell(bounds.getMaxY()) != entry.mMaxCellY)
+   {
+      Remove(module, entry);
+      Insert(module, entry);
+   }
+}
+
+void ModuleSpatialIndex::Insert(IDrawableModule* module, Entry& entry)
+{
+   entry.mMinCellX = GetCell(entry.mBounds.getMinX());
+   entry.mMinCellY = GetCell(entry.mBounds.getMinY());
+   entry.mMaxCellX = GetCell(entry.mBounds.getMaxX());
+   entry.mMaxCellY = GetCell(entry.mBounds.getMaxY());
+   entry.mOversized = (entry.mMaxCellX - entry.mMinCellX + 1) * (entry.mMaxCellY - entry.mMinCellY + 1) > kMaxCellsPerModule;
+   
+   if (entry.mOversized)
+   {
+      mOversized.push_back(module);
+      return;
+   }
+   
+   for (int x = entry.mMinCellX; x <= entry.mMaxCellX; ++x)
+   {
+      for (int y = entry.mMinCellY; y <= entry.mMaxCellY; ++y)
+         mCells[GetCellKey(x, y)].push_back(module);
+   }
+}
+
+void ModuleSpatialIndex::Remove(IDrawableModule* module, Entry& entry)
+{
+   if (entry.mOversized)
+   {
+      RemoveFromVector(module, mOversized);
+      return;
+   }
+   
+   for (int x = entry.mMinCellX; x <= entry.mMaxCellX; ++x)
+   {
+      for (int y = entry.mMinCellY; y <= entry.mMaxCellY; ++y)
+      {
+         auto cell = mCells.find(GetCellKey(x, y));
+         if (cell == mCells.end())
+            continue;
+         RemoveFromVector(module, cell->second);
+         if (cell->second.empty())
+            mCells.erase(cell);
+      }
+   }
+}
+
+void ModuleSpatialIndex::Query(const ofRectangle& rect, std::vector<IDrawableModule*>& output)
+{
+   ++mQueryStamp;
+   size_t start = output.size();
+   
+   auto consider = [this, &rect, &output](IDrawableModule* module)
+   {
+      Entry& entry = mEntries[module];
+      if (entry.mQueryStamp == mQueryStamp)
+         return;
+      entry.mQueryStamp = mQueryStamp;
+      //inclusive test, to match IClickable::TestClick() for zero-sized queries
+      if (entry.mBounds.getMinX() <= rect.getMaxX() && entry.mBounds.getMaxX() >= rect.getMinX() &&
+          entry.mBounds.getMinY() <= rect.getMaxY() && entry.mBounds.getMaxY() >= rect.getMinY())
+         output.push_back(module);
+   };
+   
+   int minCellX = GetCell(rect.getMinX());
+   int minCellY = GetCell(rect.getMinY());
+   int maxCellX = GetCell(rect.getMaxX());
+   int maxCellY = GetCell(rect.getMaxY());
+   if ((int64_t)(maxCellX - minCellX + 1) * (maxCellY - minCellY + 1) > (int64_t)mCells.size())
+   {
+      //query covers more cells than exist, just walk the cells we have
+      for (auto& cell : mCells)
+      {
+         for (auto* module : cell.second)
+            consider(module);
+      }
+   }
+   else
+   {
+      for (int x = minCellX; x <= maxCellX; ++x)
+      {
+         for (int y = minCellY; y <= maxCellY; ++y)
+         {
+            auto cell = mCells.find(GetCellKey(x, y));
+            if (cell == mCells.end())
+               continue;
+            for (auto* module : cell->second)
+               consider(module);
+         }
+      }
+   }
+   for (auto* module : mOversized)
+      consider(module);
+   
+   std::sort(output.begin() + start, output.end(), [this](IDrawableModule* a, IDrawableModule* b)
+   {
+      return mEntries[a].mOrder < mEntries[b].mOrder;
+   });
+}
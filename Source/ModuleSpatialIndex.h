@@ -0,0 +1,74 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    ModuleSpatialIndex.h
+    Created: 19 Oct 2026 2:41:09pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenFrameworksPort.h"
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+class IDrawableModule;
+
+//uniform grid over module hit-test bounds, so that picking, lasso selection and culling don't have to visit every module
+class ModuleSpatialIndex
+{
+public:
+   ModuleSpatialIndex();
+   
+   void Rebuild(const std::vector<IDrawableModule*>& modules);
+   //refreshes the bounds of a module that has moved or resized
+   void Update(IDrawableModule* module);
+   //appends the modules whose bounds intersect rect, ordered front to back
+   void Query(const ofRectangle& rect, std::vector<IDrawableModule*>& output);
+   bool Contains(IDrawableModule* module) const { return mEntries.find(module) != mEntries.end(); }
+   
+private:
+   struct Entry
+   {
+      ofRectangle mBounds;
+      int mOrder;
+      int mMinCellX;
+      int mMinCellY;
+      int mMaxCellX;
+      int mMaxCellY;
+      bool mOversized;
+      long mQueryStamp;
+   };
+   
+   void SetBounds(IDrawableModule* module, Entry& entry, const ofRectangle& bounds);
+   void Insert(IDrawableModule* module, Entry& entry);
+   void Remove(IDrawableModule* module, Entry& entry);
+   static int64_t GetCellKey(int x, int y) { return ((int64_t)x << 32) | (uint32_t)y; }
+   static int GetCell(float pos);
+   
+   std::unordered_map<IDrawableModule*, Entry> mEntries;
+   std::unordered_map<int64_t, std::vector<IDrawableModule*> > mCells;
+   std::vector<IDrawableModule*> mOversized;  //too big to be worth bucketing
+   std::vector<IDrawableModule*> mStale;
+   long mQueryStamp;
+};
@@ -41,7 +41,8 @@ MultibandCompressor::MultibandCompressor()
 , mRingTimeSlider(nullptr)
 , mMaxBand(.3f)
 , mMaxBandSlider(nullptr)
-
+, mHighpassChain(COMPRESSOR_MAX_BANDS * 2)
+, mLowpassStages{ BiquadBank(COMPRESSOR_MAX_BANDS), BiquadBank(COMPRESSOR_MAX_BANDS) }
 {
    mWorkBuffer = new float[GetBuffer()->BufferSize()];
    Clear(mWorkBuffer, GetBuffer()->BufferSize());
@@ -49,7 +50,22 @@ MultibandCompressor::MultibandCompressor()
    mOutBuffer = new float[GetBuffer()->BufferSize()];
    Clear(mOutBuffer, GetBuffer()->BufferSize());
    
+   for (int i=0; i<COMPRESSOR_MAX_BANDS; ++i)
+   {
+      mBandBuffers[i] = new float[GetBuffer()->BufferSize()];
+      mHighBuffers[i] = new float[GetBuffer()->BufferSize()];
+      
+      //band i+1 splits what was left above crossover i
+      if (i + 1 < COMPRESSOR_MAX_BANDS)
+         mCrossoverInputs[i + 1] = mHighBuffers[i];
+      mHighpassTaps[i * 2] = nullptr;
+      mHighpassTaps[i * 2 + 1] = mHighBuffers[i];
+   }
+   
    CalcFilters();
+   mHighpassChain.SnapCoefficients();
+   for (auto& stage : mLowpassStages)
+      stage.SnapCoefficients();
 }
 
 void MultibandCompressor::CreateUIControls()
@@ -67,6 +83,11 @@ MultibandCompressor::~MultibandCompressor()
 {
    delete[] mOutBuffer;
    delete[] mWorkBuffer;
+   for (int i=0; i<COMPRESSOR_MAX_BANDS; ++i)
+   {
+      delete[] mBandBuffers[i];
+      delete[] mHighBuffers[i];
+   }
 }
 
 void MultibandCompressor::Process(double time)
@@ -85,40 +106,24 @@ void MultibandCompressor::Process(double time)
    {
       Clear(mOutBuffer, bufferSize);
       
-      for (int i=0; i<bufferSize; ++i)
-      {
-         float lower;
-         float highLeftover = GetBuffer()->GetChannel(0)[i];
-         for (int j=0; j<mNumBands; ++j)
-         {
-            mFilters[j].ProcessSample(highLeftover, lower, highLeftover);
-            mPeaks[j].Process(&lower, 1);
-            float compress = ofClamp(1/mPeaks[i].GetPeak(), 0, 10);
-            mOutBuffer[i] += lower * compress;
-         }
-         mOutBuffer[i] += highLeftover;
-      }
+      //split the input into bands. the high sides of the crossovers run as one chain, leaving the top band in mWorkBuffer
+      mCrossoverInputs[0] = GetBuffer()->GetChannel(0);
+      BufferCopy(mWorkBuffer, GetBuffer()->GetChannel(0), bufferSize);
+      mHighpassChain.ProcessSeries(mWorkBuffer, bufferSize, mHighpassTaps);
+      mLowpassStages[0].ProcessParallel(mCrossoverInputs, mBandBuffers, bufferSize);
+      mLowpassStages[1].ProcessParallel(mBandBuffers, mBandBuffers, bufferSize);
       
-      /*for (int i=0; i<mNumBands; ++i)
+      for (int j=0; j<mNumBands; ++j)
       {
-         //get carrier band
-         BufferCopy(mWorkBuffer, mInputBuffer, bufferSize);
-         
-         mFilters[i].ProcessSample(const double &sample, double &lowOut, double &highOut)(mWorkBuffer, bufferSize);
-         
-         //calculate modulator band level
-         mPeaks[i].Process(mWorkBuffer, bufferSize);
-         
-         //multiply carrier band by modulator band level
-         if (mPeaks[i].GetPeak() > 0)
+         float* peaks = gWorkBuffer;
+         mPeaks[j].Process(mBandBuffers[j], bufferSize, peaks);
+         for (int i=0; i<bufferSize; ++i)
          {
-            float compress = ofClamp(1/mPeaks[i].GetPeak(), 0, 10);
-            Mult(mWorkBuffer, compress, bufferSize);
+            float compress = ofClamp(1/peaks[i], 0, 10);
+            mOutBuffer[i] += mBandBuffers[j][i] * compress;
          }
-         
-         //accumulate output band into total output
-         Add(mOutBuffer, mWorkBuffer, bufferSize);
-      }*/
+      }
+      Add(mOutBuffer, mWorkBuffer, bufferSize);
       
       Mult(GetBuffer()->GetChannel(0), (1-mDryWet), bufferSize);
       Mult(mOutBuffer, mDryWet, bufferSize);
@@ -162,8 +167,24 @@ void MultibandCompressor::CalcFilters()
       float a = float(i)/mNumBands;
       float f = mFreqMin * powf(mFreqMax/mFreqMin, a);
       
-      mFilters[i].SetCrossoverFreq(f);
+      BiquadFilter lowpass;
+      lowpass.SetFilterType(kFilterType_Lowpass);
+      lowpass.mF = f;
+      lowpass.UpdateFilterCoeff();
+      BiquadFilter highpass;
+      highpass.SetFilterType(kFilterType_Highpass);
+      highpass.mF = f;
+      highpass.UpdateFilterCoeff();
+      
+      for (auto& stage : mLowpassStages)
+         stage.SetCoefficients(i, lowpass);
+      mHighpassChain.SetCoefficients(i * 2, highpass);
+      mHighpassChain.SetCoefficients(i * 2 + 1, highpass);
    }
+   
+   for (auto& stage : mLowpassStages)
+      stage.SetNumFilters(mNumBands);
+   mHighpassChain.SetNumFilters(mNumBands * 2);
 }
 
 void MultibandCompressor::IntSliderUpdated(IntSlider* slider, int oldVal)
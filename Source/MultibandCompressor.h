@@ -32,7 +32,7 @@
 #include "Slider.h"
 #include "ClickButton.h"
 #include "RollingBuffer.h"
-#include "LinkwitzRileyFilter.h"
+#include "BiquadBank.h"
 #include "PeakTracker.h"
 
 #define COMPRESSOR_MAX_BANDS 10
@@ -70,6 +70,10 @@ private:
    
    float* mWorkBuffer;
    float* mOutBuffer;
+   float* mBandBuffers[COMPRESSOR_MAX_BANDS];
+   float* mHighBuffers[COMPRESSOR_MAX_BANDS];
+   const float* mCrossoverInputs[COMPRESSOR_MAX_BANDS];
+   float* mHighpassTaps[COMPRESSOR_MAX_BANDS * 2];
    
    float mDryWet;
    FloatSlider* mDryWetSlider;
@@ -84,7 +88,9 @@ private:
    float mMaxBand;
    FloatSlider* mMaxBandSlider;
    
-   CLinkwitzRiley_4thOrder mFilters[COMPRESSOR_MAX_BANDS];
+   //each crossover is a 4th order linkwitz-riley, built from two butterworth sections for each of the low and high sides
+   BiquadBank mHighpassChain;
+   BiquadBank mLowpassStages[2];
    PeakTracker mPeaks[COMPRESSOR_MAX_BANDS];
 };
 
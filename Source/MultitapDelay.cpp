@@ -103,16 +103,35 @@ void MultitapDelay::Process(double time)
       mDelayBuffer.WriteChunk(GetBuffer()->GetChannel(ch), bufferSize, ch);
    }
    
-   for (int i=0; i<bufferSize; ++i)
+   bool perSample = SlidersNeedPerSampleCompute();
+   if (!perSample)
    {
-      ComputeSliders(i);
+      ComputeSliders(0);
+      for (int t=0; t<mNumTaps; ++t)
+         perSample |= !mTaps[t].CanProcessBlock(bufferSize);
+   }
    
+   if (perSample)
+   {
+      for (int i=0; i<bufferSize; ++i)
+      {
+         ComputeSliders(i);
+      
+         for (int ch=0; ch<GetBuffer()->NumActiveChannels(); ++ch)
+         {
+            for (int t=0; t<mNumTaps; ++t)
+               mTaps[t].Process(&mWriteBuffer.GetChannel(ch)[i], i, ch);
+            for (int t=0; t<kNumMPETaps; ++t)
+               mMPETaps[t].Process(&mWriteBuffer.GetChannel(ch)[i], i, ch);
+         }
+      }
+   }
+   else
+   {
       for (int ch=0; ch<GetBuffer()->NumActiveChannels(); ++ch)
       {
          for (int t=0; t<mNumTaps; ++t)
-            mTaps[t].Process(&mWriteBuffer.GetChannel(ch)[i], i, ch);
-         for (int t=0; t<kNumMPETaps; ++t)
-            mMPETaps[t].Process(&mWriteBuffer.GetChannel(ch)[i], i, ch);
+            mTaps[t].ProcessBlock(mWriteBuffer.GetChannel(ch), bufferSize, ch);
       }
    }
 
@@ -362,6 +381,31 @@ void MultitapDelay::DelayTap::Process(float* sampleOut, int offset, int ch)
    }
 }
 
+bool MultitapDelay::DelayTap::CanProcessBlock(int bufferSize) const
+{
+   if (mGain <= 0)
+      return true;
+   //the input for this buffer has already been written, and feedback is accumulated into it, so reads have to stay behind all of it
+   float delaySamps = mDelayMs / gInvSampleRateMs;
+   return delaySamps < mOwner->mDelayBuffer.Size()-2 && DelayLine::CanReadBlock(delaySamps - bufferSize, bufferSize);
+}
+
+void MultitapDelay::DelayTap::ProcessBlock(float* out, int bufferSize, int ch)
+{
+   if (mGain > 0)
+   {
+      float* tap = mTapBuffer.GetChannel(ch);
+      mOwner->mDelayBuffer.ReadBlock(tap, bufferSize, mDelayMs / gInvSampleRateMs, ch);
+      Mult(tap, mGain, bufferSize);
+      Add(out, tap, bufferSize);
+      
+      float panGain = ch == 0 ? GetLeftPanGain(mPan) : GetRightPanGain(mPan);
+      BufferCopy(gWorkBuffer, tap, bufferSize);
+      Mult(gWorkBuffer, mFeedback * panGain, bufferSize);
+      mOwner->mDelayBuffer.AccumChunk(gWorkBuffer, bufferSize, 0, ch);
+   }
+}
+
 void MultitapDelay::DelayTap::Draw(float w, float h)
 {
    ofPushStyle();
@@ -37,6 +37,7 @@
 #include "INoteReceiver.h"
 #include "Granulator.h"
 #include "ADSR.h"
+#include "DelayLine.h"
 
 class Sample;
 
@@ -90,6 +91,8 @@ private:
    {
       DelayTap();
       void Process(float* sampleOut, int offset, int ch);
+      bool CanProcessBlock(int bufferSize) const;
+      void ProcessBlock(float* out, int bufferSize, int ch);
       void Draw(float w, float h);
       
       float mDelayMs;
@@ -134,5 +137,5 @@ private:
    float mDryAmount;
    FloatSlider* mDisplayLengthSlider;
    float mDisplayLength;
-   RollingBuffer mDelayBuffer;
+   DelayLine mDelayBuffer;
 };
@@ -57,6 +57,7 @@ private:
 
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=80; h=38; }
    bool Enabled() const override { return true; }
 
@@ -24,6 +24,7 @@
 //
 
 #include "NamedMutex.h"
+#include "RealtimeSafetyChecker.h"
 
 void NamedMutex::Lock(std::string locker)
 {
@@ -32,7 +33,11 @@ void NamedMutex::Lock(std::string locker)
       ++mExtraLockCount;
       return;
    }
-   mMutex.lock();
+   if (!mMutex.try_lock())
+   {
+      RealtimeSafetyChecker::Check(kRealtimeViolation_MutexWait, locker.c_str());
+      mMutex.lock();
+   }
    mLocker = locker;
 }
 
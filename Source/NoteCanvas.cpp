@@ -175,6 +175,7 @@ void NoteCanvas::KeyPressed(int key, bool isRepeat)
                element->mCol = ofClamp(element->mCol + directionLeftRight, 0, mCanvas->GetNumCols()-1);
             }
          }
+         mCanvas->InvalidateElementIndex();
       }
       else
       {
@@ -589,6 +590,7 @@ void NoteCanvas::QuantizeNotes()
          element->mOffset = 0;
       }
    }
+   mCanvas->InvalidateElementIndex();
 }
 
 void NoteCanvas::CheckboxUpdated(Checkbox* checkbox)
@@ -68,6 +68,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return mEnabled; }
    void GetModuleDimensions(float& w, float& h) override { w=110; h=76; }
    
@@ -124,7 +124,7 @@ void NoteCounter::CheckboxUpdated(Checkbox* checkbox)
 void NoteCounter::IntSliderUpdated(IntSlider* slider, int oldVal)
 {
    if (slider == mCustomDivisorSlider)
-      mTransportListenerInfo->mCustomDivisor = mCustomDivisor;
+      mTransportListenerInfo->SetCustomDivisor(mCustomDivisor);
 }
 
 void NoteCounter::DropdownUpdated(DropdownList* list, int oldVal)
@@ -133,7 +133,7 @@ void NoteCounter::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mInterval;
+         transportListenerInfo->SetInterval(mInterval);
    }
 }
 
@@ -64,6 +64,7 @@ protected:
    
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return mEnabled; }
    void GetModuleDimensions(float& w, float& h) override { w=110; h=58; }
    
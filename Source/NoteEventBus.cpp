@@ -0,0 +1,158 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    NoteEventBus.cpp
+    Created: 19 Oct 2026 2:41:09pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "NoteEventBus.h"
+#include "INoteReceiver.h"
+#include "SynthGlobals.h"
+#include "ModularSynth.h"
+#include "Profiler.h"
+
+namespace
+{
+   const int kMaxDepth = 100;
+   
+   thread_local NoteEventBus::RenderQueue* sRenderQueue = nullptr;
+   
+   bool HasRoom(int used, int size, int velocity)
+   {
+      //note-ons give up while there's still room, so the note-offs for the notes that did get through always fit
+      if (velocity > 0)
+         return used < size * 3 / 4;
+      return used < size;
+   }
+}
+
+NoteEventBus::RenderQueue::RenderQueue()
+: mReadIndex(0)
+, mWriteIndex(0)
+, mDispatching(false)
+, mCurrentDepth(0)
+{
+}
+
+NoteEventBus::ScopedRender::ScopedRender(RenderQueue* queue)
+: mPrevious(sRenderQueue)
+{
+   sRenderQueue = queue;
+}
+
+NoteEventBus::ScopedRender::~ScopedRender()
+{
+   sRenderQueue = mPrevious;
+}
+
+NoteEventBus::NoteEventBus()
+: mIncomingWriteIndex(0)
+, mIncomingReadIndex(0)
+, mNumDropped(0)
+, mGeneration(0)
+{
+}
+
+void NoteEventBus::PlayNote(INoteReceiver* receiver, double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation)
+{
+   NoteEvent event;
+   event.mReceiver = receiver;
+   event.mTime = time;
+   event.mPitch = pitch;
+   event.mVelocity = velocity;
+   event.mVoiceIdx = voiceIdx;
+   event.mModulation = modulation;
+   event.mGeneration = mGeneration;
+
+   RenderQueue* queue = sRenderQueue;
+   if (queue == nullptr)
+   {
+      //the ui thread and controller threads can both be producing, so the writers take turns. the audio thread consumes without locking
+      std::lock_guard<ofMutex> lock(mIncomingWriteMutex);
+      uint32_t writeIndex = mIncomingWriteIndex.load(std::memory_order_relaxed);
+      if (!HasRoom(int(writeIndex - mIncomingReadIndex.load(std::memory_order_acquire)), kIncomingSize, velocity))
+      {
+         ++mNumDropped;
+         return;
+      }
+      mIncoming[writeIndex % kIncomingSize] = event;
+      mIncomingWriteIndex.store(writeIndex + 1, std::memory_order_release);
+      return;
+   }
+
+   event.mDepth = queue->mCurrentDepth + 1;
+   if (event.mDepth > kMaxDepth)
+   {
+      TheSynth->LogEvent("note chain hit max depth", kLogEventType_Error);
+      return;  //avoid feedback loops running forever
+   }
+   
+   if (!HasRoom(queue->mWriteIndex - queue->mReadIndex, RenderQueue::kSize, velocity))
+   {
+      ++mNumDropped;
+      return;
+   }
+   queue->mEvents[queue->mWriteIndex % RenderQueue::kSize] = event;
+   ++queue->mWriteIndex;
+   if (!queue->mDispatching)
+      Dispatch(queue);
+}
+
+void NoteEventBus::BeginBuffer()
+{
+   PROFILER(NoteEventBus);
+   
+   assert(sRenderQueue != nullptr);
+
+   uint32_t writeIndex = mIncomingWriteIndex.load(std::memory_order_acquire);
+   uint32_t readIndex = mIncomingReadIndex.load(std::memory_order_relaxed);
+   while (readIndex != writeIndex)
+   {
+      NoteEvent event = mIncoming[readIndex % kIncomingSize];
+      mIncomingReadIndex.store(++readIndex, std::memory_order_release);
+      if (event.mGeneration != mGeneration)
+         continue;
+      //it was played "now" from another thread, which is the start of this buffer from the audio thread's point of view
+      PlayNote(event.mReceiver, MAX(event.mTime, gTime), event.mPitch, event.mVelocity, event.mVoiceIdx, event.mModulation);
+   }
+   
+   if (mNumDropped.exchange(0) > 0)
+      TheSynth->LogEvent("note queue full, dropped notes", kLogEventType_Error);
+}
+
+void NoteEventBus::Dispatch(RenderQueue* queue)
+{
+   queue->mDispatching = true;
+   //receivers add to the queue as they play notes of their own, so copy each event out before delivering it
+   while (queue->mReadIndex != queue->mWriteIndex)
+   {
+      NoteEvent event = queue->mEvents[queue->mReadIndex % RenderQueue::kSize];
+      ++queue->mReadIndex;
+      queue->mCurrentDepth = event.mDepth;
+      event.mReceiver->PlayNote(event.mTime, event.mPitch, event.mVelocity, event.mVoiceIdx, event.mModulation);
+   }
+   queue->mReadIndex = 0;
+   queue->mWriteIndex = 0;
+   queue->mCurrentDepth = 0;
+   queue->mDispatching = false;
+}
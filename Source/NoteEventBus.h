@@ -0,0 +1,104 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    NoteEventBus.h
+    Created: 19 Oct 2026 2:41:09pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "ModulationChain.h"
+#include "OpenFrameworksPort.h"
+
+class INoteReceiver;
+
+//every note that goes out of a NoteOutput passes through here.
+//on a thread that's rendering audio, notes cascading through effect chains are delivered breadth-first from a queue rather than
+//by recursing into each receiver, so chain length doesn't grow the call stack and delivery order is deterministic.
+//notes played from any other thread (ui clicks, controllers) are held until the start of the next buffer and delivered
+//from the audio thread there, so they never race the audio processing.
+//both queues are fixed size. when one fills up, note-ons are dropped first so there's always room for the note-offs
+class NoteEventBus
+{
+   struct NoteEvent
+   {
+      INoteReceiver* mReceiver = nullptr;
+      double mTime = 0;
+      int mPitch = 0;
+      int mVelocity = 0;
+      int mVoiceIdx = -1;
+      ModulationParameters mModulation;
+      int mDepth = 0;
+      int mGeneration = 0;
+   };
+   
+public:
+   //notes waiting to be delivered on one rendering thread
+   class RenderQueue
+   {
+   public:
+      RenderQueue();
+   private:
+      friend class NoteEventBus;
+      static const int kSize = 1024;
+      NoteEvent mEvents[kSize];
+      int mReadIndex;
+      int mWriteIndex;
+      bool mDispatching;
+      int mCurrentDepth;
+   };
+   
+   //marks the calling thread as rendering audio for the duration of the scope, notes played on it are delivered right away through queue
+   class ScopedRender
+   {
+   public:
+      ScopedRender(RenderQueue* queue);
+      ~ScopedRender();
+   private:
+      RenderQueue* mPrevious;
+   };
+   
+   NoteEventBus();
+
+   void PlayNote(INoteReceiver* receiver, double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation);
+
+   RenderQueue* GetAudioThreadQueue() { return &mAudioThreadQueue; }
+   //called by the audio thread at the start of each buffer
+   void BeginBuffer();
+   //drop notes that were posted for modules that are going away
+   void Clear() { ++mGeneration; }
+
+private:
+   void Dispatch(RenderQueue* queue);
+
+   RenderQueue mAudioThreadQueue;
+   static const uint32_t kIncomingSize = 1024;
+   NoteEvent mIncoming[kIncomingSize];
+   std::atomic<uint32_t> mIncomingWriteIndex;
+   std::atomic<uint32_t> mIncomingReadIndex;
+   ofMutex mIncomingWriteMutex;
+   std::atomic<int> mNumDropped;
+   std::atomic<int> mGeneration;
+};
@@ -61,6 +61,7 @@ public:
 private:   
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 108; height = 40; }
    bool Enabled() const override { return mEnabled; }
    
@@ -165,7 +165,7 @@ void NoteQuantizer::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mQuantizeInterval;
+         transportListenerInfo->SetInterval(mQuantizeInterval);
    }
 }
 
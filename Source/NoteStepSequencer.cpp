@@ -984,7 +984,7 @@ void NoteStepSequencer::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mInterval;
+         transportListenerInfo->SetInterval(mInterval);
    }
    if (list == mNoteModeSelector)
    {
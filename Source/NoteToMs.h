@@ -62,6 +62,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 110; height = 0; }
    bool Enabled() const override { return mEnabled; }
    
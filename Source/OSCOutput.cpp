@@ -34,12 +34,15 @@ OSCOutput::OSCOutput()
 : mOscOutAddress("127.0.0.1")
 , mOscOutPort(7000)
 , mNoteOutLabel("note")
+, mSendRate(200)
+, mNoteOutAddressId(-1)
 {
    for (int i=0; i<OSC_OUTPUT_MAX_PARAMS; ++i)
    {
       mParams[i] = 0;
       mLabels[i] = new char[MAX_TEXTENTRY_LENGTH];
       strcpy(mLabels[i], ("slider"+ofToString(i)).c_str());
+      mSliderAddressIds[i] = -1;
    }
 }
 
@@ -51,7 +54,8 @@ void OSCOutput::Init()
 {
    IDrawableModule::Init();
    
-   mOscOut.connect(mOscOutAddress, mOscOutPort);
+   mOscOut.Connect(mOscOutAddress, mOscOutPort);
+   UpdateAddressIds();
 }
 
 void OSCOutput::CreateUIControls()
@@ -60,7 +64,8 @@ void OSCOutput::CreateUIControls()
    
    UIBLOCK0();
    TEXTENTRY(mOscOutAddressEntry, "osc out address", 16, &mOscOutAddress); UIBLOCK_SHIFTRIGHT();
-   TEXTENTRY_NUM(mOscOutPortEntry, "osc out port", 6, &mOscOutPort, 0, 99999); UIBLOCK_NEWLINE();
+   TEXTENTRY_NUM(mOscOutPortEntry, "osc out port", 6, &mOscOutPort, 0, 99999); UIBLOCK_SHIFTRIGHT();
+   TEXTENTRY_NUM(mSendRateEntry, "send rate", 4, &mSendRate, 1, 1000); UIBLOCK_NEWLINE();
    UIBLOCK_SHIFTY(5);
    for (int i=0; i<8; ++i)
    {
@@ -84,6 +89,30 @@ void OSCOutput::CreateUIControls()
 void OSCOutput::Poll()
 {
    ComputeSliders(0);
+   UpdateAddressIds();
+   mOscOut.SetSendRate(mSendRate);
+}
+
+void OSCOutput::UpdateAddressIds()
+{
+   std::string noteOutAddress = "/bespoke/" + mNoteOutLabel;
+   if (noteOutAddress != mNoteOutAddress)
+   {
+      mNoteOutAddress = noteOutAddress;
+      mNoteOutAddressId = mNoteOutLabel.size() > 0 ? mOscOut.GetAddressId(mNoteOutAddress) : -1;
+   }
+
+   int i = 0;
+   for (auto* slider : mSliders)
+   {
+      std::string sliderAddress = std::string("/bespoke/") + slider->Name();
+      if (sliderAddress != mSliderAddresses[i])
+      {
+         mSliderAddresses[i] = sliderAddress;
+         mSliderAddressIds[i] = mOscOut.GetAddressId(sliderAddress);
+      }
+      ++i;
+   }
 }
 
 void OSCOutput::DrawModule()
@@ -93,6 +122,7 @@ void OSCOutput::DrawModule()
 
    mOscOutAddressEntry->Draw();
    mOscOutPortEntry->Draw();
+   mSendRateEntry->Draw();
    
    for (auto* entry : mLabelEntry)
       entry->Draw();
@@ -104,37 +134,25 @@ void OSCOutput::DrawModule()
 
 void OSCOutput::PlayNote(double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation)
 {
-   if (mNoteOutLabel.size() > 0)
-   {
-      juce::OSCMessage msg(("/bespoke/"+mNoteOutLabel).c_str());
-      float pitchOut = pitch;
-      if (modulation.pitchBend != nullptr)
-         pitchOut += modulation.pitchBend->GetValue(0);
-      msg.addFloat32(pitchOut);
-      msg.addFloat32(velocity);
-      mOscOut.send(msg);
-   }
+   float pitchOut = pitch;
+   if (modulation.pitchBend != nullptr)
+      pitchOut += modulation.pitchBend->GetValue(0);
+   mOscOut.SendFloats(mNoteOutAddressId, pitchOut, velocity, !K(coalesce));
 }
 
 void OSCOutput::SendFloat(std::string address, float val)
 {
-   juce::OSCMessage msg(address.c_str());
-   msg.addFloat32(val);
-   mOscOut.send(msg);
+   mOscOut.SendFloat(mOscOut.GetAddressId(address), val, !K(coalesce));
 }
 
 void OSCOutput::SendInt(std::string address, int val)
 {
-   juce::OSCMessage msg(address.c_str());
-   msg.addInt32(val);
-   mOscOut.send(msg);
+   mOscOut.SendInt(mOscOut.GetAddressId(address), val, !K(coalesce));
 }
 
 void OSCOutput::SendString(std::string address, std::string val)
 {
-   juce::OSCMessage msg(address.c_str());
-   msg.addString(val);
-   mOscOut.send(msg);
+   mOscOut.SendString(mOscOut.GetAddressId(address), val);
 }
 
 void OSCOutput::GetModuleDimensions(float& w, float& h)
@@ -145,13 +163,13 @@ void OSCOutput::GetModuleDimensions(float& w, float& h)
 
 void OSCOutput::FloatSliderUpdated(FloatSlider* slider, float oldVal)
 {
-   char address[120];
-   address[0] = 0;
-   strcat(address, "/bespoke/");
-   strcat(address, slider->Name());
-   juce::OSCMessage msg(address);
-   msg.addFloat32(slider->GetValue());
-   mOscOut.send(msg);
+   int i = 0;
+   for (auto* iter : mSliders)
+   {
+      if (iter == slider)
+         mOscOut.SendFloat(mSliderAddressIds[i], slider->GetValue(), K(coalesce));
+      ++i;
+   }
 }
 
 void OSCOutput::TextEntryComplete(TextEntry* entry)
@@ -167,12 +185,10 @@ void OSCOutput::TextEntryComplete(TextEntry* entry)
       }
       ++i;
    }
+   UpdateAddressIds();
 
    if (entry == mOscOutAddressEntry || entry == mOscOutPortEntry)
-   {
-      mOscOut.disconnect();
-      mOscOut.connect(mOscOutAddress, mOscOutPort);
-   }
+      mOscOut.Connect(mOscOutAddress, mOscOutPort);
 }
 
 void OSCOutput::LoadLayout(const ofxJSONElement& moduleInfo)
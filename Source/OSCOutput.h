@@ -28,13 +28,13 @@
 #pragma once
 
 #include <iostream>
+#include <array>
 #include "IDrawableModule.h"
 #include "OpenFrameworksPort.h"
 #include "TextEntry.h"
 #include "Slider.h"
 #include "INoteReceiver.h"
-
-#include "juce_osc/juce_osc.h"
+#include "OSCSendQueue.h"
 
 #define OSC_OUTPUT_MAX_PARAMS 50
 
@@ -68,8 +68,10 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override;
+   void UpdateAddressIds();
    
    char* mLabels[OSC_OUTPUT_MAX_PARAMS];
    std::list<TextEntry*> mLabelEntry;
@@ -83,8 +85,15 @@ private:
 
    std::string mNoteOutLabel;
    TextEntry* mNoteOutLabelEntry;
+   int mSendRate;
+   TextEntry* mSendRateEntry;
    
-   juce::OSCSender mOscOut;
+   OSCSendQueue mOscOut;
+   //looked up on the main thread, so that notes and slider changes can be queued from anywhere
+   std::atomic<int> mNoteOutAddressId;
+   std::string mNoteOutAddress;
+   std::array<std::atomic<int>, OSC_OUTPUT_MAX_PARAMS> mSliderAddressIds;
+   std::array<std::string, OSC_OUTPUT_MAX_PARAMS> mSliderAddresses;
 
    float mWidth;
    float mHeight;
@@ -0,0 +1,266 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    OSCSendQueue.cpp
+    Created: 19 Oct 2026 8:04:52pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "OSCSendQueue.h"
+#include "SynthGlobals.h"
+
+#include <cstring>
+
+namespace
+{
+   const float kDefaultSendRateHz = 200;
+   const int kMaxBundleElements = 64;   //keep each bundle well inside a udp packet
+}
+
+OSCSendQueue::OSCSendQueue()
+: juce::Thread("osc send")
+, mPushIndex(0)
+, mPopIndex(0)
+, mNumDropped(0)
+, mConnected(false)
+, mSendIntervalMs(0)
+{
+   for (uint32_t i = 0; i < kQueueSize; ++i)
+      mQueue[i].mSequence = i;
+   SetSendRate(kDefaultSendRateHz);
+   mPending.reserve(kQueueSize);
+   
+   startThread();
+}
+
+OSCSendQueue::~OSCSendQueue()
+{
+   stopThread(1000);
+   Disconnect();
+}
+
+bool OSCSendQueue::Connect(std::string host, int port)
+{
+   std::lock_guard<std::mutex> lock(mSenderMutex);
+   mSender.disconnect();
+   mConnected = mSender.connect(host, port);
+   return mConnected;
+}
+
+void OSCSendQueue::Disconnect()
+{
+   std::lock_guard<std::mutex> lock(mSenderMutex);
+   mSender.disconnect();
+   mConnected = false;
+}
+
+void OSCSendQueue::SetSendRate(float hz)
+{
+   mSendIntervalMs = MAX(1, int(1000 / MAX(hz, 1) + .5f));
+}
+
+int OSCSendQueue::GetAddressId(const std::string& address)
+{
+   std::lock_guard<std::mutex> lock(mAddressMutex);
+   auto iter = mAddressIds.find(address);
+   if (iter != mAddressIds.end())
+      return iter->second;
+   
+   try
+   {
+      mAddresses.push_back(juce::OSCAddressPattern(address));
+   }
+   catch (juce::OSCFormatError& e)
+   {
+      ofLog() << "invalid osc address " << address << ": " << e.description.toStdString();
+      return -1;
+   }
+   int id = (int)mAddresses.size() - 1;
+   mAddressIds[address] = id;
+   return id;
+}
+
+void OSCSendQueue::SendFloat(int addressId, float value, bool coalesce)
+{
+   Event event;
+   event.mAddressId = addressId;
+   event.mType = kEvent_Float;
+   event.mCoalesce = coalesce;
+   event.mFloats[0] = value;
+   Push(event);
+}
+
+void OSCSendQueue::SendFloats(int addressId, float value1, float value2, bool coalesce)
+{
+   Event event;
+   event.mAddressId = addressId;
+   event.mType = kEvent_TwoFloats;
+   event.mCoalesce = coalesce;
+   event.mFloats[0] = value1;
+   event.mFloats[1] = value2;
+   Push(event);
+}
+
+void OSCSendQueue::SendInt(int addressId, int value, bool coalesce)
+{
+   Event event;
+   event.mAddressId = addressId;
+   event.mType = kEvent_Int;
+   event.mCoalesce = coalesce;
+   event.mInt = value;
+   Push(event);
+}
+
+void OSCSendQueue::SendString(int addressId, const std::string& value)
+{
+   Event event;
+   event.mAddressId = addressId;
+   event.mType = kEvent_String;
+   event.mCoalesce = false;
+   strncpy(event.mString, value.c_str(), kMaxStringLength - 1);
+   event.mString[kMaxStringLength - 1] = 0;
+   Push(event);
+}
+
+void OSCSendQueue::Push(Event& event)
+{
+   if (event.mAddressId < 0 || !mConnected)
+      return;
+   
+   event.mTimeMs = juce::Time::getMillisecondCounterHiRes();
+   
+   uint32_t pos = mPushIndex.load(std::memory_order_relaxed);
+   while (true)
+   {
+      Slot& slot = mQueue[pos % kQueueSize];
+      int32_t diff = int32_t(slot.mSequence.load(std::memory_order_acquire) - pos);
+      if (diff == 0)
+      {
+         if (mPushIndex.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+         {
+            slot.mEvent = event;
+            slot.mSequence.store(pos + 1, std::memory_order_release);
+            return;
+         }
+      }
+      else if (diff < 0)
+      {
+         ++mNumDropped;   //full, the network thread has fallen way behind
+         return;
+      }
+      else
+      {
+         pos = mPushIndex.load(std::memory_order_relaxed);
+      }
+   }
+}
+
+bool OSCSendQueue::Pop(Event& event)
+{
+   Slot& slot = mQueue[mPopIndex % kQueueSize];
+   if (int32_t(slot.mSequence.load(std::memory_order_acquire) - (mPopIndex + 1)) < 0)
+      return false;
+   event = slot.mEvent;
+   slot.mSequence.store(mPopIndex + kQueueSize, std::memory_order_release);
+   ++mPopIndex;
+   return true;
+}
+
+void OSCSendQueue::run()
+{
+   while (!threadShouldExit())
+   {
+      wait(mSendIntervalMs);
+      SendPending();
+   }
+}
+
+void OSCSendQueue::SendPending()
+{
+   mPending.clear();
+   mPendingCoalesced.clear();
+   
+   Event event;
+   while (Pop(event))
+   {
+      if (event.mCoalesce)
+      {
+         auto iter = mPendingCoalesced.find(event.mAddressId);
+         if (iter != mPendingCoalesced.end())
+         {
+            //keep the slot of the first one, so it stays in order with everything else
+            double timeMs = mPending[iter->second].mTimeMs;
+            mPending[iter->second] = event;
+            mPending[iter->second].mTimeMs = timeMs;
+            continue;
+         }
+         mPendingCoalesced[event.mAddressId] = mPending.size();
+      }
+      mPending.push_back(event);
+   }
+   
+   if (mPending.empty())
+      return;
+   
+   //everything is delayed by up to one send interval, so schedule the bundle for one interval after the oldest event.
+   //receivers that respect time tags then see a steady latency instead of the batching jitter
+   double oldestMs = mPending[0].mTimeMs;
+   for (const auto& pending : mPending)
+      oldestMs = MIN(oldestMs, pending.mTimeMs);
+   double msUntilTag = oldestMs + mSendIntervalMs - juce::Time::getMillisecondCounterHiRes();
+   juce::OSCTimeTag timeTag(juce::Time(juce::Time::currentTimeMillis() + juce::int64(msUntilTag)));
+   
+   std::lock_guard<std::mutex> addressLock(mAddressMutex);
+   std::lock_guard<std::mutex> senderLock(mSenderMutex);
+   if (!mConnected)
+      return;
+   
+   for (size_t i = 0; i < mPending.size(); i += kMaxBundleElements)
+   {
+      juce::OSCBundle bundle(timeTag);
+      for (size_t j = i; j < mPending.size() && j < i + kMaxBundleElements; ++j)
+         bundle.addElement(MakeMessage(mPending[j]));
+      mSender.send(bundle);
+   }
+}
+
+juce::OSCMessage OSCSendQueue::MakeMessage(const Event& event) const
+{
+   juce::OSCMessage msg(mAddresses[event.mAddressId]);
+   switch (event.mType)
+   {
+      case kEvent_Float:
+         msg.addFloat32(event.mFloats[0]);
+         break;
+      case kEvent_TwoFloats:
+         msg.addFloat32(event.mFloats[0]);
+         msg.addFloat32(event.mFloats[1]);
+         break;
+      case kEvent_Int:
+         msg.addInt32(event.mInt);
+         break;
+      case kEvent_String:
+         msg.addString(event.mString);
+         break;
+   }
+   return msg;
+}
@@ -0,0 +1,116 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    OSCSendQueue.h
+    Created: 19 Oct 2026 8:04:52pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "juce_osc/juce_osc.h"
+
+//outgoing osc, sent from its own thread.
+//any thread can queue a message without locking or allocating, as long as it has looked up the address id beforehand.
+//the network thread wakes up at the send rate, keeps only the latest value for each address that was queued with coalesce,
+//and sends everything it collected as one bundle
+class OSCSendQueue : private juce::Thread
+{
+public:
+   OSCSendQueue();
+   ~OSCSendQueue();
+   
+   bool Connect(std::string host, int port);
+   void Disconnect();
+   bool IsConnected() const { return mConnected; }
+   void SetSendRate(float hz);
+   
+   //locks, so cache the result rather than calling this from the audio thread
+   int GetAddressId(const std::string& address);
+   
+   void SendFloat(int addressId, float value, bool coalesce);
+   void SendFloats(int addressId, float value1, float value2, bool coalesce);
+   void SendInt(int addressId, int value, bool coalesce);
+   void SendString(int addressId, const std::string& value);
+   
+   int GetNumDropped() const { return mNumDropped; }
+   
+private:
+   enum EventType
+   {
+      kEvent_Float,
+      kEvent_TwoFloats,
+      kEvent_Int,
+      kEvent_String
+   };
+   
+   static const int kMaxStringLength = 128;
+   
+   struct Event
+   {
+      int mAddressId;
+      EventType mType;
+      bool mCoalesce;
+      double mTimeMs;
+      float mFloats[2];
+      int mInt;
+      char mString[kMaxStringLength];
+   };
+   
+   //bounded multi producer queue, each slot's sequence says whose turn it is
+   struct Slot
+   {
+      std::atomic<uint32_t> mSequence;
+      Event mEvent;
+   };
+   
+   void run() override;
+   void Push(Event& event);
+   bool Pop(Event& event);
+   void SendPending();
+   juce::OSCMessage MakeMessage(const Event& event) const;
+   
+   static const uint32_t kQueueSize = 1024;
+   Slot mQueue[kQueueSize];
+   std::atomic<uint32_t> mPushIndex;
+   uint32_t mPopIndex;
+   std::atomic<int> mNumDropped;
+   
+   std::mutex mAddressMutex;
+   std::unordered_map<std::string, int> mAddressIds;
+   std::vector<juce::OSCAddressPattern> mAddresses;
+   
+   std::mutex mSenderMutex;
+   juce::OSCSender mSender;
+   std::atomic<bool> mConnected;
+   std::atomic<int> mSendIntervalMs;
+   
+   //network thread only
+   std::vector<Event> mPending;
+   std::unordered_map<int, size_t> mPendingCoalesced;
+};
@@ -609,6 +609,15 @@ void ofTriangle(float x1, float y1, float x2, float y2, float x3, float y3)
    ofEndShape();
 }
 
+void ofRectangle::growToInclude(const ofRectangle& other)
+{
+   float minX = MIN(getMinX(), other.getMinX());
+   float minY = MIN(getMinY(), other.getMinY());
+   float maxX = MAX(getMaxX(), other.getMaxX());
+   float maxY = MAX(getMaxY(), other.getMaxY());
+   set(minX, minY, maxX - minX, maxY - minY);
+}
+
 float ofRectangle::getMinX() const
 {
    return MIN(x, x + width);  // - width
@@ -130,6 +130,7 @@ struct ofRectangle
       height += amount * 2;
       return *this;
    }
+   void growToInclude(const ofRectangle& other);
    float getMinX() const;
    float getMaxX() const;
    float getMinY() const;
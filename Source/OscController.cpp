@@ -32,7 +32,6 @@ OscController::OscController(MidiDeviceListener* listener, std::string outAddres
 , mOutAddress(outAddress)
 , mOutPort(outPort)
 , mInPort(inPort)
-, mOutputConnected(false)
 {
    Connect();
 }
@@ -63,9 +62,7 @@ void OscController::Connect()
 void OscController::ConnectOutput()
 {
    if (mOutAddress != "" && mOutPort > 0)
-   {
-      mOutputConnected = mOscOut.connect(mOutAddress, mOutPort);
-   }
+      mOscOut.Connect(mOutAddress, mOutPort);
 }
 
 bool OscController::SetInPort(int port)
@@ -92,26 +89,21 @@ void OscController::SendValue(int page, int control, float value, bool forceNote
    if (!mConnected)
       return;
    
-   for (int i=0; i<mOscMap.size(); ++i)
+   auto iter = mControlToMapIndex.find(control);
+   if (iter == mControlToMapIndex.end())
+      return;
+   
+   //queued, the send thread only sends the latest value for each address
+   OscMap& map = mOscMap[iter->second];
+   if (map.mIsFloat)
    {
-      if (control == mOscMap[i].mControl)// && mOscMap[i].mLastChangedTime + 50 < gTime)
-      {
-         juce::OSCMessage msg(mOscMap[i].mAddress.c_str());
-
-         if (mOscMap[i].mIsFloat)
-         {
-            mOscMap[i].mFloatValue = value;
-            msg.addFloat32(mOscMap[i].mFloatValue);
-         }
-         else
-         {
-            mOscMap[i].mIntValue = value*127;
-            msg.addInt32(mOscMap[i].mIntValue);
-         }
-         
-         if (mOutputConnected)
-            mOscOut.send(msg);
-      }
+      map.mFloatValue = value;
+      mOscOut.SendFloat(map.mOutAddressId, map.mFloatValue, K(coalesce));
+   }
+   else
+   {
+      map.mIntValue = value*127;
+      mOscOut.SendInt(map.mOutAddressId, map.mIntValue, K(coalesce));
    }
 }
 
@@ -178,15 +170,25 @@ void OscController::oscMessageReceived(const juce::OSCMessage& msg)
 
 int OscController::FindControl(std::string address)
 {
-   for (int i = 0; i < mOscMap.size(); ++i)
-   {
-      if (address == mOscMap[i].mAddress)
-         return i;
-   }
+   auto iter = mAddressToMapIndex.find(address);
+   if (iter != mAddressToMapIndex.end())
+      return iter->second;
 
    return -1;
 }
 
+void OscController::RebuildLookups()
+{
+   mAddressToMapIndex.clear();
+   mControlToMapIndex.clear();
+   for (int i = 0; i < (int)mOscMap.size(); ++i)
+   {
+      mAddressToMapIndex.insert(std::make_pair(mOscMap[i].mAddress, i));   //first one wins, like the old linear search
+      mControlToMapIndex.insert(std::make_pair(mOscMap[i].mControl, i));
+      mOscMap[i].mOutAddressId = mOscOut.GetAddressId(mOscMap[i].mAddress);
+   }
+}
+
 int OscController::AddControl(std::string address, bool isFloat)
 {
    int existing = FindControl(address);
@@ -198,7 +200,10 @@ int OscController::AddControl(std::string address, bool isFloat)
    entry.mControl = mapIndex;
    entry.mAddress = address;
    entry.mIsFloat = isFloat;
+   entry.mOutAddressId = mOscOut.GetAddressId(address);
    mOscMap.push_back(entry);
+   mAddressToMapIndex[address] = mapIndex;
+   mControlToMapIndex[entry.mControl] = mapIndex;
 
    return mapIndex;
 }
@@ -242,4 +247,5 @@ void OscController::LoadState(FileStreamIn& in)
       in >> mOscMap[i].mIntValue;
       in >> mOscMap[i].mLastChangedTime;
    }
+   RebuildLookups();
 }
@@ -27,9 +27,11 @@
 #define __Bespoke__OscController__
 
 #include <iostream>
+#include <unordered_map>
 #include "MidiDevice.h"
 #include "INonstandardController.h"
 #include "ofxJSONElement.h"
+#include "OSCSendQueue.h"
 
 #include "juce_osc/juce_osc.h"
 
@@ -41,6 +43,7 @@ struct OscMap
    float mFloatValue;
    int mIntValue;
    double mLastChangedTime;
+   int mOutAddressId;
 };
 
 class OscController : public INonstandardController,
@@ -69,15 +72,17 @@ private:
 
    int FindControl(std::string address);
    void ConnectOutput();
+   void RebuildLookups();
    
    std::string mOutAddress;
    int mOutPort;
    int mInPort;
-   juce::OSCSender mOscOut;
+   OSCSendQueue mOscOut;
    bool mConnected;
-   bool mOutputConnected;
    
    std::vector<OscMap> mOscMap;
+   std::unordered_map<std::string, int> mAddressToMapIndex;
+   std::unordered_map<int, int> mControlToMapIndex;
 };
 
 #endif /* defined(__Bespoke__OscController__) */
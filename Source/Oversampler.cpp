@@ -0,0 +1,290 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    Oversampler.cpp
+    Created: 19 Oct 2026 11:48:52pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "Oversampler.h"
+#include "DropdownList.h"
+#include "SynthGlobals.h"
+
+#include <functional>
+
+#include "juce_core/juce_core.h"
+#include "juce_audio_basics/juce_audio_basics.h"
+
+namespace
+{
+   //transition bandwidth of each stage relative to its higher rate. the first doubling has to be steep to keep
+   //the audible band, later ones only have to reject what would fold back into it, so they get by with fewer allpasses
+   const double kStageTransition[] = { .04, .12, .18 };
+   const double kStageAttenuationDb = 90;
+   
+   //elliptic half-band design for polyphase allpass pairs, after Valenzuela & Constantinides
+   double TransitionParameter(double transition, double& k)
+   {
+      k = tan((1 - transition * 2) * PI / 4);
+      k *= k;
+      double kksqrt = pow(1 - k * k, .25);
+      double e = .5 * (1 - kksqrt) / (1 + kksqrt);
+      double e2 = e * e;
+      double e4 = e2 * e2;
+      return e * (1 + e4 * (2 + e4 * (15 + 150 * e4)));
+   }
+   
+   double AllpassCoefficient(int index, double k, double q, int order)
+   {
+      int c = index + 1;
+      double num = 0;
+      double term;
+      int i = 0;
+      double sign = 1;
+      do
+      {
+         term = pow(q, i * (i + 1)) * sin((i * 2 + 1) * c * PI / order) * sign;
+         num += term;
+         sign = -sign;
+         ++i;
+      } while (fabs(term) > 1e-100);
+      num *= pow(q, .25);
+      
+      double den = 0;
+      i = 1;
+      sign = -1;
+      do
+      {
+         term = pow(q, i * i) * cos(i * 2 * c * PI / order) * sign;
+         den += term;
+         sign = -sign;
+         ++i;
+      } while (fabs(term) > 1e-100);
+      den += .5;
+      
+      double ww = num / den;
+      double wwsq = ww * ww;
+      double x = sqrt((1 - wwsq * k) * (1 - wwsq / k)) / (1 + wwsq);
+      return (1 - x) / (1 + x);
+   }
+}
+
+//static
+const Oversampler::Design& Oversampler::GetDesign(int stage)
+{
+   static Design sDesigns[kNumStages];
+   static bool sDesigned = false;
+   if (!sDesigned)
+   {
+      for (int s=0; s<kNumStages; ++s)
+      {
+         Design& design = sDesigns[s];
+         double k;
+         double q = TransitionParameter(kStageTransition[s], k);
+         double attenuation = pow(10, -kStageAttenuationDb / 10);
+         double a = attenuation / (1 - attenuation);
+         int order = int(ceil(log(a * a / 16) / log(q)));
+         if (order % 2 == 0)
+            ++order;
+         design.mNumCoefficients = MIN((order - 1) / 2, kMaxCoefficients);
+         
+         //coefficients alternate between the two phases. a first order allpass running at the lower rate delays
+         //low frequencies by 2(1-a)/(1+a) samples of the higher rate. the one sample offset between the phases
+         //going up is taken back out coming down
+         double phaseDelay[2] = { 0, 0 };
+         for (int i=0; i<design.mNumCoefficients; ++i)
+         {
+            double coefficient = AllpassCoefficient(i, k, q, order);
+            design.mCoefficients[i] = float(coefficient);
+            phaseDelay[i % 2] += 2 * (1 - coefficient) / (1 + coefficient);
+         }
+         design.mLatency = float(phaseDelay[0] + phaseDelay[1]);
+      }
+      sDesigned = true;
+   }
+   return sDesigns[stage];
+}
+
+void Oversampler::HalfBand::Reset()
+{
+   for (int i=0; i<kMaxCoefficients; ++i)
+   {
+      mX[i] = 0;
+      mY[i] = 0;
+   }
+}
+
+void Oversampler::HalfBand::Upsample(const float* in, float* out, int size)
+{
+   for (int i=0; i<size; ++i)
+   {
+      //both phases start from the same input
+      float even = in[i];
+      float odd = in[i];
+      Filter(even, odd);
+      out[i*2] = even;
+      out[i*2+1] = odd;
+   }
+}
+
+void Oversampler::HalfBand::Downsample(const float* in, float* out, int size)
+{
+   for (int i=0; i<size; ++i)
+   {
+      float even = in[i*2+1];
+      float odd = in[i*2];
+      Filter(even, odd);
+      out[i] = .5f * (even + odd);
+   }
+}
+
+Oversampler::Oversampler()
+: Oversampler(gBufferSize)
+{
+}
+
+Oversampler::Oversampler(int maxBufferSize)
+: mFactor(1)
+, mNumStages(0)
+{
+   //sized for the highest factor up front, so that changing it never allocates on the audio thread
+   for (int ch=0; ch<ChannelBuffer::kMaxNumChannels; ++ch)
+      mBuffers[ch].resize(maxBufferSize * kMaxFactor);
+   mScratch.resize(maxBufferSize * kMaxFactor);
+   
+   for (int ch=0; ch<ChannelBuffer::kMaxNumChannels; ++ch)
+   {
+      for (int s=0; s<kNumStages; ++s)
+      {
+         mUpsamplers[ch][s].SetDesign(&GetDesign(s));
+         mDownsamplers[ch][s].SetDesign(&GetDesign(s));
+      }
+   }
+}
+
+void Oversampler::SetFactor(int factor)
+{
+   factor = CLAMP(factor, 1, kMaxFactor);
+   mNumStages = 0;
+   while ((2 << mNumStages) <= factor)
+      ++mNumStages;
+   mFactor = 1 << mNumStages;
+   Reset();
+}
+
+void Oversampler::Reset()
+{
+   for (int ch=0; ch<ChannelBuffer::kMaxNumChannels; ++ch)
+   {
+      for (int s=0; s<kNumStages; ++s)
+      {
+         mUpsamplers[ch][s].Reset();
+         mDownsamplers[ch][s].Reset();
+      }
+   }
+}
+
+float Oversampler::GetLatency() const
+{
+   float latency = 0;
+   for (int s=0; s<mNumStages; ++s)
+      latency += GetDesign(s).mLatency / (2 << s);  //stage s runs at 2^(s+1) times the base rate
+   return latency;
+}
+
+float* Oversampler::Upsample(float* buffer, int bufferSize, int channel)
+{
+   if (mNumStages == 0)
+      return buffer;
+   
+   assert(bufferSize * mFactor <= (int)mScratch.size());
+   
+   //ping-pong so that the last stage lands in the channel's buffer
+   const float* in = buffer;
+   for (int s=0; s<mNumStages; ++s)
+   {
+      float* out = ((mNumStages - s) % 2 == 1) ? mBuffers[channel].data() : mScratch.data();
+      mUpsamplers[channel][s].Upsample(in, out, bufferSize << s);
+      in = out;
+   }
+   return mBuffers[channel].data();
+}
+
+void Oversampler::Downsample(float* buffer, int bufferSize, int channel)
+{
+   if (mNumStages == 0)
+      return;
+   
+   //each stage halves the length, so it can run in place
+   float* samples = mBuffers[channel].data();
+   for (int s=mNumStages-1; s>0; --s)
+      mDownsamplers[channel][s].Downsample(samples, samples, bufferSize << s);
+   mDownsamplers[channel][0].Downsample(samples, buffer, bufferSize);
+}
+
+//static
+void Oversampler::AddFactorLabels(DropdownList* list)
+{
+   for (int factor=1; factor<=kMaxFactor; factor *= 2)
+      list->AddLabel(ofToString(factor) + "x", factor);
+}
+
+//static
+void Oversampler::RunBenchmark(int bufferSize)
+{
+   juce::ScopedNoDenormals noDenormals;
+   
+   const int kIterations = 2000;
+   std::vector<float> buffer(bufferSize);
+   
+   auto NanosecondsPerSample = [bufferSize, &buffer](std::function<void()> process)
+   {
+      juce::int64 start = juce::Time::getHighResolutionTicks();
+      for (int i=0; i<kIterations; ++i)
+      {
+         for (int j=0; j<bufferSize; ++j)
+            buffer[j] = sinf(j * .05f) * .8f;
+         process();
+      }
+      double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+      return seconds * 1e9 / kIterations / bufferSize;
+   };
+   
+   ofLog() << "oversampling benchmark: buffer size " << bufferSize << ", tanh distortion, ns per sample per channel (includes filling the input)";
+   ofLog() << "   factor   ns      latency (samples)   allpasses per stage";
+   for (int factor=1; factor<=kMaxFactor; factor *= 2)
+   {
+      Oversampler oversampler(bufferSize);
+      oversampler.SetFactor(factor);
+      double ns = NanosecondsPerSample([&]()
+      {
+         float* samples = oversampler.Upsample(buffer.data(), bufferSize, 0);
+         for (int i=0; i<bufferSize*factor; ++i)
+            samples[i] = tanhf(samples[i] * 4) * .25f;
+         oversampler.Downsample(buffer.data(), bufferSize, 0);
+      });
+      std::string allpasses;
+      for (int s=0; s<oversampler.mNumStages; ++s)
+         allpasses += ofToString(GetDesign(s).mNumCoefficients) + " ";
+      ofLog() << "   " << factor << "x       " << ofToString(ns, 2) << "   " << ofToString(oversampler.GetLatency(), 2) << "                " << allpasses;
+   }
+}
@@ -0,0 +1,122 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    Oversampler.h
+    Created: 19 Oct 2026 11:48:52pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ChannelBuffer.h"
+#include <vector>
+
+class DropdownList;
+
+//runs a stretch of processing at 2x, 4x or 8x the sample rate, for nonlinearities that would otherwise alias.
+//each doubling is a polyphase half-band iir (two parallel chains of first order allpasses, one per output phase),
+//so every stage only filters at its lower rate. factor 1 passes buffers straight through.
+class Oversampler
+{
+public:
+   Oversampler();   //for buffers up to gBufferSize
+   explicit Oversampler(int maxBufferSize);
+   
+   static const int kMaxFactor = 8;
+   
+   //resets the filters, call from the thread doing the processing
+   void SetFactor(int factor);
+   int GetFactor() const { return mFactor; }
+   //delay added by upsampling and downsampling again, in samples at the base rate.
+   //the filters aren't linear phase, so this is the group delay at low frequencies
+   float GetLatency() const;
+   void Reset();
+   
+   //returns bufferSize * GetFactor() samples to process in place, valid until the next Upsample() of that channel
+   float* Upsample(float* buffer, int bufferSize, int channel);
+   //filters the processed samples back down into buffer
+   void Downsample(float* buffer, int bufferSize, int channel);
+   
+   //labels for a dropdown picking the factor
+   static void AddFactorLabels(DropdownList* list);
+   
+   static void RunBenchmark(int bufferSize);
+   
+private:
+   static const int kNumStages = 3;   //log2(kMaxFactor)
+   static const int kMaxCoefficients = 16;
+   
+   struct Design
+   {
+      float mCoefficients[kMaxCoefficients];
+      int mNumCoefficients;
+      float mLatency;   //in samples at the stage's higher rate, for going up and back down
+   };
+   static const Design& GetDesign(int stage);
+   
+   class HalfBand
+   {
+   public:
+      HalfBand() : mDesign(nullptr) { Reset(); }
+      void SetDesign(const Design* design) { mDesign = design; }
+      void Reset();
+      void Upsample(const float* in, float* out, int size);
+      void Downsample(const float* in, float* out, int size);
+   private:
+      //runs each phase through its allpasses, which alternate between the two. both chains advance together so they pipeline
+      inline void Filter(float& even, float& odd)
+      {
+         const float* coefficients = mDesign->mCoefficients;
+         const int numCoefficients = mDesign->mNumCoefficients;
+         int c = 0;
+         for (; c+1 < numCoefficients; c += 2)
+         {
+            float filteredEven = (even - mY[c]) * coefficients[c] + mX[c];
+            float filteredOdd = (odd - mY[c+1]) * coefficients[c+1] + mX[c+1];
+            mX[c] = even;
+            mX[c+1] = odd;
+            mY[c] = filteredEven;
+            mY[c+1] = filteredOdd;
+            even = filteredEven;
+            odd = filteredOdd;
+         }
+         if (c < numCoefficients)
+         {
+            float filteredEven = (even - mY[c]) * coefficients[c] + mX[c];
+            mX[c] = even;
+            mY[c] = filteredEven;
+            even = filteredEven;
+         }
+      }
+      
+      const Design* mDesign;
+      float mX[kMaxCoefficients];
+      float mY[kMaxCoefficients];
+   };
+   
+   int mFactor;
+   int mNumStages;
+   HalfBand mUpsamplers[ChannelBuffer::kMaxNumChannels][kNumStages];
+   HalfBand mDownsamplers[ChannelBuffer::kMaxNumChannels][kNumStages];
+   std::vector<float> mBuffers[ChannelBuffer::kMaxNumChannels];
+   std::vector<float> mScratch;
+};
@@ -219,8 +219,8 @@ void PSMoveController::FloatSliderUpdated(FloatSlider* slider, float oldVal)
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
       {
-         transportListenerInfo->mInterval = kInterval_4n;
-         transportListenerInfo->mOffsetInfo = OffsetInfo(mMetronomeLagOffset, true);
+         transportListenerInfo->SetInterval(kInterval_4n);
+         transportListenerInfo->SetOffsetInfo(OffsetInfo(mMetronomeLagOffset, true));
       }
    }
 }
@@ -0,0 +1,256 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    PagedMemory.cpp
+    Created: 19 Oct 2026 4:12:55pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "PagedMemory.h"
+#include "SynthGlobals.h"
+
+#include <algorithm>
+#include <vector>
+#include "juce_core/juce_core.h"
+
+#ifdef JUCE_WINDOWS
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+   size_t GetPageSize()
+   {
+#ifdef JUCE_WINDOWS
+      SYSTEM_INFO info;
+      GetSystemInfo(&info);
+      return info.dwPageSize;
+#else
+      return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+   }
+
+   const size_t kPageSize = GetPageSize();
+   const int kPagerIntervalMs = 10;
+
+   size_t GetAllocationBytes(int count)
+   {
+      size_t bytes = count * sizeof(float);
+      return (bytes + kPageSize - 1) / kPageSize * kPageSize;
+   }
+}
+
+//static
+float* PagedMemory::AllocateFloats(int count)
+{
+   size_t bytes = GetAllocationBytes(count);
+#ifdef JUCE_WINDOWS
+   //committed pages are still only backed by physical memory once they're touched
+   void* data = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+   if (data == nullptr)
+#else
+   void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (data == MAP_FAILED)
+#endif
+   {
+      ofLog() << "warning: couldn't reserve paged memory for " << count << " samples";
+      return nullptr;
+   }
+   return (float*)data;
+}
+
+//static
+void PagedMemory::FreeFloats(float* data, int count)
+{
+   if (data == nullptr)
+      return;
+#ifdef JUCE_WINDOWS
+   VirtualFree(data, 0, MEM_RELEASE);
+#else
+   munmap(data, GetAllocationBytes(count));
+#endif
+}
+
+//static
+void PagedMemory::DecommitFloats(float* data, int count)
+{
+   if (data == nullptr || count <= 0)
+      return;
+
+   //only whole pages can be handed back, zero the partial ones at either end by hand
+   size_t start = (size_t)data;
+   size_t end = (size_t)(data + count);
+   size_t firstPage = (start + kPageSize - 1) / kPageSize * kPageSize;
+   size_t lastPage = end / kPageSize * kPageSize;
+   if (firstPage >= lastPage)
+   {
+      ::Clear(data, count);
+      return;
+   }
+
+   ::Clear(data, int((firstPage - start) / sizeof(float)));
+   ::Clear((float*)lastPage, int((end - lastPage) / sizeof(float)));
+#ifdef JUCE_WINDOWS
+   VirtualFree((void*)firstPage, lastPage - firstPage, MEM_DECOMMIT);
+   VirtualAlloc((void*)firstPage, lastPage - firstPage, MEM_COMMIT, PAGE_READWRITE);
+#else
+   //mapping fresh anonymous pages over the range gives zero pages back, on every posix platform
+   mmap((void*)firstPage, lastPage - firstPage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+#endif
+}
+
+//static
+void PagedMemory::CommitFloats(float* data, int count)
+{
+   if (data == nullptr || count <= 0)
+      return;
+   
+   //an atomic "or 0" write-faults the page in without any chance of clobbering a sample being written at the same time
+   char* end = (char*)(data + count);
+   for (char* page = (char*)((size_t)data / kPageSize * kPageSize); page < end; page += kPageSize)
+   {
+      uint32_t* word = (uint32_t*)std::max(page, (char*)data);
+#ifdef JUCE_WINDOWS
+      InterlockedOr((volatile LONG*)word, 0);
+#else
+      __atomic_fetch_or(word, 0, __ATOMIC_RELAXED);
+#endif
+   }
+}
+
+namespace
+{
+   class PagedMemoryThread : public juce::Thread
+   {
+   public:
+      PagedMemoryThread() : juce::Thread("paged memory") {}
+      ~PagedMemoryThread() { stopThread(1000); }
+      
+      void Add(PagedChannel* channel)
+      {
+         {
+            const juce::ScopedLock lock(mChannelsLock);
+            mChannels.push_back(channel);
+         }
+         if (!isThreadRunning())
+            startThread();
+      }
+      
+      void Remove(PagedChannel* channel)
+      {
+         const juce::ScopedLock lock(mChannelsLock);
+         mChannels.erase(std::remove(mChannels.begin(), mChannels.end(), channel), mChannels.end());
+      }
+      
+      void run() override
+      {
+         while (!threadShouldExit())
+         {
+            {
+               const juce::ScopedLock lock(mChannelsLock);
+               for (auto* channel : mChannels)
+                  channel->Update();
+            }
+            wait(kPagerIntervalMs);
+         }
+      }
+      
+   private:
+      juce::CriticalSection mChannelsLock;
+      std::vector<PagedChannel*> mChannels;
+   };
+   
+   PagedMemoryThread& GetPagedMemoryThread()
+   {
+      static PagedMemoryThread sThread;
+      return sThread;
+   }
+}
+
+PagedChannel::PagedChannel(int count)
+: mCount(count)
+, mData(PagedMemory::AllocateFloats(count))
+, mSpare(nullptr)
+, mRetired(nullptr)
+, mWantCommitted(0)
+, mCommittedData(nullptr)
+, mNumCommitted(0)
+{
+   if (mData != nullptr)
+   {
+      mSpare = PagedMemory::AllocateFloats(count);
+      GetPagedMemoryThread().Add(this);
+   }
+}
+
+PagedChannel::~PagedChannel()
+{
+   if (mData == nullptr)
+      return;
+   
+   GetPagedMemoryThread().Remove(this);
+   PagedMemory::FreeFloats(mData, mCount);
+   PagedMemory::FreeFloats(mSpare, mCount);
+   PagedMemory::FreeFloats(mRetired, mCount);
+}
+
+void PagedChannel::Clear()
+{
+   float* spare = mSpare.exchange(nullptr);
+   if (spare != nullptr)
+   {
+      mRetired = mData.load();
+      mData = spare;
+   }
+   else
+   {
+      //the last clear is still being cleaned up, this only happens when clearing over and over
+      ::Clear(mData, mCount);
+   }
+}
+
+void PagedChannel::Update()
+{
+   float* retired = mRetired;
+   if (retired != nullptr)
+   {
+      PagedMemory::DecommitFloats(retired, mCount);
+      mRetired = nullptr;
+      mSpare = retired;
+   }
+   
+   float* data = mData;
+   if (data != mCommittedData)
+   {
+      mCommittedData = data;
+      mNumCommitted = 0;
+   }
+   int wantCommitted = std::min(int(mWantCommitted), mCount);
+   if (wantCommitted > mNumCommitted)
+   {
+      PagedMemory::CommitFloats(data + mNumCommitted, wantCommitted - mNumCommitted);
+      mNumCommitted = wantCommitted;
+   }
+}
@@ -0,0 +1,69 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    PagedMemory.h
+    Created: 19 Oct 2026 4:12:55pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+
+//sample memory for big, mostly-empty buffers like loopers and retrospective recorders.
+//the whole range is reserved up front so it never has to be allocated on the audio thread, but the os only gives
+//it real memory one page at a time as it gets written to. untouched pages read as zero.
+class PagedMemory
+{
+public:
+   static float* AllocateFloats(int count);   //returns nullptr if the os won't reserve it
+   static void FreeFloats(float* data, int count);
+   //zeroes the range, handing any whole pages in it back to the os. makes system calls, keep it off the audio thread
+   static void DecommitFloats(float* data, int count);
+   //gets the os to back the range with memory without changing what's in it, so it's safe while something else writes to it
+   static void CommitFloats(float* data, int count);
+};
+
+//one channel of paged samples. page faults and handing pages back to the os are slow system calls, so they're done on
+//the paged memory thread: it commits pages ahead of where they're going to be written, and cleans a spare region so
+//that clearing from the audio thread is just swapping it in
+class PagedChannel
+{
+public:
+   PagedChannel(int count);
+   ~PagedChannel();
+   
+   bool IsValid() const { return mData != nullptr; }
+   float* Get() const { return mData; }
+   void Clear();   //safe on the audio thread
+   void RequestCommitted(int count) { mWantCommitted = count; }   //safe on the audio thread
+   void Update();  //called from the paged memory thread
+   
+private:
+   int mCount;
+   std::atomic<float*> mData;
+   std::atomic<float*> mSpare;     //zeroed and ready to swap in
+   std::atomic<float*> mRetired;   //swapped out, waiting for the paged memory thread to zero it
+   std::atomic<int> mWantCommitted;
+   float* mCommittedData;
+   int mNumCommitted;
+};
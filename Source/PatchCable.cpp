@@ -110,6 +110,7 @@ void PatchCable::Render()
             if (vizBuff == nullptr)
                vizBuff = audioSource->GetVizBuffer();
             assert(vizBuff);
+            vizBuff->RequestCapture();
             int numSamples = vizBuff->Size();
             bool allZero = true;
             for (int ch=0; ch<vizBuff->NumChannels(); ++ch)
@@ -295,6 +296,7 @@ void PatchCable::Render()
          if (vizBuff == nullptr)
             vizBuff = audioSource->GetVizBuffer();
          assert(vizBuff);
+         vizBuff->RequestCapture();
          int numSamples = vizBuff->Size();
          float dx = (cable.plug.x - cable.start.x) / wireLength;
          float dy = (cable.plug.y - cable.start.y) / wireLength;
@@ -522,6 +522,20 @@ bool PatchCableSource::TestHover(float x, float y) const
    return GetHoverIndex(x, y) != -1;
 }
 
+ofRectangle PatchCableSource::GetHoverBounds() const
+{
+   //covers every position that GetHoverIndex() can match
+   int count = MAX(1, (int)mPatchCables.size());
+   ofRectangle bounds(mX, mY, 0, 0);
+   if (mSide == Side::kBottom)
+      bounds.height = (count - 1) * kPatchCableSpacing;
+   else if (mSide == Side::kLeft)
+      bounds.x -= (count - 1) * kPatchCableSpacing;
+   if (mSide == Side::kLeft || mSide == Side::kRight)
+      bounds.width = (count - 1) * kPatchCableSpacing;
+   return bounds.grow(kPatchCableSourceRadius);
+}
+
 int PatchCableSource::GetHoverIndex(float x, float y) const
 {
    float cableX = mX;
@@ -95,7 +95,7 @@ public:
    ConnectionType GetConnectionType() const { return mType; }
    void SetConnectionType(ConnectionType type);
    IDrawableModule* GetOwner() const { return mOwner; }
-   void SetOverrideVizBuffer(RollingBuffer* viz) { mOverrideVizBuffer = viz; }
+   void SetOverrideVizBuffer(RollingBuffer* viz) { mOverrideVizBuffer = viz; if (viz != nullptr) viz->SetCaptureOnDemand(true); }
    RollingBuffer* GetOverrideVizBuffer() const { return mOverrideVizBuffer; }
    void UpdatePosition(bool parentMinimized);
    void SetManualPosition(int x, int y) { mManualPositionX = x; mManualPositionY = y; mAutomaticPositioning = false; }
@@ -119,6 +119,7 @@ public:
    void SetManualSide(Side side) { mManualSide = side; }
    void SetClickable(bool clickable) { mClickable = clickable; }
    bool TestHover(float x, float y) const;
+   ofRectangle GetHoverBounds() const;
    void SetOverrideCableDir(ofVec2f dir) { mHasOverrideCableDir = true; mOverrideCableDir = dir; }
    ofVec2f GetCableStart(int index) const;
    ofVec2f GetCableStartDir(int index, ofVec2f dest) const;
@@ -33,7 +33,8 @@ class PeakTracker
 public:
    PeakTracker() : mPeak(0), mDecayTime(.01f), mLimit(-1) {}
    
-   void Process(float* buffer, int bufferSize);
+   //optionally writes the peak at every sample into peaks, which can be the same as buffer
+   void Process(float* buffer, int bufferSize, float* peaks = nullptr);
    float GetPeak() const { return mPeak; }
    void SetDecayTime(float time) { mDecayTime = time; }
    void SetLimit(float limit) { mLimit = limit; }
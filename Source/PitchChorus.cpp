@@ -35,6 +35,7 @@ PitchChorus::PitchChorus()
 {
    mOutputBuffer = new float[gBufferSize];
    Clear(mOutputBuffer, gBufferSize);
+   mRampBuffer = new float[gBufferSize];
 }
 
 void PitchChorus::CreateUIControls()
@@ -46,6 +47,7 @@ void PitchChorus::CreateUIControls()
 PitchChorus::~PitchChorus()
 {
    delete[] mOutputBuffer;
+   delete[] mRampBuffer;
 }
 
 void PitchChorus::Process(double time)
@@ -69,12 +71,11 @@ void PitchChorus::Process(double time)
          {
             BufferCopy(gWorkBuffer, GetBuffer()->GetChannel(0), bufferSize);
             mShifters[i].mShifter.Process(gWorkBuffer, bufferSize);
-            double timeCopy = time;
-            for (int j=0; j<bufferSize; ++j)
-            {
-               mOutputBuffer[j] += gWorkBuffer[j] * mShifters[i].mRamp.Value(timeCopy);
-               timeCopy += gInvSampleRateMs;
-            }
+            if (mShifters[i].mRamp.Fill(time, mRampBuffer, bufferSize))
+               Mult(gWorkBuffer, mRampBuffer[0], bufferSize);
+            else
+               Mult(gWorkBuffer, mRampBuffer, bufferSize);
+            Add(mOutputBuffer, gWorkBuffer, bufferSize);
          }
       }
       
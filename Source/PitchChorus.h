@@ -60,6 +60,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=120; h=22; }
    bool Enabled() const override { return mEnabled; }
    
@@ -75,6 +76,7 @@ private:
    };
    
    float* mOutputBuffer;
+   float* mRampBuffer;
    PitchShifterVoice mShifters[kNumShifters];
    bool mPassthrough;
    Checkbox* mPassthroughCheckbox;
@@ -27,240 +27,187 @@
 #include "FFT.h"
 #include "SynthGlobals.h"
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+
 #define L2SC (float)3.32192809488736218171
 
-PitchDetector::PitchDetector()
-: mTune(440)
-, mPitch(0)
-, mConfidence(0)
+namespace
 {
-   mfs = gSampleRate;
-   
-   mcbsize = 2048;
-   mcorrsize = mcbsize / 2 + 1;
-   
-   mpmax = 1/(float)70;  // max and min periods (ms)
-   mpmin = 1/(float)700; // eventually may want to bring these out as sliders
-   
-   mnmax = (unsigned long)(gSampleRate * mpmax);
-   if (mnmax > mcorrsize) {
-      mnmax = mcorrsize;
-   }
-   mnmin = (unsigned long)(gSampleRate * mpmin);
-   
-   mcbi = (float*)calloc(mcbsize, sizeof(float));
-   
-   mcbiwr = 0;
-   
-   // Generate a window with a single raised cosine from N/4 to 3N/4
-   mcbwindow = (float*)calloc(mcbsize, sizeof(float));
-   for (int ti=0; ti<(mcbsize / 2); ti++) {
-      mcbwindow[ti+mcbsize/4] = -0.5*cos(4*PI*ti/(mcbsize - 1)) + 0.5;
-   }
-   
-   mnoverlap = 4;
+   const float kMinFreq = 70;    //eventually may want to bring these out as sliders
+   const float kMaxFreq = 700;
    
-   mFFT = new ::FFT((int)mcbsize);
+   std::mutex sAnalysisWindowMutex;
+   std::map<int, std::shared_ptr<const PitchDetector::AnalysisWindow>> sAnalysisWindows;
    
-   mffttime = (float*)calloc(mcbsize, sizeof(float));
-   mfftfreqre = (float*)calloc(mcorrsize, sizeof(float));
-   mfftfreqim = (float*)calloc(mcorrsize, sizeof(float));
-   
-   
-   // ---- Calculate autocorrelation of window ----
-   macwinv = (float*)calloc(mcbsize, sizeof(float));
-   for (int ti=0; ti<mcbsize; ti++) {
-      mffttime[ti] = mcbwindow[ti];
-   }
-   mFFT->Forward(mcbwindow, mfftfreqre, mfftfreqim);
-   for (int ti=0; ti<mcorrsize; ti++) {
-      mfftfreqre[ti] = (mfftfreqre[ti])*(mfftfreqre[ti]) + (mfftfreqim[ti])*(mfftfreqim[ti]);
-      mfftfreqim[ti] = 0;
-   }
-   mFFT->Inverse(mfftfreqre, mfftfreqim, mffttime);
-   for (long ti=1; ti<mcbsize; ti++) {
-      macwinv[ti] = mffttime[ti]/mffttime[0];
-      if (macwinv[ti] > 0.000001) {
-         macwinv[ti] = (float)1/macwinv[ti];
-      }
-      else {
-         macwinv[ti] = 0;
+   std::shared_ptr<const PitchDetector::AnalysisWindow> GetAnalysisWindow(int windowSize)
+   {
+      std::lock_guard<std::mutex> lock(sAnalysisWindowMutex);
+      auto& cached = sAnalysisWindows[windowSize];
+      if (cached == nullptr)
+      {
+         int correlationSize = windowSize / 2 + 1;
+         auto analysisWindow = std::make_shared<PitchDetector::AnalysisWindow>();
+         std::vector<float>& window = analysisWindow->mWindow;
+         std::vector<float>& inverse = analysisWindow->mInverseWindowAutocorrelation;
+         window.assign(windowSize, 0);
+         inverse.assign(windowSize, 0);
+         
+         //a single raised cosine from N/4 to 3N/4
+         for (int i=0; i<windowSize/2; ++i)
+            window[i+windowSize/4] = -0.5*cos(4*PI*i/(windowSize - 1)) + 0.5;
+         
+         //autocorrelation of the window, to take its bias back out of the estimates
+         ::FFT fft(windowSize);
+         std::vector<float> time(window);
+         std::vector<float> re(correlationSize);
+         std::vector<float> im(correlationSize);
+         fft.Forward(time.data(), re.data(), im.data());
+         for (int i=0; i<correlationSize; ++i)
+         {
+            re[i] = re[i]*re[i] + im[i]*im[i];
+            im[i] = 0;
+         }
+         fft.Inverse(re.data(), im.data(), time.data());
+         for (int i=1; i<windowSize; ++i)
+         {
+            float correlation = time[i] / time[0];
+            inverse[i] = correlation > 0.000001f ? 1 / correlation : 0;
+         }
+         inverse[0] = 1;
+         
+         cached = analysisWindow;
       }
+      return cached;
    }
-   macwinv[0] = 1;
-   // ---- END Calculate autocorrelation of window ----
-   
-   
-   mlrshift = 0;
-   mptarget = 0;
-   msptarget = 0;
-   
-   mvthresh = 0.7;  //  The voiced confidence (unbiased peak) threshold level
+}
+
+PitchDetector::PitchDetector(int windowSize /*= 2048*/)
+: mWindowSize(windowSize)
+, mCorrelationSize(windowSize / 2 + 1)
+, mWritePos(0)
+, mTune(440)
+, mVoicedThreshold(.7f)
+, mPitch(69)
+, mConfidence(0)
+{
+   mMaxPeriod = MIN(int(gSampleRate / kMinFreq), mCorrelationSize);
+   mMinPeriod = int(gSampleRate / kMaxFreq);
+   SetOverlap(4);
+   
+   mAnalysisWindow = GetAnalysisWindow(windowSize);
+   mFFT = new ::FFT(windowSize);
+   mInput.assign(windowSize, 0);
+   mFFTTime.assign(windowSize, 0);
+   mFFTFreqRe.assign(mCorrelationSize, 0);
+   mFFTFreqIm.assign(mCorrelationSize, 0);
 }
 
 PitchDetector::~PitchDetector()
 {
    delete mFFT;
-   free(mcbi);
-   free(mcbwindow);
-   free(macwinv);
-   free(mffttime);
-   free(mfftfreqre);
-   free(mfftfreqim);
 }
 
-float PitchDetector::DetectPitch(float* buffer, int bufferSize)
+void PitchDetector::SetOverlap(int overlap)
 {
-   long int N;
-   long int Nf;
-   long int fs;
-   
-   long int ti;
-   long int ti2;
-   long int ti3;
-   long int ti4;
-   float tf;
-   float tf2;
-   
-   float pperiod;
-   
-   float* pfInput = buffer;
-   
-   maref = (float)mTune;
-   
-   N = mcbsize;
-   Nf = mcorrsize;
-   fs = mfs;
-   
-   float inpitch = 0;
-   float conf = mconf;
-   
+   mHopSize = MAX(mWindowSize / MAX(overlap, 1), 1);
+}
+
+void PitchDetector::AddListener(IPitchDetectorListener* listener)
+{
+   if (std::find(mListeners.begin(), mListeners.end(), listener) == mListeners.end())
+      mListeners.push_back(listener);
+}
+
+void PitchDetector::RemoveListener(IPitchDetectorListener* listener)
+{
+   mListeners.erase(std::remove(mListeners.begin(), mListeners.end(), listener), mListeners.end());
+}
+
+float PitchDetector::DetectPitch(const float* buffer, int bufferSize)
+{
+   for (int i=0; i<bufferSize; ++i)
+      Push(buffer[i], i);
+   return mPitch;
+}
+
+bool PitchDetector::Push(float sample, int sampleOffset /*= 0*/)
+{
+   mInput[mWritePos] = sample;
+   ++mWritePos;
+   if (mWritePos >= mWindowSize)
+      mWritePos = 0;
+   
+   if (mWritePos % mHopSize != 0)
+      return false;
+   
+   Analyze();
+   for (auto* listener : mListeners)
+      listener->OnPitchDetected(this, sampleOffset);
+   return true;
+}
+
+void PitchDetector::Analyze()
+{
+   const int N = mWindowSize;
+   const int Nf = mCorrelationSize;
+   const float* window = mAnalysisWindow->mWindow.data();
+   float* time = mFFTTime.data();
+   float* re = mFFTFreqRe.data();
+   float* im = mFFTFreqIm.data();
+   
+   //window the most recent N samples, newest first
+   for (int i=0; i<N; ++i)
+      time[i] = mInput[(mWritePos-i+N)%N] * window[i];
+   
+   //autocovariance, via the power spectrum with dc removed
+   mFFT->Forward(time, re, im);
+   re[0] = 0;
+   im[0] = 0;
+   for (int i=1; i<Nf; ++i)
+   {
+      re[i] = re[i]*re[i] + im[i]*im[i];
+      im[i] = 0;
+   }
+   mFFT->Inverse(re, im, time);
+   float normalize = 1 / time[0];
+   for (int i=1; i<N; ++i)
+      time[i] *= normalize;
+   time[0] = 1;
+   
+   //the period is at the biggest (biased) peak within range, the confidence is its unbiased height
+   float peakHeight = 0;
+   int peakIndex = 0;
+   for (int i=mMinPeriod; i<mMaxPeriod; ++i)
+   {
+      int prev = MAX(i-1, 0);
+      int next = MIN(i+1, Nf);
+      float height = time[i];
+      if (height > time[prev] && height >= time[next] && height > peakHeight)
+      {
+         peakHeight = height;
+         peakIndex = i;
+      }
+   }
    
-   /*******************
-    *  MAIN DSP LOOP  *
-    *******************/
-   for (int lSampleIndex = 0; lSampleIndex < bufferSize; lSampleIndex++)
+   float period = 1 / kMaxFreq;
+   if (peakHeight > 0)
    {
-      // load data into circular buffer
-      tf = (float) *(pfInput++);
-      ti4 = mcbiwr;
-      mcbi[ti4] = tf;
-      
-      // Input write pointer logic
-      mcbiwr++;
-      if (mcbiwr >= N)
+      mConfidence = peakHeight * mAnalysisWindow->mInverseWindowAutocorrelation[peakIndex];
+      if (peakIndex > 0 && peakIndex < Nf)
       {
-         mcbiwr = 0;
+         //center of mass around the peak
+         float mass = time[peakIndex-1] + time[peakIndex] + time[peakIndex+1];
+         float center = (time[peakIndex-1]*(peakIndex-1) + time[peakIndex]*peakIndex + time[peakIndex+1]*(peakIndex+1)) / mass;
+         period = center / gSampleRate;
       }
-      
-      
-      // ********************
-      // * Low-rate section *
-      // ********************
-      
-      // Every N/noverlap samples, run pitch estimation / manipulation code
-      if ((mcbiwr)%(N/mnoverlap) == 0)
+      else
       {
-         // ---- Obtain autocovariance ----
-         
-         // Window and fill FFT buffer
-         ti2 = mcbiwr;
-         for (ti=0; ti<N; ti++)
-         {
-            mffttime[ti] = (float)(mcbi[(ti2-ti+N)%N]*mcbwindow[ti]);
-         }
-         
-         // Calculate FFT
-         mFFT->Forward(mffttime, mfftfreqre, mfftfreqim);
-         
-         // Remove DC
-         mfftfreqre[0] = 0;
-         mfftfreqim[0] = 0;
-         
-         // Take magnitude squared
-         for (ti=1; ti<Nf; ti++)
-         {
-            mfftfreqre[ti] = (mfftfreqre[ti])*(mfftfreqre[ti]) + (mfftfreqim[ti])*(mfftfreqim[ti]);
-            mfftfreqim[ti] = 0;
-         }
-         
-         // Calculate IFFT
-         mFFT->Inverse(mfftfreqre, mfftfreqim, mffttime);
-         
-         // Normalize
-         tf = (float)1/mffttime[0];
-         for (ti=1; ti<N; ti++)
-         {
-            mffttime[ti] = mffttime[ti] * tf;
-         }
-         mffttime[0] = 1;
-         
-         //  ---- END Obtain autocovariance ----
-         
-         
-         //  ---- Calculate pitch and confidence ----
-         
-         // Calculate pitch period
-         //   Pitch period is determined by the location of the max (biased)
-         //     peak within a given range
-         //   Confidence is determined by the corresponding unbiased height
-         tf2 = 0;
-         pperiod = mpmin;
-         for (ti=mnmin; ti<mnmax; ti++)
-         {
-            ti2 = ti-1;
-            ti3 = ti+1;
-            if (ti2<0)
-            {
-               ti2 = 0;
-            }
-            if (ti3>Nf)
-            {
-               ti3 = Nf;
-            }
-            tf = mffttime[ti];
-            
-            if (tf>mffttime[ti2] && tf>=mffttime[ti3] && tf>tf2)
-            {
-               tf2 = tf;
-               ti4 = ti;
-            }
-         }
-         if (tf2>0)
-         {
-            conf = tf2*macwinv[ti4];
-            if (ti4>0 && ti4<Nf)
-            {
-               // Find the center of mass in the vicinity of the detected peak
-               tf = mffttime[ti4-1]*(ti4-1);
-               tf = tf + mffttime[ti4]*(ti4);
-               tf = tf + mffttime[ti4+1]*(ti4+1);
-               tf = tf/(mffttime[ti4-1] + mffttime[ti4] + mffttime[ti4+1]);
-               pperiod = tf/fs;
-            }
-            else
-            {
-               pperiod = (float)ti4/fs;
-            }
-         }
-         
-         // Convert to semitones
-         tf = (float) -12*log10((float)maref*pperiod)*L2SC;
-         if (conf>=mvthresh)
-         {
-            inpitch = tf;
-         }
-         mconf = conf;
-         
-         mPitch = inpitch + 69;
-         mConfidence = MIN(conf,1);
-         
-         //  ---- END Calculate pitch and confidence ----
+         period = float(peakIndex) / gSampleRate;
       }
    }
    
-   // Tell the host the algorithm latency
-   mLatency = (N-1);
-   
-   return mPitch;
+   if (IsVoiced())
+      mPitch = -12*log10(mTune*period)*L2SC + 69;
 }
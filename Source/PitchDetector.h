@@ -27,55 +27,79 @@
 #define __modularSynth__PitchDetector__
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 class FFT;
+class PitchDetector;
 
+class IPitchDetectorListener
+{
+public:
+   virtual ~IPitchDetectorListener() {}
+   //called on the thread feeding the detector, each time it makes an estimate. sampleOffset is where in the pushed buffer that happened
+   virtual void OnPitchDetected(PitchDetector* detector, int sampleOffset) = 0;
+};
+
+//tracks pitch from the autocorrelation of a sliding window, taken with an fft once per hop.
+//the strongest autocorrelation peak in range gives the period, and its height normalized by the autocorrelation
+//of the window itself gives the confidence (like MPM's normalized peak). the window tables are computed once
+//per window size and shared between all detectors, so any number of consumers can run one cheaply.
 class PitchDetector
 {
 public:
-   PitchDetector();
+   PitchDetector(int windowSize = 2048);
    ~PitchDetector();
    
-   float DetectPitch(float* buffer, int bufferSize);
+   //returns true if an estimate was made on this sample
+   bool Push(float sample, int sampleOffset = 0);
+   //returns the latest pitch after the whole buffer
+   float DetectPitch(const float* buffer, int bufferSize);
    
-private:
+   //estimates per window length. higher is lower latency and more cpu
+   void SetOverlap(int overlap);
+   int GetHopSize() const { return mHopSize; }
+   int GetWindowSize() const { return mWindowSize; }
+   void SetTuning(float a4) { mTune = a4; }
    
-   ////////////////////////////////////////
-   //ported
-   float mTune;
-   float mPitch;
-   float mConfidence;
-   float mLatency;
-   ::FFT* mFFT;
-   
-   unsigned long mfs; // Sample rate
+   float GetPitch() const { return mPitch; }  //midi pitch, holds the last voiced estimate
+   float GetConfidence() const { return mConfidence; }
+   bool IsVoiced() const { return mConfidence >= mVoicedThreshold; }
+   //circular history of the input, its write position is the number of samples pushed modulo the window size
+   const float* GetInputBuffer() const { return mInput.data(); }
    
-   unsigned long mcbsize; // size of circular buffer
-   unsigned long mcorrsize; // cbsize/2 + 1
-   unsigned long mcbiwr;
-   float* mcbi; // circular input buffer
+   //only add or remove listeners while the audio thread is locked
+   void AddListener(IPitchDetectorListener* listener);
+   void RemoveListener(IPitchDetectorListener* listener);
    
-   float* mcbwindow; // hann of length N/2, zeros for the rest
-   float* macwinv; // inverse of autocorrelation of window
-   int mnoverlap;
+   struct AnalysisWindow
+   {
+      std::vector<float> mWindow;   //hann over the middle half, zeros elsewhere
+      std::vector<float> mInverseWindowAutocorrelation;
+   };
    
-   float* mffttime;
-   float* mfftfreqre;
-   float* mfftfreqim;
+private:
+   void Analyze();
    
-   // VARIABLES FOR LOW-RATE SECTION
-   float maref; // A tuning reference (Hz)
-   float mconf; // Confidence of pitch period estimate (between 0 and 1)
-   float mvthresh; // Voiced speech threshold
+   int mWindowSize;
+   int mCorrelationSize;
+   int mHopSize;
+   int mWritePos;
+   int mMinPeriod;
+   int mMaxPeriod;
+   float mTune;
+   float mVoicedThreshold;
+   float mPitch;
+   float mConfidence;
    
-   float mpmax; // Maximum allowable pitch period (seconds)
-   float mpmin; // Minimum allowable pitch period (seconds)
-   unsigned long mnmax; // Maximum period index for pitch prd est
-   unsigned long mnmin; // Minimum period index for pitch prd est
+   std::shared_ptr<const AnalysisWindow> mAnalysisWindow;
+   ::FFT* mFFT;
+   std::vector<float> mInput;
+   std::vector<float> mFFTTime;
+   std::vector<float> mFFTFreqRe;
+   std::vector<float> mFFTFreqIm;
    
-   float mlrshift; // Shift prescribed by low-rate section
-   int mptarget; // Pitch target, between 0 and 11
-   float msptarget; // Smoothed pitch target
+   std::vector<IPitchDetectorListener*> mListeners;
 };
 
 #endif /* defined(__modularSynth__PitchDetector__) */
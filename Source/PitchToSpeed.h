@@ -65,6 +65,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 106; height=17*2+2; }
    bool Enabled() const override { return mEnabled; }
    
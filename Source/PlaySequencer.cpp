@@ -311,15 +311,15 @@ void PlaySequencer::UpdateInterval()
    TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
    if (transportListenerInfo != nullptr)
    {
-      transportListenerInfo->mInterval = mInterval;
-      transportListenerInfo->mOffsetInfo = OffsetInfo(0, false);
+      transportListenerInfo->SetInterval(mInterval);
+      transportListenerInfo->SetOffsetInfo(OffsetInfo(0, false));
    }
 
    TransportListenerInfo* noteOffListenerInfo = TheTransport->GetListenerInfo(&mNoteOffScheduler);
    if (noteOffListenerInfo != nullptr)
    {
-      noteOffListenerInfo->mInterval = mInterval;
-      noteOffListenerInfo->mOffsetInfo = OffsetInfo(TheTransport->GetMeasureFraction(mInterval) * .5f, false);
+      noteOffListenerInfo->SetInterval(mInterval);
+      noteOffListenerInfo->SetOffsetInfo(OffsetInfo(TheTransport->GetMeasureFraction(mInterval) * .5f, false));
    }
 
    UpdateNumMeasures(mNumMeasures);
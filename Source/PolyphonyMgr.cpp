@@ -31,12 +31,18 @@
 #include "SampleVoice.h"
 #include "SynthGlobals.h"
 #include "Profiler.h"
+#include "ModularSynth.h"
 
 ChannelBuffer gMidiVoiceWorkChannelBuffer(kWorkBufferSize);
 
 PolyphonyMgr::PolyphonyMgr(IDrawableModule* owner)
-   : mAllowStealing(true)
-   , mLastVoice(-1)
+   : mFirstFree(-1)
+   , mLastFree(-1)
+   , mVoiceType(kVoiceType_SingleOscillator)
+   , mVoiceParams(nullptr)
+   , mAllowStealing(true)
+   , mPeakActiveVoices(0)
+   , mNumSteals(0)
    , mFadeOutBufferPos(0)
    , mOwner(owner)
    , mFadeOutBuffer(kVoiceFadeSamples)
@@ -44,107 +50,216 @@ PolyphonyMgr::PolyphonyMgr(IDrawableModule* owner)
    , mVoiceLimit(kNumVoices)
    , mOversampling(1)
 {
+   for (int i=0; i<128; ++i)
+      mFirstHeld[i] = -1;
+   //reserve up front so that voices can move between lists on the audio thread without allocating
+   mVoices.reserve(kMaxVoicePoolSize);
+   mActiveVoices.reserve(kMaxVoicePoolSize);
 }
 
 PolyphonyMgr::~PolyphonyMgr()
 {
-   for (int i=0; i<kNumVoices; ++i)
-      delete mVoices[i].mVoice;
+   for (auto& voice : mVoices)
+      delete voice.mVoice;
 }
 
-void PolyphonyMgr::Init(VoiceType type, IVoiceParams* params)
+void PolyphonyMgr::Init(VoiceType type, IVoiceParams* params, int poolSize)
 {
-   if (type == kVoiceType_FM)
-   {
-      for (int i=0; i<kNumVoices; ++i)
-      {
-         mVoices[i].mVoice = new FMVoice(mOwner);
-         mVoices[i].mVoice->SetVoiceParams(params);
-      }
-   }
-   else if (type == kVoiceType_Karplus)
+   mVoiceType = type;
+   mVoiceParams = params;
+   GrowPool(poolSize);
+}
+
+IMidiVoice* PolyphonyMgr::CreateVoice() const
+{
+   IMidiVoice* voice = nullptr;
+   if (mVoiceType == kVoiceType_FM)
+      voice = new FMVoice(mOwner);
+   else if (mVoiceType == kVoiceType_Karplus)
+      voice = new KarplusStrongVoice(mOwner);
+   else if (mVoiceType == kVoiceType_SingleOscillator)
+      voice = new SingleOscillatorVoice(mOwner);
+   else if (mVoiceType == kVoiceType_Sampler)
+      voice = new SampleVoice(mOwner);
+   else
+      assert(false);  //unsupported voice type
+   
+   if (voice)
+      voice->SetVoiceParams(mVoiceParams);
+   return voice;
+}
+
+void PolyphonyMgr::GrowPool(int poolSize)
+{
+   poolSize = MIN(poolSize, kMaxVoicePoolSize);
+   if (poolSize <= (int)mVoices.size())
+      return;
+   
+   //allocate the voices before taking the lock, the audio thread only has to wait for the bookkeeping
+   std::vector<IMidiVoice*> newVoices;
+   for (int i=(int)mVoices.size(); i<poolSize; ++i)
+      newVoices.push_back(CreateVoice());
+   
+   bool lock = !mVoices.empty(); //the initial pool is created in the owner's constructor, before the audio thread can see it
+   if (lock)
+      TheSynth->GetAudioMutex()->Lock("PolyphonyMgr::GrowPool()");
+   for (auto* voice : newVoices)
    {
-      for (int i=0; i<kNumVoices; ++i)
-      {
-         mVoices[i].mVoice = new KarplusStrongVoice(mOwner);
-         mVoices[i].mVoice->SetVoiceParams(params);
-      }
+      mVoices.push_back(VoiceInfo());
+      mVoices.back().mVoice = voice;
+      PushFree((int)mVoices.size() - 1);
    }
-   else if (type == kVoiceType_SingleOscillator)
+   if (lock)
+      TheSynth->GetAudioMutex()->Unlock();
+}
+
+void PolyphonyMgr::SetVoiceLimit(int limit)
+{
+   limit = ofClamp(limit, 1, kMaxVoicePoolSize);
+   GrowPool(limit);
+   mVoiceLimit = limit;
+}
+
+//static
+int PolyphonyMgr::GetPitchSlot(float pitch)
+{
+   int slot = (int)pitch;
+   if (slot < 0 || slot >= 128 || slot != pitch)
+      return -1;
+   return slot;
+}
+
+void PolyphonyMgr::PushFree(int voiceIdx)
+{
+   VoiceInfo& info = mVoices[voiceIdx];
+   info.mPrevFree = mLastFree;
+   info.mNextFree = -1;
+   if (mLastFree != -1)
+      mVoices[mLastFree].mNextFree = voiceIdx;
+   else
+      mFirstFree = voiceIdx;
+   mLastFree = voiceIdx;
+}
+
+void PolyphonyMgr::RemoveFree(int voiceIdx)
+{
+   VoiceInfo& info = mVoices[voiceIdx];
+   if (info.mPrevFree != -1)
+      mVoices[info.mPrevFree].mNextFree = info.mNextFree;
+   else
+      mFirstFree = info.mNextFree;
+   if (info.mNextFree != -1)
+      mVoices[info.mNextFree].mPrevFree = info.mPrevFree;
+   else
+      mLastFree = info.mPrevFree;
+   info.mPrevFree = -1;
+   info.mNextFree = -1;
+}
+
+void PolyphonyMgr::Activate(int voiceIdx)
+{
+   VoiceInfo& info = mVoices[voiceIdx];
+   if (info.mActiveIndex != -1)
+      return;
+   RemoveFree(voiceIdx);
+   info.mActiveIndex = (int)mActiveVoices.size();
+   mActiveVoices.push_back(voiceIdx);
+   mPeakActiveVoices = MAX(mPeakActiveVoices, (int)mActiveVoices.size());
+}
+
+void PolyphonyMgr::Deactivate(int voiceIdx)
+{
+   VoiceInfo& info = mVoices[voiceIdx];
+   if (info.mActiveIndex == -1)
+      return;
+   RemoveHeld(voiceIdx);
+   int last = mActiveVoices.back();
+   mActiveVoices[info.mActiveIndex] = last;
+   mVoices[last].mActiveIndex = info.mActiveIndex;
+   mActiveVoices.pop_back();
+   info.mActiveIndex = -1;
+   info.mPitch = -1;
+   info.mNoteOn = false;
+   PushFree(voiceIdx);
+}
+
+void PolyphonyMgr::AddHeld(int voiceIdx)
+{
+   VoiceInfo& info = mVoices[voiceIdx];
+   int slot = GetPitchSlot(info.mPitch);
+   if (slot == -1)
+      return;
+   info.mPrevHeld = -1;
+   info.mNextHeld = mFirstHeld[slot];
+   if (mFirstHeld[slot] != -1)
+      mVoices[mFirstHeld[slot]].mPrevHeld = voiceIdx;
+   mFirstHeld[slot] = voiceIdx;
+}
+
+void PolyphonyMgr::RemoveHeld(int voiceIdx)
+{
+   VoiceInfo& info = mVoices[voiceIdx];
+   int slot = GetPitchSlot(info.mPitch);
+   if (!info.mNoteOn || slot == -1)
+      return;
+   if (info.mPrevHeld != -1)
+      mVoices[info.mPrevHeld].mNextHeld = info.mNextHeld;
+   else
+      mFirstHeld[slot] = info.mNextHeld;
+   if (info.mNextHeld != -1)
+      mVoices[info.mNextHeld].mPrevHeld = info.mPrevHeld;
+   info.mPrevHeld = -1;
+   info.mNextHeld = -1;
+}
+
+int PolyphonyMgr::FindVoiceToSteal(double time) const
+{
+   //prefer the oldest released voice, otherwise take the held voice whose envelope is quietest
+   int oldestReleased = -1;
+   int quietestHeld = -1;
+   float quietestLevel = 0;
+   for (int voiceIdx : mActiveVoices)
    {
-      for (int i=0; i<kNumVoices; ++i)
+      const VoiceInfo& info = mVoices[voiceIdx];
+      if (!info.mNoteOn)
       {
-         mVoices[i].mVoice = new SingleOscillatorVoice(mOwner);
-         mVoices[i].mVoice->SetVoiceParams(params);
+         if (oldestReleased == -1 || info.mTime < mVoices[oldestReleased].mTime)
+            oldestReleased = voiceIdx;
       }
-   }
-   else if (type == kVoiceType_Sampler)
-   {
-      for (int i=0; i<kNumVoices; ++i)
+      else if (oldestReleased == -1)
       {
-         mVoices[i].mVoice = new SampleVoice(mOwner);
-         mVoices[i].mVoice->SetVoiceParams(params);
+         float level = info.mVoice->GetEnvelopeLevel(time);
+         if (quietestHeld == -1 || level < quietestLevel ||
+             (level == quietestLevel && info.mTime < mVoices[quietestHeld].mTime))
+         {
+            quietestHeld = voiceIdx;
+            quietestLevel = level;
+         }
       }
    }
-   else
-   {
-      assert(false);  //unsupported voice type
-   }
+   return oldestReleased != -1 ? oldestReleased : quietestHeld;
 }
 
 void PolyphonyMgr::Start(double time, int pitch, float amount, int voiceIdx, ModulationParameters modulation)
 {
-   assert(voiceIdx < kNumVoices);
+   assert(voiceIdx < (int)mVoices.size());
+   if (voiceIdx >= (int)mVoices.size())
+      voiceIdx = -1;
    
    bool preserveVoice = voiceIdx != -1 &&  //we specified a voice
                         mVoices[voiceIdx].mPitch != -1; //there is a note playing from that voice
-
-   /*if (voiceIdx == -1) //haven't specified a voice
-   {
-      for (int i=0; i<kNumVoices; ++i)
-      {
-         if (mVoices[i].mPitch == pitch)
-         {
-            voiceIdx = i;   //reuse existing voice
-            preserveVoice = true;
-            break;
-         }
-      }
-   }*/
    
-   if (voiceIdx == -1) //need a new voice
-   {
-      for (int i=0; i<mVoiceLimit; ++i)
-      {
-         int check = (i + mLastVoice + 1) % mVoiceLimit;  //try to keep incrementing through list to allow old voices to finish
-         if (mVoices[check].mPitch == -1)
-         {
-            voiceIdx = check;
-            break;
-         }
-      }
-   }
+   if (voiceIdx == -1 && (int)mActiveVoices.size() < mVoiceLimit) //need a new voice
+      voiceIdx = mFirstFree;  //idle voices are queued in the order they finished, to allow old voices to finish
 
    if (voiceIdx == -1)   //all used
    {
       if (mAllowStealing)
-      {
-         double oldest = mVoices[0].mTime;
-         int oldestIndex = 0;
-         for (int i=1; i<mVoiceLimit; ++i)
-         {
-            if (mVoices[i].mTime < oldest)
-            {
-               oldest = mVoices[i].mTime;
-               oldestIndex = i;
-            }
-         }
-         voiceIdx = oldestIndex;
-      }
-      else
-      {
+         voiceIdx = FindVoiceToSteal(time);
+      
+      if (voiceIdx == -1)
          return;
-      }
+      ++mNumSteals;
    }
    
    IMidiVoice* voice = mVoices[voiceIdx].mVoice;
@@ -167,32 +282,54 @@ void PolyphonyMgr::Start(double time, int pitch, float amount, int voiceIdx, Mod
    voice->SetModulators(modulation);
    voice->Start(time, amount);
    voice->SetPan(modulation.pan);
-   mLastVoice = voiceIdx;
    
+   if (mVoices[voiceIdx].mActiveIndex == -1)
+      Activate(voiceIdx);
+   else
+      RemoveHeld(voiceIdx);
    mVoices[voiceIdx].mPitch = pitch;
    mVoices[voiceIdx].mTime = time;
    mVoices[voiceIdx].mNoteOn = true;
+   AddHeld(voiceIdx);
 }
 
 void PolyphonyMgr::Stop(double time, int pitch)
 {
-   for (int i=0; i<kNumVoices; ++i)
+   int slot = GetPitchSlot(pitch);
+   if (slot != -1)
+   {
+      int voiceIdx = mFirstHeld[slot];
+      while (voiceIdx != -1)
+      {
+         int next = mVoices[voiceIdx].mNextHeld;
+         RemoveHeld(voiceIdx);
+         mVoices[voiceIdx].mVoice->Stop(time);
+         mVoices[voiceIdx].mNoteOn = false;
+         voiceIdx = next;
+      }
+   }
+   else
    {
-      if (mVoices[i].mPitch == pitch && mVoices[i].mNoteOn)
+      for (int voiceIdx : mActiveVoices)
       {
-         mVoices[i].mVoice->Stop(time);
-         mVoices[i].mNoteOn = false;
+         if (mVoices[voiceIdx].mPitch == pitch && mVoices[voiceIdx].mNoteOn)
+         {
+            mVoices[voiceIdx].mVoice->Stop(time);
+            mVoices[voiceIdx].mNoteOn = false;
+         }
       }
    }
 }
 
 void PolyphonyMgr::KillAll()
 {
-   for (int i = 0; i < kNumVoices; ++i)
+   while (!mActiveVoices.empty())
    {
-      mVoices[i].mVoice->ClearVoice();
-      mVoices[i].mNoteOn = false;
+      int voiceIdx = mActiveVoices.back();
+      mVoices[voiceIdx].mVoice->ClearVoice();
+      Deactivate(voiceIdx);
    }
+   mPeakActiveVoices = 0;
 }
 
 void PolyphonyMgr::Process(double time, ChannelBuffer* out, int bufferSize)
@@ -202,12 +339,15 @@ void PolyphonyMgr::Process(double time, ChannelBuffer* out, int bufferSize)
    mFadeOutBuffer.SetNumActiveChannels(out->NumActiveChannels());
    mFadeOutWorkBuffer.SetNumActiveChannels(out->NumActiveChannels());
 
-   for (int i=0; i<mVoiceLimit; ++i)
+   for (int i=0; i<(int)mActiveVoices.size();)
    {
-      mVoices[i].mVoice->Process(time, out, mOversampling);
+      VoiceInfo& info = mVoices[mActiveVoices[i]];
+      info.mVoice->Process(time, out, mOversampling);
       
-      if (mVoices[i].mPitch != -1 && !mVoices[i].mNoteOn && mVoices[i].mVoice->IsDone(time))
-         mVoices[i].mPitch = -1;
+      if (!info.mNoteOn && info.mVoice->IsDone(time))
+         Deactivate(mActiveVoices[i]);  //swaps the last active voice into this slot
+      else
+         ++i;
    }
    
    for (int ch=0; ch<out->NumActiveChannels(); ++ch)
@@ -228,7 +368,9 @@ void PolyphonyMgr::DrawDebug(float x, float y)
    ofPushMatrix();
    ofPushStyle();
    ofTranslate(x,y);
-   for (int i=0; i<kNumVoices; ++i)
+   ofSetColor(255, 255, 255);
+   DrawTextNormal("voices: "+ofToString(GetNumActiveVoices())+"/"+ofToString(mVoiceLimit)+" (pool "+ofToString(GetPoolSize())+", peak "+ofToString(mPeakActiveVoices)+", steals "+ofToString(mNumSteals)+")", 0, 0);
+   for (int i=0; i<(int)mVoices.size(); ++i)
    {
       if (mVoices[i].mPitch == -1)
          ofSetColor(100, 100, 100);
@@ -236,8 +378,27 @@ void PolyphonyMgr::DrawDebug(float x, float y)
          ofSetColor(0, 255, 0);
       else
          ofSetColor(255, 0, 0);
-      DrawTextNormal(mVoices[i].mPitch == -1 ? "voice "+ofToString(i)+" unused" : "voice "+ofToString(i)+" used: "+ofToString(mVoices[i].mPitch) + (mVoices[i].mNoteOn ? " (note on)" : " (note off)"), 0, i * 18);
+      DrawTextNormal(mVoices[i].mPitch == -1 ? "voice "+ofToString(i)+" unused" : "voice "+ofToString(i)+" used: "+ofToString(mVoices[i].mPitch) + (mVoices[i].mNoteOn ? " (note on)" : " (note off)"), 0, (i+1) * 18);
    }
    ofPopStyle();
    ofPopMatrix();
 }
+
+void PolyphonyMgr::DrawVoiceMeter(float x, float y, float width, float height)
+{
+   ofPushStyle();
+   ofFill();
+   ofSetColor(0, 0, 0, gModuleDrawAlpha * .4f);
+   ofRect(x, y, width, height, 0);
+   float limit = MAX(mVoiceLimit, 1);
+   int active = GetNumActiveVoices();
+   if (active >= mVoiceLimit)
+      ofSetColor(255, 80, 0, gModuleDrawAlpha * .8f);
+   else
+      ofSetColor(0, 200, 100, gModuleDrawAlpha * .8f);
+   ofRect(x, y, width * MIN(active / limit, 1), height, 0);
+   ofSetColor(255, 255, 255, gModuleDrawAlpha * .6f);
+   float peakX = x + width * MIN(mPeakActiveVoices / limit, 1);
+   ofLine(peakX, y, peakX, y + height);
+   ofPopStyle();
+}
@@ -27,11 +27,13 @@
 #define __additiveSynth__PolyphonyMgr__
 
 #include <iostream>
+#include <vector>
 #include "OpenFrameworksPort.h"
 #include "SynthGlobals.h"
 #include "ChannelBuffer.h"
 
 const int kVoiceFadeSamples = 50;
+const int kMaxVoicePoolSize = 128;
 
 extern ChannelBuffer gMidiVoiceWorkChannelBuffer;
 
@@ -50,12 +52,17 @@ enum VoiceType
 
 struct VoiceInfo
 {
-   VoiceInfo() : mPitch(-1), mNoteOn(false) {}
+   VoiceInfo() : mPitch(-1), mVoice(nullptr), mTime(0), mNoteOn(false), mActiveIndex(-1), mPrevFree(-1), mNextFree(-1), mPrevHeld(-1), mNextHeld(-1) {}
    
    float mPitch;
    IMidiVoice* mVoice;
    double mTime;
    bool mNoteOn;
+   int mActiveIndex; //index into mActiveVoices, -1 when the voice is idle
+   int mPrevFree;    //links in the idle voice list
+   int mNextFree;
+   int mPrevHeld;    //links in the list of held voices for this pitch
+   int mNextHeld;
 };
 
 class PolyphonyMgr
@@ -65,19 +72,41 @@ public:
    ~PolyphonyMgr();
    
    void Init(VoiceType type,
-             IVoiceParams* mVoiceParams);
+             IVoiceParams* mVoiceParams,
+             int poolSize = kNumVoices);
    
    void Start(double time, int pitch, float amount, int voiceIdx, ModulationParameters modulation);
    void Stop(double time, int pitch);
    void Process(double time, ChannelBuffer* out, int bufferSize);
    void DrawDebug(float x, float y);
-   void SetVoiceLimit(int limit) { mVoiceLimit = limit; }
+   void DrawVoiceMeter(float x, float y, float width, float height);
+   void SetVoiceLimit(int limit);
    void KillAll();
    void SetOversampling(int oversampling) { mOversampling = oversampling; }
+   int GetPoolSize() const { return (int)mVoices.size(); }
+   int GetNumActiveVoices() const { return (int)mActiveVoices.size(); }
 private:
-   VoiceInfo mVoices[kNumVoices];
+   void GrowPool(int poolSize);
+   IMidiVoice* CreateVoice() const;
+   int FindVoiceToSteal(double time) const;
+   void Activate(int voiceIdx);
+   void Deactivate(int voiceIdx);
+   void PushFree(int voiceIdx);
+   void RemoveFree(int voiceIdx);
+   void AddHeld(int voiceIdx);
+   void RemoveHeld(int voiceIdx);
+   static int GetPitchSlot(float pitch);
+   
+   std::vector<VoiceInfo> mVoices;
+   std::vector<int> mActiveVoices;  //voices that are sounding, idle voices aren't processed at all
+   int mFirstFree;
+   int mLastFree;
+   int mFirstHeld[128];  //note-on voices by pitch, so a note-off doesn't have to search
+   VoiceType mVoiceType;
+   IVoiceParams* mVoiceParams;
    bool mAllowStealing;
-   int mLastVoice;
+   int mPeakActiveVoices;
+   int mNumSteals;
    ChannelBuffer mFadeOutBuffer;
    ChannelBuffer mFadeOutWorkBuffer;
    float mWorkBuffer[2048];
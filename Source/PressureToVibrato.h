@@ -56,6 +56,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 138; height = 22; }
    bool Enabled() const override { return mEnabled; }
    
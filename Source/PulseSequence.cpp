@@ -241,7 +241,7 @@ void PulseSequence::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mInterval;
+         transportListenerInfo->SetInterval(mInterval);
    }
 }
 
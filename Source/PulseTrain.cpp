@@ -215,7 +215,7 @@ void PulseTrain::DropdownUpdated(DropdownList* list, int oldVal)
    {
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mInterval;
+         transportListenerInfo->SetInterval(mInterval);
    }
 }
 
@@ -239,8 +239,8 @@ void Pulser::DropdownUpdated(DropdownList* list, int oldVal)
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
       {
-         transportListenerInfo->mInterval = mInterval;
-         transportListenerInfo->mOffsetInfo = OffsetInfo(GetOffset(), false);
+         transportListenerInfo->SetInterval(mInterval);
+         transportListenerInfo->SetOffsetInfo(OffsetInfo(GetOffset(), false));
       }
    }
    if (list == mTimeModeSelector)
@@ -253,15 +253,15 @@ void Pulser::DropdownUpdated(DropdownList* list, int oldVal)
          mFreeTimeStep = TheTransport->GetDuration(mInterval);
          TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
          if (transportListenerInfo != nullptr)
-            transportListenerInfo->mInterval = kInterval_None;
+            transportListenerInfo->SetInterval(kInterval_None);
       }
       else if (oldVal == kTimeMode_Free)
       {
          TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
          if (transportListenerInfo != nullptr)
          {
-            transportListenerInfo->mInterval = mInterval;
-            transportListenerInfo->mOffsetInfo = OffsetInfo(GetOffset(), false);
+            transportListenerInfo->SetInterval(mInterval);
+            transportListenerInfo->SetOffsetInfo(OffsetInfo(GetOffset(), false));
          }
       }
       
@@ -278,8 +278,8 @@ void Pulser::FloatSliderUpdated(FloatSlider* slider, float oldVal)
          TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
          if (transportListenerInfo != nullptr)
          {
-            transportListenerInfo->mInterval = mInterval;
-            transportListenerInfo->mOffsetInfo = OffsetInfo(GetOffset(), false);
+            transportListenerInfo->SetInterval(mInterval);
+            transportListenerInfo->SetOffsetInfo(OffsetInfo(GetOffset(), false));
          }
       }
    }
@@ -288,7 +288,7 @@ void Pulser::FloatSliderUpdated(FloatSlider* slider, float oldVal)
 void Pulser::IntSliderUpdated(IntSlider* slider, int oldVal)
 {
    if (slider == mCustomDivisorSlider)
-      mTransportListenerInfo->mCustomDivisor = mCustomDivisor;
+      mTransportListenerInfo->SetCustomDivisor(mCustomDivisor);
 }
 
 void Pulser::SaveLayout(ofxJSONElement& moduleInfo)
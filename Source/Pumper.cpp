@@ -26,6 +26,7 @@
 #include "Pumper.h"
 #include "Profiler.h"
 #include "UIControlMacros.h"
+#include "DynamicsCore.h"
 
 namespace
 {
@@ -80,7 +81,7 @@ void Pumper::ProcessAudio(double time, ChannelBuffer* buffer)
    if (!mEnabled)
       return;
 
-   float bufferSize = buffer->BufferSize();
+   int bufferSize = buffer->BufferSize();
    
    ComputeSliders(0);
    
@@ -94,14 +95,12 @@ void Pumper::ProcessAudio(double time, ChannelBuffer* buffer)
    float smoothingOffset = smoothingTimeMs / TheTransport->GetDuration(mInterval);
    mLFO.SetOffset(mOffset + smoothingOffset);*/
 
+   float* gain = gWorkBuffer;
+   double intervalPerSample = gInvSampleRateMs / TheTransport->GetDuration(mInterval);
    for (int i=0; i<bufferSize; ++i)
-   {
-      float adsrValue = mAdsr.Value((intervalPos + i * gInvSampleRateMs / TheTransport->GetDuration(mInterval)) * kAdsrTime);
-      float value = mLastValue * .99f + adsrValue * .01f;
-      for (int ch=0; ch<buffer->NumActiveChannels(); ++ch)
-         buffer->GetChannel(ch)[i] *= value;
-      mLastValue = value;
-   }
+      gain[i] = mAdsr.Value((intervalPos + i * intervalPerSample) * kAdsrTime);
+   DynamicsCore::Smooth(gain, bufferSize, mLastValue, .99f);
+   DynamicsCore::ApplyGain(buffer, gain, bufferSize);
 }
 
 double Pumper::GetIntervalPos(double time)
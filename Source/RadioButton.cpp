@@ -46,6 +46,7 @@ RadioButton::RadioButton(IRadioButtonListener* owner, const char* name, int x, i
 , mElementWidth(8)
 , mSliderVal(0)
 , mForcedWidth(-1)
+, mLastDisplayedValue(INT_MAX)
 {
    assert(owner);
    SetName(name);
@@ -129,6 +130,8 @@ void RadioButton::UpdateDimensions()
 
    if (mForcedWidth != -1)
       mWidth = mForcedWidth;
+   
+   MarkNeedsDraw();
 }
 
 void RadioButton::Clear()
@@ -139,6 +142,8 @@ void RadioButton::Clear()
 
    if (mForcedWidth != -1)
       mWidth = mForcedWidth;
+   
+   MarkNeedsDraw();
 }
 
 void RadioButton::Poll()
@@ -149,6 +154,9 @@ void RadioButton::Poll()
 
 void RadioButton::Render()
 {
+   if (mVar)
+      mLastDisplayedValue = *mVar;
+   
    ofPushStyle();
    
    DrawBeacon(mX+mWidth/2, mY+mHeight/2);
@@ -214,6 +222,14 @@ void RadioButton::Render()
    DrawHover(mX, mY, w, h);
 }
 
+bool RadioButton::CheckNeedsDraw()
+{
+   if (IUIControl::CheckNeedsDraw())
+      return true;
+   
+   return mVar != nullptr && *mVar != mLastDisplayedValue;
+}
+
 bool RadioButton::MouseMoved(float x, float y)
 {
    CheckHover(x, y);
@@ -80,6 +80,7 @@ public:
    bool InvertScrollDirection() override { return mDirection == kRadioVertical; }
    void Increment(float amount) override;
    void Poll() override;
+   bool CheckNeedsDraw() override;
    void SaveState(FileStreamOut& out) override;
    void LoadState(FileStreamIn& in, bool shouldSetValue = true) override;
 
@@ -108,6 +109,7 @@ private:
    float mSliderVal;
    int mLastSetValue;
    int mForcedWidth;
+   int mLastDisplayedValue;
 };
 
 #endif /* defined(__modularSynth__RadioButton__) */
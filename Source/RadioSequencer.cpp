@@ -269,7 +269,7 @@ void RadioSequencer::DropdownUpdated(DropdownList* list, int oldVal)
       {
          TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
          if (transportListenerInfo != nullptr)
-            transportListenerInfo->mInterval = mInterval;
+            transportListenerInfo->SetInterval(mInterval);
          SetNumSteps(newSteps, true);
       }
       else
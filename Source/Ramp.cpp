@@ -74,6 +74,48 @@ float Ramp::Value(double time) const
    return retVal;
 }
 
+bool Ramp::Fill(double time, float* values, int size) const
+{
+   double endTime = time + (size - 1) * gInvSampleRateMs;
+   const RampData* rampData = GetCurrentRampData(time);
+   if (GetCurrentRampData(endTime) != rampData)   //a new ramp starts within the block
+   {
+      for (int i = 0; i < size; ++i)
+         values[i] = Value(time + i * gInvSampleRateMs);
+      return false;
+   }
+   
+   if (rampData->mStartTime == -1 || endTime <= rampData->mStartTime || time >= rampData->mEndTime)
+   {
+      float value = Value(time);
+      for (int i = 0; i < size; ++i)
+         values[i] = value;
+      return true;
+   }
+   
+   //same math as Value(), without looking up the ramp for every sample
+   for (int i = 0; i < size; ++i)
+   {
+      double sampleTime = time + i * gInvSampleRateMs;
+      if (sampleTime <= rampData->mStartTime)
+      {
+         values[i] = rampData->mStartValue;
+      }
+      else if (sampleTime >= rampData->mEndTime)
+      {
+         values[i] = rampData->mEndValue;
+      }
+      else
+      {
+         double blend = (sampleTime - rampData->mStartTime) / (rampData->mEndTime - rampData->mStartTime);
+         values[i] = rampData->mStartValue + blend * (rampData->mEndValue - rampData->mStartValue);
+         if (fabsf(values[i]) < FLT_EPSILON)
+            values[i] = 0;
+      }
+   }
+   return false;
+}
+
 const Ramp::RampData* Ramp::GetCurrentRampData(double time) const
 {
    int ret = 0;
@@ -38,6 +38,8 @@ public:
    void SetValue(float val);
    bool HasValue(double time) const;
    float Value(double time) const;
+   //fills one value per sample starting at time, returns true if they're all the same
+   bool Fill(double time, float* values, int size) const;
    float Target(double time) const { return GetCurrentRampData(time)->mEndValue; }
 private:
    struct RampData
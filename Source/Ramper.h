@@ -55,6 +55,7 @@ public:
    
    //IAudioPoller
    void OnTransportAdvanced(float amount) override;
+   bool IsControlRate() const override { return true; }
 
    //IPulseReceiver
    void OnPulse(double time, float velocity, int flags) override;
@@ -73,6 +74,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    bool Enabled() const override { return mEnabled; }
    void GetModuleDimensions(float& width, float& height) override;
    void OnClicked(int x, int y, bool right) override;
@@ -120,8 +120,8 @@ void RandomNoteGenerator::FloatSliderUpdated(FloatSlider* slider, float oldVal)
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
       {
-         transportListenerInfo->mInterval = mInterval;
-         transportListenerInfo->mOffsetInfo = OffsetInfo(mOffset / TheTransport->CountInStandardMeasure(mInterval), !K(offsetIsInMs));
+         transportListenerInfo->SetInterval(mInterval);
+         transportListenerInfo->SetOffsetInfo(OffsetInfo(mOffset / TheTransport->CountInStandardMeasure(mInterval), !K(offsetIsInMs)));
       }
    }
 }
@@ -139,8 +139,8 @@ void RandomNoteGenerator::DropdownUpdated(DropdownList* list, int oldVal)
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
       {
-         transportListenerInfo->mInterval = mInterval;
-         transportListenerInfo->mOffsetInfo = OffsetInfo(mOffset / TheTransport->CountInStandardMeasure(mInterval), !K(offsetIsInMs));
+         transportListenerInfo->SetInterval(mInterval);
+         transportListenerInfo->SetOffsetInfo(OffsetInfo(mOffset / TheTransport->CountInStandardMeasure(mInterval), !K(offsetIsInMs)));
       }
    }
 }
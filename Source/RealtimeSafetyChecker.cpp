@@ -0,0 +1,356 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    RealtimeSafetyChecker.cpp
+    Created: 19 Oct 2026 4:18:52pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyChecker.h"
+#include "SynthGlobals.h"
+#include "IDrawableModule.h"
+#include "IAudioSource.h"
+
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+
+#include "juce_core/juce_core.h"
+
+#if BESPOKE_WINDOWS
+#include <Windows.h>
+#else
+#include <execinfo.h>
+#endif
+
+std::atomic<bool> RealtimeSafetyChecker::sEnabled{false};
+thread_local bool RealtimeSafetyChecker::sIsAudioThread = false;
+thread_local bool RealtimeSafetyChecker::sIsRecording = false;
+thread_local const char* RealtimeSafetyChecker::sContext = nullptr;
+
+namespace
+{
+   const int kMaxViolations = 256;
+   const int kMaxFrames = 24;
+   const int kMaxTextLength = 64;
+   const char* kReportFilename = "realtime_violations.txt";
+   
+   struct Violation
+   {
+      std::atomic<int> mSequence{-1};
+      RealtimeViolationType mType{kRealtimeViolation_Allocation};
+      char mContext[kMaxTextLength]{};
+      char mDetail[kMaxTextLength]{};
+      size_t mSize{0};
+      int mNumFrames{0};
+      void* mFrames[kMaxFrames]{};
+   };
+   
+   //written by the audio thread, read by Flush()
+   Violation sViolations[kMaxViolations];
+   std::atomic<int> sNumRecorded{0};
+   
+   //main thread only
+   struct Site
+   {
+      RealtimeViolationType mType;
+      std::string mContext;
+      std::string mDetail;
+      std::string mCallstack;
+      int mCount;
+      size_t mTotalSize;
+   };
+   std::map<std::string, Site> sSites;
+   int sNumFlushed = 0;
+   int sNumDropped = 0;
+   
+   int CaptureCallstack(void** frames, int maxFrames)
+   {
+#if BESPOKE_WINDOWS
+      return CaptureStackBackTrace(0, maxFrames, frames, nullptr);
+#else
+      return backtrace(frames, maxFrames);
+#endif
+   }
+   
+   //the first frame is always RealtimeSafetyChecker::Record(), leave it out
+   std::string DescribeCallstack(void* const* frames, int numFrames)
+   {
+      std::string ret;
+#if BESPOKE_WINDOWS
+      for (int i=1; i<numFrames; ++i)
+      {
+         char address[32];
+         snprintf(address, sizeof(address), "%p", frames[i]);
+         ret += std::string("   ") + address + "\n";
+      }
+#else
+      char** symbols = backtrace_symbols(frames, numFrames);
+      for (int i=1; i<numFrames; ++i)
+         ret += std::string("   ") + (symbols != nullptr ? symbols[i] : "?") + "\n";
+      free(symbols);
+#endif
+      return ret;
+   }
+   
+   const char* GetTypeName(RealtimeViolationType type)
+   {
+      switch (type)
+      {
+         case kRealtimeViolation_Allocation: return "heap allocation";
+         case kRealtimeViolation_Free: return "heap free";
+         case kRealtimeViolation_MutexWait: return "mutex wait";
+         case kRealtimeViolation_FileAccess: return "file access";
+      }
+      return "";
+   }
+   
+   std::string GetReportPath()
+   {
+      return ofToDataPath(kReportFilename);
+   }
+   
+   void CopyText(char* dst, const char* src)
+   {
+      if (src == nullptr)
+         src = "";
+      strncpy(dst, src, kMaxTextLength - 1);
+      dst[kMaxTextLength - 1] = 0;
+   }
+}
+
+RealtimeSafetyChecker::ScopedAudioThread::ScopedAudioThread()
+{
+   sIsAudioThread = true;
+   sContext = "audio thread";
+}
+
+RealtimeSafetyChecker::ScopedAudioThread::~ScopedAudioThread()
+{
+   sIsAudioThread = false;
+   sContext = nullptr;
+}
+
+RealtimeSafetyChecker::ScopedContext::ScopedContext(const char* name)
+: mPrevious(sContext)
+{
+   sContext = name;
+}
+
+RealtimeSafetyChecker::ScopedContext::ScopedContext(IAudioSource* source)
+: mPrevious(sContext)
+{
+   if (IsChecking())
+   {
+      IDrawableModule* module = dynamic_cast<IDrawableModule*>(source);
+      if (module != nullptr)
+         sContext = module->Name();
+   }
+}
+
+RealtimeSafetyChecker::ScopedContext::~ScopedContext()
+{
+   sContext = mPrevious;
+}
+
+//static
+void RealtimeSafetyChecker::SetEnabled(bool enabled)
+{
+   if (enabled && !IsEnabled())
+   {
+      //the first backtrace() can load libraries and allocate, get that out of the way here rather than on the audio thread
+      void* frames[kMaxFrames];
+      CaptureCallstack(frames, kMaxFrames);
+      
+      sSites.clear();
+      sNumFlushed = sNumRecorded.load();
+      sNumDropped = 0;
+      juce::File(GetReportPath()).replaceWithText("bespoke realtime safety report, started " + ofGetTimestampString("%Y-%m-%d %H:%M:%S") + "\n\n");
+      
+      ofLog() << "realtime safety checks enabled, logging to " << GetReportPath();
+      if (!BESPOKE_REALTIME_SAFETY_CHECKS)
+         ofLog() << "heap allocations are only detected in builds with BESPOKE_REALTIME_SAFETY_CHECKS";
+   }
+   
+   sEnabled = enabled;
+   
+   if (!enabled)
+      Flush();
+}
+
+//static
+void RealtimeSafetyChecker::Record(RealtimeViolationType type, const char* detail, size_t size)
+{
+   if (sIsRecording)
+      return;  //capturing the callstack can allocate on some platforms
+   sIsRecording = true;
+   
+   int index = sNumRecorded.fetch_add(1);
+   Violation& violation = sViolations[index % kMaxViolations];
+   violation.mSequence.store(-1, std::memory_order_release);
+   violation.mType = type;
+   CopyText(violation.mContext, sContext);
+   CopyText(violation.mDetail, detail);
+   violation.mSize = size;
+   violation.mNumFrames = CaptureCallstack(violation.mFrames, kMaxFrames);
+   violation.mSequence.store(index, std::memory_order_release);
+   
+   sIsRecording = false;
+}
+
+//static
+void RealtimeSafetyChecker::Flush()
+{
+   int numRecorded = sNumRecorded.load(std::memory_order_acquire);
+   if (numRecorded - sNumFlushed > kMaxViolations)
+   {
+      sNumDropped += numRecorded - kMaxViolations - sNumFlushed;
+      sNumFlushed = numRecorded - kMaxViolations;
+   }
+   
+   std::string newSites;
+   for (; sNumFlushed < numRecorded; ++sNumFlushed)
+   {
+      const Violation& slot = sViolations[sNumFlushed % kMaxViolations];
+      int sequence = slot.mSequence.load(std::memory_order_acquire);
+      if (sequence < sNumFlushed)
+         break;   //still being written, pick it up next time
+      
+      Violation violation;
+      violation.mType = slot.mType;
+      memcpy(violation.mContext, slot.mContext, kMaxTextLength);
+      memcpy(violation.mDetail, slot.mDetail, kMaxTextLength);
+      violation.mSize = slot.mSize;
+      violation.mNumFrames = MIN(slot.mNumFrames, kMaxFrames);
+      memcpy(violation.mFrames, slot.mFrames, sizeof(violation.mFrames));
+      if (slot.mSequence.load(std::memory_order_acquire) != sNumFlushed)
+      {
+         ++sNumDropped;  //overwritten while we were reading it
+         continue;
+      }
+      
+      std::string key = ofToString((int)violation.mType) + "|" + violation.mContext + "|" + violation.mDetail;
+      for (int i=0; i<violation.mNumFrames; ++i)
+      {
+         char address[32];
+         snprintf(address, sizeof(address), "|%p", violation.mFrames[i]);
+         key += address;
+      }
+      
+      auto iter = sSites.find(key);
+      if (iter != sSites.end())
+      {
+         ++iter->second.mCount;
+         iter->second.mTotalSize += violation.mSize;
+         continue;
+      }
+      
+      Site site;
+      site.mType = violation.mType;
+      site.mContext = violation.mContext;
+      site.mDetail = violation.mDetail;
+      site.mCallstack = DescribeCallstack(violation.mFrames, violation.mNumFrames);
+      site.mCount = 1;
+      site.mTotalSize = violation.mSize;
+      sSites[key] = site;
+      
+      std::string description = std::string(GetTypeName(site.mType)) + " on the audio thread in " + site.mContext;
+      if (!site.mDetail.empty())
+         description += " (" + site.mDetail + ")";
+      if (site.mTotalSize > 0)
+         description += ", " + ofToString((int)site.mTotalSize) + " bytes";
+      ofLog() << "realtime violation: " << description;
+      newSites += description + "\n" + site.mCallstack + "\n";
+   }
+   
+   if (!newSites.empty())
+      juce::File(GetReportPath()).appendText(newSites);
+}
+
+//static
+void RealtimeSafetyChecker::WriteReport()
+{
+   Flush();
+   
+   std::vector<const Site*> sites;
+   for (const auto& iter : sSites)
+      sites.push_back(&iter.second);
+   std::sort(sites.begin(), sites.end(), [](const Site* a, const Site* b) { return a->mCount > b->mCount; });
+   
+   std::string report = "bespoke realtime safety report, written " + ofGetTimestampString("%Y-%m-%d %H:%M:%S") + "\n";
+   report += ofToString((int)sites.size()) + " sites, " + ofToString(sNumDropped) + " violations dropped\n\n";
+   for (const Site* site : sites)
+   {
+      report += ofToString(site->mCount) + "x " + GetTypeName(site->mType) + " in " + site->mContext;
+      if (!site->mDetail.empty())
+         report += " (" + site->mDetail + ")";
+      if (site->mTotalSize > 0)
+         report += ", " + ofToString((int)site->mTotalSize) + " bytes total";
+      report += "\n" + site->mCallstack + "\n";
+   }
+   juce::File(GetReportPath()).replaceWithText(report);
+   
+   ofLog() << "realtime safety report: " << (int)sites.size() << " sites, written to " << GetReportPath();
+}
+
+#if BESPOKE_REALTIME_SAFETY_CHECKS && !defined(BESPOKE_DEBUG_ALLOCATIONS)
+#undef new
+void* operator new(std::size_t size)
+{
+   RealtimeSafetyChecker::Check(kRealtimeViolation_Allocation, "new", size);
+   void* ptr = malloc(size > 0 ? size : 1);
+   if (ptr == nullptr)
+      throw std::bad_alloc();
+   return ptr;
+}
+void* operator new[](std::size_t size)
+{
+   RealtimeSafetyChecker::Check(kRealtimeViolation_Allocation, "new[]", size);
+   void* ptr = malloc(size > 0 ? size : 1);
+   if (ptr == nullptr)
+      throw std::bad_alloc();
+   return ptr;
+}
+void operator delete(void* ptr) noexcept
+{
+   if (ptr != nullptr)
+      RealtimeSafetyChecker::Check(kRealtimeViolation_Free, "delete");
+   free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+   if (ptr != nullptr)
+      RealtimeSafetyChecker::Check(kRealtimeViolation_Free, "delete[]");
+   free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept
+{
+   operator delete(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+   operator delete[](ptr);
+}
+#define new DEBUG_NEW
+#endif
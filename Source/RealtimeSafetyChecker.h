@@ -0,0 +1,96 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    RealtimeSafetyChecker.h
+    Created: 19 Oct 2026 4:18:52pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+class IAudioSource;
+
+//heap allocations are only visible to the checker when global operator new is replaced, which costs a little on every allocation,
+//so that part is compiled in separately. mutex waits and file access are always checked while the checker is enabled
+#ifndef BESPOKE_REALTIME_SAFETY_CHECKS
+#define BESPOKE_REALTIME_SAFETY_CHECKS 0
+#endif
+
+enum RealtimeViolationType
+{
+   kRealtimeViolation_Allocation,
+   kRealtimeViolation_Free,
+   kRealtimeViolation_MutexWait,
+   kRealtimeViolation_FileAccess
+};
+
+//diagnostic mode that records anything that can block while the audio thread is inside ModularSynth::AudioOut(),
+//along with the module that was processing and a callstack. recording is lock-free and allocation-free,
+//violations are reported on the main thread by Flush()
+class RealtimeSafetyChecker
+{
+public:
+   //marks the calling thread as the audio thread for the duration of the scope
+   class ScopedAudioThread
+   {
+   public:
+      ScopedAudioThread();
+      ~ScopedAudioThread();
+   };
+   
+   //names what the audio thread is working on, so violations can be attributed to it
+   class ScopedContext
+   {
+   public:
+      ScopedContext(const char* name);
+      ScopedContext(IAudioSource* source);
+      ~ScopedContext();
+   private:
+      const char* mPrevious;
+   };
+   
+   static void SetEnabled(bool enabled);
+   static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+   static bool IsChecking() { return sIsAudioThread && IsEnabled(); }
+   
+   static void Check(RealtimeViolationType type, const char* detail, size_t size = 0)
+   {
+      if (IsChecking())
+         Record(type, detail, size);
+   }
+   
+   //called from the main thread, logs sites that haven't been seen before to the console and the report file
+   static void Flush();
+   //writes every site seen so far with its count to the report file
+   static void WriteReport();
+   
+private:
+   static void Record(RealtimeViolationType type, const char* detail, size_t size);
+   
+   static std::atomic<bool> sEnabled;
+   static thread_local bool sIsAudioThread;
+   static thread_local bool sIsRecording;
+   static thread_local const char* sContext;
+};
@@ -0,0 +1,250 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    RetrospectiveRecorder.cpp
+    Created: 19 Oct 2026 6:03:40pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#include "juce_audio_formats/juce_audio_formats.h"
+
+#include "RetrospectiveRecorder.h"
+#include "SynthGlobals.h"
+#include "ModularSynth.h"
+
+namespace
+{
+   const int kNumChannels = 2;
+   const int kBytesPerFrame = kNumChannels * sizeof(int16_t);
+   const int kChunkSamples = 8192;
+   const int kWriterIntervalMs = 50;
+   const float kWriterHeadroomSeconds = 2;   //how close the audio thread can get to lapping the writer before we give up on the oldest samples
+}
+
+RetrospectiveRecorder::RetrospectiveRecorder(int memorySamples, long long diskSamples, std::string diskPath)
+: juce::Thread("retrospective recorder")
+, mMemoryBuffer(memorySamples)
+, mTotalWritten(0)
+, mDiskWritten(0)
+, mDiskLength(0)
+, mDiskFile(diskPath)
+{
+   mMemoryBuffer.SetNumChannels(kNumChannels);
+   for (int ch=0; ch<kNumChannels; ++ch)
+      mSaveBuffers[ch].resize(memorySamples);
+
+   if (diskSamples > 0)
+   {
+      mDiskFile.getParentDirectory().createDirectory();
+      mDiskFile.deleteFile();
+      mDiskStream = std::make_unique<juce::FileOutputStream>(mDiskFile);
+      if (mDiskStream->failedToOpen())
+      {
+         ofLog() << "couldn't open " << diskPath << " for the record buffer, only keeping the last " << memorySamples / gSampleRate << " seconds in memory";
+         mDiskStream.reset();
+      }
+      else
+      {
+         mDiskLength = diskSamples;
+         mConvertBuffer.resize(kChunkSamples * kNumChannels);
+         startThread();
+      }
+   }
+}
+
+RetrospectiveRecorder::~RetrospectiveRecorder()
+{
+   stopThread(1000);
+   if (mDiskStream != nullptr)
+   {
+      mDiskStream.reset();
+      mDiskFile.deleteFile();
+   }
+}
+
+void RetrospectiveRecorder::Write(float** output, int bufferSize, int nChannels)
+{
+   if (nChannels < 1)
+      return;
+   //keep both channels moving together, so a sample's position in the ring is always its index modulo the ring size
+   for (int ch=0; ch<kNumChannels; ++ch)
+      mMemoryBuffer.WriteChunk(output[MIN(ch, nChannels-1)], bufferSize, ch);
+   mTotalWritten += bufferSize;
+}
+
+long long RetrospectiveRecorder::GetCapacity() const
+{
+   if (mDiskLength > 0)
+      return mDiskLength;
+   return mMemoryBuffer.Size();
+}
+
+void RetrospectiveRecorder::run()
+{
+   while (!threadShouldExit())
+   {
+      {
+         std::lock_guard<std::mutex> lock(mDiskMutex);
+         WritePendingToDisk();
+      }
+      wait(kWriterIntervalMs);
+   }
+}
+
+void RetrospectiveRecorder::WritePendingToDisk()
+{
+   long long written = mTotalWritten;
+   int memorySize = mMemoryBuffer.Size();
+   long long oldestSafe = written - (memorySize - (long long)(kWriterHeadroomSeconds * gSampleRate));
+
+   while (mDiskWritten < written)
+   {
+      long long diskPos = mDiskWritten % mDiskLength;
+      int chunk = (int)MIN(MIN(written - mDiskWritten, (long long)kChunkSamples), mDiskLength - diskPos);
+      for (int i=0; i<chunk; ++i)
+      {
+         long long index = mDiskWritten + i;
+         for (int ch=0; ch<kNumChannels; ++ch)
+         {
+            float sample = 0;
+            if (index >= oldestSafe)   //otherwise the audio thread got there first, write silence rather than whatever overwrote it
+               sample = mMemoryBuffer.GetRawBuffer()->GetChannel(ch)[index % memorySize];
+            mConvertBuffer[i * kNumChannels + ch] = (int16_t)(ofClamp(sample, -1, 1) * 32767);
+         }
+      }
+
+      mDiskStream->setPosition(diskPos * kBytesPerFrame);
+      mDiskStream->write(mConvertBuffer.data(), chunk * kBytesPerFrame);
+      mDiskWritten += chunk;
+   }
+   mDiskStream->flush();
+}
+
+void RetrospectiveRecorder::ReadFromDisk(float** dst, long long start, int length)
+{
+   juce::FileInputStream input(mDiskFile);
+   int done = 0;
+   while (done < length)
+   {
+      long long diskPos = (start + done) % mDiskLength;
+      int chunk = (int)MIN(MIN((long long)(length - done), (long long)kChunkSamples), mDiskLength - diskPos);
+      input.setPosition(diskPos * kBytesPerFrame);
+      input.read(mConvertBuffer.data(), chunk * kBytesPerFrame);
+      for (int i=0; i<chunk; ++i)
+      {
+         for (int ch=0; ch<kNumChannels; ++ch)
+            dst[ch][done + i] = mConvertBuffer[i * kNumChannels + ch] / 32767.0f;
+      }
+      done += chunk;
+   }
+}
+
+void RetrospectiveRecorder::ReadFromMemory(float** dst, long long start, int length)
+{
+   int memorySize = mMemoryBuffer.Size();
+   for (int ch=0; ch<kNumChannels; ++ch)
+   {
+      float* src = mMemoryBuffer.GetRawBuffer()->GetChannel(ch);
+      for (int i=0; i<length; ++i)
+         dst[ch][i] = src[(start + i) % memorySize];
+   }
+}
+
+bool RetrospectiveRecorder::Save(std::string path, long long maxSamples /*= -1*/)
+{
+   //hold the writer off, so the disk ring stays put while we read it
+   std::lock_guard<std::mutex> diskLock(mDiskMutex);
+
+   long long start;
+   long long end;
+   long long diskEnd;
+   long long recentStart;
+   {
+      //only the newest samples that haven't made it to disk yet come from memory, so the audio thread is only held up for those
+      ScopedMutex mutex(TheSynth->GetAudioMutex(), "RetrospectiveRecorder::Save()");
+      end = mTotalWritten;
+      start = MAX(0, end - GetCapacity());
+      if (maxSamples >= 0)
+         start = MAX(start, end - maxSamples);
+      diskEnd = start;
+      if (mDiskLength > 0)
+         diskEnd = MAX(start, MIN(mDiskWritten, end));
+      recentStart = MAX(diskEnd, end - mMemoryBuffer.Size());
+      recentStart = MAX(recentStart, start);
+
+      float* recentData[kNumChannels];
+      for (int ch=0; ch<kNumChannels; ++ch)
+         recentData[ch] = mSaveBuffers[ch].data();   //never more than the memory ring holds
+      ReadFromMemory(recentData, recentStart, (int)(end - recentStart));
+
+      mMemoryBuffer.ClearBuffer();
+      mTotalWritten = 0;
+   }
+
+   auto wavFormat = std::make_unique<juce::WavAudioFormat>();
+   juce::File outputFile(ofToDataPath(path).c_str());
+   outputFile.create();
+   auto outputTo = outputFile.createOutputStream();
+   if (outputTo == nullptr)
+   {
+      mDiskWritten = 0;
+      return false;
+   }
+   auto writer = std::unique_ptr<juce::AudioFormatWriter>(wavFormat->createWriterFor(outputTo.release(), gSampleRate, kNumChannels, 16, juce::StringPairArray(), 0));
+   if (writer == nullptr)
+   {
+      mDiskWritten = 0;
+      return false;
+   }
+
+   //older audio from the disk ring, streamed through in chunks
+   std::vector<float> chunkData[kNumChannels];
+   float* chunkPtrs[kNumChannels];
+   for (int ch=0; ch<kNumChannels; ++ch)
+   {
+      chunkData[ch].resize(kChunkSamples);
+      chunkPtrs[ch] = chunkData[ch].data();
+   }
+   for (long long pos = start; pos < diskEnd; pos += kChunkSamples)
+   {
+      int length = (int)MIN((long long)kChunkSamples, diskEnd - pos);
+      ReadFromDisk(chunkPtrs, pos, length);
+      writer->writeFromFloatArrays(chunkPtrs, kNumChannels, length);
+   }
+
+   //if the writer ever fell behind far enough to lose audio, keep the timeline intact
+   for (long long pos = diskEnd; pos < recentStart; pos += kChunkSamples)
+   {
+      int length = (int)MIN((long long)kChunkSamples, recentStart - pos);
+      for (int ch=0; ch<kNumChannels; ++ch)
+         ::Clear(chunkPtrs[ch], length);
+      writer->writeFromFloatArrays(chunkPtrs, kNumChannels, length);
+   }
+
+   const float* recentData[kNumChannels];
+   for (int ch=0; ch<kNumChannels; ++ch)
+      recentData[ch] = mSaveBuffers[ch].data();
+   writer->writeFromFloatArrays(recentData, kNumChannels, (int)(end - recentStart));
+
+   mDiskWritten = 0;
+   return true;
+}
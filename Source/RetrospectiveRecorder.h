@@ -0,0 +1,71 @@
+/**
+    bespoke synth, a software modular synthesizer
+    Copyright (C) 2021 Ryan Challinor (contact: awwbees@gmail.com)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**/
+/*
+  ==============================================================================
+
+    RetrospectiveRecorder.h
+    Created: 19 Oct 2026 6:03:40pm
+    Author:  Ryan Challinor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "juce_core/juce_core.h"
+#include "RollingBuffer.h"
+
+//always-on capture of the main output, for writing out the last however-many minutes after the fact.
+//the audio thread only writes into a small in-memory ring. when a disk length is given, a background thread drains
+//that ring into a ring file of 16-bit frames, so the capture can run for hours without holding it all in memory.
+class RetrospectiveRecorder : public juce::Thread
+{
+public:
+   RetrospectiveRecorder(int memorySamples, long long diskSamples, std::string diskPath);
+   ~RetrospectiveRecorder();
+
+   RollingBuffer* GetMemoryBuffer() { return &mMemoryBuffer; }
+   //audio thread
+   void Write(float** output, int bufferSize, int nChannels);
+   //writes the most recent maxSamples (or everything, if -1) out to a wav from both tiers, then starts over
+   bool Save(std::string path, long long maxSamples = -1);
+   long long GetCapacity() const;
+
+   //juce::Thread
+   void run() override;
+
+private:
+   void WritePendingToDisk();
+   void ReadFromDisk(float** dst, long long start, int length);
+   void ReadFromMemory(float** dst, long long start, int length);
+
+   RollingBuffer mMemoryBuffer;
+   std::atomic<long long> mTotalWritten;
+   long long mDiskWritten;   //guarded by mDiskMutex
+   long long mDiskLength;
+   juce::File mDiskFile;
+   std::unique_ptr<juce::FileOutputStream> mDiskStream;
+   std::mutex mDiskMutex;
+   std::vector<int16_t> mConvertBuffer;
+   std::vector<float> mSaveBuffers[2];   //the part of a save that comes from memory, allocated up front so the audio thread isn't held up for it
+};
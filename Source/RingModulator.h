@@ -67,6 +67,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 130; height = 68; }
    bool Enabled() const override { return mEnabled; }
 
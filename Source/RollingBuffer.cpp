@@ -26,11 +26,19 @@
 #include "RollingBuffer.h"
 #include "SynthGlobals.h"
 
-RollingBuffer::RollingBuffer(int sizeInSamples)
-: mBuffer(sizeInSamples)
+namespace
+{
+   const double kCaptureHoldMs = 250;   //long enough to bridge a slow ui frame
+}
+
+RollingBuffer::RollingBuffer(int sizeInSamples, bool pagedMemory /*= false*/)
+: mBuffer(sizeInSamples, pagedMemory)
+, mCaptureOnDemand(false)
+, mCaptureRequestedUntil(0)
 {
    for (int i=0; i<ChannelBuffer::kMaxNumChannels; ++i)
       mOffsetToNow[i] = 0;
+   mBuffer.SetCommittedLength(sizeInSamples);
 }
 
 RollingBuffer::~RollingBuffer()
@@ -70,10 +78,27 @@ void RollingBuffer::Accum(int samplesAgo, float sample, int channel)
    mBuffer.GetChannel(channel)[(Size() + mOffsetToNow[channel] - samplesAgo) % Size()] += sample;
 }
 
+void RollingBuffer::RequestCapture()
+{
+   //don't show whatever was in here from the last time it was looked at.
+   //nothing writes to the buffer while it isn't capturing, so it's safe to clear it here instead of on the audio thread
+   if (!IsCapturing())
+      ClearBuffer();
+   mCaptureRequestedUntil = gTime + kCaptureHoldMs;
+}
+
+bool RollingBuffer::IsCapturing()
+{
+   return !mCaptureOnDemand || gTime < mCaptureRequestedUntil;
+}
+
 void RollingBuffer::WriteChunk(float* samples, int size, int channel)
 {
    assert(size < Size());
    
+   if (!IsCapturing())
+      return;
+   
    int wrapSamples = (mOffsetToNow[channel] + size) - Size();
    if (wrapSamples <= 0) //no wraparound
    {
@@ -92,6 +117,9 @@ void RollingBuffer::WriteChunk(float* samples, int size, int channel)
 
 void RollingBuffer::Write(float sample, int channel)
 {
+   if (!IsCapturing())
+      return;
+   
    mBuffer.GetChannel(channel)[mOffsetToNow[channel]] = sample;
    mOffsetToNow[channel] = (mOffsetToNow[channel] + 1) % Size();
    if (channel != 0 && mOffsetToNow[channel] < mOffsetToNow[0] - gBufferSize * 2)   //channels out of sync, probably was only writing to channel 0 for a while
@@ -27,13 +27,14 @@
 #define __modularSynth__RollingBuffer__
 
 #include <iostream>
+#include <atomic>
 #include "FileStream.h"
 #include "ChannelBuffer.h"
 
 class RollingBuffer
 {
 public:
-   RollingBuffer(int sizeInSamples);
+   RollingBuffer(int sizeInSamples, bool pagedMemory = false);
    ~RollingBuffer();
    float GetSample(int samplesAgo, int channel);
    void ReadChunk(float* dst, int size, int samplesAgo, int channel);
@@ -48,11 +49,18 @@ public:
    void SetNumChannels(int channels) { mBuffer.SetNumActiveChannels(channels); }
    int NumChannels() const { return mBuffer.NumActiveChannels(); }
    
+   //for buffers that are only there to be looked at: writes are skipped unless something has called RequestCapture() recently
+   void SetCaptureOnDemand(bool onDemand) { mCaptureOnDemand = onDemand; }
+   void RequestCapture();
+   bool IsCapturing();
+   
    void SaveState(FileStreamOut& out);
    void LoadState(FileStreamIn& in);
 private:
    int mOffsetToNow[ChannelBuffer::kMaxNumChannels];
    ChannelBuffer mBuffer;
+   bool mCaptureOnDemand;
+   std::atomic<double> mCaptureRequestedUntil;
 };
 
 #endif /* defined(__modularSynth__RollingBuffer__) */
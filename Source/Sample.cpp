@@ -28,6 +28,7 @@
 #include "FileStream.h"
 #include "ModularSynth.h"
 #include "ChannelBuffer.h"
+#include "RealtimeSafetyChecker.h"
 #include <memory>
 
 #include "juce_audio_formats/juce_audio_formats.h"
@@ -54,6 +55,8 @@ Sample::~Sample()
 
 bool Sample::Read(const char* path, bool mono, ReadType readType)
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_FileAccess, "Sample::Read");
+   
    mReadPath = path;
    ofStringReplace(mReadPath, GetPathSeparator(), "/");
    std::vector<std::string> tokens = ofSplitString(mReadPath, "/");
@@ -172,6 +175,8 @@ bool Sample::Write(const char* path /*=nullptr*/)
 //static
 bool Sample::WriteDataToFile(const char *path, float **data, int numSamples, int channels)
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_FileAccess, "Sample::WriteDataToFile");
+   
    auto wavFormat = std::make_unique<juce::WavAudioFormat>();
    juce::File outputFile(ofToDataPath(path).c_str());
    outputFile.create();
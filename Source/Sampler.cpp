@@ -198,6 +198,10 @@ void Sampler::DrawModule()
       ofRect(0,0,100,50);
    ofPopStyle();
    ofPopMatrix();
+
+   float width, height;
+   GetModuleDimensions(width, height);
+   mPolyMgr.DrawVoiceMeter(3, height - 4, width - 6, 2);
 }
 
 void Sampler::StopRecording()
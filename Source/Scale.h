@@ -148,6 +148,7 @@ private:
    
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& width, float& height) override { width = 164; height = 82; }
    bool Enabled() const override { return true; }
    
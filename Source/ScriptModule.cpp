@@ -48,9 +48,50 @@
    #include "pybind11/stl.h"
 #include "leathers/pop"
 
+#include <optional>
+#include <mutex>
+
 namespace py = pybind11;
 using namespace juce;
 
+namespace
+{
+   const int kScriptSchedulerIntervalMs = 1;
+   
+   //runs scheduled python callbacks on their own thread, so their timing doesn't depend on how long the UI takes to render.
+   //everything that touches script state holds the GIL, and the few calls that change the module graph hop over to the main thread
+   class ScriptSchedulerThread : public juce::Thread
+   {
+   public:
+      ScriptSchedulerThread() : juce::Thread("script scheduler") {}
+      
+      void run() override
+      {
+         while (!threadShouldExit())
+         {
+            ScriptModule::RunScheduledEventsForAllScripts();
+            wait(kScriptSchedulerIntervalMs);
+         }
+      }
+   };
+   
+   std::unique_ptr<ScriptSchedulerThread> sScriptScheduler;
+   PyThreadState* sMainThreadState = nullptr;
+   
+   //the main thread doesn't hold the GIL between uses, so anything that touches script state from outside of python needs to take it
+   class ScopedPythonLock
+   {
+   public:
+      ScopedPythonLock()
+      {
+         if (ScriptModule::sPythonInitialized)
+            mGIL.emplace();
+      }
+   private:
+      std::optional<py::gil_scoped_acquire> mGIL;
+   };
+}
+
 //static
 std::vector<ScriptModule*> ScriptModule::sScriptModules;
 //static
@@ -88,11 +129,15 @@ ScriptModule::ScriptModule()
 , mInitExecutePriority(0)
 , mOscInputPort(-1)
 , mShowJediWarning(false)
+, mNumPendingOutputEvents(0)
+, mHasHeldOutputEvent(false)
 {
    CheckIfPythonEverSuccessfullyInitialized();
    if ((TheSynth->IsLoadingState() || Prefab::sLoadingPrefab) && sHasPythonEverSuccessfullyInitialized)
       InitializePythonIfNecessary();
 
+   ScopedPythonLock lock;
+   
    Reset();
    
    mScriptModuleIndex = sScriptModules.size();
@@ -105,6 +150,10 @@ ScriptModule::ScriptModule()
 
 ScriptModule::~ScriptModule()
 {
+   TheTransport->RemoveAudioPoller(this);
+   
+   ScopedPythonLock lock;
+   sScriptModules[mScriptModuleIndex] = nullptr;
 }
 
 void ScriptModule::CreateUIControls()
@@ -132,10 +181,27 @@ void ScriptModule::CreateUIControls()
       mCodeEntry->SetStyleFromJSON(mStyleJSON[0u]);
 }
 
+void ScriptModule::Init()
+{
+   IDrawableModule::Init();
+   
+   TheTransport->AddAudioPoller(this);
+}
+
 void ScriptModule::UninitializePython()
 {
+   if (sScriptScheduler != nullptr)
+   {
+      sScriptScheduler->stopThread(1000);
+      sScriptScheduler.reset();
+   }
+   
    if (sPythonInitialized)
+   {
+      PyEval_RestoreThread(sMainThreadState);
+      sMainThreadState = nullptr;
       py::finalize_interpreter();
+   }
    sPythonInitialized = false;
 }
 
@@ -153,8 +219,15 @@ void ScriptModule::InitializePythonIfNecessary()
       py::exec(GetBootstrapImportString(), py::globals());
       
       CodeEntry::OnPythonInit();
+      
+      //release the GIL from the main thread, python gets locked explicitly wherever it is used
+      sMainThreadState = PyEval_SaveThread();
+      
+      sPythonInitialized = true;
+      
+      sScriptScheduler = std::make_unique<ScriptSchedulerThread>();
+      sScriptScheduler->startThread();
    }
-   sPythonInitialized = true;
 
    if (!sHasPythonEverSuccessfullyInitialized)
    {
@@ -457,7 +530,32 @@ void ScriptModule::Poll()
       }
       sScriptsRequestingInitExecution.clear();
    }
+}
+
+//static
+void ScriptModule::RunScheduledEventsForAllScripts()
+{
+   //called on the script scheduler thread
+   
+   if (!sPythonInitialized || TheSynth->IsLoadingState())
+      return;
    
+   py::gil_scoped_acquire gil;
+   
+   if (TheSynth->IsLoadingState())   //loading may have started while we waited for the GIL
+      return;
+   
+   //sScriptModules is only changed with the GIL held, so it's safe to walk here
+   for (size_t i=0; i<sScriptModules.size(); ++i)
+   {
+      ScriptModule* script = sScriptModules[i];
+      if (script != nullptr && script->IsInitialized() && !script->IsDeleted())
+         script->RunScheduledEvents();
+   }
+}
+
+void ScriptModule::RunScheduledEvents()
+{
    double time = gTime;
    
    for (size_t i=0; i<mScheduledPulseTimes.size(); ++i)
@@ -495,7 +593,13 @@ void ScriptModule::Poll()
       if (mScheduledUIControlValue[i].time != -1 &&
           time + TheTransport->GetEventLookaheadMs() > mScheduledUIControlValue[i].time)
       {
-         AdjustUIControl(mScheduledUIControlValue[i].control, mScheduledUIControlValue[i].value, mScheduledUIControlValue[i].lineNum);
+         ScriptOutputEvent event;
+         event.type = ScriptOutputEvent::kUIControl;
+         event.time = mScheduledUIControlValue[i].time;
+         event.control = mScheduledUIControlValue[i].control;
+         event.value = mScheduledUIControlValue[i].value;
+         event.lineNum = mScheduledUIControlValue[i].lineNum;
+         PushOutputEvent(event);
          mScheduledUIControlValue[i].time = -1;
       }
    }
@@ -715,20 +819,164 @@ void ScriptModule::PlayNote(double time, float pitch, float velocity, float pan,
    }
    
    //ofLog() << "ScriptModule::PlayNote() " << velocity << " " << time;
-   int intPitch = int(pitch+.5f);
-   ModulationParameters modulation;
-   modulation.pan = pan;
-   if (pitch - intPitch != 0)
-   {
-      modulation.pitchBend = &mPitchBends[intPitch];
-      modulation.pitchBend->SetValue(pitch - intPitch);
-   }
-   SendNoteToIndex(noteOutputIndex, time, intPitch, (int)velocity, -1, modulation);
+   ScriptOutputEvent event;
+   event.type = ScriptOutputEvent::kNote;
+   event.time = time;
+   event.pitch = pitch;
+   event.velocity = velocity;
+   event.pan = pan;
+   event.noteOutputIndex = noteOutputIndex;
+   event.lineNum = lineNum;
+   PushOutputEvent(event);
    
    if (velocity > 0)
       mNotePlayTracker.AddEvent(lineNum, ofToString(pitch) + " " + ofToString(velocity) + " " + ofToString(pan,1));
 }
 
+void ScriptModule::PushOutputEvent(const ScriptOutputEvent& event)
+{
+   //the writers take turns, the audio thread consumes without locking
+   mOutputEventQueueWriteMutex.lock();
+   mOutputEventQueue.produce(event);
+   mOutputEventQueueWriteMutex.unlock();
+}
+
+//static
+void ScriptModule::RunOnMainThread(std::function<void()> func)
+{
+   if (MessageManager::getInstance()->isThisTheMessageThread())
+   {
+      func();
+      return;
+   }
+   
+   //the main thread may need the GIL before it gets around to this, so let go of it while we wait
+   py::gil_scoped_release release;
+   
+   struct Call
+   {
+      std::mutex mutex;
+      bool abandoned{ false };
+      WaitableEvent done;
+   };
+   auto call = std::make_shared<Call>();
+   MessageManager::callAsync([call, func]()
+   {
+      std::lock_guard<std::mutex> lock(call->mutex);
+      if (!call->abandoned)
+         func();
+      call->done.signal();
+   });
+   
+   while (!call->done.wait(kScriptSchedulerIntervalMs * 10))
+   {
+      if (Thread::currentThreadShouldExit())   //shutting down, the main thread is waiting on us and won't get to it
+      {
+         std::lock_guard<std::mutex> lock(call->mutex);
+         call->abandoned = true;
+         break;
+      }
+   }
+}
+
+bool ScriptModule::AddPendingOutputEvent(const ScriptOutputEvent& event)
+{
+   if (mNumPendingOutputEvents < (int)mPendingOutputEvents.size())
+   {
+      mPendingOutputEvents[mNumPendingOutputEvents++] = event;
+      return true;
+   }
+   
+   if (!event.IsNoteOff())
+      return true;   //no room, let it go. only note offs are worth holding on to
+   
+   //make room for the note off by giving up something that can't leave a note stuck
+   for (int i=mNumPendingOutputEvents-1; i>=0; --i)
+   {
+      if (!mPendingOutputEvents[i].IsNoteOff())
+      {
+         mPendingOutputEvents[i] = event;
+         return true;
+      }
+   }
+   
+   return false;   //nothing but note offs pending, this one has to wait for some of them to play
+}
+
+void ScriptModule::OnTransportAdvanced(float amount)
+{
+   if (mHasHeldOutputEvent && AddPendingOutputEvent(mHeldOutputEvent))
+      mHasHeldOutputEvent = false;
+   
+   ScriptOutputEvent event;
+   while (!mHasHeldOutputEvent && mOutputEventQueue.consume(event))
+   {
+      if (event.type == ScriptOutputEvent::kFlush)
+      {
+         int numKept = 0;
+         for (int i=0; i<mNumPendingOutputEvents; ++i)
+         {
+            if (mPendingOutputEvents[i].IsNoteOff())
+               mPendingOutputEvents[numKept++] = mPendingOutputEvents[i];
+         }
+         mNumPendingOutputEvents = numKept;
+      }
+      else if (!AddPendingOutputEvent(event))
+      {
+         //leave the rest of the queue for later buffers rather than lose a note off
+         mHeldOutputEvent = event;
+         mHasHeldOutputEvent = true;
+      }
+   }
+   
+   if (mNumPendingOutputEvents == 0)
+      return;
+   
+   //play out everything that lands in this buffer with its exact time. note offs first, like the scheduled notes are processed
+   double bufferEndTime = gTime + gBufferSizeMs;
+   for (int pass = 0; pass < 2; ++pass)
+   {
+      bool noteOffPass = (pass == 0);
+      for (int i=0; i<mNumPendingOutputEvents; ++i)
+      {
+         ScriptOutputEvent& pending = mPendingOutputEvents[i];
+         if (pending.time != -1 && pending.time < bufferEndTime && pending.IsNoteOff() == noteOffPass)
+         {
+            SendOutputEvent(pending);
+            pending.time = -1;
+         }
+      }
+   }
+   
+   int numKept = 0;
+   for (int i=0; i<mNumPendingOutputEvents; ++i)
+   {
+      if (mPendingOutputEvents[i].time != -1)
+         mPendingOutputEvents[numKept++] = mPendingOutputEvents[i];
+   }
+   mNumPendingOutputEvents = numKept;
+}
+
+void ScriptModule::SendOutputEvent(const ScriptOutputEvent& event)
+{
+   if (event.type == ScriptOutputEvent::kNote)
+   {
+      int intPitch = int(event.pitch+.5f);
+      ModulationParameters modulation;
+      modulation.pan = event.pan;
+      if (event.pitch - intPitch != 0)
+      {
+         modulation.pitchBend = &mPitchBends[intPitch];
+         modulation.pitchBend->SetValue(event.pitch - intPitch);
+      }
+      SendNoteToIndex(event.noteOutputIndex, event.time, intPitch, (int)event.velocity, -1, modulation);
+   }
+   else if (event.type == ScriptOutputEvent::kUIControl)
+   {
+      AdjustUIControl(event.control, event.value, event.lineNum);
+   }
+}
+
 void ScriptModule::SendNoteToIndex(int index, double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation)
 {
    if (index == 0)
@@ -1009,6 +1257,8 @@ std::pair<int,int> ScriptModule::RunScript(double time, int lineStart/*=-1*/, in
       return std::make_pair(0,0);
    }
 
+   py::gil_scoped_acquire gil;
+
    py::exec(GetThisName()+" = scriptmodule.get_me("+ofToString(mScriptModuleIndex)+")", py::globals());
    std::string code = mCodeEntry->GetText(true);
    std::vector<std::string> lines = ofSplitString(code, "\n");
@@ -1064,6 +1314,8 @@ void ScriptModule::RunCode(double time, std::string code)
       return;
    }
 
+   py::gil_scoped_acquire gil;
+
    sMostRecentRunTime = time;
    mNextLineToExecute = -1;
    ComputeSliders(0);
@@ -1289,6 +1541,8 @@ void ScriptModule::OnModuleReferenceBound(IDrawableModule* target)
 
 void ScriptModule::Stop()
 {
+   ScopedPythonLock lock;
+   
    double time = gTime + gBufferSizeMs;
 
    //run through any scheduled note offs for this pitch
@@ -1324,6 +1578,11 @@ void ScriptModule::Reset()
    
    for (size_t i=0; i<mPrintDisplay.size(); ++i)
       mPrintDisplay[i].time = -1;
+   
+   ScriptOutputEvent flush;
+   flush.type = ScriptOutputEvent::kFlush;
+   flush.time = gTime;
+   PushOutputEvent(flush);
 }
 
 void ScriptModule::GetModuleDimensions(float& w, float& h)
@@ -37,10 +37,12 @@
 #include "DropdownList.h"
 #include "ModulationChain.h"
 #include "MidiController.h"
+#include "IAudioPoller.h"
+#include "LockFreeQueue.h"
 
 #include "juce_osc/juce_osc.h"
 
-class ScriptModule : public IDrawableModule, public IButtonListener, public NoteEffectBase, public IPulseReceiver, public ICodeEntryListener, public IFloatSliderListener, public IDropdownListener,
+class ScriptModule : public IDrawableModule, public IButtonListener, public NoteEffectBase, public IPulseReceiver, public ICodeEntryListener, public IFloatSliderListener, public IDropdownListener, public IAudioPoller,
                      private juce::OSCReceiver,
                      private juce::OSCReceiver::Listener<juce::OSCReceiver::MessageLoopCallback>
 {
@@ -55,8 +57,11 @@ public:
    
    std::string GetTitleLabel() override { return "script"; }
    void CreateUIControls() override;
+   void Init() override;
    
    void Poll() override;
+   static void RunScheduledEventsForAllScripts();
+   static void RunOnMainThread(std::function<void()> func);
    
    void PlayNoteFromScript(float pitch, float velocity, float pan, int noteOutputIndex);
    void PlayNoteFromScriptAfterDelay(float pitch, float velocity, double delayMeasureTime, float pan, int noteOutputIndex);
@@ -89,6 +94,9 @@ public:
    
    //INoteReceiver
    void PlayNote(double time, int pitch, int velocity, int voiceIdx = -1, ModulationParameters modulation = ModulationParameters()) override;
+   
+   //IAudioPoller
+   void OnTransportAdvanced(float amount) override;
 
    //OSCReceiver
    void oscMessageReceived(const juce::OSCMessage& msg) override;
@@ -123,6 +131,7 @@ public:
 private:
    void PlayNote(double time, float pitch, float velocity, float pan, int noteOutputIndex, int lineNum);
    void AdjustUIControl(IUIControl* control, float value, int lineNum);
+   void RunScheduledEvents();
    std::pair<int,int> RunScript(double time, int lineStart = -1, int lineEnd = -1);
    void FixUpCode(std::string& code);
    void ScheduleNote(double time, float pitch, float velocity, float pan, int noteOutputIndex);
@@ -235,6 +244,37 @@ private:
    };
    std::array<UIControlModificationDisplay, 10> mUIControlModifications;
    
+   //events produced by python, played out by the audio thread at their exact time
+   struct ScriptOutputEvent
+   {
+      enum Type
+      {
+         kNote,
+         kUIControl,
+         kFlush  //drop anything pending except note offs
+      };
+      Type type;
+      double time;
+      float pitch;
+      float velocity;
+      float pan;
+      int noteOutputIndex;
+      IUIControl* control;
+      float value;
+      int lineNum;
+      
+      bool IsNoteOff() const { return type == kNote && velocity == 0; }
+   };
+   void PushOutputEvent(const ScriptOutputEvent& event);
+   void SendOutputEvent(const ScriptOutputEvent& event);
+   bool AddPendingOutputEvent(const ScriptOutputEvent& event);
+   LockFreeQueue<ScriptOutputEvent> mOutputEventQueue;
+   ofMutex mOutputEventQueueWriteMutex;
+   std::array<ScriptOutputEvent, 512> mPendingOutputEvents;
+   int mNumPendingOutputEvents;
+   ScriptOutputEvent mHeldOutputEvent;   //a note off that didn't fit yet
+   bool mHasHeldOutputEvent;
+   
    class LineEventTracker
    {
    public:
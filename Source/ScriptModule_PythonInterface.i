@@ -220,7 +220,7 @@ PYBIND11_EMBEDDED_MODULE(scriptmodule, m)
       })
       .def("set_num_note_outputs", [](ScriptModule& module, int num)
       {
-         module.SetNumNoteOutputs(num);
+         ScriptModule::RunOnMainThread([&module, num]() { module.SetNumNoteOutputs(num); });
       })
       .def("connect_osc_input", [](ScriptModule& module, int port)
       {
@@ -606,20 +606,22 @@ PYBIND11_EMBEDDED_MODULE(module, m)
    }, py::return_value_policy::reference);
    m.def("create", [](std::string moduleType, int x, int y)
    {
-      return TheSynth->SpawnModuleOnTheFly(moduleType, x, y);
+      IDrawableModule* ret = nullptr;
+      ScriptModule::RunOnMainThread([&ret, moduleType, x, y]() { ret = TheSynth->SpawnModuleOnTheFly(moduleType, x, y); });
+      return ret;
    }, py::return_value_policy::reference);
    py::class_<IDrawableModule>(m, "module")
       .def("set_position", [](IDrawableModule& module, int x, int y)
       {
-         module.SetPosition(x,y);
+         ScriptModule::RunOnMainThread([&module, x, y]() { module.SetPosition(x,y); });
       })
       .def("set_target", [](IDrawableModule& module, IDrawableModule* target)
       {
-         module.SetTarget(target);
+         ScriptModule::RunOnMainThread([&module, target]() { module.SetTarget(target); });
       })
       .def("delete", [](IDrawableModule& module)
       {
-         module.GetOwningContainer()->DeleteModule(&module);
+         ScriptModule::RunOnMainThread([&module]() { module.GetOwningContainer()->DeleteModule(&module); });
       })
       .def("set", [](IDrawableModule& module, std::string path, float value)
       {
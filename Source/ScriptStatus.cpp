@@ -80,6 +80,7 @@ void ScriptStatus::Poll()
    
    if (gTime > mNextUpdateTime)
    {
+      py::gil_scoped_acquire gil;
       mStatus = py::str(py::globals());
       ofStringReplace(mStatus, ",", "\n");
       mNextUpdateTime = gTime + 100;
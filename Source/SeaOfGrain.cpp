@@ -58,6 +58,7 @@ SeaOfGrain::SeaOfGrain()
 , mKeyboardNumPitchesSelector(nullptr)
 , mDisplayStartSamples(0)
 , mDisplayEndSamples(0)
+, mGrainOutput(gBufferSize)
 {
    mSample = new Sample();
    
@@ -142,6 +143,9 @@ void SeaOfGrain::Process(double time)
          mRecordBuffer.WriteChunk(GetBuffer()->GetChannel(ch), bufferSize, ch);
    }
    
+   if ((int)mGrainOffsets.size() < bufferSize)
+      mGrainOffsets.resize(bufferSize);
+   
    gWorkChannelBuffer.SetNumActiveChannels(numChannels);
    gWorkChannelBuffer.Clear();
    for (int i=0; i<kNumMPEVoices; ++i)
@@ -388,6 +392,7 @@ void SeaOfGrain::PlayNote(double time, int pitch, int velocity, int voiceIdx, Mo
 void SeaOfGrain::LoadLayout(const ofxJSONElement& moduleInfo)
 {
    mModuleSaveData.LoadString("target", moduleInfo);
+   mModuleSaveData.LoadInt("max_grains", moduleInfo, MAX_GRAINS, 1, MAX_GRAIN_CAP, K(isTextField));
    
    SetUpFromSaveData();
 }
@@ -395,6 +400,12 @@ void SeaOfGrain::LoadLayout(const ofxJSONElement& moduleInfo)
 void SeaOfGrain::SetUpFromSaveData()
 {
    SetTarget(TheSynth->FindModule(mModuleSaveData.GetString("target")));
+   
+   int maxGrains = mModuleSaveData.GetInt("max_grains");
+   for (int i=0; i<kNumMPEVoices; ++i)
+      mMPEVoices[i].mGranulator.SetGrainCap(maxGrains);
+   for (int i=0; i<kNumManualVoices; ++i)
+      mManualVoices[i].mGranulator.SetGrainCap(maxGrains);
 }
 
 namespace
@@ -455,31 +466,40 @@ void SeaOfGrain::GrainMPEVoice::Process(ChannelBuffer* output, int bufferSize)
 {
    if (!mADSR.IsDone(gTime) && mOwner->GetSourceBuffer()->BufferSize() > 0)
    {
-      double time = gTime;
+      //the grain parameters follow the expression at the start of the buffer, the position and gain follow it every sample
+      float pressure = mPressure ? mPressure->GetValue(0) : 0;
+      float modwheel = mModWheel ? mModWheel->GetValue(0) : 0;
+      if (pressure > 0)
+      {
+         mGranulator.mGrainOverlap = ofMap(pressure * pressure, 0, 1, 3, MAX_GRAINS);
+         mGranulator.mPosRandomizeMs = ofMap(pressure * pressure, 0, 1, 100, .03f);
+      }
+      mGranulator.mGrainLengthMs = ofMap(modwheel, -1, 1, 10, 700);
+      
+      double* offsets = mOwner->mGrainOffsets.data();
       for (int i=0; i< bufferSize; ++i)
       {
          float pitchBend = mPitchBend ? mPitchBend->GetValue(i) : 0;
+         float pos = (mPitch + pitchBend + MIN(.125f, mPlay) - mOwner->mKeyboardBasePitch) / mOwner->mKeyboardNumPitches;
+         offsets[i] = ofLerp(mOwner->GetSourceStartSample(), mOwner->GetSourceEndSample(), pos) + mOwner->GetSourceBufferOffset();
+         mPlay += .001f;
+      }
+      
+      ChannelBuffer* grains = &mOwner->mGrainOutput;
+      mGranulator.ProcessBlock(gTime, mOwner->GetSourceBuffer(), mOwner->GetSourceBuffer()->BufferSize(), offsets, grains, bufferSize);
+      
+      double time = gTime;
+      for (int i=0; i< bufferSize; ++i)
+      {
          float pressure = mPressure ? mPressure->GetValue(i) : 0;
-         float modwheel = mModWheel ? mModWheel->GetValue(i) : 0;
-         if (pressure > 0)
-         {
-            mGranulator.mGrainOverlap = ofMap(pressure * pressure, 0, 1, 3, MAX_GRAINS);
-            mGranulator.mPosRandomizeMs = ofMap(pressure * pressure, 0, 1, 100, .03f);
-         }
-         mGranulator.mGrainLengthMs = ofMap(modwheel, -1, 1, 10, 700);
-         
          float blend = .0005f;
          mGain = mGain * (1-blend) + pressure * blend;
-
-         float outSample[ChannelBuffer::kMaxNumChannels];
-         Clear(outSample, ChannelBuffer::kMaxNumChannels);
-         float pos = (mPitch + pitchBend + MIN(.125f, mPlay) - mOwner->mKeyboardBasePitch) / mOwner->mKeyboardNumPitches;
-         mGranulator.ProcessFrame(time, mOwner->GetSourceBuffer(), mOwner->GetSourceBuffer()->BufferSize(), ofLerp(mOwner->GetSourceStartSample(), mOwner->GetSourceEndSample(), pos) + mOwner->GetSourceBufferOffset(), outSample);
+         
+         float gain = sqrtf(mGain) * mADSR.Value(time);
          for (int ch = 0; ch < output->NumActiveChannels(); ++ch)
-            output->GetChannel(ch)[i] += outSample[ch] * sqrtf(mGain) * mADSR.Value(time);
+            output->GetChannel(ch)[i] += grains->GetChannel(ch)[i] * gain;
 
          time += gInvSampleRateMs;
-         mPlay += .001f;
       }
    }
    else
@@ -528,17 +548,20 @@ void SeaOfGrain::GrainManualVoice::Process(ChannelBuffer* output, int bufferSize
 {
    if (mGain > 0 && mOwner->GetSourceBuffer()->BufferSize() > 0)
    {
-      double time = gTime;
       float panLeft = GetLeftPanGain(mPan);
       float panRight = GetRightPanGain(mPan);
+      double* offsets = mOwner->mGrainOffsets.data();
+      double offset = ofLerp(mOwner->GetSourceStartSample(), mOwner->GetSourceEndSample(), mPosition) + mOwner->GetSourceBufferOffset();
       for (int i=0; i < bufferSize; ++i)
+         offsets[i] = offset;
+      
+      ChannelBuffer* grains = &mOwner->mGrainOutput;
+      mGranulator.ProcessBlock(gTime, mOwner->GetSourceBuffer(), mOwner->GetSourceBuffer()->BufferSize(), offsets, grains, bufferSize);
+      for (int ch = 0; ch < output->NumActiveChannels(); ++ch)
       {
-         float outSample[ChannelBuffer::kMaxNumChannels];
-         Clear(outSample, ChannelBuffer::kMaxNumChannels);
-         mGranulator.ProcessFrame(time, mOwner->GetSourceBuffer(), mOwner->GetSourceBuffer()->BufferSize(), ofLerp(mOwner->GetSourceStartSample(), mOwner->GetSourceEndSample(), mPosition) + mOwner->GetSourceBufferOffset(), outSample);
-         for (int ch = 0; ch < output->NumActiveChannels(); ++ch)
-            output->GetChannel(ch)[i] += outSample[ch] * mGain * (ch == 0 ? panLeft : panRight);
-         time += gInvSampleRateMs;
+         float gain = mGain * (ch == 0 ? panLeft : panRight);
+         for (int i=0; i < bufferSize; ++i)
+            output->GetChannel(ch)[i] += grains->GetChannel(ch)[i] * gain;
       }
    }
    else
@@ -151,6 +151,8 @@ private:
    GrainMPEVoice mMPEVoices[kNumMPEVoices];
    static const int kNumManualVoices = 6;
    GrainManualVoice mManualVoices[kNumManualVoices];
+   ChannelBuffer mGrainOutput;   //scratch for the voices, which are processed one after another
+   std::vector<double> mGrainOffsets;
    
    Sample* mSample;
    RollingBuffer mRecordBuffer;
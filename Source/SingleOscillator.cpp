@@ -316,6 +316,10 @@ void SingleOscillator::DrawModule()
       ofSetColor(100, 100, 100);
    DrawTextLeftJustify("filter", (kGap + kColumnWidth) * 3 - 3, 15);
    ofPopStyle();
+
+   float width, height;
+   GetModuleDimensions(width, height);
+   mPolyMgr.DrawVoiceMeter(3, height - 4, width - 6, 2);
 }
  
 void SingleOscillator::DrawModuleUnclipped()
@@ -342,7 +346,7 @@ void SingleOscillator::LoadLayout(const ofxJSONElement& moduleInfo)
    mModuleSaveData.LoadEnum<OscillatorType>("osc", moduleInfo, kOsc_Sin, mOscSelector);
    mModuleSaveData.LoadFloat("detune", moduleInfo, 0, mDetuneSlider);
    mModuleSaveData.LoadBool("pressure_envelope", moduleInfo);
-   mModuleSaveData.LoadInt("voicelimit", moduleInfo, -1, -1, kNumVoices);
+   mModuleSaveData.LoadInt("voicelimit", moduleInfo, -1, -1, kMaxVoicePoolSize);
    mModuleSaveData.LoadBool("mono", moduleInfo, false);
 
    SetUpFromSaveData();
@@ -78,6 +78,7 @@ public:
    bool Process(double time, ChannelBuffer* out, int oversampling) override;
    void SetVoiceParams(IVoiceParams* params) override;
    bool IsDone(double time) override;
+   float GetEnvelopeLevel(double time) override { return mAdsr.Value(time); }
 
    static float GetADSRScale(float velocity, float velToEnvelope);
    
@@ -65,6 +65,12 @@ FloatSlider::FloatSlider(IFloatSliderListener* owner, const char* label, int x,
 , mComputeHasBeenCalledOnce(false)
 , mLastComputeTime(0)
 , mLastComputeSamplesIn(0)
+, mControlRateValues(nullptr)
+, mControlRateSlopes(nullptr)
+, mControlRateTime(-1)
+, mControlRate(0)
+, mNumControlRateSegments(0)
+, mModulatorIsAudioRate(false)
 , mLastDisplayedValue(FLT_MAX)
 , mFloatEntry(nullptr)
 , mAllowMinMaxAdjustment(true)
@@ -90,6 +96,8 @@ FloatSlider::~FloatSlider()
 {
    if (mIsSmoothing)
       TheTransport->RemoveAudioPoller(this);
+   delete[] mControlRateValues;
+   delete[] mControlRateSlopes;
 }
 
 void FloatSlider::Init()
@@ -110,14 +118,22 @@ FloatSliderLFOControl* FloatSlider::AcquireLFO()
 
 void FloatSlider::SetLFO(FloatSliderLFOControl* lfo)
 {
+   SetModulator(lfo);
    mLFOControl = lfo;
-   mModulator = lfo;
 }
 
 void FloatSlider::SetModulator(IModulator* modulator)
 {
    mModulator = modulator;
    mLFOControl = nullptr;
+   mControlRateTime = -1;
+   mModulatorIsAudioRate = modulator != nullptr && modulator->IsAudioRate();
+   if (modulator != nullptr && mControlRateValues == nullptr)
+   {
+      //only modulated sliders need these, so allocate them here rather than on the audio thread
+      mControlRateValues = new float[gBufferSize + 1];
+      mControlRateSlopes = new float[gBufferSize];
+   }
 }
 
 void FloatSlider::Render()
@@ -637,12 +653,13 @@ void FloatSlider::Compute(int samplesIn /*= 0*/)
    }
    else
    {
-      if (mModulator && mModulator->Active())
+      //once this buffer's control rate values are in, the modulator doesn't need to be asked anything until the next one
+      if (mModulator && (HasControlRateValue(samplesIn) || mModulator->Active()))
       {
          if (mIsSmoothing)
-            mSmoothTarget = mModulator->Value(samplesIn);
+            mSmoothTarget = GetModulatorValue(samplesIn);
          else
-            *mVar = mModulator->Value(samplesIn);
+            *mVar = GetModulatorValue(samplesIn);
       }
 
       if (mIsSmoothing)
@@ -659,6 +676,56 @@ void FloatSlider::Compute(int samplesIn /*= 0*/)
       mOwner->FloatSliderUpdated(this, oldVal);
 }
 
+bool FloatSlider::HasControlRateValue(int samplesIn) const
+{
+   return mControlRateTime == gTime && mControlRate == TheTransport->GetControlRate() && samplesIn >= 0 && samplesIn < gBufferSize;
+}
+
+float FloatSlider::GetModulatorValue(int samplesIn)
+{
+   int controlRate = TheTransport->GetControlRate();
+   if (!HasControlRateValue(samplesIn))
+   {
+      if (controlRate <= 1 || mControlRateValues == nullptr || mModulatorIsAudioRate || samplesIn < 0 || samplesIn >= gBufferSize)
+         return mModulator->Value(samplesIn);
+      
+      mControlRateTime = gTime;
+      mControlRate = controlRate;
+      mControlRateValues[0] = mModulator->Value(0);
+      mNumControlRateSegments = 0;
+   }
+   
+   int segment = samplesIn / controlRate;
+   int offset = samplesIn - segment * controlRate;
+   
+   //evaluate the modulator at control points as far as they've been asked for, and interpolate linearly between them.
+   //a read right on a control point doesn't need the next one, so a slider that's only computed once a buffer costs one call.
+   //the last segment ends on the last sample of the buffer, so we never ask the modulator to look past it
+   int numSegmentsNeeded = (offset == 0) ? segment : segment + 1;
+   while (mNumControlRateSegments < numSegmentsNeeded)
+   {
+      int i = mNumControlRateSegments;
+      int start = i * controlRate;
+      int end = MIN(start + controlRate, gBufferSize - 1);
+      mControlRateValues[i + 1] = mModulator->Value(end);
+      mControlRateSlopes[i] = end > start ? (mControlRateValues[i + 1] - mControlRateValues[i]) / (end - start) : 0;
+      ++mNumControlRateSegments;
+   }
+   
+   if (offset == 0)
+      return mControlRateValues[segment];
+   return mControlRateValues[segment] + mControlRateSlopes[segment] * offset;
+}
+
+bool FloatSlider::IsModulatedPerSample() const
+{
+   if (mIsSmoothing)
+      return true;
+   if (mLFOControl && mLFOControl->Active() && mLFOControl->InLowResMode())
+      return false;
+   return mModulator && mModulator->Active();
+}
+
 float* FloatSlider::GetModifyValue()
 {
    if (!TheSynth->IsLoadingModule() && mModulator && mModulator->Active() && mModulator->CanAdjustRange())
@@ -699,6 +766,12 @@ bool FloatSlider::CheckNeedsDraw()
    if (IUIControl::CheckNeedsDraw())
       return true;
    
+   if (mFloatEntry || mMinEntry || mMaxEntry || mIsSmoothing || AdjustSmooth())
+      return true;
+   
+   if (mModulator && mModulator->Active())
+      return true;
+   
    return *mVar != mLastDisplayedValue;
 }
 
@@ -868,6 +941,7 @@ IntSlider::IntSlider(IIntSliderListener* owner, const char* label, int x, int y,
 , mOwner(owner)
 , mOriginalValue(0)
 , mSliderVal(0)
+, mLastDisplayedSliderVal(0)
 , mShowName(true)
 , mIntEntry(nullptr)
 , mAllowMinMaxAdjustment(true)
@@ -916,6 +990,7 @@ void IntSlider::Render()
    }
    
    mLastDisplayedValue = *mVar;
+   mLastDisplayedSliderVal = mSliderVal;
    
    ofPushStyle();
 
@@ -1164,7 +1239,10 @@ bool IntSlider::CheckNeedsDraw()
    if (IUIControl::CheckNeedsDraw())
       return true;
    
-   return *mVar != mLastDisplayedValue;
+   if (mIntEntry || mMinEntry || mMaxEntry)
+      return true;
+   
+   return *mVar != mLastDisplayedValue || mSliderVal != mLastDisplayedSliderVal;
 }
 
 bool IntSlider::AttemptTextInput()
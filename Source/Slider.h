@@ -53,8 +53,9 @@ public:
    bool MouseMoved(float x, float y) override;
    void MouseReleased() override;
    bool IsMouseDown() const override { return mMouseDown; }
-   void SetExtents(float min, float max) { mMin = min; mMax = max; }
+   void SetExtents(float min, float max) { mMin = min; mMax = max; MarkNeedsDraw(); }
    void Compute(int samplesIn = 0);
+   bool IsModulatedPerSample() const;  //whether Compute() can change the value within a buffer
    void DisplayLFOControl();
    void DisableLFO();
    FloatSliderLFOControl* GetLFO() { return mLFOControl; }
@@ -118,6 +119,8 @@ private:
    float ValToPos(float val, bool ignoreSmooth) const;
    bool AdjustSmooth() const;
    void SmoothUpdated();
+   float GetModulatorValue(int samplesIn);
+   bool HasControlRateValue(int samplesIn) const;
    
    int mWidth;
    int mHeight;
@@ -153,6 +156,12 @@ private:
    int mLastComputeSamplesIn;
    double* mLastComputeCacheTime;
    float* mLastComputeCacheValue;
+   float* mControlRateValues;   //the modulator at each control point this buffer, filled in as far as it has been read
+   float* mControlRateSlopes;
+   double mControlRateTime;
+   int mControlRate;
+   int mNumControlRateSegments;
+   bool mModulatorIsAudioRate;
    
    float mLastDisplayedValue;
    
@@ -183,7 +192,7 @@ public:
    bool MouseMoved(float x, float y) override;
    void MouseReleased() override { mMouseDown = false; }
    bool IsMouseDown() const override { return mMouseDown; }
-   void SetExtents(int min, int max) { mMin = min; mMax = max; CalcSliderVal(); }
+   void SetExtents(int min, int max) { mMin = min; mMax = max; CalcSliderVal(); MarkNeedsDraw(); }
    void SetShowName(bool show) { mShowName = show; }
    void SetDimensions(int w, int h) { mWidth = w; mHeight = h; }
    
@@ -233,6 +242,7 @@ private:
    int mLastDisplayedValue;
    int mLastSetValue;
    float mSliderVal;
+   float mLastDisplayedSliderVal;
    bool mShowName;
    
    TextEntry* mIntEntry;
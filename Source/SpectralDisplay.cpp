@@ -43,6 +43,9 @@ SpectralDisplay::SpectralDisplay()
 , mFFTData(kNumFFTBins, kNumFFTBins/2+1)
 , mRollingInputBuffer(kNumFFTBins)
 {
+   //only captured while the display is on screen, the analysis happens when drawing
+   mRollingInputBuffer.SetCaptureOnDemand(true);
+
    // Generate a window with a single raised cosine from N/4 to 3N/4
    mWindower = new float[kNumFFTBins];
    for (int i=0; i<kNumFFTBins; ++i)
@@ -79,18 +82,34 @@ void SpectralDisplay::Process(double time)
    if (target)
    {
       ChannelBuffer* out = target->GetBuffer();
+      for (int ch=0; ch<GetBuffer()->NumActiveChannels(); ++ch)
+      {
+         Add(out->GetChannel(ch), GetBuffer()->GetChannel(ch), out->BufferSize());
+         GetVizBuffer()->WriteChunk(GetBuffer()->GetChannel(ch),GetBuffer()->BufferSize(), ch);
+      }
+   }
+   
+   if (mRollingInputBuffer.IsCapturing())
+   {
       for (int ch=0; ch<GetBuffer()->NumActiveChannels(); ++ch)
       {
          if (ch == 0)
             BufferCopy(gWorkBuffer, GetBuffer()->GetChannel(ch), GetBuffer()->BufferSize());
          else
             Add(gWorkBuffer, GetBuffer()->GetChannel(ch), GetBuffer()->BufferSize());
-         Add(out->GetChannel(ch), GetBuffer()->GetChannel(ch), out->BufferSize());
-         GetVizBuffer()->WriteChunk(GetBuffer()->GetChannel(ch),GetBuffer()->BufferSize(), ch);
       }
+      mRollingInputBuffer.WriteChunk(gWorkBuffer, GetBuffer()->BufferSize(), 0);
    }
+      
+   GetBuffer()->Reset();
+}
+
+void SpectralDisplay::DrawModule()
+{
+   if (Minimized() || IsVisible() == false)
+      return;
    
-   mRollingInputBuffer.WriteChunk(gWorkBuffer, GetBuffer()->BufferSize(), 0);
+   mRollingInputBuffer.RequestCapture();
    
    //copy rolling input buffer into working buffer and window it
    mRollingInputBuffer.ReadChunk(mFFTData.mTimeDomain, kNumFFTBins, 0, 0);
@@ -99,14 +118,6 @@ void SpectralDisplay::Process(double time)
    mFFT.Forward(mFFTData.mTimeDomain,
                 mFFTData.mRealValues,
                 mFFTData.mImaginaryValues);
-      
-   GetBuffer()->Reset();
-}
-
-void SpectralDisplay::DrawModule()
-{
-   if (Minimized() || IsVisible() == false)
-      return;
 
    ofPushStyle();
    ofPushMatrix();
@@ -1013,7 +1013,7 @@ void StepSequencer::DropdownUpdated(DropdownList* list, int oldVal)
       oldGrid->Delete();
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
-         transportListenerInfo->mInterval = mStepInterval;
+         transportListenerInfo->SetInterval(mStepInterval);
       mFlusher.SetInterval(mStepInterval);
       mGrid->SetMajorColSize(TheTransport->CountInStandardMeasure(mStepInterval) / 4);
       for (int i=0; i<NUM_STEPSEQ_ROWS; ++i)
@@ -1178,8 +1178,8 @@ void StepSequencerRow::UpdateTimeListener()
    TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
    if (transportListenerInfo != nullptr)
    {
-      transportListenerInfo->mInterval = mSeq->GetStepInterval();
-      transportListenerInfo->mOffsetInfo = OffsetInfo(mOffset, false);
+      transportListenerInfo->SetInterval(mSeq->GetStepInterval());
+      transportListenerInfo->SetOffsetInfo(OffsetInfo(mOffset, false));
    }
 }
 
@@ -1249,8 +1249,8 @@ void NoteRepeat::SetInterval(NoteInterval interval)
    TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
    if (transportListenerInfo != nullptr)
    {
-      transportListenerInfo->mInterval = mInterval;
-      transportListenerInfo->mOffsetInfo = OffsetInfo(mOffset, false);
+      transportListenerInfo->SetInterval(mInterval);
+      transportListenerInfo->SetOffsetInfo(OffsetInfo(mOffset, false));
    }
 }
 
@@ -1260,8 +1260,8 @@ void NoteRepeat::SetOffset(float offset)
    TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
    if (transportListenerInfo != nullptr)
    {
-      transportListenerInfo->mInterval = mInterval;
-      transportListenerInfo->mOffsetInfo = OffsetInfo(mOffset, false);
+      transportListenerInfo->SetInterval(mInterval);
+      transportListenerInfo->SetOffsetInfo(OffsetInfo(mOffset, false));
    }
 }
 
@@ -1281,8 +1281,8 @@ void StepSequencerNoteFlusher::SetInterval(NoteInterval interval)
    TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
    if (transportListenerInfo != nullptr)
    {
-      transportListenerInfo->mInterval = interval;
-      transportListenerInfo->mOffsetInfo = OffsetInfo(.01f, false);
+      transportListenerInfo->SetInterval(interval);
+      transportListenerInfo->SetOffsetInfo(OffsetInfo(.01f, false));
    }
 }
 
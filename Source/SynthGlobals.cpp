@@ -37,6 +37,8 @@
 #include "PatchCableSource.h"
 #include "ChannelBuffer.h"
 #include "IPulseReceiver.h"
+#include "CompiledExpression.h"
+#include "RealtimeSafetyChecker.h"
 #include "exprtk/exprtk.hpp"
 
 #include "juce_audio_formats/juce_audio_formats.h"
@@ -1366,12 +1368,6 @@ void DrawFallbackText(const char* text, float posX, float posY)
 
 bool EvaluateExpression(std::string expressionStr, float currentValue, float& output)
 {
-   exprtk::symbol_table<float> symbolTable;
-   exprtk::expression<float> expression;
-   symbolTable.add_variable("current_value",currentValue);
-   symbolTable.add_constants();
-   expression.register_symbol_table(symbolTable);
-   
    juce::String input = expressionStr;
    if (input.startsWith("+="))
       input = input.replace("+=", "current_value+");
@@ -1382,6 +1378,21 @@ bool EvaluateExpression(std::string expressionStr, float currentValue, float& ou
    if (input.startsWith("-="))
       input = input.replace("-=", "current_value-");
    
+   //the common cases are compiled once and cached, anything fancier goes through exprtk
+   static const std::vector<std::string> kVariables = { "current_value" };
+   std::shared_ptr<const CompiledExpression> compiled = CompiledExpression::Compile(input.toStdString(), kVariables);
+   if (compiled)
+   {
+      output = compiled->Evaluate(&currentValue);
+      return true;
+   }
+   
+   exprtk::symbol_table<float> symbolTable;
+   exprtk::expression<float> expression;
+   symbolTable.add_variable("current_value",currentValue);
+   symbolTable.add_constants();
+   expression.register_symbol_table(symbolTable);
+   
    exprtk::parser<float> parser;
    bool expressionValid = parser.compile(input.toStdString(), expression);
    if (expressionValid)
@@ -1549,12 +1560,14 @@ void DumpUnfreedMemory()
 #undef new
 void* operator new(std::size_t size) throw(std::bad_alloc)
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_Allocation, "new", size);
    void *ptr = (void*)malloc(size);
    //AddTrack((uint32)ptr, size, "<unknown>", 0);
    return(ptr);
 }
 void* operator new(std::size_t size, const char *file, int line) throw(std::bad_alloc)
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_Allocation, "new", size);
    void *ptr = (void*)malloc(size);
    AddTrack((uint32)ptr, size, file, line);
    return(ptr);
@@ -1566,12 +1579,14 @@ void operator delete(void* p) throw()
 }
 void* operator new[](std::size_t size) throw(std::bad_alloc)
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_Allocation, "new[]", size);
    void *ptr = (void*)malloc(size);
    //AddTrack((uint32)ptr, size, "<unknown>", 0);
    return(ptr);
 }
 void* operator new[](std::size_t size, const char *file, int line) throw(std::bad_alloc)
 {
+   RealtimeSafetyChecker::Check(kRealtimeViolation_Allocation, "new[]", size);
    void* ptr = (void*)malloc(size);
    AddTrack((uint32)ptr, size, file, line);
    return(ptr);
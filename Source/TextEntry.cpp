@@ -161,6 +161,7 @@ void TextEntry::Render()
    ofRect(mX + xOffset,mY,w - xOffset,h);
 
    gFontFixedWidth.DrawString(mString, 14, mX+2+xOffset, mY+12);
+   mLastDisplayedString = mString;
    
    if (IKeyboardFocusListener::GetActiveKeyboardFocus() == this)
    {
@@ -500,6 +501,18 @@ void TextEntry::UpdateDisplayString()
       StringCopy(mString, ofToString(*mVarFloat).c_str(), MAX_TEXTENTRY_LENGTH);
 }
 
+bool TextEntry::CheckNeedsDraw()
+{
+   if (IUIControl::CheckNeedsDraw())
+      return true;
+   
+   if (IKeyboardFocusListener::GetActiveKeyboardFocus() == this)
+      return true;
+   
+   UpdateDisplayString();
+   return mLastDisplayedString != mString;
+}
+
 void TextEntry::ClearInput()
 {
    std::memset(mString, 0, MAX_TEXTENTRY_LENGTH);
@@ -81,7 +81,7 @@ public:
    void RemoveSelectedText();
    void SetNextTextEntry(TextEntry* entry);
    void UpdateDisplayString();
-   void SetInErrorMode(bool error) { mInErrorMode = error; }
+   void SetInErrorMode(bool error) { if (error != mInErrorMode) MarkNeedsDraw(); mInErrorMode = error; }
    void DrawLabel(bool draw) { mDrawLabel = draw; }
    void SetRequireEnter(bool require) { mRequireEnterToAccept = require; }
    void SetFlexibleWidth(bool flex) { mFlexibleWidth = flex; }
@@ -99,6 +99,7 @@ public:
    bool IsSliderControl() override { return false; }
    bool IsButtonControl() override { return false; }
    bool IsTextEntry() const override { return true; }
+   bool CheckNeedsDraw() override;
    
 protected:
    ~TextEntry();   //protected so that it can't be created on the stack
@@ -138,6 +139,7 @@ private:
    bool mFlexibleWidth;
    bool mHovered;
    bool mRequireEnterToAccept;
+   std::string mLastDisplayedString;
 };
 
 #endif /* defined(__modularSynth__TextEntry__) */
@@ -407,6 +407,8 @@ void TitleBar::DrawModule()
    std::string stats;
    stats += "fps:" + ofToString(ofGetFrameRate(),0);
    stats += "  audio cpu:" + ofToString(usage * 100,1);
+   if (TheSynth->GetRenderCache()->IsEnabled())
+      stats += "  cached:" + ofToString(TheSynth->GetRenderCache()->GetNumHits()) + " redrawn:" + ofToString(TheSynth->GetRenderCache()->GetNumRedraws());
    if (usage > 1)
       ofSetColor(255,150,150);
    else
@@ -29,12 +29,52 @@
 #include "ChaosEngine.h"
 #include "FillSaveDropdown.h"
 
+#include <algorithm>
+#include <functional>
+
 Transport* TheTransport = nullptr;
 
 //statics
 bool Transport::sDoEventLookahead = false;
 double Transport::sEventEarlyMs = 150;
 
+namespace
+{
+   const double kNeverSteps = std::numeric_limits<double>::max();
+}
+
+void TransportListenerInfo::SetInterval(NoteInterval interval)
+{
+   if (interval == mInterval)
+      return;
+   mInterval = interval;
+   TheTransport->MarkNeedsSchedule(this);
+}
+
+void TransportListenerInfo::SetOffsetInfo(OffsetInfo offsetInfo)
+{
+   if (offsetInfo.mOffset == mOffsetInfo.mOffset && offsetInfo.mOffsetIsInMs == mOffsetInfo.mOffsetIsInMs)
+      return;
+   mOffsetInfo = offsetInfo;
+   TheTransport->MarkNeedsSchedule(this);
+}
+
+void TransportListenerInfo::SetUseEventLookahead(bool useEventLookahead)
+{
+   if (useEventLookahead == mUseEventLookahead)
+      return;
+   mUseEventLookahead = useEventLookahead;
+   TheTransport->MarkNeedsSchedule(this);
+}
+
+void TransportListenerInfo::SetCustomDivisor(int divisor)
+{
+   if (divisor == mCustomDivisor)
+      return;
+   mCustomDivisor = divisor;
+   TheTransport->MarkNeedsSchedule(this);
+}
+
 Transport::Transport()
 : mTempo(gDefaultTempo)
 , mTimeSigTop(4)
@@ -57,6 +97,21 @@ Transport::Transport()
 , mTempoSlider(nullptr)
 , mLoopStartMeasure(-1)
 , mLoopEndMeasure(-1)
+, mControlRate(1)
+, mControlRateDropdown(nullptr)
+, mFiringListener(nullptr)
+, mScheduledTempo(0)
+, mScheduledTimeSigTop(0)
+, mScheduledTimeSigBottom(0)
+, mScheduledSwing(0)
+, mScheduledSwingInterval(0)
+, mScheduledMeasureTime(0)
+, mScheduledJumpMs(0)
+, mScheduledLookaheadMs(0)
+, mScheduleDirty(true)
+, mListenersNeedSchedule(false)
+, mControlRatePendingAmount(0)
+, mControlRatePendingSamples(0)
 {
    assert(TheTransport == nullptr);
    TheTransport = this;
@@ -78,6 +133,7 @@ void Transport::CreateUIControls()
    mNudgeBackButton = new ClickButton(this," < ",80,78);
    mNudgeForwardButton = new ClickButton(this," > ",110,78);
    mSetTempoCheckbox = new Checkbox(this,"set tempo",HIDDEN_UICONTROL,HIDDEN_UICONTROL,&mSetTempoBool);
+   mControlRateDropdown = new DropdownList(this,"control rate",5,101,&mControlRate);
    
    mTimeSigTopDropdown->AddLabel("2", 2);
    mTimeSigTopDropdown->AddLabel("3", 3);
@@ -106,6 +162,14 @@ void Transport::CreateUIControls()
    mSwingIntervalDropdown->AddLabel("4n", 4);
    mSwingIntervalDropdown->AddLabel("8n", 8);
    mSwingIntervalDropdown->AddLabel("16n", 16);
+   
+   mControlRateDropdown->AddLabel("off", 1);
+   mControlRateDropdown->AddLabel("8", 8);
+   mControlRateDropdown->AddLabel("16", 16);
+   mControlRateDropdown->AddLabel("32", 32);
+   mControlRateDropdown->AddLabel("64", 64);
+   mControlRateDropdown->AddLabel("128", 128);
+   mControlRateDropdown->AddLabel("256", 256);
 }
 
 void Transport::Init()
@@ -129,10 +193,16 @@ void Transport::Advance(double ms)
    
    assert(amount > 0);
    
+   if (mMeasureTime != mScheduledMeasureTime)
+      mScheduleDirty = true;  //the playhead was moved since the last buffer
+   
    mMeasureTime += amount;
    
    if (mLoopStartMeasure != -1 && (GetMeasure(gTime) < mLoopStartMeasure || GetMeasure(gTime) >= mLoopEndMeasure))
+   {
       SetMeasure(mLoopStartMeasure);
+      mScheduleDirty = true;
+   }
    
    if (TheChaosEngine)
       TheChaosEngine->AudioUpdate();
@@ -144,6 +214,17 @@ void Transport::Advance(double ms)
       IAudioPoller* poller = *i;
       poller->OnTransportAdvanced(amount);
    }
+   
+   //control rate pollers only get advanced once enough buffers have passed to cover the control rate
+   mControlRatePendingAmount += amount;
+   mControlRatePendingSamples += gBufferSize;
+   if (mControlRatePendingSamples >= mControlRate)
+   {
+      for (auto* poller : mControlRatePollers)
+         poller->OnTransportAdvanced(mControlRatePendingAmount);
+      mControlRatePendingAmount = 0;
+      mControlRatePendingSamples = 0;
+   }
 }
 
 float QuadraticBezier (float x, float a, float b)
@@ -187,6 +268,27 @@ double Transport::SwingBeat(double pos)
    return pos;
 }
 
+double Transport::InverseSwing(double pos)
+{
+   double swingSlices = double(mSwingInterval) * mTimeSigTop / 4.0;
+   
+   double swungPos = pos * swingSlices;
+   int swingBeat = int(swungPos);
+   swungPos -= swingBeat;
+   
+   return (swingBeat + InverseSwingBeat(swungPos)) / swingSlices;
+}
+
+double Transport::InverseSwingBeat(double pos)
+{
+   //solve SwingBeat()'s quadratic for its input
+   double swingDouble = mSwing;
+   double term = (.5 - swingDouble) / (swingDouble*swingDouble - swingDouble);
+   if (fabs(term) < 1e-9)
+      return pos;
+   return (sqrt((1-term)*(1-term) + 4*term*pos) - (1-term)) / (2*term);
+}
+
 void Transport::Nudge(double amount)
 {
    mMeasureTime += amount;
@@ -208,6 +310,7 @@ void Transport::DrawModule()
    ofPushStyle();
    float w,h;
    GetDimensions(w,h);
+   h = 100; //the control rate dropdown sits below the timeline
    ofFill();
    ofSetColor(255,255,255,50);
    float beatWidth = w/mTimeSigTop;
@@ -225,6 +328,7 @@ void Transport::DrawModule()
    mTimeSigTopDropdown->Draw();
    mTimeSigBottomDropdown->Draw();
    mSwingIntervalDropdown->Draw();
+   mControlRateDropdown->Draw();
    mNudgeBackButton->Draw();
    mNudgeForwardButton->Draw();
    mIncreaseTempoButton->Draw();
@@ -274,16 +378,18 @@ TransportListenerInfo* Transport::AddListener(ITimeListener* listener, NoteInter
    TransportListenerInfo* info = GetListenerInfo(listener);
    if (info != nullptr)
    {
-      info->mInterval = interval;
-      info->mOffsetInfo = offsetInfo;
-      info->mUseEventLookahead = useEventLookahead;
+      info->SetInterval(interval);
+      info->SetOffsetInfo(offsetInfo);
+      info->SetUseEventLookahead(useEventLookahead);
    }
    else
    {
-      mListeners.push_front(TransportListenerInfo(listener, interval, offsetInfo, useEventLookahead));
+      mListeners.emplace_front(listener, interval, offsetInfo, useEventLookahead);
+      info = &mListeners.front();
+      MarkNeedsSchedule(info);
    }
 
-   return GetListenerInfo(listener);
+   return info;
 }
 
 TransportListenerInfo* Transport::GetListenerInfo(ITimeListener* listener)
@@ -303,9 +409,20 @@ void Transport::RemoveListener(ITimeListener* listener)
    {
       TransportListenerInfo& info = *i;
       if (info.mListener == listener)
+      {
+         if (mFiringListener == &info)
+            mFiringListener = nullptr;
+         TransportListenerInfo* removed = &info;
+         mScheduledEvents.erase(std::remove_if(mScheduledEvents.begin(), mScheduledEvents.end(),
+                                               [removed](const ScheduledEvent& event) { return event.mInfo == removed; }),
+                                mScheduledEvents.end());
+         std::make_heap(mScheduledEvents.begin(), mScheduledEvents.end(), std::greater<ScheduledEvent>());
          i = mListeners.erase(i);
+      }
       else
+      {
          ++i;
+      }
    }
 }
 
@@ -318,23 +435,27 @@ void Transport::AddAudioPoller(IAudioPoller* poller)
       assert(module->IsInitialized());
 #endif
 
-   if (!ListContains(poller, mAudioPollers))
-      mAudioPollers.push_front(poller);
+   std::list<IAudioPoller*>& pollers = poller->IsControlRate() ? mControlRatePollers : mAudioPollers;
+   if (!ListContains(poller, pollers))
+      pollers.push_front(poller);
 }
 
 void Transport::RemoveAudioPoller(IAudioPoller* poller)
 {
    mAudioPollers.remove(poller);
+   mControlRatePollers.remove(poller);
 }
 
-int Transport::GetQuantized(double time, const TransportListenerInfo* listenerInfo, double* remainderMs /*=nullptr*/)
+double Transport::GetOffsetMs(const TransportListenerInfo* listenerInfo) const
 {
-   double offsetMs;
    if (listenerInfo->mOffsetInfo.mOffsetIsInMs)
-      offsetMs = listenerInfo->mOffsetInfo.mOffset;
-   else
-      offsetMs = listenerInfo->mOffsetInfo.mOffset*MsPerBar();
-   time += offsetMs;
+      return listenerInfo->mOffsetInfo.mOffset;
+   return listenerInfo->mOffsetInfo.mOffset*MsPerBar();
+}
+
+int Transport::GetQuantized(double time, const TransportListenerInfo* listenerInfo, double* remainderMs /*=nullptr*/)
+{
+   time += GetOffsetMs(listenerInfo);
 
    int measure = GetMeasure(time);
    double measurePos = GetMeasurePos(time);
@@ -461,11 +582,7 @@ int Transport::GetStepsPerMeasure(ITimeListener* listener)
 
 int Transport::GetSyncedStep(double time, ITimeListener* listener, const TransportListenerInfo* listenerInfo, int length)
 {
-   double offsetMs;
-   if (listenerInfo->mOffsetInfo.mOffsetIsInMs)
-      offsetMs = listenerInfo->mOffsetInfo.mOffset;
-   else
-      offsetMs = listenerInfo->mOffsetInfo.mOffset*MsPerBar();
+   double offsetMs = GetOffsetMs(listenerInfo);
    
    int step;
    if (GetMeasureFraction(listenerInfo->mInterval) < 1)
@@ -546,38 +663,196 @@ double Transport::GetMeasureFraction(NoteInterval interval)
 
 void Transport::UpdateListeners(double jumpMs)
 {
+   if (mScheduleDirty || TransportChangedSinceSchedule() || jumpMs != mScheduledJumpMs || GetEventLookaheadMs() != mScheduledLookaheadMs)
+      RescheduleAll(jumpMs, false);
+   mScheduledMeasureTime = mMeasureTime;
+   
+   //new listeners, and listeners whose modules changed their interval/offset since the last buffer.
+   //the flag is cleared before looking, so a change that comes in during the walk is picked up next buffer
+   if (mListenersNeedSchedule.exchange(false, std::memory_order_acquire))
+   {
+      for (auto& info : mListeners)
+      {
+         if (info.mNeedsSchedule.load(std::memory_order_acquire))
+            ScheduleListener(info, MAX(gTime + GetListenerLookaheadMs(info) - jumpMs, info.mLastEventTime));
+      }
+   }
+   
+   //fire every step that lands in this buffer (or in its lookahead window), in time order
+   while (!mScheduledEvents.empty() && mScheduledEvents.front().mFireTime <= gTime)
+   {
+      ScheduledEvent event = mScheduledEvents.front();
+      std::pop_heap(mScheduledEvents.begin(), mScheduledEvents.end(), std::greater<ScheduledEvent>());
+      mScheduledEvents.pop_back();
+      
+      TransportListenerInfo* info = event.mInfo;
+      if (event.mSerial != info->mScheduleSerial)
+         continue;   //superseded by a reschedule
+      
+      if (info->mNeedsSchedule)
+      {
+         ScheduleListener(*info, MAX(gTime + GetListenerLookaheadMs(*info) - jumpMs, info->mLastEventTime));
+         continue;
+      }
+      
+      //nudge the time past the boundary, so that GetQuantized() at this time reports the new step
+      double time = event.mEventTime + .0001;
+      info->mLastEventTime = time;
+      mFiringListener = info;
+      info->mListener->OnTimeEvent(time);
+      if (mFiringListener == nullptr)
+         continue;   //the listener removed itself
+      mFiringListener = nullptr;
+      
+      if (TransportChangedSinceSchedule() || mMeasureTime != mScheduledMeasureTime)
+      {
+         //the event changed the transport, nothing already scheduled can be trusted
+         RescheduleAll(jumpMs, true);
+         mScheduledMeasureTime = mMeasureTime;
+      }
+      else if (info->mNeedsSchedule)
+      {
+         ScheduleListener(*info, info->mLastEventTime);
+      }
+      else
+      {
+         info->mNextBoundary = GetNextStepBoundary(*info, info->mNextBoundary);
+         PushScheduledEvent(*info);
+      }
+   }
+}
+
+bool Transport::TransportChangedSinceSchedule() const
+{
+   return mTempo != mScheduledTempo ||
+          mTimeSigTop != mScheduledTimeSigTop ||
+          mTimeSigBottom != mScheduledTimeSigBottom ||
+          mSwing != mScheduledSwing ||
+          mSwingInterval != mScheduledSwingInterval;
+}
+
+void Transport::RescheduleAll(double jumpMs, bool afterLastEvents)
+{
+   mScheduledTempo = mTempo;
+   mScheduledTimeSigTop = mTimeSigTop;
+   mScheduledTimeSigBottom = mTimeSigBottom;
+   mScheduledSwing = mSwing;
+   mScheduledSwingInterval = mSwingInterval;
+   mScheduledJumpMs = jumpMs;
+   mScheduledLookaheadMs = GetEventLookaheadMs();
+   mScheduleDirty = false;
+   
+   mScheduledEvents.clear();
    for (std::list<TransportListenerInfo>::iterator i = mListeners.begin(); i != mListeners.end(); ++i)
    {
-      const TransportListenerInfo& info = *i;
-      if (info.mInterval != kInterval_None &&
-          info.mInterval != kInterval_Free)
-      {         
-         double lookaheadMs = jumpMs;
-         if (info.mUseEventLookahead)
-            lookaheadMs = MAX(lookaheadMs, GetEventLookaheadMs());
-         
-         double checkTime = gTime + lookaheadMs;
-         
-         double remainderMs;
-         int oldStep = GetQuantized(checkTime - jumpMs, &info);
-         int newStep = GetQuantized(checkTime, &info, &remainderMs);
-         if (oldStep != newStep)
+      //start from the beginning of this buffer's window. if we're in the middle of firing, don't repeat
+      //events that already went out, otherwise a listener that moves the playhead could retrigger itself forever
+      TransportListenerInfo& info = *i;
+      double fromTime = gTime + GetListenerLookaheadMs(info) - jumpMs;
+      if (afterLastEvents)
+         fromTime = MAX(fromTime, info.mLastEventTime);
+      ScheduleListener(info, fromTime);
+   }
+}
+
+void Transport::MarkNeedsSchedule(TransportListenerInfo* info)
+{
+   //no locking, the setters are called from the ui thread while the audio thread is scheduling.
+   //the listener's flag has to be visible before the transport's, so the audio thread can't miss it
+   info->mNeedsSchedule.store(true, std::memory_order_release);
+   mListenersNeedSchedule.store(true, std::memory_order_release);
+}
+
+void Transport::ScheduleListener(TransportListenerInfo& info, double fromTime)
+{
+   //cleared before the settings are read, so a change made while we schedule sets it again
+   info.mNeedsSchedule.exchange(false, std::memory_order_acq_rel);
+   ++info.mScheduleSerial;
+   
+   if (info.mInterval == kInterval_None || info.mInterval == kInterval_Free)
+      return;
+   
+   info.mNextBoundary = GetNextStepBoundary(info, GetMeasureTime(fromTime + GetOffsetMs(&info)));
+   PushScheduledEvent(info);
+}
+
+void Transport::PushScheduledEvent(TransportListenerInfo& info)
+{
+   if (info.mNextBoundary == kNeverSteps)
+      return;
+   
+   ScheduledEvent event;
+   event.mEventTime = gTime + (info.mNextBoundary - mMeasureTime) * MsPerBar() - GetOffsetMs(&info);
+   event.mFireTime = event.mEventTime - GetListenerLookaheadMs(info);
+   event.mInfo = &info;
+   event.mSerial = info.mScheduleSerial;
+   mScheduledEvents.push_back(event);
+   std::push_heap(mScheduledEvents.begin(), mScheduledEvents.end(), std::greater<ScheduledEvent>());
+}
+
+//returns the first measure time after measureTime at which GetQuantized() would move to a new step
+double Transport::GetNextStepBoundary(const TransportListenerInfo& info, double measureTime)
+{
+   int measure = (int)floor(measureTime);
+   double stepsPerMeasure;
+   switch (info.mInterval)
+   {
+      case kInterval_1n:
+      case kInterval_2:
+      case kInterval_3:
+      case kInterval_4:
+      case kInterval_8:
+      case kInterval_16:
+      case kInterval_32:
+      case kInterval_64:
+      {
+         //integer division, to match GetQuantized()
+         int measuresPerStep = (int)GetMeasureFraction(info.mInterval);
+         for (int next = measure + 1; next <= measure + measuresPerStep * 2 + 1; ++next)
          {
-            double time = checkTime - remainderMs + .0001;  //TODO(Ryan) investigate this fudge number. I would think that subtracting remainderMs from checkTime would give me a number that gives me the same GetQuantized() result with a zero remainder, but sometimes it is just short of the correct quantization
-            /*ofLog() << oldStep << " " << newStep << " " << remainderMs << " " << jumpMs << " " << checkTime << " " << time << " " << GetQuantized(checkTime, info.mInterval) << " " << GetQuantized(time, info.mInterval);
-            if (GetQuantized(checkTime + offsetMs, info.mInterval) != GetQuantized(time + offsetMs, info.mInterval))
-            {
-               double aboveRemainderMs;
-               GetQuantized(checkTime + offsetMs, info.mInterval, &aboveRemainderMs);
-               double remainderShouldBeZeroMs;
-               GetQuantized(time + offsetMs, info.mInterval, &remainderShouldBeZeroMs);
-               ofLog() << remainderShouldBeZeroMs;
-            }*/
-            //assert(GetQuantized(checkTime + offsetMs, info.mInterval) == GetQuantized(time + offsetMs, info.mInterval));
-            info.mListener->OnTimeEvent(time);
+            if (next / measuresPerStep != (next - 1) / measuresPerStep)
+               return next;
          }
+         return kNeverSteps;
       }
+      case kInterval_2n:
+      case kInterval_2nt:
+      case kInterval_4n:
+      case kInterval_4nt:
+      case kInterval_8n:
+      case kInterval_8nt:
+      case kInterval_16n:
+      case kInterval_16nt:
+      case kInterval_32n:
+      case kInterval_32nt:
+      case kInterval_64n:
+         stepsPerMeasure = CountInStandardMeasure(info.mInterval) * double(mTimeSigTop) / mTimeSigBottom;
+         break;
+      case kInterval_CustomDivisor:
+         stepsPerMeasure = info.mCustomDivisor;
+         break;
+      default:
+         return kNeverSteps;
    }
+   
+   if (stepsPerMeasure <= 1)
+      return kNeverSteps;  //a single step per measure never changes value
+   
+   double measurePos = measureTime - measure;
+   for (int step = (int)(Swing(measurePos) * stepsPerMeasure) + 1; step < stepsPerMeasure; ++step)
+   {
+      double boundary = measure + InverseSwing(step / stepsPerMeasure);
+      if (boundary > measureTime)
+         return boundary;
+   }
+   return measure + 1;
+}
+
+double Transport::GetListenerLookaheadMs(const TransportListenerInfo& info) const
+{
+   if (info.mUseEventLookahead)
+      return MAX(mScheduledJumpMs, mScheduledLookaheadMs);
+   return mScheduledJumpMs;
 }
 
 void Transport::OnDrumEvent(NoteInterval drumEvent)
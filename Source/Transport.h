@@ -26,7 +26,10 @@
 #ifndef __modularSynth__Transport__
 #define __modularSynth__Transport__
 
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <vector>
 #include "IDrawableModule.h"
 #include "Slider.h"
 #include "ClickButton.h"
@@ -81,13 +84,26 @@ struct OffsetInfo
 struct TransportListenerInfo
 {
    TransportListenerInfo(ITimeListener* listener, NoteInterval interval, OffsetInfo offsetInfo, bool useEventLookahead)
-   : mListener(listener), mInterval(interval), mOffsetInfo(offsetInfo), mUseEventLookahead(useEventLookahead), mCustomDivisor(8) {}
+   : mListener(listener), mInterval(interval), mOffsetInfo(offsetInfo), mUseEventLookahead(useEventLookahead), mCustomDivisor(8)
+   , mNextBoundary(0), mLastEventTime(-std::numeric_limits<double>::max()), mScheduleSerial(0), mNeedsSchedule(false) {}
+   
+   //listeners registered with the transport must be changed through these, so that their next event gets rescheduled
+   void SetInterval(NoteInterval interval);
+   void SetOffsetInfo(OffsetInfo offsetInfo);
+   void SetUseEventLookahead(bool useEventLookahead);
+   void SetCustomDivisor(int divisor);
    
    ITimeListener* mListener;
    NoteInterval mInterval;
    OffsetInfo mOffsetInfo;
    bool mUseEventLookahead;
    int mCustomDivisor;
+   
+   //scheduler state, owned by Transport
+   double mNextBoundary;   //in measures, with the offset applied
+   double mLastEventTime;
+   unsigned int mScheduleSerial;
+   std::atomic<bool> mNeedsSchedule;   //set from whichever thread changes the settings above, cleared by the audio thread
 };
 
 class Transport : public IDrawableModule, public IButtonListener, public IFloatSliderListener, public IDropdownListener
@@ -133,6 +149,9 @@ public:
    
    double GetEventLookaheadMs() { return sDoEventLookahead ? sEventEarlyMs : 0; }
    
+   //how many samples apart modulation is evaluated, 1 is every sample. saved with the patch
+   int GetControlRate() const { return mControlRate; }
+   
    //IDrawableModule
    void Init() override;
    void KeyPressed(int key, bool isRepeat) override;
@@ -151,8 +170,29 @@ public:
    static bool sDoEventLookahead;
    static double sEventEarlyMs;
    
+   //called when a registered listener's interval or offset changes, from any thread
+   void MarkNeedsSchedule(TransportListenerInfo* info);
+
 private:
+   struct ScheduledEvent
+   {
+      bool operator>(const ScheduledEvent& other) const { return mFireTime > other.mFireTime; }
+      double mFireTime;   //event time minus the listener's lookahead
+      double mEventTime;
+      TransportListenerInfo* mInfo;
+      unsigned int mSerial;
+   };
+   
    void UpdateListeners(double jumpMs);
+   bool TransportChangedSinceSchedule() const;
+   void RescheduleAll(double jumpMs, bool afterLastEvents);
+   void ScheduleListener(TransportListenerInfo& info, double fromTime);
+   void PushScheduledEvent(TransportListenerInfo& info);
+   double GetNextStepBoundary(const TransportListenerInfo& info, double measureTime);
+   double GetListenerLookaheadMs(const TransportListenerInfo& info) const;
+   double GetOffsetMs(const TransportListenerInfo* listenerInfo) const;
+   double InverseSwing(double pos);
+   double InverseSwingBeat(double pos);
    double Swing(double measurePos);
    double SwingBeat(double pos);
    void Nudge(double amount);
@@ -160,7 +200,7 @@ private:
 
    //IDrawableModule
    void DrawModule() override;
-   void GetModuleDimensions(float& width, float& height) override { width = 140; height = 100; }
+   void GetModuleDimensions(float& width, float& height) override { width = 140; height = 118; }
    bool Enabled() const override { return true; }
    
    float mTempo;
@@ -184,9 +224,28 @@ private:
    FloatSlider* mTempoSlider;
    int mLoopStartMeasure;
    int mLoopEndMeasure;
+   int mControlRate;
+   DropdownList* mControlRateDropdown;
 
    std::list<TransportListenerInfo> mListeners;
+   std::atomic<bool> mListenersNeedSchedule;   //some listener has mNeedsSchedule set, so the next buffer has to look for it
+   
+   //min-heap of each listener's next event, so a buffer only costs as much as the events that land in it
+   std::vector<ScheduledEvent> mScheduledEvents;
+   TransportListenerInfo* mFiringListener;
+   float mScheduledTempo;
+   int mScheduledTimeSigTop;
+   int mScheduledTimeSigBottom;
+   float mScheduledSwing;
+   int mScheduledSwingInterval;
+   double mScheduledMeasureTime;
+   double mScheduledJumpMs;
+   double mScheduledLookaheadMs;
+   bool mScheduleDirty;
    std::list<IAudioPoller*> mAudioPollers;
+   std::list<IAudioPoller*> mControlRatePollers;
+   double mControlRatePendingAmount;
+   int mControlRatePendingSamples;
 };
 
 extern Transport* TheTransport;
@@ -57,6 +57,7 @@ public:
    int GetRows() { return mRows; }
    int GetCols() { return mCols; }
    void Render() override;
+   bool CheckNeedsDraw() override { return true; }
    void MouseReleased() override;
    bool MouseMoved(float x, float y) override;
    bool MouseScrolled(int x, int y, float scrollX, float scrollY) override;
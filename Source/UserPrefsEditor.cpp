@@ -51,6 +51,7 @@ void UserPrefsEditor::CreateUIControls()
    DROPDOWN(mAudioInputDeviceDropdown, "audio_input_device", &mAudioInputDeviceIndex, 350);
    DROPDOWN(mSampleRateDropdown, "samplerate", &mSampleRateIndex, 100);
    DROPDOWN(mBufferSizeDropdown, "buffersize", &mBufferSizeIndex, 100);
+   DROPDOWN(mBlockSizeDropdown, "blocksize", &mBlockSize, 100);
    TEXTENTRY_NUM(mWindowWidthEntry, "width", 5, &mWindowWidth, 1, 10000);
    TEXTENTRY_NUM(mWindowHeightEntry, "height", 5, &mWindowHeight, 1, 10000);
    CHECKBOX(mSetWindowPositionCheckbox, "set position", &mSetWindowPosition);
@@ -62,7 +63,8 @@ void UserPrefsEditor::CreateUIControls()
    FLOATSLIDER(mScrollMultiplierHorizontalSlider, "scroll_multiplier_horizontal", &mScrollMultiplierHorizontal, -2, 2);
    CHECKBOX(mAutosaveCheckbox, "autosave", &mAutosave);
    TEXTENTRY(mRecordingsPathEntry, "recordings_path", 70, &mRecordingsPath);
-   TEXTENTRY_NUM(mRecordBufferLengthEntry, "record_buffer_length_minutes", 5, &mRecordBufferLengthMinutes, 1, 120);
+   TEXTENTRY_NUM(mRecordBufferLengthEntry, "record_buffer_length_minutes", 5, &mRecordBufferLengthMinutes, 1, 1440);
+   CHECKBOX(mRecordBufferToDiskCheckbox, "record_buffer_to_disk", &mRecordBufferToDisk);
    TEXTENTRY(mTooltipsFilePathEntry, "tooltips", 100, &mTooltipsFilePath);
    TEXTENTRY(mDefaultLayoutPathEntry, "layout", 100, &mDefaultLayoutPath);
    TEXTENTRY(mYoutubeDlPathEntry, "youtube-dl_path", 100, &mYoutubeDlPath);
@@ -76,6 +78,10 @@ void UserPrefsEditor::CreateUIControls()
    mWidth = 1150;
 
 
+   mBlockSizeDropdown->AddLabel("buffersize", 0);
+   for (int blockSize = 16; blockSize <= 2048; blockSize *= 2)
+      mBlockSizeDropdown->AddLabel(ofToString(blockSize), blockSize);
+
    mZoomSlider->SetShowName(false);
    mUIScaleSlider->SetShowName(false);
    mScrollMultiplierVerticalSlider->SetShowName(false);
@@ -106,6 +112,11 @@ void UserPrefsEditor::Show()
       mWindowPositionY = 100;
    }
 
+   if (TheSynth->GetUserPrefs()["blocksize"].isNull())
+      mBlockSize = 0;
+   else
+      mBlockSize = TheSynth->GetUserPrefs()["blocksize"].asInt();
+
    if (TheSynth->GetUserPrefs()["zoom"].isNull())
       mZoom = 1;
    else
@@ -141,6 +152,11 @@ void UserPrefsEditor::Show()
    else
       mRecordBufferLengthMinutes = TheSynth->GetUserPrefs()["record_buffer_length_minutes"].asDouble();
 
+   if (TheSynth->GetUserPrefs()["record_buffer_to_disk"].isNull())
+      mRecordBufferToDisk = false;
+   else
+      mRecordBufferToDisk = TheSynth->GetUserPrefs()["record_buffer_to_disk"].asBool();
+
    if (TheSynth->GetUserPrefs()["tooltips"].isNull())
       mTooltipsFilePath = "tooltips_eng.txt";
    else
@@ -335,7 +351,7 @@ void UserPrefsEditor::UpdateDropdowns(std::vector<DropdownList*> toUpdate)
       for (auto bufferSize : selectedDevice->getAvailableBufferSizes())
       {
          mBufferSizeDropdown->AddLabel(ofToString(bufferSize), i);
-         if (bufferSize == gBufferSize)
+         if (bufferSize == setup.bufferSize)
             mBufferSizeIndex = i;
          ++i;
       }
@@ -380,6 +396,8 @@ void UserPrefsEditor::DrawModule()
          DrawRightLabel(mBufferSizeDropdown, "couldn't find any buffer sizes for this device, for some reason (is it plugged in?)", ofColor::yellow);
    }
 
+   DrawRightLabel(mBlockSizeDropdown, "(currently: " + ofToString(gBufferSize) + ", audio is processed in blocks of this size)", ofColor::white);
+
    DrawRightLabel(mWindowWidthEntry, "(currently: " + ofToString(ofGetWidth()) + ")", ofColor::white);
    DrawRightLabel(mWindowHeightEntry, "(currently: " + ofToString(ofGetHeight()) + ")", ofColor::white);
    if (mSetWindowPosition)
@@ -477,6 +495,10 @@ void UserPrefsEditor::ButtonClicked(ClickButton* button)
       UpdatePrefStr(userPrefs, "audio_input_device", mAudioInputDeviceDropdown->GetLabel(mAudioInputDeviceIndex));
       UpdatePrefInt(userPrefs, "samplerate", ofToInt(mSampleRateDropdown->GetLabel(mSampleRateIndex)));
       UpdatePrefInt(userPrefs, "buffersize", ofToInt(mBufferSizeDropdown->GetLabel(mBufferSizeIndex)));
+      if (mBlockSize > 0)
+         UpdatePrefInt(userPrefs, "blocksize", mBlockSize);
+      else
+         userPrefs.removeMember("blocksize");
       UpdatePrefInt(userPrefs, "width", mWindowWidth);
       UpdatePrefInt(userPrefs, "height", mWindowHeight);
       if (mSetWindowPosition)
@@ -496,6 +518,7 @@ void UserPrefsEditor::ButtonClicked(ClickButton* button)
       UpdatePrefBool(userPrefs, "autosave", mAutosave);
       UpdatePrefStr(userPrefs, "recordings_path", mRecordingsPath);
       UpdatePrefFloat(userPrefs, "record_buffer_length_minutes", mRecordBufferLengthMinutes);
+      UpdatePrefBool(userPrefs, "record_buffer_to_disk", mRecordBufferToDisk);
       UpdatePrefStr(userPrefs, "tooltips", mTooltipsFilePath);
       UpdatePrefStr(userPrefs, "layout", mDefaultLayoutPath);
       UpdatePrefStr(userPrefs, "youtube-dl_path", mYoutubeDlPath);
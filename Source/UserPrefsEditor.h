@@ -79,6 +79,8 @@ private:
    int mSampleRateIndex;
    DropdownList* mBufferSizeDropdown;
    int mBufferSizeIndex;
+   DropdownList* mBlockSizeDropdown;
+   int mBlockSize;
    DropdownList* mAudioOutputDeviceDropdown;
    int mAudioOutputDeviceIndex;
    DropdownList* mAudioInputDeviceDropdown;
@@ -107,6 +109,8 @@ private:
    std::string mRecordingsPath;
    TextEntry* mRecordBufferLengthEntry;
    float mRecordBufferLengthMinutes;
+   Checkbox* mRecordBufferToDiskCheckbox;
+   bool mRecordBufferToDisk;
    TextEntry* mTooltipsFilePathEntry;
    std::string mTooltipsFilePath;
    TextEntry* mDefaultLayoutPathEntry;
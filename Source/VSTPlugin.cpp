@@ -32,6 +32,7 @@
 #include "Profiler.h"
 #include "Scale.h"
 #include "ModulationChain.h"
+#include "Transport.h"
 //#include "NSWindowOverlay.h"
 
 namespace
@@ -180,6 +181,13 @@ VSTPlugin::VSTPlugin()
 , mDisplayMode(kDisplayMode_Sliders)
 , mShowParameterIndex(-1)
 , mTemporarilyDisplayedParamIndex(-1)
+, mExtraChannels(2, gBufferSize)
+, mChannelPointers(2, nullptr)
+, mNumQueuedParameterChanges(0)
+, mAnticipative(false)
+, mAnticipativeCheckbox(nullptr)
+, mCanAnticipate(false)
+, mAnticipatedBuffer(2, gBufferSize)
 {
    juce::File(ofToDataPath("vst")).createDirectory();
    juce::File(ofToDataPath("vst/presets")).createDirectory();
@@ -188,6 +196,12 @@ VSTPlugin::VSTPlugin()
       VSTLookup::sFormatManager.addDefaultFormats();
    
    mChannelModulations.resize(kGlobalModulationIdx+1);
+   
+   //so adding events on the audio thread doesn't allocate
+   const int kMidiBufferBytes = 8192;
+   mMidiBuffer.ensureSize(kMidiBufferBytes);
+   mFutureMidiBuffer.ensureSize(kMidiBufferBytes);
+   mAnticipatedMidiBuffer.ensureSize(kMidiBufferBytes);
 }
 
 void VSTPlugin::CreateUIControls()
@@ -195,6 +209,7 @@ void VSTPlugin::CreateUIControls()
    IDrawableModule::CreateUIControls();
    mVolSlider = new FloatSlider(this,"vol",3,3,80,15,&mVol,0,4);
    mOpenEditorButton = new ClickButton(this, "open", mVolSlider, kAnchor_Right_Padded);
+   mAnticipativeCheckbox = new Checkbox(this, "anticipative", mOpenEditorButton, kAnchor_Right_Padded, &mAnticipative);
    mPresetFileSelector = new DropdownList(this,"preset",3,21,&mPresetFileIndex,110);
    mSavePresetFileButton = new ClickButton(this,"save as",-1,-1);
    mShowParameterDropdown = new DropdownList(this,"show parameter",3,38,&mShowParameterIndex);
@@ -212,6 +227,8 @@ void VSTPlugin::CreateUIControls()
 
 VSTPlugin::~VSTPlugin()
 {
+   if (TheSynth)
+      TheSynth->GetAnticipativeRenderPool()->Forget(this);
 }
 
 void VSTPlugin::Exit()
@@ -225,7 +242,15 @@ void VSTPlugin::Exit()
 
 std::string VSTPlugin::GetTitleLabel()
 {
-   return "vst: "+GetPluginName();
+   std::string label = "vst: "+GetPluginName();
+   if (mAnticipative)
+   {
+      if (mCanAnticipate)
+         label += " (chain +" + ofToString(gBufferSize * 1000.0f / gSampleRate, 1) + "ms)";
+      else
+         label += " (live input, not anticipating)";
+   }
+   return label;
 }
 
 std::string VSTPlugin::GetPluginName()
@@ -358,6 +383,12 @@ void VSTPlugin::LoadVST(juce::PluginDescription desc)
       mNumInputs = MIN(mPlugin->getTotalNumInputChannels(), 4);
       mNumOutputs = MIN(mPlugin->getTotalNumOutputChannels(), 4);
       ofLog() << "vst inputs: " << mNumInputs << "  vst outputs: " << mNumOutputs;
+      
+      //processBlock() needs a channel for every input and output the plugin has, even ones the module doesn't use
+      int processChannels = MAX(2, MAX(mPlugin->getTotalNumInputChannels(), mPlugin->getTotalNumOutputChannels()));
+      mExtraChannels.setSize(processChannels, gBufferSize);
+      mAnticipatedBuffer.setSize(processChannels, gBufferSize);
+      mChannelPointers.assign(processChannels, nullptr);
 
       mPluginName = mPlugin->getName().toStdString();
 
@@ -425,7 +456,12 @@ void VSTPlugin::CreateParameterSliders()
 
 void VSTPlugin::Poll()
 {
-   if (mDisplayMode == kDisplayMode_Sliders)
+   mCanAnticipate = !TheSynth->IsAudioTarget(this);
+   if (mAnticipative)
+      TheSynth->GetAnticipativeRenderPool()->Start();
+   
+   //don't pull values back from the plugin while slider changes are still waiting for the audio thread, they'd be reverted
+   if (mDisplayMode == kDisplayMode_Sliders && mNumQueuedParameterChanges == 0)
    {
       for (int i=0; i<mParameterSliders.size(); ++i)
       {
@@ -447,6 +483,9 @@ void VSTPlugin::Poll()
 
 void VSTPlugin::Process(double time)
 {
+   mAudioThreadId = std::this_thread::get_id();
+   ApplyQueuedMidi();
+   
    if (!mPluginReady)
    {
       //bypass
@@ -474,25 +513,41 @@ void VSTPlugin::Process(double time)
    
    SyncBuffers();
    
-   const int kSafetyMaxChannels = 16; //hitting a crazy issue (memory stomp?) where numchannels is getting blown out sometimes
-   
    int bufferSize = GetBuffer()->BufferSize();
    assert(bufferSize == gBufferSize);
+   int numActiveChannels = GetBuffer()->NumActiveChannels();
    
-   juce::AudioBuffer<float> buffer(inputChannels, bufferSize);
-   for (int i=0; i<inputChannels && i < kSafetyMaxChannels; ++i)
-      buffer.copyFrom(i, 0, GetBuffer()->GetChannel(MIN(i,GetBuffer()->NumActiveChannels()-1)), GetBuffer()->BufferSize());
-
    IAudioReceiver* target = GetTarget();
    
-   if (mEnabled && mPlugin != nullptr)
+   bool processedInPlace = false;
+   bool anticipate = mAnticipative && mCanAnticipate && mEnabled;
+   bool playingAnticipated = false;
+   bool anticipated = AnticipativeRenderPool::IsSubmitted(this);
+   if (anticipated)
+      TheSynth->GetAnticipativeRenderPool()->Wait(this);  //pick up what a worker rendered while the last buffer played
+   
+   bool submit = false;
+   if (mPlugin != nullptr && mVSTMutex.try_lock())   //if the plugin is being loaded, skip it for this buffer rather than wait
    {
-      mVSTMutex.lock();
-
-      ComputeSliders(0);
-
+      int processChannels = (int)mChannelPointers.size();
+      
+      if (anticipated && anticipate)
       {
-         const juce::ScopedLock lock(mMidiInputLock);
+         for (int ch=0; ch<processChannels; ++ch)
+         {
+            if (ch < numActiveChannels)
+               BufferCopy(GetBuffer()->GetChannel(ch), mAnticipatedBuffer.getReadPointer(ch), bufferSize);
+            else
+               Add(GetBuffer()->GetChannel(numActiveChannels-1), mAnticipatedBuffer.getReadPointer(ch), bufferSize);
+         }
+         playingAnticipated = true;
+      }
+      
+      ApplyQueuedParameterChanges();
+      
+      if (mEnabled)
+      {
+         ComputeSliders(0);
          
          for (int i=0; i<mChannelModulations.size(); ++i)
          {
@@ -534,39 +589,129 @@ void VSTPlugin::Process(double time)
          mFutureMidiBuffer.addEvents(mMidiBuffer, gBufferSize, mMidiBuffer.getLastEventTime()-gBufferSize + 1, -gBufferSize);
          mMidiBuffer.clear(gBufferSize, mMidiBuffer.getLastEventTime() + 1);
          
-         mPlugin->processBlock(buffer, mMidiBuffer);
+         if (anticipate)
+         {
+            //the render is heard at the next buffer, so it gets the next buffer's midi. with event lookahead on, scheduled notes
+            //have already arrived for it and land on time. anything that only showed up for this buffer comes out a buffer late
+            mAnticipatedMidiBuffer.addEvents(mMidiBuffer, 0, gBufferSize, 0);
+            mAnticipatedMidiBuffer.addEvents(mFutureMidiBuffer, 0, gBufferSize, 0);
+            mFutureMidiBuffer.clear(0, gBufferSize);
+            submit = true;
+         }
+         else
+         {
+            //midi from an anticipated render that never got the plugin
+            if (!mAnticipatedMidiBuffer.isEmpty())
+            {
+               mMidiBuffer.addEvents(mAnticipatedMidiBuffer, 0, -1, 0);
+               mAnticipatedMidiBuffer.clear();
+            }
+            
+            for (int ch=0; ch<processChannels; ++ch)
+            {
+               if (ch < numActiveChannels)
+               {
+                  mChannelPointers[ch] = GetBuffer()->GetChannel(ch);
+               }
+               else
+               {
+                  mChannelPointers[ch] = mExtraChannels.getWritePointer(ch);
+                  BufferCopy(mChannelPointers[ch], GetBuffer()->GetChannel(numActiveChannels-1), bufferSize);
+               }
+            }
+            mProcessBuffer.setDataToReferTo(mChannelPointers.data(), processChannels, bufferSize);
+            
+            mPlugin->processBlock(mProcessBuffer, mMidiBuffer);
+            
+            //fold any output channels the module's buffer can't hold into its last one
+            int outputChannels = MIN(processChannels, MAX(2, mPlugin->getTotalNumOutputChannels()));
+            for (int ch=numActiveChannels; ch<outputChannels; ++ch)
+               Add(GetBuffer()->GetChannel(numActiveChannels-1), mChannelPointers[ch], bufferSize);
+            processedInPlace = true;
+         }
          
          mMidiBuffer.clear();
       }
       mVSTMutex.unlock();
+   }
    
-      GetBuffer()->Clear();
-      for (int ch=0; ch < buffer.getNumChannels() && ch < kSafetyMaxChannels; ++ch)
-      {
-         int outputChannel = MIN(ch,GetBuffer()->NumActiveChannels()-1);
-         for (int sampleIndex=0; sampleIndex < buffer.getNumSamples(); ++sampleIndex)
-         {
-            GetBuffer()->GetChannel(outputChannel)[sampleIndex] += buffer.getSample(ch, sampleIndex) * mVol;
-         }
-         if (target)
-            Add(target->GetBuffer()->GetChannel(outputChannel), GetBuffer()->GetChannel(outputChannel), bufferSize);
-         GetVizBuffer()->WriteChunk(GetBuffer()->GetChannel(outputChannel), bufferSize, outputChannel);
-      }
+   if (submit)
+      TheSynth->GetAnticipativeRenderPool()->Submit(this);
+   
+   if (!mEnabled)
+      mMidiBuffer.clear();
+   
+   if (processedInPlace || playingAnticipated)
+   {
+      for (int ch=0; ch<numActiveChannels; ++ch)
+         Mult(GetBuffer()->GetChannel(ch), mVol, bufferSize);
    }
-   else
+   
+   //when not processed, this is the bypass
+   for (int ch=0; ch<numActiveChannels; ++ch)
    {
-      //bypass
-      for (int ch=0; ch<GetBuffer()->NumActiveChannels(); ++ch)
-      {
-         if (target)
-            Add(target->GetBuffer()->GetChannel(ch), GetBuffer()->GetChannel(ch), GetBuffer()->BufferSize());
-         GetVizBuffer()->WriteChunk(GetBuffer()->GetChannel(ch),GetBuffer()->BufferSize(), ch);
-      }
+      if (target)
+         Add(target->GetBuffer()->GetChannel(ch), GetBuffer()->GetChannel(ch), bufferSize);
+      GetVizBuffer()->WriteChunk(GetBuffer()->GetChannel(ch), bufferSize, ch);
    }
 
    GetBuffer()->Clear();
 }
 
+void VSTPlugin::RenderAhead()
+{
+   //nothing is patched into us, so the input is silent. that's also what plays if the plugin is busy being loaded
+   mAnticipatedBuffer.clear();
+   if (mVSTMutex.try_lock())
+   {
+      if (mPlugin != nullptr)
+         mPlugin->processBlock(mAnticipatedBuffer, mAnticipatedMidiBuffer);
+      mAnticipatedMidiBuffer.clear();
+      mVSTMutex.unlock();
+   }
+   //otherwise the midi stays queued for the next render, so no note offs are lost
+}
+
+void VSTPlugin::ApplyQueuedMidi()
+{
+   QueuedMidiMessage queued;
+   while (mQueuedMidi.consume(queued))
+   {
+      int sampleNumber = MAX(0, int((queued.mTime - gTime) * gSampleRateMs));
+      mMidiBuffer.addEvent(queued.mMessage, sampleNumber);
+      if (queued.mModulationIdx != -1)
+         mChannelModulations[queued.mModulationIdx].mModulation = queued.mModulation;
+   }
+}
+
+void VSTPlugin::ApplyQueuedParameterChanges()
+{
+   QueuedParameterChange change;
+   while (mQueuedParameterChanges.consume(change))
+   {
+      if (change.mSliderIndex < (int)mParameterSliders.size())
+         mParameterSliders[change.mSliderIndex].mParameter->setValue(change.mValue);
+      --mNumQueuedParameterChanges;
+   }
+}
+
+void VSTPlugin::AddMidiMessage(const juce::MidiMessage& message, double time, int modulationIdx, const ModulationParameters& modulation)
+{
+   if (IsAudioThread())
+   {
+      int sampleNumber = (time - gTime) * gSampleRateMs;
+      //ofLog() << sampleNumber;
+      mMidiBuffer.addEvent(message, sampleNumber);
+      if (modulationIdx != -1)
+         mChannelModulations[modulationIdx].mModulation = modulation;
+   }
+   else
+   {
+      std::lock_guard<ofMutex> lock(mQueueWriteMutex);
+      mQueuedMidi.produce({ message, time, modulationIdx, modulation });
+   }
+}
+
 void VSTPlugin::PlayNote(double time, int pitch, int velocity, int voiceIdx, ModulationParameters modulation)
 {
    if (!mPluginReady || mPlugin == nullptr)
@@ -582,27 +727,20 @@ void VSTPlugin::PlayNote(double time, int pitch, int velocity, int voiceIdx, Mod
    if (voiceIdx == -1)
       channel = 1;
    
-   const juce::ScopedLock lock(mMidiInputLock);
-   
-   int sampleNumber = (time - gTime) * gSampleRateMs;
-   //ofLog() << sampleNumber;
+   int modIdx = voiceIdx;
+   if (voiceIdx == -1)
+      modIdx = kGlobalModulationIdx;
    
    if (velocity > 0)
    {
-      mMidiBuffer.addEvent(juce::MidiMessage::noteOn(mUseVoiceAsChannel ? channel : mChannel, pitch, (uint8)velocity), sampleNumber);
+      AddMidiMessage(juce::MidiMessage::noteOn(mUseVoiceAsChannel ? channel : mChannel, pitch, (uint8)velocity), time, modIdx, modulation);
       //ofLog() << "+ vst note on: " << (mUseVoiceAsChannel ? channel : mChannel) << " " << pitch << " " << (uint8)velocity;
    }
    else
    {
-      mMidiBuffer.addEvent(juce::MidiMessage::noteOff(mUseVoiceAsChannel ? channel : mChannel, pitch), sampleNumber);
+      AddMidiMessage(juce::MidiMessage::noteOff(mUseVoiceAsChannel ? channel : mChannel, pitch), time, modIdx, modulation);
       //ofLog() << "- vst note off: " << (mUseVoiceAsChannel ? channel : mChannel) << " " << pitch;
    }
-   
-   int modIdx = voiceIdx;
-   if (voiceIdx == -1)
-      modIdx = kGlobalModulationIdx;
-   
-   mChannelModulations[modIdx].mModulation = modulation;
 }
 
 void VSTPlugin::SendCC(int control, int value, int voiceIdx /*=-1*/)
@@ -617,9 +755,7 @@ void VSTPlugin::SendCC(int control, int value, int voiceIdx /*=-1*/)
    if (voiceIdx == -1)
       channel = 1;
    
-   const juce::ScopedLock lock(mMidiInputLock);
-   
-   mMidiBuffer.addEvent(juce::MidiMessage::controllerEvent((mUseVoiceAsChannel ? channel : mChannel), control, (uint8)value), 0);
+   AddMidiMessage(juce::MidiMessage::controllerEvent((mUseVoiceAsChannel ? channel : mChannel), control, (uint8)value), gTime, -1, ModulationParameters());
 }
 
 void VSTPlugin::SetEnabled(bool enabled)
@@ -654,6 +790,7 @@ void VSTPlugin::DrawModule()
    mPresetFileSelector->Draw();
    mSavePresetFileButton->Draw();
    mOpenEditorButton->Draw();
+   mAnticipativeCheckbox->Draw();
    mShowParameterDropdown->Draw();
    
    if (mDisplayMode == kDisplayMode_Sliders)
@@ -792,7 +929,16 @@ void VSTPlugin::FloatSliderUpdated(FloatSlider* slider, float oldVal)
    {
       if (mParameterSliders[i].mSlider == slider)
       {
-         mParameterSliders[i].mParameter->setValue(mParameterSliders[i].mValue);
+         if (IsAudioThread())
+         {
+            mParameterSliders[i].mParameter->setValue(mParameterSliders[i].mValue);
+         }
+         else
+         {
+            std::lock_guard<ofMutex> lock(mQueueWriteMutex);
+            ++mNumQueuedParameterChanges;
+            mQueuedParameterChanges.produce({ i, mParameterSliders[i].mValue });
+         }
       }
    }
 }
@@ -804,6 +950,8 @@ void VSTPlugin::IntSliderUpdated(IntSlider* slider, int oldVal)
 
 void VSTPlugin::CheckboxUpdated(Checkbox* checkbox)
 {
+   if (checkbox == mAnticipativeCheckbox && mAnticipative)
+      Transport::sDoEventLookahead = true;   //anticipative rendering needs notes a buffer early to stay in time
 }
 
 void VSTPlugin::ButtonClicked(ClickButton* button)
@@ -984,6 +1132,9 @@ void VSTPlugin::LoadState(FileStreamIn& in)
 {
    IDrawableModule::LoadState(in);
    
+   if (mAnticipative)
+      Transport::sDoEventLookahead = true;   //anticipative rendering needs notes a buffer early to stay in time
+   
    int rev;
    in >> rev;
    LoadStateValidate(rev <= kSaveStateRev);
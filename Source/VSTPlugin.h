@@ -38,6 +38,11 @@
 #include "ClickButton.h"
 #include "VSTPlayhead.h"
 #include "VSTWindow.h"
+#include "LockFreeQueue.h"
+#include "AnticipativeRenderPool.h"
+
+#include <atomic>
+#include <thread>
 
 #include "juce_audio_processors/juce_audio_processors.h"
 
@@ -51,7 +56,7 @@ namespace VSTLookup
    std::string GetVSTPath(std::string vstName);
 }
 
-class VSTPlugin : public IAudioProcessor, public INoteReceiver, public IDrawableModule, public IDropdownListener, public IFloatSliderListener, public IIntSliderListener, public IButtonListener
+class VSTPlugin : public IAudioProcessor, public INoteReceiver, public IDrawableModule, public IDropdownListener, public IFloatSliderListener, public IIntSliderListener, public IButtonListener, public AnticipativeRenderPool::Job
 {
 public:
    VSTPlugin();
@@ -106,6 +111,13 @@ private:
    std::string GetPluginId();
    void CreateParameterSliders();
    void RefreshPresetFiles();
+   bool IsAudioThread() const { return std::this_thread::get_id() == mAudioThreadId; }
+   void AddMidiMessage(const juce::MidiMessage& message, double time, int modulationIdx, const ModulationParameters& modulation);
+   void ApplyQueuedMidi();
+   void ApplyQueuedParameterChanges();
+   
+   //AnticipativeRenderPool::Job
+   void RenderAhead() override;
    
    float mVol;
    FloatSlider* mVolSlider;
@@ -123,7 +135,6 @@ private:
    std::unique_ptr<VSTWindow> mWindow;
    juce::MidiBuffer mMidiBuffer;
    juce::MidiBuffer mFutureMidiBuffer;
-   juce::CriticalSection mMidiInputLock;
    int mNumInputs;
    int mNumOutputs;
    
@@ -153,6 +164,39 @@ private:
    
    std::vector<ChannelModulations> mChannelModulations;
    
+   //the plugin processes the module's own channel memory in place. channels past what the module's buffer holds
+   //are backed by mExtraChannels. these are sized for the plugin's channel count when it's loaded
+   juce::AudioBuffer<float> mProcessBuffer;
+   juce::AudioBuffer<float> mExtraChannels;
+   std::vector<float*> mChannelPointers;
+   
+   //midi and parameter changes from threads other than the audio thread are queued, and applied at the start of the next Process()
+   struct QueuedMidiMessage
+   {
+      juce::MidiMessage mMessage;
+      double mTime;
+      int mModulationIdx;  //-1 if the message doesn't carry modulation
+      ModulationParameters mModulation;
+   };
+   struct QueuedParameterChange
+   {
+      int mSliderIndex;
+      float mValue;
+   };
+   std::thread::id mAudioThreadId;
+   LockFreeQueue<QueuedMidiMessage> mQueuedMidi;
+   LockFreeQueue<QueuedParameterChange> mQueuedParameterChanges;
+   std::atomic<int> mNumQueuedParameterChanges;
+   ofMutex mQueueWriteMutex;
+   
+   //in anticipative mode, each buffer's midi is rendered on a worker while the rest of the graph processes,
+   //and played at the next buffer. that's only possible if nothing is patched into our input
+   bool mAnticipative;
+   Checkbox* mAnticipativeCheckbox;
+   std::atomic<bool> mCanAnticipate;
+   juce::AudioBuffer<float> mAnticipatedBuffer;
+   juce::MidiBuffer mAnticipatedMidiBuffer;
+   
    ofMutex mVSTMutex;
    VSTPlayhead mPlayhead;
    
@@ -172,8 +172,8 @@ void VelocityStepSequencer::DropdownUpdated(DropdownList* list, int oldVal)
       TransportListenerInfo* transportListenerInfo = TheTransport->GetListenerInfo(this);
       if (transportListenerInfo != nullptr)
       {
-         transportListenerInfo->mInterval = mInterval;
-         transportListenerInfo->mOffsetInfo = OffsetInfo(-.1f, true);
+         transportListenerInfo->SetInterval(mInterval);
+         transportListenerInfo->SetOffsetInfo(OffsetInfo(-.1f, true));
       }
    }
 }
@@ -59,6 +59,7 @@ public:
 private:
    //IDrawableModule
    void DrawModule() override;
+   bool IsRenderCacheable() const override { return true; }
    void GetModuleDimensions(float& w, float& h) override { w=60; h=0; }
    bool Enabled() const override { return true; }
 
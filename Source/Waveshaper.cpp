@@ -51,6 +51,8 @@ Waveshaper::Waveshaper()
 , mDSlider(nullptr)
 , mE(0)
 , mESlider(nullptr)
+, mOversample(1)
+, mOversampleDropdown(nullptr)
 , mExpressionValid(false)
 {
    mEntryString = "x";
@@ -68,6 +70,9 @@ void Waveshaper::CreateUIControls()
    mCSlider = new FloatSlider(this,"c",mBSlider,kAnchor_Below,110,15,&mC,-10,10,4);
    mDSlider = new FloatSlider(this,"d",mCSlider,kAnchor_Below,110,15,&mD,-10,10,4);
    mESlider = new FloatSlider(this,"e",mDSlider,kAnchor_Below,110,15,&mE,-10,10,4);
+   mOversampleDropdown = new DropdownList(this,"oversample",mESlider,kAnchor_Below,&mOversample);
+   
+   Oversampler::AddFactorLabels(mOversampleDropdown);
    
    mSymbolTable.add_variable("x",mExpressionInput);
    mSymbolTable.add_variable("x1",mHistPre1);
@@ -122,16 +127,23 @@ void Waveshaper::Process(double time)
    {
       int bufferSize = GetBuffer()->BufferSize();
       
+      if (mOversampler.GetFactor() != mOversample)
+         mOversampler.SetFactor(mOversample);
+      const int factor = mOversampler.GetFactor();
+      const double invSampleRateMs = gInvSampleRateMs / factor;
+      
       ChannelBuffer* out = target->GetBuffer();
       for (int ch=0; ch<GetBuffer()->NumActiveChannels(); ++ch)
       {
          float* buffer = GetBuffer()->GetChannel(ch);
          if (mExpressionValid)
          {
-            for (int i=0; i<bufferSize; ++i)
+            //x1/x2/y1/y2 are the previous samples at the oversampled rate
+            float* samples = mOversampler.Upsample(buffer, bufferSize, ch);
+            for (int i=0; i<bufferSize*factor; ++i)
             {
-               ComputeSliders(i);
-               mExpressionInput = buffer[i] * mRescale;
+               ComputeSliders(i / factor);
+               mExpressionInput = samples[i] * mRescale;
                
                mHistPre1 = mBiquadState[ch].mHistPre1;
                mHistPre2 = mBiquadState[ch].mHistPre2;
@@ -143,14 +155,15 @@ void Waveshaper::Process(double time)
                if (mExpressionInput < min)
                   min = mExpressionInput;
                
-               mT = (gTime + i * gInvSampleRateMs) * .001;
-               buffer[i] = mExpression.value() / mRescale;
+               mT = (gTime + i * invSampleRateMs) * .001;
+               samples[i] = mExpression.value() / mRescale;
                
                mBiquadState[ch].mHistPre2 = mBiquadState[ch].mHistPre1;
                mBiquadState[ch].mHistPre1 = mExpressionInput;
                mBiquadState[ch].mHistPost2 = mBiquadState[ch].mHistPost1;
-               mBiquadState[ch].mHistPost1 = ofClamp(buffer[i], -1, 1); //keep feedback from spiraling out of control
+               mBiquadState[ch].mHistPost1 = ofClamp(samples[i], -1, 1); //keep feedback from spiraling out of control
             }
+            mOversampler.Downsample(buffer, bufferSize, ch);
          }
          Add(out->GetChannel(ch), buffer, bufferSize);
          GetVizBuffer()->WriteChunk(buffer, bufferSize, ch);
@@ -220,12 +233,13 @@ void Waveshaper::DrawModule()
    mCSlider->Draw();
    mDSlider->Draw();
    mESlider->Draw();
+   mOversampleDropdown->Draw();
 }
 
 void Waveshaper::GetModuleDimensions(float& w, float& h)
 {
    w = MAX(kGraphX + kGraphWidth + 2, 4 + mTextEntry->GetRect().width); 
-   h = kGraphY + kGraphHeight;
+   h = MAX(kGraphY + kGraphHeight, mOversampleDropdown->GetRect(K(local)).getMaxY() + 2);
 }
 
 void Waveshaper::LoadLayout(const ofxJSONElement& moduleInfo)
@@ -32,9 +32,11 @@
 #include "Slider.h"
 #include "ClickButton.h"
 #include "TextEntry.h"
+#include "DropdownList.h"
+#include "Oversampler.h"
 #include "exprtk/exprtk.hpp"
 
-class Waveshaper : public IAudioProcessor, public IDrawableModule, public IFloatSliderListener, public ITextEntryListener
+class Waveshaper : public IAudioProcessor, public IDrawableModule, public IFloatSliderListener, public ITextEntryListener, public IDropdownListener
 {
 public:
    Waveshaper();
@@ -54,6 +56,9 @@ public:
    //ITextEntryListener
    void TextEntryComplete(TextEntry* entry) override;
    
+   //IDropdownListener
+   void DropdownUpdated(DropdownList* list, int oldVal) override {}
+   
    virtual void LoadLayout(const ofxJSONElement& moduleInfo) override;
    virtual void SetUpFromSaveData() override;
    
@@ -75,6 +80,8 @@ private:
    FloatSlider* mDSlider;
    float mE;
    FloatSlider* mESlider;
+   int mOversample;
+   DropdownList* mOversampleDropdown;
    
    std::string mEntryString;
    TextEntry* mTextEntry;
@@ -109,4 +116,5 @@ private:
    };
    
    BiquadState mBiquadState[ChannelBuffer::kMaxNumChannels];
+   Oversampler mOversampler;
 };